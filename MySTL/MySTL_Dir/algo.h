@@ -104,7 +104,7 @@ namespace mystl {
 		return first;
 	}
 
-	// һΧǷĵڶΧ
+	// 第一个范围中是否包含的第二个范围所有数并且是连续的
 	template <class ForwardIter1, class ForwardIter2>
 	ForwardIter1 search(ForwardIter1 first1, ForwardIter1 last1, ForwardIter2 first2, ForwardIter2 last2)
 	{
@@ -161,7 +161,7 @@ namespace mystl {
 		return first1;
 	}
 
-	//һΧǷnvalue
+	//第一个范围中是否连续包含n个value
 	template <class ForwardIter, class Size, class T>
 	ForwardIter search_n(ForwardIter first, ForwardIter last, Size n, const T& value)
 	{
@@ -228,7 +228,7 @@ namespace mystl {
 		return first;
 	}
 
-	// ΧһһΧλ
+	// 范围一中最后一组包含范围二的位置
 	template <class ForwardIter1, class ForwardIter2>
 	ForwardIter1 find_end_dispatch(ForwardIter1 first1, ForwardIter1 last1,
 		ForwardIter2 first2, ForwardIter2 last2,
@@ -342,7 +342,7 @@ namespace mystl {
 			first2, last2, iterator_category(first1), iterator_category(first2), cmp);
 	}
 
-	//ΧһеһڷΧе
+	//输出范围一中第一个在范围二中的数
 	template <class InputIter, class ForwardIter>
 	InputIter find_first_of(InputIter first1, InputIter last1,
 		ForwardIter first2, ForwardIter last2)
@@ -382,7 +382,7 @@ namespace mystl {
 		return f;
 	}
 
-	//ڲλ
+	//找相邻并返回位置
 	template <class ForwardIter>
 	ForwardIter adjacent_find(ForwardIter first, ForwardIter last)
 	{
@@ -418,7 +418,7 @@ namespace mystl {
 		return last;
 	}
 
-	// һڵvalueλã㷨ҪѾ
+	// 找一个大于等于value的数的位置，该算法要求已经排序
 	template <class ForwardIter, class T>
 	ForwardIter lbound_dispatch(ForwardIter first, ForwardIter last,
 		const T& value, forward_iterator_tag)
@@ -548,7 +548,7 @@ namespace mystl {
 		return first;
 	}
 
-	// ҵһvalueλãҪ
+	// 找到第一个大于value的数的位置，要求排序
 	template <class ForwardIter, class T>
 	ForwardIter ubound_dispatch(ForwardIter first, ForwardIter last,
 		const T& value, radom_access_iterator_tag)
@@ -630,7 +630,7 @@ namespace mystl {
 		return mystl::ubound_dispatch(first, last, value, iterator_category(first), cmp);
 	}
 
-	// ֲҿΧǷvalue
+	// 二分查找看范围中是否存在value
 	template <class Iter, class T>
 	bool binaty_search(Iter first, Iter last, const T& value)
 	{
@@ -646,7 +646,7 @@ namespace mystl {
 		return iter != last && !cmp(value, *iter);
 	}
 
-	// һָڵvalueֵλúһvalueֵλãҪѾ
+	// 返回一个指向大于等于value的值的位置和一个大于value值的位置，要求已经排序
 	template <class ForwardIter, class T>
 	mystl::pair<ForwardIter, ForwardIter>
 		erange_dispatch(ForwardIter first, ForwardIter last,
@@ -794,7 +794,7 @@ namespace mystl {
 		}
 	}
 
-	// ҷΧһǷڷΧҪѾ
+	// 查找范围一中是否存在范围二且要求已经排序
 	template <class ForwardIter1, class ForwardIter2>
 	bool includes(ForwardIter1 first1, ForwardIter1 last1,
 		ForwardIter2 first2, ForwardIter2 last2)
@@ -844,7 +844,7 @@ namespace mystl {
 		return first2 == last2;
 	}
 
-	// ѵصǸڵӽڵ
+	// 堆的特点是父节点大于子节点
 	template <class RadomIter>
 	bool is_heap(RadomIter first, RadomIter last)
 	{
@@ -929,7 +929,7 @@ namespace mystl {
 	const T& median(const T& a, const T& b, const T& c, Compared cmp)
 	{
 		if (cmp(a, b)) {
-			return cmp(a, b) ? (cmp(c, b) ? c : b) : a;
+			return cmp(a, c) ? (cmp(c, b) ? c : b) : a;
 		}
 		else {
 			return cmp(b, c) ? (cmp(c, a) ? c : a) : b;
@@ -1005,15 +1005,6 @@ namespace mystl {
 	}
 
 
-	template <class ForwardIter1, class ForwardIter2>
-	void swap_range(ForwardIter1 first1, ForwardIter1 last1, ForwardIter2 first2)
-	{
-		for (; first1 != last1; first1++, first2++) {
-			mystl::iter_swap(first1, first2);
-		}
-	}
-
-
 	template <class InputIter, class OutIter, class UnaryOperation>
 	OutIter transform(InputIter first, InputIter last,
 		OutIter result, UnaryOperation unary)
@@ -1073,7 +1064,7 @@ namespace mystl {
 	template <class InputIter, class OutIter, class T, class UnaryPredicate>
 	OutIter remove_if(InputIter first, InputIter last, OutIter result, const T& value, UnaryPredicate unary)
 	{
-		first = mystl::find_if(first, last, cmp);
+		first = mystl::find_if(first, last, unary);
 		return first == last ? last : mystl::remove_copy(++first, last, result, value, unary);
 	}
 
@@ -1201,25 +1192,25 @@ namespace mystl {
 		}
 	}
 
-	// 㷨ֻһʹã÷
+	// 这个算法只会在一个容器中使用，用法如下
 	// 1 2 3 4 5 6 7
-	// 4Ϊķת
+	// 以4为中心翻转
 	// 4 5 6 7 1 2 3
 	template <class BidirectionalIter>
 	BidirectionalIter rotate_dispatch(BidirectionalIter first, BidirectionalIter middle,
 		BidirectionalIter last, bidirectional_iterator_tag)
 	{
-		mystl::reverse_dispatch(first, middle, bidirectional_iterator_tag);
-		mystl::reverse_dispatch(middle, last, bidirectional_iterator_tag);
+		mystl::reverse_dispatch(first, middle, bidirectional_iterator_tag());
+		mystl::reverse_dispatch(middle, last, bidirectional_iterator_tag());
 		while (first != middle && middle != last) {
 			mystl::iter_swap(first++, --last);
 		}
 		if (first == middle) {
-			mystl::reverse_dispatch(middle, last, bidirectional_iterator_tag);
+			mystl::reverse_dispatch(middle, last, bidirectional_iterator_tag());
 			return last;
 		}
 		else {
-			mystl::reverse_dispatch(first, middle, bidirectional_iterator_tag);
+			mystl::reverse_dispatch(first, middle, bidirectional_iterator_tag());
 			return first;
 		}
 	}
@@ -1275,37 +1266,38 @@ namespace mystl {
 			mystl::swap_range(first, middle, middle);
 			return middle;
 		}
+		// 一共 gcd(l, n) 个环，每个环沿着 +l / -r 把元素挪到最终位置
 		auto num = mystl::gcd(l, n);
-		for (int i = 0; i < num; i++) {
-			auto tmp = *first;
+		for (decltype(num) i = 0; i < num; i++) {
+			auto tmp = mystl::move(*first);
 			auto p = first;
 			if (l < r) {
-				for (int j = 0; j < r / num; j++) {
+				for (decltype(num) j = 0; j < r / num; j++) {
 					if (p > first + r) {
-						*p = *(p - r);
+						*p = mystl::move(*(p - r));
 						p -= r;
 					}
-					*p = *(p + l);
+					*p = mystl::move(*(p + l));
 					p += l;
 				}
 			}
 			else {
-				for (int j = 0; j < l / num; j++) {
+				for (decltype(num) j = 0; j < l / num - 1; j++) {
 					if (p < last - l) {
-						*p = *(p + l);
+						*p = mystl::move(*(p + l));
 						p += l;
 					}
-					*p = *(p - r);
+					*p = mystl::move(*(p - r));
 					p -= r;
 				}
 			}
-			*p = tmp;
+			*p = mystl::move(tmp);
 			first++;
 		}
 		return result;
 	}
 
-	// һнηΧɴСͬ
+	// 在一个容器中将两段范围交换，可大小不同
 	template <class ForwardIter>
 	ForwardIter rotate(ForwardIter first, ForwardIter middle, ForwardIter last)
 	{
@@ -1414,7 +1406,7 @@ namespace mystl {
 		return mystl::is_permutation_aux(first1, last1, first2, last2, mystl::equal_to<v1>());
 	}
 
-	//СгɴС
+	//将从小到大的排序逐渐排列成由大到小的排序
 	template <class BidirectionalIter>
 	bool next_permutation(BidirectionalIter first, BidirectionalIter last)
 	{
@@ -1510,20 +1502,21 @@ namespace mystl {
 		}
 	}
 
-	// й鲢
+	// 将两个容器的数进行归并排序
 	template <class InputIter1, class InputIter2, class OutIter>
 	OutIter merge(InputIter1 first, InputIter1 last,
 		InputIter2 begin, InputIter2 end, OutIter result)
 	{
+		// 相等时先取第一段的，保证稳定
 		while (first != last && begin != end) {
-			if (*first < *begin) {
-				*result = *first;
-				++first;
-			}
-			else {
+			if (*begin < *first) {
 				*result = *begin;
 				++begin;
 			}
+			else {
+				*result = *first;
+				++first;
+			}
 			++result;
 		}
 		return mystl::copy(first, last, mystl::copy(begin, end, result));
@@ -1535,20 +1528,20 @@ namespace mystl {
 		InputIter2 begin, InputIter2 end, OutIter result, Compared cmp)
 	{
 		while (first != last && begin != end) {
-			if (cmp(*first, *begin)) {
-				*result = *first;
-				++first;
-			}
-			else {
+			if (cmp(*begin, *first)) {
 				*result = *begin;
 				++begin;
 			}
+			else {
+				*result = *first;
+				++first;
+			}
 			++result;
 		}
 		return mystl::copy(first, last, mystl::copy(begin, end, result));
 	}
 
-	// һн˵ķΧкϲ
+	// 在一个容器中将两段排序了的范围进行合并并排序
 	template <class BidirectionalIter, class Distance>
 	void merge_without_buffer(BidirectionalIter first, BidirectionalIter middle,
 		BidirectionalIter last, Distance len1, Distance len2)
@@ -1557,7 +1550,7 @@ namespace mystl {
 			return;
 		}
 		if (len1 + len2 == 2) {
-			if (*first < *middle) {
+			if (*middle < *first) {
 				mystl::iter_swap(first, middle);
 			}
 			return;
@@ -1578,14 +1571,15 @@ namespace mystl {
 			len11 = mystl::distance(first, first_cut);
 		}
 		auto new_result = mystl::rotate(first_cut, middle, second_cut);
-		merge_without_buffer(first, first_cut, new_result, len11, len22);
-		merge_without_buffer(new_result, second_cut, last, len1 - len11, len2 - len22);
+		mystl::merge_without_buffer(first, first_cut, new_result, len11, len22);
+		mystl::merge_without_buffer(new_result, second_cut, last, len1 - len11, len2 - len22);
 	}
 
 
+	// 从后往前归并到 result 之前，相等时第二段的排在后面，保证稳定
 	template <class BidirectionalIter1, class BidirectionalIter2>
 	BidirectionalIter1 merge_backward(BidirectionalIter1 first1, BidirectionalIter1 last1,
-		BidirectionalIter2 first2, BidirectionalIter2 last2, BidirectionalIter2 result)
+		BidirectionalIter2 first2, BidirectionalIter2 last2, BidirectionalIter1 result)
 	{
 		if (first1 == last1) {
 			return mystl::copy_backward(first2, last2, result);
@@ -1598,21 +1592,21 @@ namespace mystl {
 			if (*last2 < *last1) {
 				*--result = *last1;
 				if (first1 == last1) {
-					return mystl::copy_backward(first2, last2, result);
+					return mystl::copy_backward(first2, ++last2, result);
 				}
 				--last1;
 			}
 			else {
 				*--result = *last2;
 				if (first2 == last2) {
-					return mystl::copy_backward(first1, last1, result);
+					return mystl::copy_backward(first1, ++last1, result);
 				}
 				--last2;
 			}
 		}
 	}
 
-	// ûķΧת
+	// 用缓存区的范围翻转
 	template <class BidirectionalIter1, class BidirectionalIter2, class Distance>
 	BidirectionalIter1 rotate_adaptive(BidirectionalIter1 first, BidirectionalIter1 middle,
 		BidirectionalIter1 last, Distance len1, Distance len2, BidirectionalIter2 buffer, Distance buf_size)
@@ -1620,7 +1614,7 @@ namespace mystl {
 		if (len1 > len2 && len2 <= buf_size) {
 			auto buffer_end = mystl::copy(middle, last, buffer);
 			mystl::copy_backward(first, middle, last);
-			return mystl::copy_backward(buffer, buffer_end, first);
+			return mystl::copy(buffer, buffer_end, first);
 		}
 		else if (len1 <= buf_size) {
 			auto buffer_end = mystl::copy(first, middle, buffer);
@@ -1628,11 +1622,11 @@ namespace mystl {
 			return mystl::copy_backward(buffer, buffer_end, last);
 		}
 		else {
-			return rotate(first, middle, last);
+			return mystl::rotate(first, middle, last);
 		}
 	}
 
-	// лĽһеķΧųһźķΧ
+	// 有缓冲区的将一个容器中的两段排了序的范围排成一段排好序的范围
 	template <class BidirectionalIter, class Distance, class Pointer>
 	void merge_adaptive(BidirectionalIter first, BidirectionalIter middle,
 		BidirectionalIter last, Distance len1, Distance len2,
@@ -1644,7 +1638,7 @@ namespace mystl {
 		}
 		else if (len2 <= buff_size) {
 			Pointer buff_end = mystl::copy(middle, last, buffer);
-			mystl::merge_backward(buffer, buff_end, first, middle, last);
+			mystl::merge_backward(first, middle, buffer, buff_end, last);
 		}
 		else {
 			auto first_cur = first;
@@ -1669,7 +1663,7 @@ namespace mystl {
 		}
 	}
 
-	//Ƿ뻺ûɷΧĻλ
+	//看看是否能申请缓冲区，借用缓冲区来完成范围的换位
 	template <class BidirectionalIter, class T>
 	void inplace_merge_aux(BidirectionalIter first, BidirectionalIter middle,
 		BidirectionalIter last, T*)
@@ -1681,7 +1675,7 @@ namespace mystl {
 			mystl::merge_without_buffer(first, middle, last, len1, len2);
 		}
 		else {
-			mystl::merge_adaptive(first, middle, last, len1, len2, buf, buf.size());
+			mystl::merge_adaptive(first, middle, last, len1, len2, buf.begin(), buf.size());
 		}
 	}
 
@@ -1704,7 +1698,7 @@ namespace mystl {
 			return;
 		}
 		if (len1 + len2 == 2) {
-			if (cmp(*first, *middle)) {
+			if (cmp(*middle, *first)) {
 				mystl::iter_swap(first, middle);
 			}
 			return;
@@ -1725,14 +1719,14 @@ namespace mystl {
 			len11 = mystl::distance(first, first_cut);
 		}
 		auto new_result = mystl::rotate(first_cut, middle, second_cut);
-		merge_without_buffer(first, first_cut, new_result, len11, len22, cmp);
-		merge_without_buffer(new_result, second_cut, last, len1 - len11, len2 - len22, cmp);
+		mystl::merge_without_buffer(first, first_cut, new_result, len11, len22, cmp);
+		mystl::merge_without_buffer(new_result, second_cut, last, len1 - len11, len2 - len22, cmp);
 	}
 
 
 	template <class BidirectionalIter1, class BidirectionalIter2, class Compared>
 	BidirectionalIter1 merge_backward(BidirectionalIter1 first1, BidirectionalIter1 last1,
-		BidirectionalIter2 first2, BidirectionalIter2 last2, BidirectionalIter2 result, Compared cmp)
+		BidirectionalIter2 first2, BidirectionalIter2 last2, BidirectionalIter1 result, Compared cmp)
 	{
 		if (first1 == last1) {
 			return mystl::copy_backward(first2, last2, result);
@@ -1745,14 +1739,14 @@ namespace mystl {
 			if (cmp(*last2, *last1)) {
 				*--result = *last1;
 				if (first1 == last1) {
-					return mystl::copy_backward(first2, last2, result);
+					return mystl::copy_backward(first2, ++last2, result);
 				}
 				--last1;
 			}
 			else {
 				*--result = *last2;
 				if (first2 == last2) {
-					return mystl::copy_backward(first1, last1, result);
+					return mystl::copy_backward(first1, ++last1, result);
 				}
 				--last2;
 			}
@@ -1771,7 +1765,7 @@ namespace mystl {
 		}
 		else if (len2 <= buff_size) {
 			Pointer buff_end = mystl::copy(middle, last, buffer);
-			mystl::merge_backward(buffer, buff_end, first, middle, last, cmp);
+			mystl::merge_backward(first, middle, buffer, buff_end, last, cmp);
 		}
 		else {
 			auto first_cur = first;
@@ -1808,7 +1802,7 @@ namespace mystl {
 			mystl::merge_without_buffer(first, middle, last, len1, len2, cmp);
 		}
 		else {
-			mystl::merge_adaptive(first, middle, last, len1, len2, buf, buf.size(), cmp);
+			mystl::merge_adaptive(first, middle, last, len1, len2, buf.begin(), buf.size(), cmp);
 		}
 	}
 
@@ -1822,8 +1816,8 @@ namespace mystl {
 		mystl::inplace_merge_aux(first, middle, last, value_type(first), cmp);
 	}
 
-	// 
-	// [first middle) ж
+	// 部分排序
+	// 对[first， middle) 进行堆排序
 	template <class RadomIter>
 	void partial_sort(RadomIter first, RadomIter middle, RadomIter last)
 	{
@@ -1996,11 +1990,11 @@ namespace mystl {
 		}
 	}
 
-	// 
+	// 快排
 	template <class RadomIter, class Size>
 	void intro_sort(RadomIter first, RadomIter last, Size depth_limit)
 	{
-		while (static_cast<Size>(last - first) > kSmallSectionSize) {
+		while (static_cast<size_t>(last - first) > kSmallSectionSize) {
 			if (depth_limit == 0) {
 				mystl::partial_sort(first, last, last);
 				return;
@@ -2013,45 +2007,45 @@ namespace mystl {
 		}
 	}
 
-	// Ӻ
+	// 从后插入，value 是从 *last 拿出来的，不能是 *last 的引用，否则第一次挪动就把它覆盖了
 	template <class RadomIter, class T>
-	void unchecked_linear_insert(RadomIter last, const T& value)
+	void unchecked_linear_insert(RadomIter last, T value)
 	{
 		auto pre = last - 1;
-		while (*pre > value) {
-			*last = *pre;
+		while (value < *pre) {
+			*last = mystl::move(*pre);
 			pre--;
 			last--;
 		}
-		*last = value;
+		*last = mystl::move(value);
 	}
 
-	//
+	// 插入排序，不检查边界：first 前面必须已经有不大于区间里所有元素的值，first 本身也要插入
 	template <class RandomIter>
 	void unchecked_insertion_sort(RandomIter first, RandomIter last)
 	{
-		for (auto iter = first + 1; iter != last; iter++) {
-			unchecked_linear_insert(iter, *iter);
+		for (auto iter = first; iter != last; iter++) {
+			mystl::unchecked_linear_insert(iter, mystl::move(*iter));
 		}
 	}
 
-	// [first, last)в
+	// 将[first, last)进行插入排序
 	template <class RandomIter>
 	void insertion_sort(RandomIter first, RandomIter last)
 	{
 		for (auto iter = first + 1; iter != last; iter++) {
-			auto value = *iter;
+			auto value = mystl::move(*iter);
 			if (value < *first) {
-				mystl::copy_backward(first, iter, iter + 1);
-				*first = value;
+				mystl::move_backward(first, iter, iter + 1);
+				*first = mystl::move(value);
 			}
 			else {
-				mystl::unchecked_linear_insert(iter, value);
+				mystl::unchecked_linear_insert(iter, mystl::move(value));
 			}
 		}
 	}
 
-	// ԲŻ
+	// 对插入排序的优化
 	template <class RandomIter>
 	void final_insertion_sort(RandomIter first, RandomIter last)
 	{
@@ -2086,7 +2080,7 @@ namespace mystl {
 			while (cmp(value, *last)) {
 				--last;
 			}
-			if (!(cmp(*first, *last))) {
+			if (!(first < last)) {
 				return first;
 			}
 			mystl::iter_swap(first, last);
@@ -2094,11 +2088,11 @@ namespace mystl {
 		}
 	}
 
-	// 
+	// 快排
 	template <class RadomIter, class Size, class Compared>
 	void intro_sort(RadomIter first, RadomIter last, Size depth_limit, Compared cmp)
 	{
-		while (static_cast<Size>(last - first) > kSmallSectionSize) {
+		while (static_cast<size_t>(last - first) > kSmallSectionSize) {
 			if (depth_limit == 0) {
 				mystl::partial_sort(first, last, last,cmp);
 				return;
@@ -2111,25 +2105,25 @@ namespace mystl {
 		}
 	}
 
-	// Ӻ
+	// 从后插入
 	template <class RadomIter, class T, class Compared>
-	void unchecked_linear_insert(RadomIter last, const T& value, Compared cmp)
+	void unchecked_linear_insert(RadomIter last, T value, Compared cmp)
 	{
 		auto pre = last - 1;
-		while (cmp(*pre, value)) {
-			*last = *pre;
+		while (cmp(value, *pre)) {
+			*last = mystl::move(*pre);
 			pre--;
 			last--;
 		}
-		*last = value;
+		*last = mystl::move(value);
 	}
 
-	//
+	//插入排序
 	template <class RandomIter, class Compared>
 	void unchecked_insertion_sort(RandomIter first, RandomIter last, Compared cmp)
 	{
-		for (auto iter = first + 1; iter != last; iter++) {
-			unchecked_linear_insert(iter, *iter, cmp);
+		for (auto iter = first; iter != last; iter++) {
+			mystl::unchecked_linear_insert(iter, mystl::move(*iter), cmp);
 		}
 	}
 
@@ -2138,13 +2132,13 @@ namespace mystl {
 	void insertion_sort(RandomIter first, RandomIter last, Compared cmp)
 	{
 		for (auto iter = first + 1; iter != last; iter++) {
-			auto value = *iter;
+			auto value = mystl::move(*iter);
 			if (cmp(value, *first)) {
-				mystl::copy_backward(first, iter, iter + 1);
-				*first = value;
+				mystl::move_backward(first, iter, iter + 1);
+				*first = mystl::move(value);
 			}
 			else {
-				mystl::unchecked_linear_insert(iter, value, cmp);
+				mystl::unchecked_linear_insert(iter, mystl::move(value), cmp);
 			}
 		}
 	}
@@ -2173,7 +2167,7 @@ namespace mystl {
 	}
 
 
-	//д *nth Ԫطŵ棬Сڵķǰ
+	//将所有大于 *nth 的元素放到他后面，小于的放在前面
 	template <class RandomIter>
 	void ntl_element(RandomIter first, RandomIter nth, RandomIter last)
 	{
@@ -2182,7 +2176,7 @@ namespace mystl {
 		}
 		while (last - first > 3) {
 			auto cut = mystl::unchecked_partition(first, last,
-				mystl::median(*first, *(first + (lasat - first) / 2), *last));
+				mystl::median(*first, *(first + (last - first) / 2), *last));
 
 			if (cut <= nth) {
 				first = cut;
@@ -2202,7 +2196,7 @@ namespace mystl {
 		}
 		while (last - first > 3) {
 			auto cut = mystl::unchecked_partition(first, last,
-				mystl::median(*first, *(first + (lasat - first) / 2), *last, cmp), cmp);
+				mystl::median(*first, *(first + (last - first) / 2), *last, cmp), cmp);
 
 			if (cut <= nth) {
 				first = cut;
@@ -2213,7 +2207,7 @@ namespace mystl {
 		}
 	}
 
-	// [first, last)ҪѾ
+	// [first, last)要求已经排序
 	template <class InputIter, class ForwardIter>
 	ForwardIter unique_copy_dispatch(InputIter first, InputIter last,
 		ForwardIter result, forward_iterator_tag)
@@ -1,7 +1,7 @@
 #ifndef MYSTL_ALGOBASE_H
 #define MYSTL_ALGOBASE_H
 
-// ļһЩͿ㷨
+// 这个文件是一些填充和拷贝的算法
 #include <cstring>
 
 #include "iterator.h"
@@ -11,12 +11,12 @@ namespace mystl {
 
 #ifdef max
 #pragma message("#undefing marco max")
-#undef
+#undef max
 #endif // max
 
 #ifdef min
 #pragma message("#undefing marco min")
-#undef
+#undef min
 #endif // min
 
 
@@ -63,7 +63,7 @@ namespace mystl {
 		unchecked_copy_cat(InputIter first, InputIter last, OutIter begin,
 			mystl::radom_access_iterator_tag)
 	{
-		// üҾΪ˸ȫ
+		// 这里用减法不像上面那样我觉得是为了更安全
 		for (size_t len = last - first; len > 0; len--, first++, begin++) {
 			*begin = *first;
 		}
@@ -87,8 +87,8 @@ namespace mystl {
 	{
 		const auto n = static_cast<size_t> (last - first);
 		if (n != 0) {
-			//  memcpy() һmencpyȫ
-			// ǵص
+			// 这个函数和 memcpy() 一样，但比mencpy更安全
+			// 考虑到了重叠的问题
 			std::memmove(result, first, n * sizeof(Up));
 		}
 		return result + n;
@@ -118,8 +118,8 @@ namespace mystl {
 		unchecked_copy_backward_cat(BidirectionalIter1 first, BidirectionalIter1 last,
 			BidirectionalIter2 result, mystl::radom_access_iterator_tag)
 	{
-		for (size_t i = 1; i <= last - first; i++) {
-			*(result - i) = *(last - i);
+		for (auto n = last - first; n > 0; n--) {
+			*(--result) = *(--last);
 		}
 		return result;
 	}
@@ -135,8 +135,8 @@ namespace mystl {
 
 	template <class Tp, class Up>
 	typename std::enable_if<
-		std::is_same<Tp, Up>::value &&
-		std::is_copy_assignable<Up>::value,
+		std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+		std::is_trivially_copy_assignable<Up>::value,
 		Up*>::type
 		unchecked_copy_backward(Tp* first, Tp* last, Up* begin)
 	{
@@ -193,7 +193,7 @@ namespace mystl {
 	mystl::pair<InputIter, OutIter>
 		copy_n(InputIter first, Size n, OutIter begin)
 	{
-		return unchecked_copy(first, n, begin, mystl::iterator_category(first));
+		return uncheck_copy_n(first, n, begin, mystl::iterator_category(first));
 	}
 
 
@@ -225,7 +225,7 @@ namespace mystl {
 	OutIter
 		unchecked_move(InputIter first, InputIter last, OutIter begin)
 	{
-		return unchecked_copy_cat(first, last, begin, mystl::iterator_category(first));
+		return unchecked_move_cat(first, last, begin, mystl::iterator_category(first));
 	}
 
 	template <class Tp, class Up>
@@ -265,9 +265,9 @@ namespace mystl {
 	template <class RandomIter1, class RandomIter2>
 	RandomIter2
 		uncheck_move_backward_cat(RandomIter1 first, RandomIter1 last,
-			RandomIter2 being, mystl::radom_access_iterator_tag)
+			RandomIter2 begin, mystl::radom_access_iterator_tag)
 	{
-		for (auto n = last - first; n > 0; n--, last--, begin--) {
+		for (auto n = last - first; n > 0; n--) {
 			*(--begin) = mystl::move(*(--last));
 		}
 		return begin;
@@ -278,7 +278,7 @@ namespace mystl {
 	Iter2
 		uncheck_move_backward(Iter1 first, Iter1 last, Iter2 begin)
 	{
-		return uncheck_move_backward_cat(first, last, being, mystl::iterator_category(first));
+		return uncheck_move_backward_cat(first, last, begin, mystl::iterator_category(first));
 	}
 
 
@@ -289,9 +289,10 @@ namespace mystl {
 		Up*>::type
 		uncheck_move_backward(Tp* first, Tp* last, Up* begin)
 	{
-		const auto n = static_cast<size_t> last - first;
+		const auto n = static_cast<size_t>(last - first);
 		if (n != 0) {
-			std::memmove(being, first, n * sizeof(Up));
+			begin -= n;
+			std::memmove(begin, first, n * sizeof(Up));
 		}
 		return begin;
 	}
@@ -336,7 +337,7 @@ namespace mystl {
 	}
 	
 
-	// һ
+	// 如果是一个空类
 	template <class Tp, class Size, class Up>
 	typename std::enable_if<
 		std::is_integral<Tp>::value && sizeof(Tp) == 1 &&
@@ -373,14 +374,14 @@ namespace mystl {
 	void fill_cat(RadomIter first, RadomIter last, const T& value,
 		mystl::radom_access_iterator_tag)
 	{
-		fill_n(first, last - first, value);
+		mystl::fill_n(first, last - first, value);
 	}
 
 
 	template <class Iter, class T>
 	void fill(Iter first, Iter last, const T& value)
 	{
-		fill_cat(first, last, value, mystl::iterator_category(Iter));
+		fill_cat(first, last, value, mystl::iterator_category(first));
 	}
 
 
@@ -391,7 +392,7 @@ namespace mystl {
 			if (*first < *begin) {
 				return true;
 			}
-			if (*first > *begin) {
+			if (*begin < *first) {
 				return false;
 			}
 		}
@@ -406,7 +407,7 @@ namespace mystl {
 			if (cmp(*first, *begin)) {
 				return true;
 			}
-			if (!cmp(*begin, *first)) {
+			if (cmp(*begin, *first)) {
 				return false;
 			}
 		}
@@ -414,7 +415,7 @@ namespace mystl {
 	}
 
 
-	bool lexicographical_compare(const unsigned char* first1,
+	inline bool lexicographical_compare(const unsigned char* first1,
 		const unsigned char* last1,
 		const unsigned char* first2,
 		const unsigned char* last2)
@@ -87,7 +87,7 @@ namespace mystl {
 	template<class T>
 	inline void allocator<T>::construct(T* ptr, T&& value)
 	{
-		mystl::construct(ptr, value);
+		mystl::construct(ptr, mystl::move(value));
 	}
 
 	template<class T>
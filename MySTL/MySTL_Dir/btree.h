@@ -0,0 +1,1053 @@
+#ifndef MYSTL_BTREE_H
+#define MYSTL_BTREE_H
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "algobase.h"
+#include "rb_tree.h"
+
+namespace mystl {
+
+	// 每个节点放多少个值：让一个叶子节点的大小接近 NodeBytes，至少 3 个才能拆分
+	// 默认 256 字节是 4 条 cache line，int 大约 60 个，pair<int, int> 大约 30 个
+	template <class T, size_t NodeBytes>
+	struct btree_node_size
+	{
+		static constexpr size_t bytes = NodeBytes > 2 * sizeof(void*) ? NodeBytes - 2 * sizeof(void*) : 0;
+		static constexpr size_t value = bytes / sizeof(T) > 3 ? bytes / sizeof(T) : 3;
+
+		static_assert(value < 65535, "btree node is too large");
+	};
+
+	// 叶子节点只有值，内部节点在后面多一个孩子数组
+	// 值按 T 的大小和对齐直接排在节点里，count 之后的位置没有构造
+	template <class T, size_t N>
+	struct btree_node
+	{
+		using node_ptr = btree_node*;
+
+		node_ptr parent;
+		// 在父节点孩子数组里的下标
+		unsigned short position;
+		unsigned short count;
+		bool leaf;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type slot[N];
+
+		T* value(size_t i)
+		{
+			return reinterpret_cast<T*>(&slot[i]);
+		}
+
+		node_ptr& child(size_t i);
+	};
+
+	template <class T, size_t N>
+	struct btree_internal_node : public btree_node<T, N>
+	{
+		btree_node<T, N>* children[N + 1];
+	};
+
+	template <class T, size_t N>
+	inline btree_node<T, N>*& btree_node<T, N>::child(size_t i)
+	{
+		return static_cast<btree_internal_node<T, N>*>(this)->children[i];
+	}
+
+	// 迭代器是 (节点, 下标)，end 是最右边叶子的 (节点, count)
+	template <class T, size_t N>
+	struct btree_iterator_base : public mystl::iterator<mystl::bidirectional_iterator_tag, T>
+	{
+		using node_ptr = btree_node<T, N>*;
+
+		node_ptr node;
+		size_t position;
+
+		btree_iterator_base() : node(nullptr), position(0) {}
+		btree_iterator_base(node_ptr n, size_t p) : node(n), position(p) {}
+
+		void inc()
+		{
+			if (!node->leaf) {
+				node = node->child(position + 1);
+				while (!node->leaf) {
+					node = node->child(0);
+				}
+				position = 0;
+				return;
+			}
+			if (++position < node->count) {
+				return;
+			}
+			// 叶子走完了就往上找第一个还没走到的值，一直到根都没有说明已经是 end
+			node_ptr n = node;
+			size_t p = position;
+			while (p == n->count && n->parent != nullptr) {
+				p = n->position;
+				n = n->parent;
+			}
+			if (p < n->count) {
+				node = n;
+				position = p;
+			}
+		}
+
+		void dec()
+		{
+			if (!node->leaf) {
+				node = node->child(position);
+				while (!node->leaf) {
+					node = node->child(node->count);
+				}
+				position = node->count - 1;
+				return;
+			}
+			while (position == 0 && node->parent != nullptr) {
+				position = node->position;
+				node = node->parent;
+			}
+			--position;
+		}
+
+		bool operator==(const btree_iterator_base& rhs) const { return node == rhs.node && position == rhs.position; }
+		bool operator!=(const btree_iterator_base& rhs) const { return !(*this == rhs); }
+	};
+
+	template <class T, size_t N>
+	struct btree_iterator : public btree_iterator_base<T, N>
+	{
+		using value_type = T;
+		using pointer = T*;
+		using reference = T&;
+		using node_ptr = btree_node<T, N>*;
+		using self = btree_iterator;
+
+		using btree_iterator_base<T, N>::node;
+		using btree_iterator_base<T, N>::position;
+
+		btree_iterator() {}
+		btree_iterator(node_ptr n, size_t p) : btree_iterator_base<T, N>(n, p) {}
+
+		reference operator*() const { return *node->value(position); }
+		pointer operator->() const { return node->value(position); }
+
+		self& operator++()
+		{
+			this->inc();
+			return *this;
+		}
+
+		self operator++(int)
+		{
+			self tmp = *this;
+			this->inc();
+			return tmp;
+		}
+
+		self& operator--()
+		{
+			this->dec();
+			return *this;
+		}
+
+		self operator--(int)
+		{
+			self tmp = *this;
+			this->dec();
+			return tmp;
+		}
+	};
+
+	template <class T, size_t N>
+	struct btree_const_iterator : public btree_iterator_base<T, N>
+	{
+		using value_type = T;
+		using pointer = const T*;
+		using reference = const T&;
+		using node_ptr = btree_node<T, N>*;
+		using self = btree_const_iterator;
+
+		using btree_iterator_base<T, N>::node;
+		using btree_iterator_base<T, N>::position;
+
+		btree_const_iterator() {}
+		btree_const_iterator(node_ptr n, size_t p) : btree_iterator_base<T, N>(n, p) {}
+		btree_const_iterator(const btree_iterator<T, N>& rhs) : btree_iterator_base<T, N>(rhs.node, rhs.position) {}
+
+		reference operator*() const { return *node->value(position); }
+		pointer operator->() const { return node->value(position); }
+
+		self& operator++()
+		{
+			this->inc();
+			return *this;
+		}
+
+		self operator++(int)
+		{
+			self tmp = *this;
+			this->inc();
+			return tmp;
+		}
+
+		self& operator--()
+		{
+			this->dec();
+			return *this;
+		}
+
+		self operator--(int)
+		{
+			self tmp = *this;
+			this->dec();
+			return tmp;
+		}
+	};
+
+	// B 树，接口和 rb_tree 一样，btree_map / btree_set 在它上面包一层
+	// rb_tree 每个元素一个节点，每个节点带 parent/left/right/color，查找每下一层就是一次 cache miss
+	// 这里一个节点放几十个值，树高只有 log_N(n)，节点内二分查找都在连续的几条 cache line 里
+	// 值直接存在节点里，插入和删除会在节点之间挪动值，所以任何插入和删除都会让所有迭代器和指向元素的指针失效
+	template <class T, class Compare, size_t NodeBytes = 256>
+	class btree
+	{
+	public:
+
+		using value_traits = rb_tree_value_traits<T>;
+		using key_type = typename value_traits::key_type;
+		using mapped_type = typename value_traits::mapped_type;
+		using value_type = typename value_traits::value_type;
+		using key_compare = Compare;
+
+		static constexpr size_t node_values = btree_node_size<T, NodeBytes>::value;
+		// 删除后少于这么多个值的节点会和兄弟合并或者从兄弟借一个
+		static constexpr size_t min_values = node_values / 2;
+
+		using node_type = btree_node<T, node_values>;
+		using node_ptr = node_type*;
+		using internal_type = btree_internal_node<T, node_values>;
+
+		using allocator_type = allocator<T>;
+		using data_allocator = allocator<T>;
+		using leaf_allocator = allocator<node_type>;
+		using internal_allocator = allocator<internal_type>;
+
+		using pointer = typename allocator_type::pointer;
+		using const_pointer = typename allocator_type::const_pointer;
+		using reference = typename allocator_type::reference;
+		using const_reference = typename allocator_type::const_reference;
+		using size_type = typename allocator_type::size_type;
+		using difference_type = typename allocator_type::difference_type;
+
+		using iterator = btree_iterator<T, node_values>;
+		using const_iterator = btree_const_iterator<T, node_values>;
+		using reverse_iterator = mystl::reverse_iterator<iterator>;
+		using const_reverse_iterator = mystl::reverse_iterator<const_iterator>;
+
+		allocator_type get_allocate() const { return allocator_type(); }
+		key_compare key_comp() const { return m_Comp; }
+
+	private:
+
+		node_ptr	m_Root;
+		node_ptr	m_Leftmost;
+		node_ptr	m_Rightmost;
+		size_type	m_Size;
+		key_compare	m_Comp;
+
+	public:
+
+		btree()
+			: m_Root(nullptr), m_Leftmost(nullptr), m_Rightmost(nullptr), m_Size(0), m_Comp() {}
+
+		explicit btree(const Compare& comp)
+			: m_Root(nullptr), m_Leftmost(nullptr), m_Rightmost(nullptr), m_Size(0), m_Comp(comp) {}
+
+		// 按顺序插到末尾，拆分时左边留满，拷贝出来的节点几乎都是满的
+		btree(const btree& rhs)
+			: m_Root(nullptr), m_Leftmost(nullptr), m_Rightmost(nullptr), m_Size(0), m_Comp(rhs.m_Comp)
+		{
+			try {
+				for (const_iterator it = rhs.begin(); it != rhs.end(); ++it) {
+					append(*it);
+				}
+			}
+			catch (...) {
+				clear();
+				throw;
+			}
+		}
+
+		btree(btree&& rhs) noexcept
+			: m_Root(rhs.m_Root), m_Leftmost(rhs.m_Leftmost), m_Rightmost(rhs.m_Rightmost)
+			, m_Size(rhs.m_Size), m_Comp(rhs.m_Comp)
+		{
+			rhs.reset();
+		}
+
+		btree& operator=(const btree& rhs)
+		{
+			if (this != &rhs) {
+				btree tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		btree& operator=(btree&& rhs) noexcept
+		{
+			btree tmp(mystl::move(rhs));
+			swap(tmp);
+			return *this;
+		}
+
+		~btree()
+		{
+			clear();
+		}
+
+	public:
+
+		iterator begin() noexcept
+		{
+			return iterator(m_Leftmost, 0);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(m_Leftmost, 0);
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(m_Rightmost, m_Rightmost != nullptr ? m_Rightmost->count : 0);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(m_Rightmost, m_Rightmost != nullptr ? m_Rightmost->count : 0);
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		bool empty() const noexcept
+		{
+			return m_Size == 0;
+		}
+
+		size_type size() const noexcept
+		{
+			return m_Size;
+		}
+
+		size_type max_size() const noexcept
+		{
+			return static_cast<size_type>(-1);
+		}
+
+		// 树高，空树为 0
+		size_type height() const noexcept
+		{
+			size_type h = 0;
+			for (node_ptr x = m_Root; x != nullptr; x = x->leaf ? nullptr : x->child(0)) {
+				++h;
+			}
+			return h;
+		}
+
+	public:
+
+		template <class ...Args>
+		mystl::pair<iterator, bool> emplace_unique(Args&& ...args)
+		{
+			value_type tmp(mystl::forward<Args>(args)...);
+			return insert_unique(mystl::move(tmp));
+		}
+
+		template <class ...Args>
+		iterator emplace_multi(Args&& ...args)
+		{
+			value_type tmp(mystl::forward<Args>(args)...);
+			return insert_multi(mystl::move(tmp));
+		}
+
+		mystl::pair<iterator, bool> insert_unique(const value_type& value)
+		{
+			return insert_unique_value(value);
+		}
+
+		mystl::pair<iterator, bool> insert_unique(value_type&& value)
+		{
+			return insert_unique_value(mystl::move(value));
+		}
+
+		iterator insert_multi(const value_type& value)
+		{
+			return insert_multi_value(value);
+		}
+
+		iterator insert_multi(value_type&& value)
+		{
+			return insert_multi_value(mystl::move(value));
+		}
+
+		template <class InputIter>
+		void insert_unique(InputIter first, InputIter last)
+		{
+			for (; first != last; ++first) {
+				insert_unique(*first);
+			}
+		}
+
+		template <class InputIter>
+		void insert_multi(InputIter first, InputIter last)
+		{
+			for (; first != last; ++first) {
+				insert_multi(*first);
+			}
+		}
+
+		// 返回被删元素的下一个元素
+		iterator erase(iterator pos)
+		{
+			node_ptr x = pos.node;
+			size_type i = pos.position;
+			const bool internal = !x->leaf;
+			data_allocator::destroy(x->value(i));
+			if (internal) {
+				// 内部节点的值用左子树里最大的值顶上，这个值一定在叶子的末尾，真正少一个值的总是叶子
+				node_ptr leaf = x->child(i);
+				while (!leaf->leaf) {
+					leaf = leaf->child(leaf->count);
+				}
+				move_value(x->value(i), leaf->value(leaf->count - 1));
+				--leaf->count;
+				x = leaf;
+				i = leaf->count;
+			}
+			else {
+				for (size_type j = i; j + 1 < x->count; ++j) {
+					move_value(x->value(j), x->value(j + 1));
+				}
+				--x->count;
+			}
+			--m_Size;
+			// (x, i) 跟着合并和借值移动，始终指向删除位置后面的那个元素
+			rebalance(x, i);
+			if (m_Root == nullptr) {
+				return end();
+			}
+			iterator it(x, i);
+			if (i == x->count) {
+				// 叶子末尾之后的元素在祖先里
+				it = iterator(x, i - 1);
+				++it;
+			}
+			// 内部节点的情况下，删除位置后面那个元素是顶上去的前驱，再往后一个才是原来的后继
+			if (internal) {
+				++it;
+			}
+			return it;
+		}
+
+		void erase(iterator first, iterator last)
+		{
+			if (first == begin() && last == end()) {
+				clear();
+				return;
+			}
+			// 每次 erase 都会让 last 失效，先数好个数
+			size_type n = static_cast<size_type>(mystl::distance(first, last));
+			for (; n > 0; --n) {
+				first = erase(first);
+			}
+		}
+
+		size_type erase_unique(const key_type& key)
+		{
+			iterator it = find(key);
+			if (it == end()) {
+				return 0;
+			}
+			erase(it);
+			return 1;
+		}
+
+		size_type erase_multi(const key_type& key)
+		{
+			iterator it = lower_bound(key);
+			size_type n = static_cast<size_type>(mystl::distance(it, upper_bound(key)));
+			for (size_type k = n; k > 0; --k) {
+				it = erase(it);
+			}
+			return n;
+		}
+
+		void clear()
+		{
+			if (m_Root != nullptr) {
+				destroy_tree(m_Root);
+			}
+			reset();
+		}
+
+		iterator find(const key_type& key)
+		{
+			return find_pos(key);
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return find_pos(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		iterator find(const K& key)
+		{
+			return find_pos(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator find(const K& key) const
+		{
+			return find_pos(key);
+		}
+
+		size_type count_unique(const key_type& key) const
+		{
+			return find_pos(key) == end_pos() ? 0 : 1;
+		}
+
+		size_type count_multi(const key_type& key) const
+		{
+			return static_cast<size_type>(mystl::distance(lower_bound(key), upper_bound(key)));
+		}
+
+		iterator lower_bound(const key_type& key)
+		{
+			return lower_bound_pos(key);
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return lower_bound_pos(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		iterator lower_bound(const K& key)
+		{
+			return lower_bound_pos(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator lower_bound(const K& key) const
+		{
+			return lower_bound_pos(key);
+		}
+
+		iterator upper_bound(const key_type& key)
+		{
+			return upper_bound_pos(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return upper_bound_pos(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		iterator upper_bound(const K& key)
+		{
+			return upper_bound_pos(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator upper_bound(const K& key) const
+		{
+			return upper_bound_pos(key);
+		}
+
+		mystl::pair<iterator, iterator> equal_range_multi(const key_type& key)
+		{
+			return mystl::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		mystl::pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
+		{
+			return mystl::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		mystl::pair<iterator, iterator> equal_range_unique(const key_type& key)
+		{
+			iterator it = find(key);
+			iterator next = it;
+			return mystl::make_pair(it, it == end() ? it : ++next);
+		}
+
+		mystl::pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+		{
+			const_iterator it = find(key);
+			const_iterator next = it;
+			return mystl::make_pair(it, it == end() ? it : ++next);
+		}
+
+		void swap(btree& rhs) noexcept
+		{
+			mystl::swap(m_Root, rhs.m_Root);
+			mystl::swap(m_Leftmost, rhs.m_Leftmost);
+			mystl::swap(m_Rightmost, rhs.m_Rightmost);
+			mystl::swap(m_Size, rhs.m_Size);
+			mystl::swap(m_Comp, rhs.m_Comp);
+		}
+
+	private:
+
+		void reset()
+		{
+			m_Root = m_Leftmost = m_Rightmost = nullptr;
+			m_Size = 0;
+		}
+
+		iterator end_pos() const
+		{
+			return iterator(m_Rightmost, m_Rightmost != nullptr ? m_Rightmost->count : 0);
+		}
+
+		// 节点内第一个不小于 key 的下标
+		template <class K>
+		size_type lower_in_node(node_ptr x, const K& key) const
+		{
+			size_type lo = 0, hi = x->count;
+			while (lo < hi) {
+				size_type mid = (lo + hi) / 2;
+				if (m_Comp(value_traits::get_key(*x->value(mid)), key)) {
+					lo = mid + 1;
+				}
+				else {
+					hi = mid;
+				}
+			}
+			return lo;
+		}
+
+		// 节点内第一个大于 key 的下标
+		template <class K>
+		size_type upper_in_node(node_ptr x, const K& key) const
+		{
+			size_type lo = 0, hi = x->count;
+			while (lo < hi) {
+				size_type mid = (lo + hi) / 2;
+				if (m_Comp(key, value_traits::get_key(*x->value(mid)))) {
+					hi = mid;
+				}
+				else {
+					lo = mid + 1;
+				}
+			}
+			return lo;
+		}
+
+		// 往下走的时候记住最后一个落在节点内的位置，越往下的位置越小，最后记住的就是答案
+		template <class K>
+		iterator lower_bound_pos(const K& key) const
+		{
+			iterator res = end_pos();
+			for (node_ptr x = m_Root; x != nullptr; ) {
+				size_type i = lower_in_node(x, key);
+				if (i < x->count) {
+					res = iterator(x, i);
+				}
+				x = x->leaf ? nullptr : x->child(i);
+			}
+			return res;
+		}
+
+		template <class K>
+		iterator upper_bound_pos(const K& key) const
+		{
+			iterator res = end_pos();
+			for (node_ptr x = m_Root; x != nullptr; ) {
+				size_type i = upper_in_node(x, key);
+				if (i < x->count) {
+					res = iterator(x, i);
+				}
+				x = x->leaf ? nullptr : x->child(i);
+			}
+			return res;
+		}
+
+		// 在内部节点上碰到相等的 key 就直接返回，不用走到叶子
+		template <class K>
+		iterator find_pos(const K& key) const
+		{
+			for (node_ptr x = m_Root; x != nullptr; ) {
+				size_type i = lower_in_node(x, key);
+				if (i < x->count && !m_Comp(key, value_traits::get_key(*x->value(i)))) {
+					return iterator(x, i);
+				}
+				x = x->leaf ? nullptr : x->child(i);
+			}
+			return end_pos();
+		}
+
+		template <class V>
+		mystl::pair<iterator, bool> insert_unique_value(V&& value)
+		{
+			THROW_LENGTH_ERROR_IF(m_Size > max_size() - 1, "btree<T>'s size too big");
+			if (m_Root == nullptr) {
+				return mystl::make_pair(insert_at(init_root(), 0, mystl::forward<V>(value)), true);
+			}
+			const key_type& key = value_traits::get_key(value);
+			node_ptr x = m_Root;
+			for (;;) {
+				size_type i = lower_in_node(x, key);
+				if (i < x->count && !m_Comp(key, value_traits::get_key(*x->value(i)))) {
+					return mystl::make_pair(iterator(x, i), false);
+				}
+				if (x->leaf) {
+					return mystl::make_pair(insert_at(x, i, mystl::forward<V>(value)), true);
+				}
+				x = x->child(i);
+			}
+		}
+
+		// 相等的 key 插在已有的后面，和 rb_tree 的 insert_multi 一致
+		template <class V>
+		iterator insert_multi_value(V&& value)
+		{
+			THROW_LENGTH_ERROR_IF(m_Size > max_size() - 1, "btree<T>'s size too big");
+			if (m_Root == nullptr) {
+				return insert_at(init_root(), 0, mystl::forward<V>(value));
+			}
+			const key_type& key = value_traits::get_key(value);
+			node_ptr x = m_Root;
+			while (!x->leaf) {
+				x = x->child(upper_in_node(x, key));
+			}
+			return insert_at(x, upper_in_node(x, key), mystl::forward<V>(value));
+		}
+
+		// 已知 value 不小于所有元素时直接插到最右边的叶子末尾
+		void append(const value_type& value)
+		{
+			if (m_Root == nullptr) {
+				insert_at(init_root(), 0, value);
+			}
+			else {
+				insert_at(m_Rightmost, m_Rightmost->count, value);
+			}
+		}
+
+		// 在叶子 x 的下标 i 处构造新值，x 满了先拆分
+		template <class ...Args>
+		iterator insert_at(node_ptr x, size_type i, Args&& ...args)
+		{
+			if (x->count == node_values) {
+				split(x, i);
+			}
+			for (size_type j = x->count; j > i; --j) {
+				move_value(x->value(j), x->value(j - 1));
+			}
+			try {
+				data_allocator::construct(x->value(i), mystl::forward<Args>(args)...);
+			}
+			catch (...) {
+				for (size_type j = i; j < x->count; ++j) {
+					move_value(x->value(j), x->value(j + 1));
+				}
+				throw;
+			}
+			++x->count;
+			++m_Size;
+			return iterator(x, i);
+		}
+
+		// 把满的节点 x 拆成两个，中间的值放到父节点上，父节点也满了就先拆父节点
+		// (x, i) 是要插入的位置，拆完之后改成新值应该去的节点和下标
+		void split(node_ptr& x, size_type& i)
+		{
+			if (x->parent == nullptr) {
+				node_ptr root = new_internal();
+				set_child(root, 0, x);
+				m_Root = root;
+			}
+			else if (x->parent->count == node_values) {
+				node_ptr p = x->parent;
+				size_type pi = x->position;
+				split(p, pi);
+			}
+			// 顺序插入的时候插在末尾，只把新值分出去，左边的节点保持是满的；倒序插入同理
+			const size_type mid = i == node_values ? node_values - 1 : (i == 0 ? 0 : node_values / 2);
+			node_ptr y = x->leaf ? new_leaf() : new_internal();
+			node_ptr p = x->parent;
+			const size_type pos = x->position;
+			const size_type moved = node_values - mid - 1;
+			for (size_type j = 0; j < moved; ++j) {
+				move_value(y->value(j), x->value(mid + 1 + j));
+			}
+			if (!x->leaf) {
+				for (size_type j = 0; j <= moved; ++j) {
+					set_child(y, j, x->child(mid + 1 + j));
+				}
+			}
+			y->count = static_cast<unsigned short>(moved);
+			// 父节点里 pos 之后的值和 pos + 1 之后的孩子都往后挪一格
+			for (size_type j = p->count; j > pos; --j) {
+				move_value(p->value(j), p->value(j - 1));
+				set_child(p, j + 1, p->child(j));
+			}
+			move_value(p->value(pos), x->value(mid));
+			set_child(p, pos + 1, y);
+			++p->count;
+			x->count = static_cast<unsigned short>(mid);
+			if (x == m_Rightmost) {
+				m_Rightmost = y;
+			}
+			if (i > mid) {
+				x = y;
+				i -= mid + 1;
+			}
+		}
+
+		// x 刚少了一个值，不够一半时和兄弟合并，合并不了就从多的那个兄弟借一个，然后往上检查父节点
+		// (track, ti) 是 erase 要返回的位置，节点被合并掉或者值被挪动时跟着改
+		void rebalance(node_ptr& track, size_type& ti)
+		{
+			node_ptr x = track;
+			while (x != m_Root && x->count < min_values) {
+				node_ptr p = x->parent;
+				const size_type k = x->position;
+				node_ptr left = k > 0 ? p->child(k - 1) : nullptr;
+				node_ptr right = k < p->count ? p->child(k + 1) : nullptr;
+				if (left != nullptr && left->count + x->count + 1 <= node_values) {
+					if (track == x) {
+						ti += left->count + 1;
+						track = left;
+					}
+					merge(left, x);
+					x = p;
+				}
+				else if (right != nullptr && x->count + right->count + 1 <= node_values) {
+					merge(x, right);
+					x = p;
+				}
+				else {
+					if (left != nullptr && (right == nullptr || left->count >= right->count)) {
+						rotate_right(left, x);
+						if (track == x) {
+							++ti;
+						}
+					}
+					else if (right != nullptr) {
+						rotate_left(x, right);
+					}
+					break;
+				}
+			}
+			// 根的两个孩子合并之后根就空了，树高减一
+			if (m_Root->count == 0) {
+				node_ptr old = m_Root;
+				if (old->leaf) {
+					reset();
+				}
+				else {
+					m_Root = old->child(0);
+					m_Root->parent = nullptr;
+					m_Root->position = 0;
+				}
+				free_node(old);
+			}
+		}
+
+		// right 和它们中间的分隔值都并到 left 上，释放 right
+		void merge(node_ptr left, node_ptr right)
+		{
+			node_ptr p = left->parent;
+			const size_type k = left->position;
+			const size_type n = left->count;
+			move_value(left->value(n), p->value(k));
+			for (size_type j = 0; j < right->count; ++j) {
+				move_value(left->value(n + 1 + j), right->value(j));
+			}
+			if (!left->leaf) {
+				for (size_type j = 0; j <= right->count; ++j) {
+					set_child(left, n + 1 + j, right->child(j));
+				}
+			}
+			left->count = static_cast<unsigned short>(n + 1 + right->count);
+			for (size_type j = k; j + 1 < p->count; ++j) {
+				move_value(p->value(j), p->value(j + 1));
+				set_child(p, j + 1, p->child(j + 2));
+			}
+			--p->count;
+			if (right == m_Rightmost) {
+				m_Rightmost = left;
+			}
+			free_node(right);
+		}
+
+		// 左兄弟的最后一个值经过父节点转到 x 的最前面
+		void rotate_right(node_ptr left, node_ptr x)
+		{
+			node_ptr p = x->parent;
+			const size_type k = x->position - 1;
+			for (size_type j = x->count; j > 0; --j) {
+				move_value(x->value(j), x->value(j - 1));
+			}
+			move_value(x->value(0), p->value(k));
+			move_value(p->value(k), left->value(left->count - 1));
+			if (!x->leaf) {
+				for (size_type j = x->count + 1; j > 0; --j) {
+					set_child(x, j, x->child(j - 1));
+				}
+				set_child(x, 0, left->child(left->count));
+			}
+			--left->count;
+			++x->count;
+		}
+
+		// 右兄弟的第一个值经过父节点转到 x 的末尾
+		void rotate_left(node_ptr x, node_ptr right)
+		{
+			node_ptr p = x->parent;
+			const size_type k = x->position;
+			move_value(x->value(x->count), p->value(k));
+			move_value(p->value(k), right->value(0));
+			for (size_type j = 0; j + 1 < right->count; ++j) {
+				move_value(right->value(j), right->value(j + 1));
+			}
+			if (!x->leaf) {
+				set_child(x, x->count + 1, right->child(0));
+				for (size_type j = 0; j < right->count; ++j) {
+					set_child(right, j, right->child(j + 1));
+				}
+			}
+			++x->count;
+			--right->count;
+		}
+
+		// 值在节点之间移动：在 dst 上移动构造，再析构 src
+		static void move_value(T* dst, T* src)
+		{
+			data_allocator::construct(dst, mystl::move(*src));
+			data_allocator::destroy(src);
+		}
+
+		static void set_child(node_ptr x, size_type i, node_ptr c)
+		{
+			x->child(i) = c;
+			c->parent = x;
+			c->position = static_cast<unsigned short>(i);
+		}
+
+		node_ptr init_root()
+		{
+			m_Root = m_Leftmost = m_Rightmost = new_leaf();
+			return m_Root;
+		}
+
+		static node_ptr new_leaf()
+		{
+			node_ptr x = leaf_allocator::allocate(1);
+			x->parent = nullptr;
+			x->position = 0;
+			x->count = 0;
+			x->leaf = true;
+			return x;
+		}
+
+		static node_ptr new_internal()
+		{
+			node_ptr x = internal_allocator::allocate(1);
+			x->parent = nullptr;
+			x->position = 0;
+			x->count = 0;
+			x->leaf = false;
+			return x;
+		}
+
+		static void free_node(node_ptr x)
+		{
+			if (x->leaf) {
+				leaf_allocator::deallocate(x);
+			}
+			else {
+				internal_allocator::deallocate(static_cast<internal_type*>(x));
+			}
+		}
+
+		static void destroy_tree(node_ptr x)
+		{
+			for (size_type j = 0; j < x->count; ++j) {
+				data_allocator::destroy(x->value(j));
+			}
+			if (!x->leaf) {
+				for (size_type j = 0; j <= x->count; ++j) {
+					destroy_tree(x->child(j));
+				}
+			}
+			free_node(x);
+		}
+	};
+
+	template <class T, class Compare, size_t NodeBytes>
+	bool operator==(const btree<T, Compare, NodeBytes>& lhs, const btree<T, Compare, NodeBytes>& rhs)
+	{
+		return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <class T, class Compare, size_t NodeBytes>
+	bool operator!=(const btree<T, Compare, NodeBytes>& lhs, const btree<T, Compare, NodeBytes>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class T, class Compare, size_t NodeBytes>
+	bool operator<(const btree<T, Compare, NodeBytes>& lhs, const btree<T, Compare, NodeBytes>& rhs)
+	{
+		return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <class T, class Compare, size_t NodeBytes>
+	void swap(btree<T, Compare, NodeBytes>& lhs, btree<T, Compare, NodeBytes>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_BTREE_H
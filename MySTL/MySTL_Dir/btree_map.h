@@ -0,0 +1,554 @@
+#ifndef MYSTL_BTREE_MAP_H
+#define MYSTL_BTREE_MAP_H
+
+
+#include "btree.h"
+
+
+namespace mystl {
+
+	template <class Key, class T, class Compare = mystl::less<Key>>
+	class btree_map
+	{
+	private:
+
+		using base_type = btree<pair<const Key, T>, Compare>;
+		base_type tree;
+
+	public:
+
+		using allocator_type = typename base_type::allocator_type;
+		using key_type = typename base_type::key_type;
+		using mapped_type = typename base_type::mapped_type;
+		using value_type = typename base_type::value_type;
+		using key_compare = typename base_type::key_compare;
+
+		using pointer = typename base_type::pointer;
+		using const_pointer = typename base_type::const_pointer;
+		using reference = typename base_type::reference;
+		using const_reference = typename base_type::const_reference;
+		using size_type = typename base_type::size_type;
+		using difference_type = typename base_type::difference_type;
+
+		using iterator = typename base_type::iterator;
+		using const_iterator = typename base_type::const_iterator;
+		using reverse_iterator = typename base_type::reverse_iterator;
+		using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+		allocator_type get_allocator() const { return tree.get_allocate(); }
+		key_compare key_comp() const { return tree.key_comp(); }
+
+	public:
+
+		btree_map() = default;
+
+		explicit btree_map(const Compare& comp) : tree(comp) {}
+
+		template <class InputIter>
+		btree_map(InputIter first, InputIter last, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_unique(first, last);
+		}
+
+		btree_map(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_unique(ilist.begin(), ilist.end());
+		}
+
+		btree_map(const btree_map& other) : tree(other.tree) {}
+
+		btree_map(btree_map&& other) noexcept : tree(mystl::move(other.tree)) {}
+
+		btree_map& operator=(const btree_map& other)
+		{
+			tree = other.tree;
+			return *this;
+		}
+
+		btree_map& operator=(btree_map&& other) noexcept
+		{
+			tree = mystl::move(other.tree);
+			return *this;
+		}
+
+		btree_map& operator=(std::initializer_list<value_type> ilist)
+		{
+			tree.clear();
+			tree.insert_unique(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		~btree_map() = default;
+
+		iterator begin() noexcept
+		{
+			return tree.begin();
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return tree.begin();
+		}
+
+		iterator end() noexcept
+		{
+			return tree.end();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return tree.end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return tree.rbegin();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return tree.rbegin();
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return tree.rend();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return tree.rend();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return tree.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return tree.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return tree.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return tree.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return tree.max_size();
+		}
+
+		mapped_type& at(const key_type& key)
+		{
+			iterator it = tree.find(key);
+			THROW_OUT_RANGE_IF(it == end(), "btree_map<Key, T> no such element exists");
+			return it->second;
+		}
+
+		const mapped_type& at(const key_type& key) const
+		{
+			const_iterator it = tree.find(key);
+			THROW_OUT_RANGE_IF(it == end(), "btree_map<Key, T> no such element exists");
+			return it->second;
+		}
+
+		mapped_type& operator[](const key_type& key)
+		{
+			iterator it = tree.find(key);
+			if (it == end()) {
+				it = tree.emplace_unique(key, T{}).first;
+			}
+			return it->second;
+		}
+
+		template <class ...Args>
+		pair<iterator, bool> emplace(Args&& ...args)
+		{
+			return tree.emplace_unique(mystl::forward<Args>(args)...);
+		}
+
+		pair<iterator, bool> insert(const value_type& value)
+		{
+			return tree.insert_unique(value);
+		}
+
+		pair<iterator, bool> insert(value_type&& value)
+		{
+			return tree.insert_unique(mystl::move(value));
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			tree.insert_unique(first, last);
+		}
+
+		iterator erase(iterator pos)
+		{
+			return tree.erase(pos);
+		}
+
+		size_type erase(const key_type& key)
+		{
+			return tree.erase_unique(key);
+		}
+
+		void erase(iterator first, iterator last)
+		{
+			tree.erase(first, last);
+		}
+
+		void clear()
+		{
+			tree.clear();
+		}
+
+		iterator find(const key_type& key)
+		{
+			return tree.find(key);
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return tree.find(key);
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return tree.count_unique(key);
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return tree.find(key) != tree.end();
+		}
+
+		iterator lower_bound(const key_type& key)
+		{
+			return tree.lower_bound(key);
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return tree.lower_bound(key);
+		}
+
+		iterator upper_bound(const key_type& key)
+		{
+			return tree.upper_bound(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return tree.upper_bound(key);
+		}
+
+		pair<iterator, iterator> equal_range(const key_type& key)
+		{
+			return tree.equal_range_unique(key);
+		}
+
+		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return tree.equal_range_unique(key);
+		}
+
+		void swap(btree_map& rhs) noexcept
+		{
+			tree.swap(rhs.tree);
+		}
+
+		friend bool operator==(const btree_map& lhs, const btree_map& rhs)
+		{
+			return lhs.tree == rhs.tree;
+		}
+
+		friend bool operator!=(const btree_map& lhs, const btree_map& rhs)
+		{
+			return lhs.tree != rhs.tree;
+		}
+
+		friend bool operator<(const btree_map& lhs, const btree_map& rhs)
+		{
+			return lhs.tree < rhs.tree;
+		}
+	};
+
+	template <class Key, class T, class Compare>
+	void swap(btree_map<Key, T, Compare>& lhs, btree_map<Key, T, Compare>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+
+	template <class Key, class T, class Compare = mystl::less<Key>>
+	class btree_multimap
+	{
+	private:
+
+		using base_type = btree<pair<const Key, T>, Compare>;
+		base_type tree;
+
+	public:
+
+		using allocator_type = typename base_type::allocator_type;
+		using key_type = typename base_type::key_type;
+		using mapped_type = typename base_type::mapped_type;
+		using value_type = typename base_type::value_type;
+		using key_compare = typename base_type::key_compare;
+
+		using pointer = typename base_type::pointer;
+		using const_pointer = typename base_type::const_pointer;
+		using reference = typename base_type::reference;
+		using const_reference = typename base_type::const_reference;
+		using size_type = typename base_type::size_type;
+		using difference_type = typename base_type::difference_type;
+
+		using iterator = typename base_type::iterator;
+		using const_iterator = typename base_type::const_iterator;
+		using reverse_iterator = typename base_type::reverse_iterator;
+		using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+		allocator_type get_allocator() const { return tree.get_allocate(); }
+		key_compare key_comp() const { return tree.key_comp(); }
+
+	public:
+
+		btree_multimap() = default;
+
+		explicit btree_multimap(const Compare& comp) : tree(comp) {}
+
+		template <class InputIter>
+		btree_multimap(InputIter first, InputIter last, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		btree_multimap(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_multi(ilist.begin(), ilist.end());
+		}
+
+		btree_multimap(const btree_multimap& other) : tree(other.tree) {}
+
+		btree_multimap(btree_multimap&& other) noexcept : tree(mystl::move(other.tree)) {}
+
+		btree_multimap& operator=(const btree_multimap& other)
+		{
+			tree = other.tree;
+			return *this;
+		}
+
+		btree_multimap& operator=(btree_multimap&& other) noexcept
+		{
+			tree = mystl::move(other.tree);
+			return *this;
+		}
+
+		btree_multimap& operator=(std::initializer_list<value_type> ilist)
+		{
+			tree.clear();
+			tree.insert_multi(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		~btree_multimap() = default;
+
+		iterator begin() noexcept
+		{
+			return tree.begin();
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return tree.begin();
+		}
+
+		iterator end() noexcept
+		{
+			return tree.end();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return tree.end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return tree.rbegin();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return tree.rbegin();
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return tree.rend();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return tree.rend();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return tree.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return tree.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return tree.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return tree.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return tree.max_size();
+		}
+
+		template <class ...Args>
+		iterator emplace(Args&& ...args)
+		{
+			return tree.emplace_multi(mystl::forward<Args>(args)...);
+		}
+
+		iterator insert(const value_type& value)
+		{
+			return tree.insert_multi(value);
+		}
+
+		iterator insert(value_type&& value)
+		{
+			return tree.insert_multi(mystl::move(value));
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		iterator erase(iterator pos)
+		{
+			return tree.erase(pos);
+		}
+
+		size_type erase(const key_type& key)
+		{
+			return tree.erase_multi(key);
+		}
+
+		void erase(iterator first, iterator last)
+		{
+			tree.erase(first, last);
+		}
+
+		void clear()
+		{
+			tree.clear();
+		}
+
+		iterator find(const key_type& key)
+		{
+			return tree.find(key);
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return tree.find(key);
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return tree.count_multi(key);
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return tree.find(key) != tree.end();
+		}
+
+		iterator lower_bound(const key_type& key)
+		{
+			return tree.lower_bound(key);
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return tree.lower_bound(key);
+		}
+
+		iterator upper_bound(const key_type& key)
+		{
+			return tree.upper_bound(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return tree.upper_bound(key);
+		}
+
+		pair<iterator, iterator> equal_range(const key_type& key)
+		{
+			return tree.equal_range_multi(key);
+		}
+
+		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return tree.equal_range_multi(key);
+		}
+
+		void swap(btree_multimap& rhs) noexcept
+		{
+			tree.swap(rhs.tree);
+		}
+
+		friend bool operator==(const btree_multimap& lhs, const btree_multimap& rhs)
+		{
+			return lhs.tree == rhs.tree;
+		}
+
+		friend bool operator!=(const btree_multimap& lhs, const btree_multimap& rhs)
+		{
+			return lhs.tree != rhs.tree;
+		}
+
+		friend bool operator<(const btree_multimap& lhs, const btree_multimap& rhs)
+		{
+			return lhs.tree < rhs.tree;
+		}
+	};
+
+	template <class Key, class T, class Compare>
+	void swap(btree_multimap<Key, T, Compare>& lhs, btree_multimap<Key, T, Compare>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_BTREE_MAP_H
@@ -0,0 +1,531 @@
+#ifndef MYSTL_BTREE_SET_H
+#define MYSTL_BTREE_SET_H
+
+
+#include "btree.h"
+
+
+namespace mystl {
+
+	template <class Key, class Compare = mystl::less<Key>>
+	class btree_set
+	{
+	private:
+
+		using base_type = btree<Key, Compare>;
+		base_type tree;
+
+	public:
+
+		using allocator_type = typename base_type::allocator_type;
+		using key_type = typename base_type::key_type;
+		using value_type = typename base_type::value_type;
+		using key_compare = typename base_type::key_compare;
+
+		using pointer = typename base_type::pointer;
+		using const_pointer = typename base_type::const_pointer;
+		using reference = typename base_type::reference;
+		using const_reference = typename base_type::const_reference;
+		using size_type = typename base_type::size_type;
+		using difference_type = typename base_type::difference_type;
+
+		using iterator = typename base_type::const_iterator;
+		using const_iterator = typename base_type::const_iterator;
+		using reverse_iterator = typename base_type::const_reverse_iterator;
+		using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+		allocator_type get_allocator() const { return tree.get_allocate(); }
+		key_compare key_comp() const { return tree.key_comp(); }
+
+	public:
+
+		btree_set() = default;
+
+		explicit btree_set(const Compare& comp) : tree(comp) {}
+
+		template <class InputIter>
+		btree_set(InputIter first, InputIter last, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_unique(first, last);
+		}
+
+		btree_set(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_unique(ilist.begin(), ilist.end());
+		}
+
+		btree_set(const btree_set& other) : tree(other.tree) {}
+
+		btree_set(btree_set&& other) noexcept : tree(mystl::move(other.tree)) {}
+
+		btree_set& operator=(const btree_set& other)
+		{
+			tree = other.tree;
+			return *this;
+		}
+
+		btree_set& operator=(btree_set&& other) noexcept
+		{
+			tree = mystl::move(other.tree);
+			return *this;
+		}
+
+		btree_set& operator=(std::initializer_list<value_type> ilist)
+		{
+			tree.clear();
+			tree.insert_unique(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		~btree_set() = default;
+
+		iterator begin() noexcept
+		{
+			return tree.begin();
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return tree.begin();
+		}
+
+		iterator end() noexcept
+		{
+			return tree.end();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return tree.end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return tree.rbegin();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return tree.rbegin();
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return tree.rend();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return tree.rend();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return tree.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return tree.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return tree.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return tree.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return tree.max_size();
+		}
+
+		template <class ...Args>
+		pair<iterator, bool> emplace(Args&& ...args)
+		{
+			return tree.emplace_unique(mystl::forward<Args>(args)...);
+		}
+
+		pair<iterator, bool> insert(const value_type& value)
+		{
+			return tree.insert_unique(value);
+		}
+
+		pair<iterator, bool> insert(value_type&& value)
+		{
+			return tree.insert_unique(mystl::move(value));
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			tree.insert_unique(first, last);
+		}
+
+		iterator erase(iterator pos)
+		{
+			return tree.erase(typename base_type::iterator(pos.node, pos.position));
+		}
+
+		size_type erase(const key_type& key)
+		{
+			return tree.erase_unique(key);
+		}
+
+		void erase(iterator first, iterator last)
+		{
+			tree.erase(typename base_type::iterator(first.node, first.position),
+				typename base_type::iterator(last.node, last.position));
+		}
+
+		void clear()
+		{
+			tree.clear();
+		}
+
+		iterator find(const key_type& key)
+		{
+			return tree.find(key);
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return tree.find(key);
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return tree.count_unique(key);
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return tree.find(key) != tree.end();
+		}
+
+		iterator lower_bound(const key_type& key)
+		{
+			return tree.lower_bound(key);
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return tree.lower_bound(key);
+		}
+
+		iterator upper_bound(const key_type& key)
+		{
+			return tree.upper_bound(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return tree.upper_bound(key);
+		}
+
+		pair<iterator, iterator> equal_range(const key_type& key)
+		{
+			return tree.equal_range_unique(key);
+		}
+
+		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return tree.equal_range_unique(key);
+		}
+
+		void swap(btree_set& rhs) noexcept
+		{
+			tree.swap(rhs.tree);
+		}
+
+		friend bool operator==(const btree_set& lhs, const btree_set& rhs)
+		{
+			return lhs.tree == rhs.tree;
+		}
+
+		friend bool operator!=(const btree_set& lhs, const btree_set& rhs)
+		{
+			return lhs.tree != rhs.tree;
+		}
+
+		friend bool operator<(const btree_set& lhs, const btree_set& rhs)
+		{
+			return lhs.tree < rhs.tree;
+		}
+	};
+
+	template <class Key, class Compare>
+	void swap(btree_set<Key, Compare>& lhs, btree_set<Key, Compare>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+
+	template <class Key, class Compare = mystl::less<Key>>
+	class btree_multiset
+	{
+	private:
+
+		using base_type = btree<Key, Compare>;
+		base_type tree;
+
+	public:
+
+		using allocator_type = typename base_type::allocator_type;
+		using key_type = typename base_type::key_type;
+		using value_type = typename base_type::value_type;
+		using key_compare = typename base_type::key_compare;
+
+		using pointer = typename base_type::pointer;
+		using const_pointer = typename base_type::const_pointer;
+		using reference = typename base_type::reference;
+		using const_reference = typename base_type::const_reference;
+		using size_type = typename base_type::size_type;
+		using difference_type = typename base_type::difference_type;
+
+		using iterator = typename base_type::const_iterator;
+		using const_iterator = typename base_type::const_iterator;
+		using reverse_iterator = typename base_type::const_reverse_iterator;
+		using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+		allocator_type get_allocator() const { return tree.get_allocate(); }
+		key_compare key_comp() const { return tree.key_comp(); }
+
+	public:
+
+		btree_multiset() = default;
+
+		explicit btree_multiset(const Compare& comp) : tree(comp) {}
+
+		template <class InputIter>
+		btree_multiset(InputIter first, InputIter last, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		btree_multiset(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_multi(ilist.begin(), ilist.end());
+		}
+
+		btree_multiset(const btree_multiset& other) : tree(other.tree) {}
+
+		btree_multiset(btree_multiset&& other) noexcept : tree(mystl::move(other.tree)) {}
+
+		btree_multiset& operator=(const btree_multiset& other)
+		{
+			tree = other.tree;
+			return *this;
+		}
+
+		btree_multiset& operator=(btree_multiset&& other) noexcept
+		{
+			tree = mystl::move(other.tree);
+			return *this;
+		}
+
+		btree_multiset& operator=(std::initializer_list<value_type> ilist)
+		{
+			tree.clear();
+			tree.insert_multi(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		~btree_multiset() = default;
+
+		iterator begin() noexcept
+		{
+			return tree.begin();
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return tree.begin();
+		}
+
+		iterator end() noexcept
+		{
+			return tree.end();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return tree.end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return tree.rbegin();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return tree.rbegin();
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return tree.rend();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return tree.rend();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return tree.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return tree.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return tree.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return tree.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return tree.max_size();
+		}
+
+		template <class ...Args>
+		iterator emplace(Args&& ...args)
+		{
+			return tree.emplace_multi(mystl::forward<Args>(args)...);
+		}
+
+		iterator insert(const value_type& value)
+		{
+			return tree.insert_multi(value);
+		}
+
+		iterator insert(value_type&& value)
+		{
+			return tree.insert_multi(mystl::move(value));
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		iterator erase(iterator pos)
+		{
+			return tree.erase(typename base_type::iterator(pos.node, pos.position));
+		}
+
+		size_type erase(const key_type& key)
+		{
+			return tree.erase_multi(key);
+		}
+
+		void erase(iterator first, iterator last)
+		{
+			tree.erase(typename base_type::iterator(first.node, first.position),
+				typename base_type::iterator(last.node, last.position));
+		}
+
+		void clear()
+		{
+			tree.clear();
+		}
+
+		iterator find(const key_type& key)
+		{
+			return tree.find(key);
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return tree.find(key);
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return tree.count_multi(key);
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return tree.find(key) != tree.end();
+		}
+
+		iterator lower_bound(const key_type& key)
+		{
+			return tree.lower_bound(key);
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return tree.lower_bound(key);
+		}
+
+		iterator upper_bound(const key_type& key)
+		{
+			return tree.upper_bound(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return tree.upper_bound(key);
+		}
+
+		pair<iterator, iterator> equal_range(const key_type& key)
+		{
+			return tree.equal_range_multi(key);
+		}
+
+		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return tree.equal_range_multi(key);
+		}
+
+		void swap(btree_multiset& rhs) noexcept
+		{
+			tree.swap(rhs.tree);
+		}
+
+		friend bool operator==(const btree_multiset& lhs, const btree_multiset& rhs)
+		{
+			return lhs.tree == rhs.tree;
+		}
+
+		friend bool operator!=(const btree_multiset& lhs, const btree_multiset& rhs)
+		{
+			return lhs.tree != rhs.tree;
+		}
+
+		friend bool operator<(const btree_multiset& lhs, const btree_multiset& rhs)
+		{
+			return lhs.tree < rhs.tree;
+		}
+	};
+
+	template <class Key, class Compare>
+	void swap(btree_multiset<Key, Compare>& lhs, btree_multiset<Key, Compare>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_BTREE_SET_H
@@ -0,0 +1,454 @@
+#ifndef MYSTL_CONCURRENT_SKIPLIST_MAP_H
+#define MYSTL_CONCURRENT_SKIPLIST_MAP_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <functional>
+#include <type_traits>
+
+#include "functional.h"
+#include "allocator.h"
+#include "epoch.h"
+
+namespace mystl {
+
+	// 跳表节点，每层的后继数组和节点放在同一块内存里，紧跟在节点后面
+	// 后继指针的最低位是删除标记：某一层的 next 被标记之后，这一层就不能再往这个节点后面插入
+	// value 放在 aligned_storage 里，表头节点只用后继数组，不构造 value
+	template <class T>
+	struct concurrent_skiplist_node
+	{
+		using node_ptr = concurrent_skiplist_node*;
+
+		// 插入线程链完所有层之后置 linked，删除线程打完标记之后置 deleted
+		// 两个都置上时后置的那一方负责把节点交给 epoch 回收
+		std::atomic<unsigned> state;
+		unsigned height;
+		std::atomic<node_ptr>* next;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+		concurrent_skiplist_node(unsigned h, std::atomic<node_ptr>* n) noexcept
+			: state(0), height(h), next(n) {}
+
+		T* value_ptr() noexcept { return reinterpret_cast<T*>(&storage); }
+		const T* value_ptr() const noexcept { return reinterpret_cast<const T*>(&storage); }
+	};
+
+	// 无锁的有序 map (Herlihy / Shavit 的无锁跳表)
+	// 插入：先在第 0 层 CAS 挂上去 (这一刻算插入成功)，再从下往上逐层 CAS 链上去
+	// 删除：先从上往下给每一层的 next 打标记，第 0 层打上标记的线程算删除成功 (逻辑删除)，
+	//       之后沿着查找路径把打了标记的节点从每一层摘掉 (物理删除)，摘干净之后交给 epoch 回收
+	// 查找和遍历不写任何东西，跳过打了标记的节点，在 epoch 临界区里进行，不会被写者阻塞
+	// 节点发布之后 value 不再修改，和 rcu_hashtable 一样通过回调在临界区里读
+	template <class Key, class T, class Compare = mystl::less<Key>>
+	class concurrent_skiplist_map
+	{
+	public:
+
+		using key_type		= Key;
+		using mapped_type	= T;
+		using value_type	= mystl::pair<const Key, T>;
+		using key_compare	= Compare;
+		using size_type		= size_t;
+
+		static constexpr unsigned max_level = 32;
+
+	private:
+
+		using node_type = concurrent_skiplist_node<value_type>;
+		using node_ptr = node_type*;
+		using link_type = std::atomic<node_ptr>;
+		using byte_allocator = mystl::allocator<char>;
+		using value_allocator = mystl::allocator<value_type>;
+
+		static constexpr unsigned node_linked = 1;
+		static constexpr unsigned node_deleted = 2;
+
+		node_ptr m_Head;
+		// 目前最高的层数，查找从这一层开始往下
+		std::atomic<unsigned> m_Top;
+		std::atomic<size_type> m_Size;
+		key_compare m_Comp;
+		mutable epoch_manager m_Epoch;
+
+	public:
+
+		explicit concurrent_skiplist_map(const Compare& comp = Compare())
+			: m_Head(allocate_node(max_level)), m_Top(1), m_Size(0), m_Comp(comp)
+		{
+		}
+
+		concurrent_skiplist_map(const concurrent_skiplist_map&) = delete;
+		concurrent_skiplist_map& operator=(const concurrent_skiplist_map&) = delete;
+
+		// 析构时不能再有并发的读写，还挂在第 0 层上的节点都是活的，逐个释放
+		// 已经摘下的节点在 m_Epoch 析构时释放
+		~concurrent_skiplist_map()
+		{
+			node_ptr cur = unmarked(m_Head->next[0].load(std::memory_order_relaxed));
+			while (cur != nullptr) {
+				node_ptr next = unmarked(cur->next[0].load(std::memory_order_relaxed));
+				destroy_node(cur);
+				cur = next;
+			}
+			deallocate_node(m_Head);
+		}
+
+		// 并发修改时只是一个近似值
+		size_type size() const noexcept
+		{
+			return m_Size.load(std::memory_order_relaxed);
+		}
+
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		key_compare key_comp() const
+		{
+			return m_Comp;
+		}
+
+		// 读操作：找到 key 后在临界区里调用 fn(const value_type&)
+		// fn 里拿到的引用离开 find 之后就可能被释放，需要的话在 fn 里拷贝出来
+		template <class Fn>
+		bool find(const key_type& key, Fn fn) const
+		{
+			epoch_guard guard(m_Epoch);
+			node_ptr np = bound_node(key, false);
+			if (np == nullptr || m_Comp(key, get_key(np))) {
+				return false;
+			}
+			fn(static_cast<const value_type&>(*np->value_ptr()));
+			return true;
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return find(key, [](const value_type&) {});
+		}
+
+		// 和 rb_tree 一样：lower_bound 是第一个不小于 key 的元素，upper_bound 是第一个大于 key 的元素
+		// 找到时在临界区里调用 fn，没有这样的元素返回 false
+		template <class Fn>
+		bool lower_bound(const key_type& key, Fn fn) const
+		{
+			epoch_guard guard(m_Epoch);
+			node_ptr np = bound_node(key, false);
+			if (np == nullptr) {
+				return false;
+			}
+			fn(static_cast<const value_type&>(*np->value_ptr()));
+			return true;
+		}
+
+		template <class Fn>
+		bool upper_bound(const key_type& key, Fn fn) const
+		{
+			epoch_guard guard(m_Epoch);
+			node_ptr np = bound_node(key, true);
+			if (np == nullptr) {
+				return false;
+			}
+			fn(static_cast<const value_type&>(*np->value_ptr()));
+			return true;
+		}
+
+		// 按 key 从小到大遍历，返回访问了多少个元素
+		// 遍历时可以有并发的插入和删除：每个元素最多访问一次，顺序一定是递增的，
+		// 遍历期间插入或删除的元素可能看得到也可能看不到
+		template <class Fn>
+		size_type for_each(Fn fn) const
+		{
+			epoch_guard guard(m_Epoch);
+			return visit(unmarked(m_Head->next[0].load(std::memory_order_acquire)), nullptr, fn);
+		}
+
+		// 遍历 [first, last)
+		template <class Fn>
+		size_type for_each_range(const key_type& first, const key_type& last, Fn fn) const
+		{
+			epoch_guard guard(m_Epoch);
+			return visit(bound_node(first, false), &last, fn);
+		}
+
+		// key 已经存在时不插入，返回 false
+		template <class ...Args>
+		bool emplace(Args&& ...args)
+		{
+			node_ptr np = create_node(random_height(), mystl::forward<Args>(args)...);
+			const key_type& key = get_key(np);
+			node_ptr preds[max_level];
+			node_ptr succs[max_level];
+			epoch_guard guard(m_Epoch);
+			for (;;) {
+				if (find_position(key, preds, succs)) {
+					destroy_node(np);
+					return false;
+				}
+				for (unsigned level = 0; level < np->height; ++level) {
+					np->next[level].store(succs[level], std::memory_order_relaxed);
+				}
+				node_ptr expected = succs[0];
+				if (preds[0]->next[0].compare_exchange_strong(expected, np,
+					std::memory_order_acq_rel, std::memory_order_acquire)) {
+					break;
+				}
+			}
+			m_Size.fetch_add(1, std::memory_order_relaxed);
+			raise_top(np->height);
+			link_upper(np, preds, succs);
+			return true;
+		}
+
+		bool insert(const value_type& value)
+		{
+			return emplace(value);
+		}
+
+		size_type erase(const key_type& key)
+		{
+			node_ptr preds[max_level];
+			node_ptr succs[max_level];
+			epoch_guard guard(m_Epoch);
+			if (!find_position(key, preds, succs)) {
+				return 0;
+			}
+			node_ptr np = succs[0];
+			// 从上往下给每一层打标记，之后这些层的 next 都不会再变
+			for (unsigned level = np->height - 1; level >= 1; --level) {
+				node_ptr next = np->next[level].load(std::memory_order_acquire);
+				while (!is_marked(next)) {
+					np->next[level].compare_exchange_weak(next, marked(next),
+						std::memory_order_acq_rel, std::memory_order_acquire);
+				}
+			}
+			// 第 0 层打上标记的线程才算删掉了这个元素，别的线程先打上了就当没找到
+			node_ptr next = np->next[0].load(std::memory_order_acquire);
+			for (;;) {
+				if (is_marked(next)) {
+					return 0;
+				}
+				if (np->next[0].compare_exchange_weak(next, marked(next),
+					std::memory_order_acq_rel, std::memory_order_acquire)) {
+					break;
+				}
+			}
+			m_Size.fetch_sub(1, std::memory_order_relaxed);
+			const unsigned prev = np->state.fetch_or(node_deleted, std::memory_order_acq_rel);
+			find_position(key, preds, succs);
+			if (prev & node_linked) {
+				m_Epoch.retire(np, &concurrent_skiplist_map::retire_node);
+			}
+			return 1;
+		}
+
+		// 主动回收一次，写得很少的时候可以在空闲时调用
+		void reclaim()
+		{
+			m_Epoch.reclaim();
+		}
+
+	private:
+
+		static bool is_marked(node_ptr p) noexcept
+		{
+			return (reinterpret_cast<std::uintptr_t>(p) & 1) != 0;
+		}
+
+		static node_ptr marked(node_ptr p) noexcept
+		{
+			return reinterpret_cast<node_ptr>(reinterpret_cast<std::uintptr_t>(p) | 1);
+		}
+
+		static node_ptr unmarked(node_ptr p) noexcept
+		{
+			return reinterpret_cast<node_ptr>(reinterpret_cast<std::uintptr_t>(p) & ~static_cast<std::uintptr_t>(1));
+		}
+
+		static const key_type& get_key(node_ptr np) noexcept
+		{
+			return np->value_ptr()->first;
+		}
+
+		// 只读的查找，不摘节点；upper 为 false 时找第一个不小于 key 的节点，为 true 时找第一个大于 key 的
+		node_ptr bound_node(const key_type& key, bool upper) const
+		{
+			node_ptr pred = m_Head;
+			node_ptr curr = nullptr;
+			for (unsigned level = m_Top.load(std::memory_order_acquire); level-- > 0; ) {
+				curr = unmarked(pred->next[level].load(std::memory_order_acquire));
+				while (curr != nullptr) {
+					node_ptr succ = curr->next[level].load(std::memory_order_acquire);
+					if (is_marked(succ)) {
+						curr = unmarked(succ);
+						continue;
+					}
+					if (upper ? m_Comp(key, get_key(curr)) : !m_Comp(get_key(curr), key)) {
+						break;
+					}
+					pred = curr;
+					curr = succ;
+				}
+			}
+			return curr;
+		}
+
+		template <class Fn>
+		size_type visit(node_ptr cur, const key_type* last, Fn& fn) const
+		{
+			size_type n = 0;
+			while (cur != nullptr) {
+				node_ptr next = cur->next[0].load(std::memory_order_acquire);
+				if (!is_marked(next)) {
+					if (last != nullptr && !m_Comp(get_key(cur), *last)) {
+						break;
+					}
+					fn(static_cast<const value_type&>(*cur->value_ptr()));
+					++n;
+				}
+				cur = unmarked(next);
+			}
+			return n;
+		}
+
+		// 找 key 在每一层的前驱和后继，路上遇到打了标记的节点顺手摘掉
+		// 摘的时候前驱已经变了就从头再找；返回第 0 层的后继是不是正好等于 key
+		bool find_position(const key_type& key, node_ptr* preds, node_ptr* succs)
+		{
+			const unsigned top = m_Top.load(std::memory_order_acquire);
+			for (unsigned level = top; level < max_level; ++level) {
+				preds[level] = m_Head;
+				succs[level] = nullptr;
+			}
+		retry:
+			node_ptr pred = m_Head;
+			for (unsigned level = top; level-- > 0; ) {
+				node_ptr curr = unmarked(pred->next[level].load(std::memory_order_acquire));
+				while (curr != nullptr) {
+					node_ptr succ = curr->next[level].load(std::memory_order_acquire);
+					if (is_marked(succ)) {
+						node_ptr expected = curr;
+						if (!pred->next[level].compare_exchange_strong(expected, unmarked(succ),
+							std::memory_order_acq_rel, std::memory_order_acquire)) {
+							goto retry;
+						}
+						curr = unmarked(succ);
+						continue;
+					}
+					if (!m_Comp(get_key(curr), key)) {
+						break;
+					}
+					pred = curr;
+					curr = succ;
+				}
+				preds[level] = pred;
+				succs[level] = curr;
+			}
+			return succs[0] != nullptr && !m_Comp(key, get_key(succs[0]));
+		}
+
+		// 第 0 层已经挂上，逐层往上链；某一层的 next 已经被打了标记说明节点正在被删，不再往上链
+		void link_upper(node_ptr np, node_ptr* preds, node_ptr* succs)
+		{
+			const key_type& key = get_key(np);
+			bool deleting = false;
+			for (unsigned level = 1; level < np->height && !deleting; ++level) {
+				for (;;) {
+					node_ptr next = np->next[level].load(std::memory_order_acquire);
+					if (next != succs[level] && (is_marked(next) ||
+						!np->next[level].compare_exchange_strong(next, succs[level],
+							std::memory_order_acq_rel, std::memory_order_acquire))) {
+						deleting = true;
+						break;
+					}
+					node_ptr expected = succs[level];
+					if (preds[level]->next[level].compare_exchange_strong(expected, np,
+						std::memory_order_acq_rel, std::memory_order_acquire)) {
+						break;
+					}
+					// 第 0 层已经找不到 np，说明它被删了
+					if (!find_position(key, preds, succs) || succs[0] != np) {
+						deleting = true;
+						break;
+					}
+				}
+			}
+			// 删除线程先置了 deleted：它摘的时候可能还有层没链上，这里再摘一遍，由这边回收
+			const unsigned prev = np->state.fetch_or(node_linked, std::memory_order_acq_rel);
+			if (prev & node_deleted) {
+				find_position(key, preds, succs);
+				m_Epoch.retire(np, &concurrent_skiplist_map::retire_node);
+			}
+		}
+
+		void raise_top(unsigned h) noexcept
+		{
+			unsigned top = m_Top.load(std::memory_order_relaxed);
+			while (top < h && !m_Top.compare_exchange_weak(top, h, std::memory_order_acq_rel)) {
+			}
+		}
+
+		// 每个线程一个 xorshift 状态，高度以 1/2 的概率逐层加一
+		static unsigned random_height() noexcept
+		{
+			thread_local std::uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			std::uint64_t bits = state;
+			unsigned h = 1;
+			while (h < max_level && (bits & 1)) {
+				++h;
+				bits >>= 1;
+			}
+			return h;
+		}
+
+		// 节点和 h 个后继指针一次分配，value 另外构造
+		static node_ptr allocate_node(unsigned h)
+		{
+			char* p = byte_allocator::allocate(sizeof(node_type) + h * sizeof(link_type));
+			link_type* links = reinterpret_cast<link_type*>(p + sizeof(node_type));
+			for (unsigned i = 0; i < h; ++i) {
+				::new ((void*)(links + i)) link_type(nullptr);
+			}
+			return ::new ((void*)p) node_type(h, links);
+		}
+
+		static void deallocate_node(node_ptr np) noexcept
+		{
+			byte_allocator::deallocate(reinterpret_cast<char*>(np));
+		}
+
+		template <class ...Args>
+		static node_ptr create_node(unsigned h, Args&& ...args)
+		{
+			node_ptr np = allocate_node(h);
+			try {
+				value_allocator::construct(np->value_ptr(), mystl::forward<Args>(args)...);
+			}
+			catch (...) {
+				deallocate_node(np);
+				throw;
+			}
+			return np;
+		}
+
+		static void destroy_node(node_ptr np)
+		{
+			value_allocator::destroy(np->value_ptr());
+			deallocate_node(np);
+		}
+
+		static void retire_node(void* p)
+		{
+			destroy_node(static_cast<node_ptr>(p));
+		}
+	};
+
+}
+
+#endif // !MYSTL_CONCURRENT_SKIPLIST_MAP_H
@@ -0,0 +1,218 @@
+#ifndef MYSTL_CONCURRENT_UNORDERED_MAP_H
+#define MYSTL_CONCURRENT_UNORDERED_MAP_H
+
+#include <cstdint>
+
+#include "hashtable.h"
+#include "rw_lock.h"
+
+namespace mystl {
+
+	// 分片的并发哈希表
+	// 按照 hash 的高位把 key 分到 2^ShardBits 个 hashtable 上，每个分片一把读写锁
+	// hashtable 内部用 hash % bucket_count 取的是低位，分片用高位两者互不干扰
+	// 因为迭代器在锁外不安全，所以查找返回的是值的拷贝
+	template <class Key, class T, class Hash = mystl::hash<Key>,
+		class KeyEqual = mystl::equal_to<Key>, size_t ShardBits = 4>
+	class concurrent_unordered_map
+	{
+	public:
+
+		using base_type = hashtable<pair<const Key, T>, Hash, KeyEqual>;
+
+		using key_type = typename base_type::key_type;
+		using mapped_type = typename base_type::mapped_type;
+		using value_type = typename base_type::value_type;
+		using hasher = typename base_type::hasher;
+		using key_equal = typename base_type::key_equal;
+		using size_type = typename base_type::size_type;
+
+		static constexpr size_type shard_count = static_cast<size_type>(1) << ShardBits;
+
+		static_assert(ShardBits > 0 && ShardBits < sizeof(size_t) * 8, "bad shard bits");
+
+	private:
+
+		// 每个分片独占一条 cache line，避免不同分片的锁之间伪共享
+		struct alignas(64) shard
+		{
+			mutable rw_lock lock;
+			base_type ht;
+
+			explicit shard(size_type bucket_cnt, const Hash& hash, const KeyEqual& equal)
+				: ht(bucket_cnt, hash, equal) {}
+		};
+
+		using shard_allocator = mystl::allocator<shard>;
+		// allocator 只保证 new 的默认对齐，分片要按 64 字节对齐只能多分配一点自己对齐
+		using raw_allocator = mystl::allocator<char>;
+
+		static constexpr size_type raw_bytes = sizeof(shard) * shard_count + alignof(shard) - 1;
+
+		char* m_Raw;
+		shard* m_Shards;
+		hasher m_Hash;
+
+	public:
+
+		explicit concurrent_unordered_map(size_type bucket_cnt = 100 * shard_count,
+			const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual())
+			: m_Raw(raw_allocator::allocate(raw_bytes)), m_Shards(nullptr), m_Hash(hash)
+		{
+			const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(m_Raw);
+			const std::uintptr_t aligned = (addr + alignof(shard) - 1) & ~static_cast<std::uintptr_t>(alignof(shard) - 1);
+			m_Shards = reinterpret_cast<shard*>(aligned);
+			const size_type per_shard = bucket_cnt / shard_count + 1;
+			size_type i = 0;
+			try {
+				for (; i < shard_count; ++i) {
+					shard_allocator::construct(m_Shards + i, per_shard, hash, equal);
+				}
+			}
+			catch (...) {
+				shard_allocator::destroy(m_Shards, m_Shards + i);
+				raw_allocator::deallocate(m_Raw, raw_bytes);
+				throw;
+			}
+		}
+
+		concurrent_unordered_map(const concurrent_unordered_map&) = delete;
+		concurrent_unordered_map& operator=(const concurrent_unordered_map&) = delete;
+
+		~concurrent_unordered_map()
+		{
+			shard_allocator::destroy(m_Shards, m_Shards + shard_count);
+			raw_allocator::deallocate(m_Raw, raw_bytes);
+		}
+
+		// 找到返回 true 并把值拷贝到 out
+		bool find(const key_type& key, mapped_type& out) const
+		{
+			const shard& s = get_shard(key);
+			shared_lock_guard<rw_lock> guard(s.lock);
+			auto it = s.ht.find(key);
+			if (it.node == nullptr) {
+				return false;
+			}
+			out = it.node->value.second;
+			return true;
+		}
+
+		bool contains(const key_type& key) const
+		{
+			const shard& s = get_shard(key);
+			shared_lock_guard<rw_lock> guard(s.lock);
+			return s.ht.count(key) != 0;
+		}
+
+		// 插入返回 true，key 已经存在则覆盖旧值并返回 false
+		template <class M>
+		bool insert_or_assign(const key_type& key, M&& obj)
+		{
+			shard& s = get_shard(key);
+			unique_lock_guard<rw_lock> guard(s.lock);
+			auto it = s.ht.find(key);
+			if (it.node != nullptr) {
+				it.node->value.second = mystl::forward<M>(obj);
+				return false;
+			}
+			s.ht.emplace_unique(key, mystl::forward<M>(obj));
+			return true;
+		}
+
+		size_type erase(const key_type& key)
+		{
+			shard& s = get_shard(key);
+			unique_lock_guard<rw_lock> guard(s.lock);
+			return s.ht.erase_unique(key);
+		}
+
+		// 在写锁内对 key 对应的值调用 fn(mapped_type&)，key 不存在返回 false
+		// fn 里不能再访问同一个 map，否则会死锁
+		template <class Fn>
+		bool update(const key_type& key, Fn fn)
+		{
+			shard& s = get_shard(key);
+			unique_lock_guard<rw_lock> guard(s.lock);
+			auto it = s.ht.find(key);
+			if (it.node == nullptr) {
+				return false;
+			}
+			fn(it.node->value.second);
+			return true;
+		}
+
+		// 依次锁住每个分片并调用 fn(base_type&)，同一时刻只持有一把锁
+		template <class Fn>
+		void for_each_shard(Fn fn)
+		{
+			for (size_type i = 0; i < shard_count; ++i) {
+				shard& s = m_Shards[i];
+				unique_lock_guard<rw_lock> guard(s.lock);
+				fn(s.ht);
+			}
+		}
+
+		template <class Fn>
+		void for_each_shard(Fn fn) const
+		{
+			for (size_type i = 0; i < shard_count; ++i) {
+				const shard& s = m_Shards[i];
+				shared_lock_guard<rw_lock> guard(s.lock);
+				fn(s.ht);
+			}
+		}
+
+		// 各分片分别加锁统计，并发修改时只是一个近似值
+		size_type size() const
+		{
+			size_type result = 0;
+			for_each_shard([&result](const base_type& ht) { result += ht.size(); });
+			return result;
+		}
+
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		void clear()
+		{
+			for_each_shard([](base_type& ht) { ht.clear(); });
+		}
+
+		hasher hash_fcn() const
+		{
+			return m_Hash;
+		}
+
+	private:
+
+		// 先乘上黄金分割数把低位的差异扩散到高位，再取高 ShardBits 位
+		// 否则像 int 这种恒等 hash 的高位全是 0，所有 key 都会落在 0 号分片
+		size_type shard_index(const key_type& key) const
+		{
+#ifdef SYSTEM_64
+			const size_t golden = 0x9E3779B97F4A7C15ull;
+#else
+			const size_t golden = 0x9E3779B9u;
+#endif
+			const size_t h = static_cast<size_t>(m_Hash(key)) * golden;
+			return static_cast<size_type>(h >> (sizeof(size_t) * 8 - ShardBits));
+		}
+
+		shard& get_shard(const key_type& key)
+		{
+			return m_Shards[shard_index(key)];
+		}
+
+		const shard& get_shard(const key_type& key) const
+		{
+			return m_Shards[shard_index(key)];
+		}
+	};
+
+}
+
+#endif // !MYSTL_CONCURRENT_UNORDERED_MAP_H
@@ -9,14 +9,14 @@
 
 #ifdef _MSC_VER
 #pragma warning(push)
-// VSЩ
+// VS下面哪些警告可以由这个生成
 #pragma warning(disable : 4100)
 #endif // 
 
 namespace mystl {
 
-	// placement newλnew
-	// ָλãַָ͵Ĺ캯
+	// placement new（定位放置new）
+	// 在指定位置（地址）调用指定类型的构造函数
 	template <class Tp,class T>
 	void construct(Tp* p,const T& value) {
 		::new ((void*)p) Tp(value);
@@ -35,7 +35,7 @@ namespace mystl {
 	template <class Tp>
 	void destroy_one(Tp*, std::true_type) {}
 
-	// ͹黹ռ
+	// 析构和归还空间相分离
 	template <class Tp>
 	void destroy_one(Tp* p, std::false_type) {
 		if (p != nullptr) {
@@ -51,7 +51,7 @@ namespace mystl {
 	template <class Iter>
 	void destroy_cat(Iter first, Iter end, std::false_type) {
 		while (first != end) {
-			mystl::destroy_one(&(*first));
+			mystl::destroy_one(&(*first), std::false_type{});
 			++first;
 		}
 	}
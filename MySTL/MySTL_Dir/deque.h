@@ -463,7 +463,7 @@ namespace {
 			}
 		}
 
-		// 黹ǰûװԪصĿռ
+		// 归还前后没有装有元素的空间
 		void shrink_to_fit() noexcept
 		{
 			for (auto cur = mMap; cur < mBegin.m_node; cur++) {
@@ -481,13 +481,13 @@ namespace {
 
 		reference at(size_type n)
 		{
-			THROW_OUT_RANGE_IF(!(n < size()), "Χ");
+			THROW_OUT_RANGE_IF(!(n < size()), "超出范围");
 			return (*this)[n];
 		}
 
 		const_reference at(size_type n) const
 		{
-			HROW_OUT_RANGE_IF(!(n < size()), "Χ");
+			HROW_OUT_RANGE_IF(!(n < size()), "超出范围");
 			return (*this)[n];
 		}
 
@@ -775,7 +775,7 @@ namespace {
 
 	private:
 
-		// һָ
+		// 创建一个指针数组
 		map_pointer create_map(size_type size)
 		{
 			map_pointer mp = nullptr;
@@ -786,7 +786,7 @@ namespace {
 			return mp;
 		}
 
-		// Ϊָÿһָָһ͵
+		// 为指针数组的每一个指针指向一个数据类型的数组
 		void create_buffer(map_pointer nstart, map_pointer nfinish)
 		{
 			map_pointer mp = nstart;
@@ -813,7 +813,7 @@ namespace {
 			}
 		}
 
-		// nelemʼԼmBeginmEnd
+		// 根据数据量nelem来初始化缓冲区以及mBegin和mEnd
 		void map_init(size_type nelem)
 		{
 			const size_type n = nelem / buf_size - 1;
@@ -856,7 +856,7 @@ namespace {
 			}
 		}
 
-		// о
+		// 这个设计有问题感觉
 		template <class Iter>
 		void copy_init(Iter first, Iter last, mystl::input_iterator_tag)
 		{
@@ -951,7 +951,7 @@ namespace {
 			value_type valueCopy = value;
 			if (elem < size() / 2) {
 				requiue_capacity(n, true);
-				// ĵѾʧЧ
+				// 这里的迭代器可能已经失效了
 				iterator newBegin = mBegin - n;
 				iterator oldBegin = mBegin;
 				pos = mBegin + elem;
@@ -964,8 +964,8 @@ namespace {
 						mystl::fill(pos - n, pos, valueCopy);
 					}
 					else {
-						// עǲֱcopy()
-						// Ϊûʼ
+						// 注意这里是不能直接用copy()函数的
+						// 因为没初始化过
 						mystl::uninitialized_fill(
 							mystl::uninitialized_copy(oldBegin, pos, newBegin), oldBegin, valueCopy
 						);
@@ -1016,7 +1016,7 @@ namespace {
 			const size_type elem = pos - mBegin;
 			if (elem < size() / 2) {
 				requiue_capacity(n, true);
-				// ĵѾʧЧ
+				// 这里的迭代器可能已经失效了
 				iterator newBegin = mBegin - n;
 				iterator oldBegin = mBegin;
 				pos = mBegin + elem;
@@ -1029,8 +1029,8 @@ namespace {
 						mystl::copy(first, last, pos - n);
 					}
 					else {
-						// עǲֱcopy()
-						// Ϊûʼ
+						// 注意这里是不能直接用copy()函数的
+						// 因为没初始化过
 						Iter mid = first;
 						mystl::advance(mid, n - elem);
 						mystl::uninitialized_copy(
@@ -1081,7 +1081,7 @@ namespace {
 			}
 		}
 
-		// аdispatchҪһΧ
+		// 名字里有包含dispatch的是要操作一个范围
 		template <class Iter>
 		void insert_dispatch(iterator pos, Iter first, Iter last, mystl::forward_iterator_tag)
 		{
@@ -1114,11 +1114,11 @@ namespace {
 				requiue_capacity(n, true);
 				iterator newBegin = mBegin - n;
 				try {
-					// Ļ䱨
-					// νвץ
+					// 如果报错的话会在下面这句报错
+					// 如何进行捕抓
 					mystl::uninitialized_copy(first, last, newBegin);
-					// ִ
-					// ִ˵Ѿᱨ
+					// 不会执行下面这句
+					// 如果执行说明已经不会报错了
 					mBegin = newBegin;
 				}
 				catch (...) {
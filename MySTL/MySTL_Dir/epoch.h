@@ -0,0 +1,220 @@
+#ifndef MYSTL_EPOCH_H
+#define MYSTL_EPOCH_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <cstdint>
+
+#include "vector.h"
+#include "util.h"
+
+namespace mystl {
+
+	// 基于 epoch 的内存回收 (EBR)
+	// 读者进入临界区前在自己的槽里登记当前的全局 epoch，离开时清零
+	// 写者把摘下来的节点连同当时的全局 epoch 放进 retire 链表
+	// 只有所有活跃读者都登记了当前 epoch 时全局 epoch 才能 +1
+	// 所以 retire 时为 e 的节点在全局 epoch 到达 e + 2 之后就不可能再被任何读者看到
+	// 读者最多占 slot_count 个独占槽，全部占满后挤进共享槽：按所在 epoch 的奇偶计数，
+	// 进入和离开仍然不会等待，只是这些读者在同一个计数器上竞争
+	class epoch_manager
+	{
+	public:
+
+		using epoch_type = std::uint64_t;
+
+		static constexpr size_t slot_count = 128;
+
+	private:
+
+		// 每个槽单独一条 cache line，读者之间不会伪共享
+		struct alignas(64) slot
+		{
+			std::atomic<bool> used;
+			std::atomic<epoch_type> epoch;
+		};
+
+		struct retired
+		{
+			void* ptr;
+			void (*deleter)(void*);
+			epoch_type epoch;
+		};
+
+		// 活跃读者只可能在全局 epoch e 或 e - 1 上，所以共享槽按奇偶分两个计数器
+		struct alignas(64) shared_slot
+		{
+			std::atomic<size_t> readers;
+		};
+
+		// 全局 epoch 从 1 开始，槽里的 0 表示不活跃
+		std::atomic<epoch_type> m_Global;
+		slot m_Slots[slot_count];
+		shared_slot m_Shared[2];
+
+		std::mutex m_RetireLock;
+		mystl::vector<retired> m_Retired;
+
+		static constexpr size_t reclaim_batch = 64;
+
+	public:
+
+		epoch_manager() : m_Global(1)
+		{
+			for (size_t i = 0; i < slot_count; ++i) {
+				m_Slots[i].used.store(false, std::memory_order_relaxed);
+				m_Slots[i].epoch.store(0, std::memory_order_relaxed);
+			}
+			m_Shared[0].readers.store(0, std::memory_order_relaxed);
+			m_Shared[1].readers.store(0, std::memory_order_relaxed);
+		}
+
+		epoch_manager(const epoch_manager&) = delete;
+		epoch_manager& operator=(const epoch_manager&) = delete;
+
+		// 析构时认为已经没有读者了，剩下的全部直接释放
+		~epoch_manager()
+		{
+			for (size_t i = 0; i < m_Retired.size(); ++i) {
+				m_Retired[i].deleter(m_Retired[i].ptr);
+			}
+		}
+
+		// 进入读临界区，返回占用的槽下标，不小于 slot_count 时表示共享槽
+		// 独占槽只找一圈，找不到就用共享槽，不会自旋等别的读者离开
+		size_t enter() noexcept
+		{
+			const size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % slot_count;
+			for (size_t i = 0; i < slot_count; ++i) {
+				const size_t idx = (start + i) % slot_count;
+				bool expected = false;
+				if (!m_Slots[idx].used.load(std::memory_order_relaxed) &&
+					m_Slots[idx].used.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+					enter_slot(idx);
+					return idx;
+				}
+			}
+			return slot_count + enter_shared();
+		}
+
+		void leave(size_t idx) noexcept
+		{
+			if (idx >= slot_count) {
+				m_Shared[idx - slot_count].readers.fetch_sub(1, std::memory_order_release);
+				return;
+			}
+			m_Slots[idx].epoch.store(0, std::memory_order_release);
+			m_Slots[idx].used.store(false, std::memory_order_release);
+		}
+
+		// 登记一个已经从数据结构上摘下来的对象，等到安全时再调用 deleter 释放
+		void retire(void* ptr, void (*deleter)(void*))
+		{
+			bool need_reclaim = false;
+			{
+				std::lock_guard<std::mutex> guard(m_RetireLock);
+				m_Retired.push_back(retired{ ptr, deleter, m_Global.load() });
+				need_reclaim = m_Retired.size() % reclaim_batch == 0;
+			}
+			if (need_reclaim) {
+				reclaim();
+			}
+		}
+
+		// 尝试推进全局 epoch 并释放已经安全的对象
+		void reclaim()
+		{
+			try_advance();
+			const epoch_type safe = m_Global.load();
+			mystl::vector<retired> ready;
+			{
+				std::lock_guard<std::mutex> guard(m_RetireLock);
+				size_t keep = 0;
+				for (size_t i = 0; i < m_Retired.size(); ++i) {
+					if (m_Retired[i].epoch + 2 <= safe) {
+						ready.push_back(m_Retired[i]);
+					}
+					else {
+						m_Retired[keep++] = m_Retired[i];
+					}
+				}
+				while (m_Retired.size() > keep) {
+					m_Retired.pop_back();
+				}
+			}
+			for (size_t i = 0; i < ready.size(); ++i) {
+				ready[i].deleter(ready[i].ptr);
+			}
+		}
+
+	private:
+
+		// 登记之后再检查一遍，防止读到 epoch 和登记之间全局 epoch 已经前进
+		void enter_slot(size_t idx) noexcept
+		{
+			epoch_type e = m_Global.load();
+			for (;;) {
+				m_Slots[idx].epoch.store(e);
+				const epoch_type now = m_Global.load();
+				if (now == e) {
+					return;
+				}
+				e = now;
+			}
+		}
+
+		// 和 enter_slot 一样先登记再检查，返回用的是哪个奇偶计数器
+		size_t enter_shared() noexcept
+		{
+			for (;;) {
+				const epoch_type e = m_Global.load();
+				const size_t parity = static_cast<size_t>(e & 1);
+				m_Shared[parity].readers.fetch_add(1);
+				if (m_Global.load() == e) {
+					return parity;
+				}
+				m_Shared[parity].readers.fetch_sub(1, std::memory_order_release);
+			}
+		}
+
+		bool try_advance() noexcept
+		{
+			epoch_type e = m_Global.load();
+			// e - 1 上还有共享槽的读者
+			if (m_Shared[(e + 1) & 1].readers.load() != 0) {
+				return false;
+			}
+			for (size_t i = 0; i < slot_count; ++i) {
+				const epoch_type cur = m_Slots[i].epoch.load();
+				if (cur != 0 && cur != e) {
+					return false;
+				}
+			}
+			return m_Global.compare_exchange_strong(e, e + 1);
+		}
+	};
+
+	// RAII 的读临界区
+	class epoch_guard
+	{
+	private:
+
+		epoch_manager& m_Manager;
+		size_t m_Slot;
+
+	public:
+
+		explicit epoch_guard(epoch_manager& manager) noexcept
+			: m_Manager(manager), m_Slot(manager.enter()) {}
+
+		~epoch_guard() { m_Manager.leave(m_Slot); }
+
+		epoch_guard(const epoch_guard&) = delete;
+		epoch_guard& operator=(const epoch_guard&) = delete;
+	};
+
+}
+
+#endif // !MYSTL_EPOCH_H
@@ -0,0 +1,489 @@
+#ifndef MYSTL_FILTERED_SET_H
+#define MYSTL_FILTERED_SET_H
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include "hashtable.h"
+
+namespace mystl {
+
+	// 分块 Bloom 过滤器，算法参考 Parquet 的 split block bloom filter：
+	// 每个 key 只落在一个 64 字节的块 (一条 cache line) 里，在块内的 8 个字上各置一位
+	// 所以一次查询最多一次 cache miss，不像普通 Bloom 过滤器 k 个位散落在 k 条 cache line 上
+	// 每个 key 约占 bits_per_key 位，满载时误判率约 0.1%
+	class blocked_bloom_filter
+	{
+	public:
+
+		using size_type = size_t;
+
+		static constexpr size_type block_words = 8;
+		static constexpr size_type block_bytes = block_words * sizeof(std::uint64_t);
+		static constexpr size_type bits_per_key = 16;
+
+	private:
+
+		using word_allocator = mystl::allocator<std::uint64_t>;
+
+		// m_Raw 是分配到的内存，m_Blocks 是其中按 block_bytes 对齐的起点
+		std::uint64_t*	m_Raw;
+		std::uint64_t*	m_Blocks;
+		size_type		m_Raw_Words;
+		size_type		m_Block_Count;
+
+	public:
+
+		blocked_bloom_filter() noexcept
+			: m_Raw(nullptr), m_Blocks(nullptr), m_Raw_Words(0), m_Block_Count(0)
+		{
+		}
+
+		explicit blocked_bloom_filter(size_type key_cnt)
+			: m_Raw(nullptr), m_Blocks(nullptr), m_Raw_Words(0), m_Block_Count(0)
+		{
+			reset(key_cnt);
+		}
+
+		blocked_bloom_filter(const blocked_bloom_filter& rhs)
+			: m_Raw(nullptr), m_Blocks(nullptr), m_Raw_Words(0), m_Block_Count(0)
+		{
+			if (rhs.m_Raw != nullptr) {
+				allocate(rhs.block_count());
+				std::memcpy(m_Blocks, rhs.m_Blocks, rhs.memory_bytes());
+			}
+		}
+
+		blocked_bloom_filter(blocked_bloom_filter&& rhs) noexcept
+			: m_Raw(rhs.m_Raw), m_Blocks(rhs.m_Blocks)
+			, m_Raw_Words(rhs.m_Raw_Words), m_Block_Count(rhs.m_Block_Count)
+		{
+			rhs.m_Raw = nullptr;
+			rhs.m_Blocks = nullptr;
+			rhs.m_Raw_Words = 0;
+			rhs.m_Block_Count = 0;
+		}
+
+		blocked_bloom_filter& operator=(const blocked_bloom_filter& rhs)
+		{
+			if (this != &rhs) {
+				blocked_bloom_filter tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		blocked_bloom_filter& operator=(blocked_bloom_filter&& rhs) noexcept
+		{
+			blocked_bloom_filter tmp(mystl::move(rhs));
+			swap(tmp);
+			return *this;
+		}
+
+		~blocked_bloom_filter()
+		{
+			word_allocator::deallocate(m_Raw);
+		}
+
+		// 按 key_cnt 个 key 重新分配，原来的位全部丢掉
+		void reset(size_type key_cnt)
+		{
+			const size_type cnt = key_cnt * bits_per_key / (block_bytes * 8) + 1;
+			if (m_Raw != nullptr && cnt == block_count()) {
+				clear();
+				return;
+			}
+			blocked_bloom_filter tmp;
+			tmp.allocate(cnt);
+			swap(tmp);
+		}
+
+		void clear() noexcept
+		{
+			if (m_Blocks != nullptr) {
+				std::memset(m_Blocks, 0, memory_bytes());
+			}
+		}
+
+		void add(std::uint64_t h) noexcept
+		{
+			const std::uint64_t x = mix(h);
+			std::uint64_t* block = m_Blocks + block_index(x) * block_words;
+			const std::uint32_t lo = static_cast<std::uint32_t>(x);
+			for (size_type i = 0; i < block_words; ++i) {
+				block[i] |= bit(lo, i);
+			}
+		}
+
+		// 返回 false 时 key 一定不在集合里，返回 true 时 key 可能在
+		bool may_contain(std::uint64_t h) const noexcept
+		{
+			if (m_Blocks == nullptr) {
+				return false;
+			}
+			const std::uint64_t x = mix(h);
+			const std::uint64_t* block = m_Blocks + block_index(x) * block_words;
+			const std::uint32_t lo = static_cast<std::uint32_t>(x);
+			// 8 个字一起与，编译器可以展开成无分支的代码
+			std::uint64_t miss = 0;
+			for (size_type i = 0; i < block_words; ++i) {
+				miss |= bit(lo, i) & ~block[i];
+			}
+			return miss == 0;
+		}
+
+		size_type block_count() const noexcept
+		{
+			return m_Block_Count;
+		}
+
+		size_type memory_bytes() const noexcept
+		{
+			return block_count() * block_bytes;
+		}
+
+		void swap(blocked_bloom_filter& rhs) noexcept
+		{
+			mystl::swap(m_Raw, rhs.m_Raw);
+			mystl::swap(m_Blocks, rhs.m_Blocks);
+			mystl::swap(m_Raw_Words, rhs.m_Raw_Words);
+			mystl::swap(m_Block_Count, rhs.m_Block_Count);
+		}
+
+	private:
+
+		void allocate(size_type cnt)
+		{
+			// 多分配一个块的空间用来对齐
+			m_Raw_Words = (cnt + 1) * block_words;
+			m_Raw = word_allocator::allocate(m_Raw_Words);
+			const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(m_Raw);
+			const std::uintptr_t aligned = (addr + block_bytes - 1) & ~static_cast<std::uintptr_t>(block_bytes - 1);
+			m_Blocks = reinterpret_cast<std::uint64_t*>(aligned);
+			m_Block_Count = cnt;
+			std::memset(m_Blocks, 0, cnt * block_bytes);
+		}
+
+		// 表里用 hash % bucket_count 选桶，过滤器再打散一次，避免和桶下标用到同样的位
+		static std::uint64_t mix(std::uint64_t h) noexcept
+		{
+			return hash_mix(h ^ hash_secret(2), hash_secret(3));
+		}
+
+		// 用高 32 位乘块数再取高位选块，块数不必是 2 的幂
+		size_type block_index(std::uint64_t x) const noexcept
+		{
+			return static_cast<size_type>(((x >> 32) * m_Block_Count) >> 32);
+		}
+
+		// 每个字用不同的奇数乘 lo，取高 6 位作为这个字里要置的位
+		static std::uint64_t bit(std::uint32_t lo, size_type i) noexcept
+		{
+			static constexpr std::uint32_t salt[block_words] = {
+				0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+				0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+			};
+			return std::uint64_t(1) << ((lo * salt[i]) >> 26);
+		}
+	};
+
+	inline void swap(blocked_bloom_filter& lhs, blocked_bloom_filter& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	// 前面挡了一个 blocked_bloom_filter 的 unordered_set，适合大而少改、查询大多查不到的集合
+	// 查不到的 key 绝大多数只读一条 cache line 就返回，不用去走桶里的链
+	// 过滤器的大小跟着桶数走，hashtable 每次扩容之后整个重建
+	// 删除的 key 没法从 Bloom 过滤器里去掉，只会多一点误判，删除的个数超过现有元素个数时重建一次
+	template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+	class filtered_set
+	{
+	private:
+
+		using base_type = hashtable<Key, Hash, KeyEqual>;
+		base_type ht;
+		blocked_bloom_filter filter;
+		// 过滤器是按多少个桶建的，和 ht.bucket_count() 不一样就说明发生过 rehash
+		size_t filter_buckets;
+		size_t erased;
+
+	public:
+
+		using key_type			= typename base_type::key_type;
+		using value_type		= typename base_type::value_type;
+		using hasher			= typename base_type::hasher;
+		using key_equal			= typename base_type::key_equal;
+
+		using const_reference	= typename base_type::const_reference;
+		using size_type			= typename base_type::size_type;
+		using difference_type	= typename base_type::difference_type;
+
+		using const_iterator	= typename base_type::const_iterator;
+
+	public:
+
+		filtered_set() : filtered_set(100)
+		{
+
+		}
+
+		explicit filtered_set(size_type n, const Hash& hash = Hash(), const KeyEqual& key = KeyEqual())
+			: ht(n, hash, key), filter(ht.bucket_count()), filter_buckets(ht.bucket_count()), erased(0)
+		{
+
+		}
+
+		template <class InputIter>
+		filtered_set(InputIter first, InputIter last,
+			const size_type n = 100,
+			const Hash& hash = Hash(),
+			const KeyEqual& key = KeyEqual())
+			: filtered_set(mystl::max(n, static_cast<size_type>(mystl::distance(first, last))), hash, key)
+		{
+			for (; first != last; ++first) {
+				insert(*first);
+			}
+		}
+
+		filtered_set(std::initializer_list<value_type> ilist,
+			const size_type n = 100,
+			const Hash& hash = Hash(),
+			const KeyEqual& key = KeyEqual())
+			: filtered_set(ilist.begin(), ilist.end(), n, hash, key)
+		{
+
+		}
+
+		filtered_set(const filtered_set& other)
+			: ht(other.ht), filter(other.filter), filter_buckets(other.filter_buckets), erased(other.erased)
+		{
+
+		}
+
+		filtered_set(filtered_set&& other)
+			: ht(mystl::move(other.ht)), filter(mystl::move(other.filter))
+			, filter_buckets(other.filter_buckets), erased(other.erased)
+		{
+			other.filter_buckets = 0;
+			other.erased = 0;
+		}
+
+		filtered_set& operator=(const filtered_set& rhs)
+		{
+			if (this != &rhs) {
+				filtered_set tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		filtered_set& operator=(filtered_set&& rhs)
+		{
+			filtered_set tmp(mystl::move(rhs));
+			swap(tmp);
+			return *this;
+		}
+
+		~filtered_set() = default;
+
+	public:
+
+		const_iterator begin() const noexcept
+		{
+			return ht.begin();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return ht.end();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return ht.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return ht.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return ht.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return ht.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return ht.max_size();
+		}
+
+		template <class ...Args>
+		bool emplace(Args&& ...args)
+		{
+			return insert(value_type(mystl::forward<Args>(args)...));
+		}
+
+		// 集合只读，插入只返回是否插入成功，不返回迭代器
+		bool insert(const value_type& value)
+		{
+			const size_type h = ht.hash_fcn()(value);
+			const bool inserted = ht.insert_unique(value).second;
+			after_insert(h, inserted);
+			return inserted;
+		}
+
+		bool insert(value_type&& value)
+		{
+			const size_type h = ht.hash_fcn()(value);
+			const bool inserted = ht.insert_unique(mystl::move(value)).second;
+			after_insert(h, inserted);
+			return inserted;
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			for (; first != last; ++first) {
+				insert(*first);
+			}
+		}
+
+		size_type erase(const key_type& key)
+		{
+			if (!filter.may_contain(ht.hash_fcn()(key))) {
+				return 0;
+			}
+			const size_type n = ht.erase_unique(key);
+			erased += n;
+			if (erased > ht.size()) {
+				rebuild_filter();
+			}
+			return n;
+		}
+
+		void clear()
+		{
+			ht.clear();
+			filter.clear();
+			erased = 0;
+		}
+
+		void swap(filtered_set& other) noexcept
+		{
+			ht.swap(other.ht);
+			filter.swap(other.filter);
+			mystl::swap(filter_buckets, other.filter_buckets);
+			mystl::swap(erased, other.erased);
+		}
+
+		// 过滤器说没有就直接返回，说可能有才去查表，查到的 key 会算两次 hash
+		size_type count(const key_type& key) const
+		{
+			return filter.may_contain(ht.hash_fcn()(key)) ? ht.count(key) : 0;
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return count(key) != 0;
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return filter.may_contain(ht.hash_fcn()(key)) ? ht.find(key) : ht.end();
+		}
+
+		size_type bucket_count() const noexcept
+		{
+			return ht.bucket_count();
+		}
+
+		float load_factor() const noexcept
+		{
+			return ht.load_factor();
+		}
+
+		float max_load_factor() const noexcept
+		{
+			return ht.max_load_factor();
+		}
+
+		hashtable_stats stats() const noexcept
+		{
+			return ht.stats();
+		}
+
+		// 过滤器占用的字节数，不含表本身
+		size_type filter_bytes() const noexcept
+		{
+			return filter.memory_bytes();
+		}
+
+		void rehash(size_type cnt)
+		{
+			ht.rehash(cnt);
+			if (ht.bucket_count() != filter_buckets) {
+				rebuild_filter();
+			}
+		}
+
+		void reserve(size_type cnt)
+		{
+			ht.reserve(cnt);
+			if (ht.bucket_count() != filter_buckets) {
+				rebuild_filter();
+			}
+		}
+
+		// 按当前的桶数重新分配过滤器，再把所有元素加进去，顺带清掉已删除 key 留下的位
+		void rebuild_filter()
+		{
+			filter.reset(ht.bucket_count());
+			const hasher hash = ht.hash_fcn();
+			for (auto it = ht.cbegin(); it != ht.cend(); ++it) {
+				filter.add(hash(*it));
+			}
+			filter_buckets = ht.bucket_count();
+			erased = 0;
+		}
+
+		hasher hash_fcn() const
+		{
+			return ht.hash_fcn();
+		}
+
+		key_equal key_eq() const
+		{
+			return ht.key_eq();
+		}
+
+	private:
+
+		// 插入触发了扩容就整个重建，这时新插入的 key 也已经在表里了
+		void after_insert(size_type h, bool inserted)
+		{
+			if (ht.bucket_count() != filter_buckets) {
+				rebuild_filter();
+			}
+			else if (inserted) {
+				filter.add(h);
+			}
+		}
+	};
+
+	template <class Key, class Hash, class KeyEqual>
+	void swap(filtered_set<Key, Hash, KeyEqual>& lhs, filtered_set<Key, Hash, KeyEqual>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_FILTERED_SET_H
@@ -0,0 +1,1303 @@
+#ifndef MYSTL_FLAT_MAP_H
+#define MYSTL_FLAT_MAP_H
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "algo.h"
+#include "functional.h"
+#include "vector.h"
+
+namespace mystl {
+
+	// key 和 value 分两个 vector 存，解引用得到的 pair<const Key&, T&> 是现拼出来的，
+	// 不是容器里的对象，-> 要先把它存在一个临时对象里再取地址
+	template <class Reference>
+	struct flat_map_arrow_proxy
+	{
+		Reference ref;
+
+		Reference* operator->() { return &ref; }
+	};
+
+	// 同时走 key 数组和 value 数组的随机访问迭代器，Const 为 true 时是 const_iterator
+	template <class Key, class T, bool Const>
+	struct flat_map_iterator : public mystl::iterator<mystl::radom_access_iterator_tag, mystl::pair<const Key, T>>
+	{
+		using mapped_pointer = typename std::conditional<Const, const T*, T*>::type;
+		using mapped_reference = typename std::conditional<Const, const T&, T&>::type;
+
+		using value_type = mystl::pair<const Key, T>;
+		using reference = mystl::pair<const Key&, mapped_reference>;
+		using pointer = flat_map_arrow_proxy<reference>;
+		using difference_type = ptrdiff_t;
+		using different_type = ptrdiff_t;
+		using self = flat_map_iterator;
+
+		const Key* key;
+		mapped_pointer value;
+
+		flat_map_iterator() : key(nullptr), value(nullptr) {}
+
+		flat_map_iterator(const Key* k, mapped_pointer v) : key(k), value(v) {}
+
+		// iterator 可以隐式转成 const_iterator
+		template <bool C = Const, typename std::enable_if<C, int>::type = 0>
+		flat_map_iterator(const flat_map_iterator<Key, T, false>& rhs) : key(rhs.key), value(rhs.value) {}
+
+		reference operator*() const { return reference(*key, *value); }
+		pointer operator->() const { return pointer{ operator*() }; }
+		reference operator[](difference_type n) const { return reference(key[n], value[n]); }
+
+		self& operator++() { ++key; ++value; return *this; }
+		self operator++(int) { self tmp = *this; ++*this; return tmp; }
+		self& operator--() { --key; --value; return *this; }
+		self operator--(int) { self tmp = *this; --*this; return tmp; }
+
+		self& operator+=(difference_type n) { key += n; value += n; return *this; }
+		self& operator-=(difference_type n) { key -= n; value -= n; return *this; }
+		self operator+(difference_type n) const { return self(key + n, value + n); }
+		self operator-(difference_type n) const { return self(key - n, value - n); }
+		difference_type operator-(const self& rhs) const { return key - rhs.key; }
+
+		bool operator==(const self& rhs) const { return key == rhs.key; }
+		bool operator!=(const self& rhs) const { return key != rhs.key; }
+		bool operator<(const self& rhs) const { return key < rhs.key; }
+		bool operator>(const self& rhs) const { return key > rhs.key; }
+		bool operator<=(const self& rhs) const { return key <= rhs.key; }
+		bool operator>=(const self& rhs) const { return key >= rhs.key; }
+	};
+
+	// 有序的 key 数组加上对应位置的 value 数组，查找只在 key 数组上二分，cache 上比 rb_tree 紧凑得多
+	// 插入和删除是 O(n)；批量插入排的是下标，排好后按下标顺序把 key 和 value 一起搬到新数组
+	// 接口和 rb_tree 一样分 unique / multi 两套，由 flat_map / flat_multimap 包装
+	template <class Key, class T, class Compare>
+	class flat_map_tree
+	{
+	public:
+
+		using key_container_type = mystl::vector<Key>;
+		using mapped_container_type = mystl::vector<T>;
+
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = mystl::pair<const Key, T>;
+		using key_compare = Compare;
+
+		using allocator_type = mystl::allocator<value_type>;
+		using size_type = typename key_container_type::size_type;
+		using difference_type = typename key_container_type::difference_type;
+
+		using iterator = flat_map_iterator<Key, T, false>;
+		using const_iterator = flat_map_iterator<Key, T, true>;
+		using reverse_iterator = mystl::reverse_iterator<iterator>;
+		using const_reverse_iterator = mystl::reverse_iterator<const_iterator>;
+
+		using reference = typename iterator::reference;
+		using const_reference = typename const_iterator::reference;
+		using pointer = typename iterator::pointer;
+		using const_pointer = typename const_iterator::pointer;
+
+		allocator_type get_allocate() const { return allocator_type(); }
+		key_compare key_comp() const { return m_Comp; }
+
+	private:
+
+		key_container_type		m_Keys;
+		mapped_container_type	m_Values;
+		key_compare				m_Comp;
+
+		// 批量插入时给下标排序，key 相等时按下标排，原来的元素和先出现的元素排在前面
+		struct index_less
+		{
+			const Key* keys;
+			Compare comp;
+
+			bool operator()(size_type a, size_type b) const
+			{
+				return comp(keys[a], keys[b]) || (!comp(keys[b], keys[a]) && a < b);
+			}
+		};
+
+	public:
+
+		flat_map_tree() = default;
+
+		explicit flat_map_tree(const Compare& comp) : m_Comp(comp) {}
+
+		flat_map_tree(const flat_map_tree& rhs) = default;
+
+		flat_map_tree(flat_map_tree&& rhs) noexcept
+			: m_Keys(mystl::move(rhs.m_Keys)), m_Values(mystl::move(rhs.m_Values)), m_Comp(rhs.m_Comp) {}
+
+		flat_map_tree& operator=(const flat_map_tree& rhs) = default;
+
+		flat_map_tree& operator=(flat_map_tree&& rhs) noexcept
+		{
+			m_Keys = mystl::move(rhs.m_Keys);
+			m_Values = mystl::move(rhs.m_Values);
+			m_Comp = rhs.m_Comp;
+			return *this;
+		}
+
+	public:
+
+		iterator begin() noexcept
+		{
+			return iterator(m_Keys.data(), m_Values.data());
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(m_Keys.data(), m_Values.data());
+		}
+
+		iterator end() noexcept
+		{
+			return begin() + static_cast<difference_type>(size());
+		}
+
+		const_iterator end() const noexcept
+		{
+			return begin() + static_cast<difference_type>(size());
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		bool empty() const noexcept
+		{
+			return m_Keys.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return m_Keys.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return m_Keys.max_size() < m_Values.max_size() ? m_Keys.max_size() : m_Values.max_size();
+		}
+
+		size_type capacity() const noexcept
+		{
+			return m_Keys.capacity();
+		}
+
+		void reserve(size_type n)
+		{
+			m_Keys.reserve(n);
+			m_Values.reserve(n);
+		}
+
+		void shrink_to_fit()
+		{
+			m_Keys.shrink_to_fit();
+			m_Values.shrink_to_fit();
+		}
+
+		// 底层的两个数组，key 只读，value 可以直接改
+		const key_container_type& keys() const noexcept
+		{
+			return m_Keys;
+		}
+
+		const mapped_container_type& values() const noexcept
+		{
+			return m_Values;
+		}
+
+		mapped_container_type& values() noexcept
+		{
+			return m_Values;
+		}
+
+	public:
+
+		template <class ...Args>
+		mystl::pair<iterator, bool> emplace_unique(Args&& ...args)
+		{
+			value_type tmp(mystl::forward<Args>(args)...);
+			return insert_unique(mystl::move(tmp));
+		}
+
+		template <class ...Args>
+		iterator emplace_multi(Args&& ...args)
+		{
+			value_type tmp(mystl::forward<Args>(args)...);
+			return insert_multi(mystl::move(tmp));
+		}
+
+		// key 不存在时才用 args 构造 value
+		template <class K, class ...Args>
+		mystl::pair<iterator, bool> try_emplace_unique(K&& key, Args&& ...args)
+		{
+			const size_type i = lower_index(key);
+			if (i != size() && !m_Comp(key, m_Keys[i])) {
+				return mystl::make_pair(begin() + i, false);
+			}
+			return mystl::make_pair(insert_at(i, mystl::forward<K>(key), mystl::forward<Args>(args)...), true);
+		}
+
+		mystl::pair<iterator, bool> insert_unique(const value_type& value)
+		{
+			return try_emplace_unique(value.first, value.second);
+		}
+
+		mystl::pair<iterator, bool> insert_unique(value_type&& value)
+		{
+			return try_emplace_unique(value.first, mystl::move(value.second));
+		}
+
+		iterator insert_multi(const value_type& value)
+		{
+			return insert_at(upper_index(value.first), value.first, value.second);
+		}
+
+		iterator insert_multi(value_type&& value)
+		{
+			return insert_at(upper_index(value.first), value.first, mystl::move(value.second));
+		}
+
+		// hint 正好是插入位置时省掉整段二分，否则只在 hint 的一侧做 lower_bound
+		iterator insert_unique(const_iterator hint, const value_type& value)
+		{
+			return insert_unique_hint(hint, value.first, value.second);
+		}
+
+		iterator insert_unique(const_iterator hint, value_type&& value)
+		{
+			return insert_unique_hint(hint, value.first, mystl::move(value.second));
+		}
+
+		iterator insert_multi(const_iterator hint, const value_type& value)
+		{
+			return insert_at(multi_hint(index_of(hint), value.first), value.first, value.second);
+		}
+
+		iterator insert_multi(const_iterator hint, value_type&& value)
+		{
+			return insert_at(multi_hint(index_of(hint), value.first), value.first, mystl::move(value.second));
+		}
+
+		// 批量插入：新元素追加到末尾，下标用 sort 排好后和原来的下标 inplace_merge，
+		// 再按合并后的顺序搬一遍，总共 O(n + m log m)
+		template <class InputIter>
+		void insert_unique(InputIter first, InputIter last)
+		{
+			merge_tail(append(first, last), true);
+		}
+
+		template <class InputIter>
+		void insert_multi(InputIter first, InputIter last)
+		{
+			merge_tail(append(first, last), false);
+		}
+
+		iterator erase(const_iterator pos)
+		{
+			const size_type i = index_of(pos);
+			m_Keys.erase(m_Keys.begin() + i);
+			m_Values.erase(m_Values.begin() + i);
+			return begin() + i;
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			const size_type i = index_of(first);
+			const size_type j = index_of(last);
+			m_Keys.erase(m_Keys.begin() + i, m_Keys.begin() + j);
+			m_Values.erase(m_Values.begin() + i, m_Values.begin() + j);
+			return begin() + i;
+		}
+
+		size_type erase_unique(const key_type& key)
+		{
+			const_iterator pos = find(key);
+			if (pos == end()) {
+				return 0;
+			}
+			erase(pos);
+			return 1;
+		}
+
+		size_type erase_multi(const key_type& key)
+		{
+			mystl::pair<iterator, iterator> range = equal_range_multi(key);
+			const size_type n = static_cast<size_type>(range.second - range.first);
+			erase(range.first, range.second);
+			return n;
+		}
+
+		void clear()
+		{
+			m_Keys.clear();
+			m_Values.clear();
+		}
+
+		iterator find(const key_type& key)
+		{
+			return begin() + find_index(key);
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return begin() + find_index(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		iterator find(const K& key)
+		{
+			return begin() + find_index(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator find(const K& key) const
+		{
+			return begin() + find_index(key);
+		}
+
+		size_type count_unique(const key_type& key) const
+		{
+			return find_index(key) == size() ? 0 : 1;
+		}
+
+		size_type count_multi(const key_type& key) const
+		{
+			return upper_index(key) - lower_index(key);
+		}
+
+		iterator lower_bound(const key_type& key)
+		{
+			return begin() + lower_index(key);
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return begin() + lower_index(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		iterator lower_bound(const K& key)
+		{
+			return begin() + lower_index(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator lower_bound(const K& key) const
+		{
+			return begin() + lower_index(key);
+		}
+
+		iterator upper_bound(const key_type& key)
+		{
+			return begin() + upper_index(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return begin() + upper_index(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		iterator upper_bound(const K& key)
+		{
+			return begin() + upper_index(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator upper_bound(const K& key) const
+		{
+			return begin() + upper_index(key);
+		}
+
+		mystl::pair<iterator, iterator> equal_range_unique(const key_type& key)
+		{
+			const size_type i = find_index(key);
+			return mystl::make_pair(begin() + i, begin() + (i == size() ? i : i + 1));
+		}
+
+		mystl::pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+		{
+			const size_type i = find_index(key);
+			return mystl::make_pair(begin() + i, begin() + (i == size() ? i : i + 1));
+		}
+
+		mystl::pair<iterator, iterator> equal_range_multi(const key_type& key)
+		{
+			return mystl::make_pair(begin() + lower_index(key), begin() + upper_index(key));
+		}
+
+		mystl::pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
+		{
+			return mystl::make_pair(begin() + lower_index(key), begin() + upper_index(key));
+		}
+
+		void swap(flat_map_tree& rhs) noexcept
+		{
+			m_Keys.swap(rhs.m_Keys);
+			m_Values.swap(rhs.m_Values);
+			mystl::swap(m_Comp, rhs.m_Comp);
+		}
+
+	private:
+
+		size_type index_of(const_iterator pos) const noexcept
+		{
+			return static_cast<size_type>(pos.key - m_Keys.data());
+		}
+
+		template <class K>
+		size_type lower_index(const K& key) const
+		{
+			return static_cast<size_type>(mystl::lower_bound(m_Keys.begin(), m_Keys.end(), key, m_Comp) - m_Keys.begin());
+		}
+
+		template <class K>
+		size_type upper_index(const K& key) const
+		{
+			return static_cast<size_type>(mystl::upper_bound(m_Keys.begin(), m_Keys.end(), key, m_Comp) - m_Keys.begin());
+		}
+
+		// 找不到返回 size()
+		template <class K>
+		size_type find_index(const K& key) const
+		{
+			const size_type i = lower_index(key);
+			return (i == size() || m_Comp(key, m_Keys[i])) ? size() : i;
+		}
+
+		// key 和 value 要在同一个下标插入，value 构造失败时把已经插进去的 key 删掉
+		template <class K, class ...Args>
+		iterator insert_at(size_type i, K&& key, Args&& ...args)
+		{
+			m_Keys.emplace(m_Keys.begin() + i, mystl::forward<K>(key));
+			try {
+				m_Values.emplace(m_Values.begin() + i, mystl::forward<Args>(args)...);
+			}
+			catch (...) {
+				m_Keys.erase(m_Keys.begin() + i);
+				throw;
+			}
+			return begin() + i;
+		}
+
+		template <class V>
+		iterator insert_unique_hint(const_iterator hint, const key_type& key, V&& value)
+		{
+			const size_type i = lower_bound_hint(index_of(hint), key);
+			if (i != size() && !m_Comp(key, m_Keys[i])) {
+				return begin() + i;
+			}
+			return insert_at(i, key, mystl::forward<V>(value));
+		}
+
+		// 先看 hint 是不是 lower_bound 的位置，不是的话 key 在 hint 哪边就只查哪边
+		size_type lower_bound_hint(size_type hint, const key_type& key) const
+		{
+			const Key* first = m_Keys.data();
+			if (hint == size() || !m_Comp(m_Keys[hint], key)) {
+				if (hint == 0 || m_Comp(m_Keys[hint - 1], key)) {
+					return hint;
+				}
+				return static_cast<size_type>(mystl::lower_bound(first, first + hint - 1, key, m_Comp) - first);
+			}
+			return static_cast<size_type>(mystl::lower_bound(first + hint + 1, first + size(), key, m_Comp) - first);
+		}
+
+		// multi 时 hint 两边的 key 夹住 key 就直接插在 hint，否则退回到 lower_bound_hint
+		size_type multi_hint(size_type hint, const key_type& key) const
+		{
+			if ((hint == size() || !m_Comp(m_Keys[hint], key)) &&
+				(hint == 0 || !m_Comp(key, m_Keys[hint - 1]))) {
+				return hint;
+			}
+			return lower_bound_hint(hint, key);
+		}
+
+		// 追加到末尾，返回原来的元素个数；中途抛异常时把追加的部分删掉
+		template <class InputIter>
+		size_type append(InputIter first, InputIter last)
+		{
+			const size_type n = size();
+			try {
+				for (; first != last; ++first) {
+					auto&& value = *first;
+					m_Keys.emplace_back(value.first);
+					m_Values.emplace_back(value.second);
+				}
+			}
+			catch (...) {
+				m_Keys.erase(m_Keys.begin() + n, m_Keys.end());
+				m_Values.erase(m_Values.begin() + n, m_Values.end());
+				throw;
+			}
+			return n;
+		}
+
+		// [0, n) 是原来的有序部分，[n, size) 是新追加的
+		// key 和 value 分开存，直接排 key 的话 value 跟不上，所以排的是下标
+		void merge_tail(size_type n, bool unique)
+		{
+			const size_type total = size();
+			if (n == total) {
+				return;
+			}
+			mystl::vector<size_type> order(total);
+			for (size_type i = 0; i < total; ++i) {
+				order[i] = i;
+			}
+			index_less cmp{ m_Keys.data(), m_Comp };
+			mystl::sort(order.begin() + n, order.end(), cmp);
+			if (n != 0 && cmp(order[n], n - 1)) {
+				mystl::inplace_merge(order.begin(), order.begin() + n, order.end(), cmp);
+			}
+			// 顺序没变而且没有要去掉的重复 key 时（比如按顺序追加）不用搬
+			bool moved = false;
+			for (size_type i = 0; i < total && !moved; ++i) {
+				moved = order[i] != i || (unique && i != 0 && !m_Comp(m_Keys[i - 1], m_Keys[i]));
+			}
+			if (!moved) {
+				return;
+			}
+			key_container_type keys;
+			mapped_container_type values;
+			keys.reserve(total);
+			values.reserve(total);
+			for (size_type i = 0; i < total; ++i) {
+				const size_type j = order[i];
+				if (unique && !keys.empty() && !m_Comp(keys.back(), m_Keys[j])) {
+					continue;
+				}
+				keys.emplace_back(mystl::move(m_Keys[j]));
+				values.emplace_back(mystl::move(m_Values[j]));
+			}
+			m_Keys.swap(keys);
+			m_Values.swap(values);
+		}
+	};
+
+	template <class Key, class T, class Compare>
+	bool operator==(const flat_map_tree<Key, T, Compare>& lhs, const flat_map_tree<Key, T, Compare>& rhs)
+	{
+		return lhs.keys() == rhs.keys() && lhs.values() == rhs.values();
+	}
+
+	template <class Key, class T, class Compare>
+	bool operator!=(const flat_map_tree<Key, T, Compare>& lhs, const flat_map_tree<Key, T, Compare>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class Key, class T, class Compare>
+	bool operator<(const flat_map_tree<Key, T, Compare>& lhs, const flat_map_tree<Key, T, Compare>& rhs)
+	{
+		const size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+		for (size_t i = 0; i < n; ++i) {
+			if (lhs.keys()[i] < rhs.keys()[i]) {
+				return true;
+			}
+			if (rhs.keys()[i] < lhs.keys()[i]) {
+				return false;
+			}
+			if (lhs.values()[i] < rhs.values()[i]) {
+				return true;
+			}
+			if (rhs.values()[i] < lhs.values()[i]) {
+				return false;
+			}
+		}
+		return lhs.size() < rhs.size();
+	}
+
+
+	template <class Key, class T, class Compare = mystl::less<Key>>
+	class flat_map
+	{
+	private:
+
+		using base_type = flat_map_tree<Key, T, Compare>;
+		base_type tree;
+
+	public:
+
+		using key_container_type = typename base_type::key_container_type;
+		using mapped_container_type = typename base_type::mapped_container_type;
+		using allocator_type = typename base_type::allocator_type;
+		using key_type = typename base_type::key_type;
+		using mapped_type = typename base_type::mapped_type;
+		using value_type = typename base_type::value_type;
+		using key_compare = typename base_type::key_compare;
+
+		using pointer = typename base_type::pointer;
+		using const_pointer = typename base_type::const_pointer;
+		using reference = typename base_type::reference;
+		using const_reference = typename base_type::const_reference;
+		using size_type = typename base_type::size_type;
+		using difference_type = typename base_type::difference_type;
+
+		using iterator = typename base_type::iterator;
+		using const_iterator = typename base_type::const_iterator;
+		using reverse_iterator = typename base_type::reverse_iterator;
+		using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+		allocator_type get_allocator() const { return tree.get_allocate(); }
+		key_compare key_comp() const { return tree.key_comp(); }
+
+	public:
+
+		flat_map() = default;
+
+		explicit flat_map(const Compare& comp) : tree(comp) {}
+
+		template <class InputIter>
+		flat_map(InputIter first, InputIter last, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_unique(first, last);
+		}
+
+		flat_map(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_unique(ilist.begin(), ilist.end());
+		}
+
+		flat_map(const flat_map& other) : tree(other.tree) {}
+
+		flat_map(flat_map&& other) noexcept : tree(mystl::move(other.tree)) {}
+
+		flat_map& operator=(const flat_map& other)
+		{
+			tree = other.tree;
+			return *this;
+		}
+
+		flat_map& operator=(flat_map&& other) noexcept
+		{
+			tree = mystl::move(other.tree);
+			return *this;
+		}
+
+		flat_map& operator=(std::initializer_list<value_type> ilist)
+		{
+			tree.clear();
+			tree.insert_unique(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		~flat_map() = default;
+
+		iterator begin() noexcept
+		{
+			return tree.begin();
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return tree.begin();
+		}
+
+		iterator end() noexcept
+		{
+			return tree.end();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return tree.end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return tree.rbegin();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return tree.rbegin();
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return tree.rend();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return tree.rend();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return tree.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return tree.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return tree.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return tree.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return tree.max_size();
+		}
+
+		size_type capacity() const noexcept
+		{
+			return tree.capacity();
+		}
+
+		void reserve(size_type n)
+		{
+			tree.reserve(n);
+		}
+
+		void shrink_to_fit()
+		{
+			tree.shrink_to_fit();
+		}
+
+		const key_container_type& keys() const noexcept
+		{
+			return tree.keys();
+		}
+
+		const mapped_container_type& values() const noexcept
+		{
+			return tree.values();
+		}
+
+		mapped_container_type& values() noexcept
+		{
+			return tree.values();
+		}
+
+		mapped_type& at(const key_type& key)
+		{
+			iterator it = tree.find(key);
+			THROW_OUT_RANGE_IF(it == end(), "flat_map<Key, T> no such element exists");
+			return it->second;
+		}
+
+		const mapped_type& at(const key_type& key) const
+		{
+			const_iterator it = tree.find(key);
+			THROW_OUT_RANGE_IF(it == end(), "flat_map<Key, T> no such element exists");
+			return it->second;
+		}
+
+		mapped_type& operator[](const key_type& key)
+		{
+			return tree.try_emplace_unique(key).first->second;
+		}
+
+		mapped_type& operator[](key_type&& key)
+		{
+			return tree.try_emplace_unique(mystl::move(key)).first->second;
+		}
+
+		template <class ...Args>
+		pair<iterator, bool> emplace(Args&& ...args)
+		{
+			return tree.emplace_unique(mystl::forward<Args>(args)...);
+		}
+
+		template <class ...Args>
+		pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+		{
+			return tree.try_emplace_unique(key, mystl::forward<Args>(args)...);
+		}
+
+		template <class V>
+		pair<iterator, bool> insert_or_assign(const key_type& key, V&& value)
+		{
+			pair<iterator, bool> res = tree.try_emplace_unique(key, mystl::forward<V>(value));
+			if (!res.second) {
+				res.first->second = mystl::forward<V>(value);
+			}
+			return res;
+		}
+
+		pair<iterator, bool> insert(const value_type& value)
+		{
+			return tree.insert_unique(value);
+		}
+
+		pair<iterator, bool> insert(value_type&& value)
+		{
+			return tree.insert_unique(mystl::move(value));
+		}
+
+		iterator insert(const_iterator hint, const value_type& value)
+		{
+			return tree.insert_unique(hint, value);
+		}
+
+		iterator insert(const_iterator hint, value_type&& value)
+		{
+			return tree.insert_unique(hint, mystl::move(value));
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			tree.insert_unique(first, last);
+		}
+
+		void insert(std::initializer_list<value_type> ilist)
+		{
+			tree.insert_unique(ilist.begin(), ilist.end());
+		}
+
+		iterator erase(const_iterator pos)
+		{
+			return tree.erase(pos);
+		}
+
+		size_type erase(const key_type& key)
+		{
+			return tree.erase_unique(key);
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			return tree.erase(first, last);
+		}
+
+		void clear()
+		{
+			tree.clear();
+		}
+
+		iterator find(const key_type& key)
+		{
+			return tree.find(key);
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return tree.find(key);
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return tree.count_unique(key);
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return tree.find(key) != tree.end();
+		}
+
+		iterator lower_bound(const key_type& key)
+		{
+			return tree.lower_bound(key);
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return tree.lower_bound(key);
+		}
+
+		iterator upper_bound(const key_type& key)
+		{
+			return tree.upper_bound(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return tree.upper_bound(key);
+		}
+
+		pair<iterator, iterator> equal_range(const key_type& key)
+		{
+			return tree.equal_range_unique(key);
+		}
+
+		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return tree.equal_range_unique(key);
+		}
+
+		void swap(flat_map& rhs) noexcept
+		{
+			tree.swap(rhs.tree);
+		}
+
+		friend bool operator==(const flat_map& lhs, const flat_map& rhs)
+		{
+			return lhs.tree == rhs.tree;
+		}
+
+		friend bool operator!=(const flat_map& lhs, const flat_map& rhs)
+		{
+			return lhs.tree != rhs.tree;
+		}
+
+		friend bool operator<(const flat_map& lhs, const flat_map& rhs)
+		{
+			return lhs.tree < rhs.tree;
+		}
+	};
+
+	template <class Key, class T, class Compare>
+	void swap(flat_map<Key, T, Compare>& lhs, flat_map<Key, T, Compare>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+
+	template <class Key, class T, class Compare = mystl::less<Key>>
+	class flat_multimap
+	{
+	private:
+
+		using base_type = flat_map_tree<Key, T, Compare>;
+		base_type tree;
+
+	public:
+
+		using key_container_type = typename base_type::key_container_type;
+		using mapped_container_type = typename base_type::mapped_container_type;
+		using allocator_type = typename base_type::allocator_type;
+		using key_type = typename base_type::key_type;
+		using mapped_type = typename base_type::mapped_type;
+		using value_type = typename base_type::value_type;
+		using key_compare = typename base_type::key_compare;
+
+		using pointer = typename base_type::pointer;
+		using const_pointer = typename base_type::const_pointer;
+		using reference = typename base_type::reference;
+		using const_reference = typename base_type::const_reference;
+		using size_type = typename base_type::size_type;
+		using difference_type = typename base_type::difference_type;
+
+		using iterator = typename base_type::iterator;
+		using const_iterator = typename base_type::const_iterator;
+		using reverse_iterator = typename base_type::reverse_iterator;
+		using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+		allocator_type get_allocator() const { return tree.get_allocate(); }
+		key_compare key_comp() const { return tree.key_comp(); }
+
+	public:
+
+		flat_multimap() = default;
+
+		explicit flat_multimap(const Compare& comp) : tree(comp) {}
+
+		template <class InputIter>
+		flat_multimap(InputIter first, InputIter last, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		flat_multimap(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_multi(ilist.begin(), ilist.end());
+		}
+
+		flat_multimap(const flat_multimap& other) : tree(other.tree) {}
+
+		flat_multimap(flat_multimap&& other) noexcept : tree(mystl::move(other.tree)) {}
+
+		flat_multimap& operator=(const flat_multimap& other)
+		{
+			tree = other.tree;
+			return *this;
+		}
+
+		flat_multimap& operator=(flat_multimap&& other) noexcept
+		{
+			tree = mystl::move(other.tree);
+			return *this;
+		}
+
+		flat_multimap& operator=(std::initializer_list<value_type> ilist)
+		{
+			tree.clear();
+			tree.insert_multi(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		~flat_multimap() = default;
+
+		iterator begin() noexcept
+		{
+			return tree.begin();
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return tree.begin();
+		}
+
+		iterator end() noexcept
+		{
+			return tree.end();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return tree.end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return tree.rbegin();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return tree.rbegin();
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return tree.rend();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return tree.rend();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return tree.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return tree.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return tree.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return tree.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return tree.max_size();
+		}
+
+		size_type capacity() const noexcept
+		{
+			return tree.capacity();
+		}
+
+		void reserve(size_type n)
+		{
+			tree.reserve(n);
+		}
+
+		void shrink_to_fit()
+		{
+			tree.shrink_to_fit();
+		}
+
+		const key_container_type& keys() const noexcept
+		{
+			return tree.keys();
+		}
+
+		const mapped_container_type& values() const noexcept
+		{
+			return tree.values();
+		}
+
+		mapped_container_type& values() noexcept
+		{
+			return tree.values();
+		}
+
+		template <class ...Args>
+		iterator emplace(Args&& ...args)
+		{
+			return tree.emplace_multi(mystl::forward<Args>(args)...);
+		}
+
+		iterator insert(const value_type& value)
+		{
+			return tree.insert_multi(value);
+		}
+
+		iterator insert(value_type&& value)
+		{
+			return tree.insert_multi(mystl::move(value));
+		}
+
+		iterator insert(const_iterator hint, const value_type& value)
+		{
+			return tree.insert_multi(hint, value);
+		}
+
+		iterator insert(const_iterator hint, value_type&& value)
+		{
+			return tree.insert_multi(hint, mystl::move(value));
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		void insert(std::initializer_list<value_type> ilist)
+		{
+			tree.insert_multi(ilist.begin(), ilist.end());
+		}
+
+		iterator erase(const_iterator pos)
+		{
+			return tree.erase(pos);
+		}
+
+		size_type erase(const key_type& key)
+		{
+			return tree.erase_multi(key);
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			return tree.erase(first, last);
+		}
+
+		void clear()
+		{
+			tree.clear();
+		}
+
+		iterator find(const key_type& key)
+		{
+			return tree.find(key);
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return tree.find(key);
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return tree.count_multi(key);
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return tree.find(key) != tree.end();
+		}
+
+		iterator lower_bound(const key_type& key)
+		{
+			return tree.lower_bound(key);
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return tree.lower_bound(key);
+		}
+
+		iterator upper_bound(const key_type& key)
+		{
+			return tree.upper_bound(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return tree.upper_bound(key);
+		}
+
+		pair<iterator, iterator> equal_range(const key_type& key)
+		{
+			return tree.equal_range_multi(key);
+		}
+
+		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return tree.equal_range_multi(key);
+		}
+
+		void swap(flat_multimap& rhs) noexcept
+		{
+			tree.swap(rhs.tree);
+		}
+
+		friend bool operator==(const flat_multimap& lhs, const flat_multimap& rhs)
+		{
+			return lhs.tree == rhs.tree;
+		}
+
+		friend bool operator!=(const flat_multimap& lhs, const flat_multimap& rhs)
+		{
+			return lhs.tree != rhs.tree;
+		}
+
+		friend bool operator<(const flat_multimap& lhs, const flat_multimap& rhs)
+		{
+			return lhs.tree < rhs.tree;
+		}
+	};
+
+	template <class Key, class T, class Compare>
+	void swap(flat_multimap<Key, T, Compare>& lhs, flat_multimap<Key, T, Compare>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_FLAT_MAP_H
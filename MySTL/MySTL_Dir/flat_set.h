@@ -0,0 +1,931 @@
+#ifndef MYSTL_FLAT_SET_H
+#define MYSTL_FLAT_SET_H
+
+#include <initializer_list>
+
+#include "algo.h"
+#include "functional.h"
+#include "vector.h"
+
+namespace mystl {
+
+	// 有序的 vector，元素连续存放，查找是二分，适合读多写少、元素不太多的场景
+	// 插入和删除要挪动后面的元素，是 O(n)；批量插入先追加到末尾排序，再和原来的部分归并
+	// 接口和 rb_tree 一样分 unique / multi 两套，由 flat_set / flat_multiset 包装
+	template <class Key, class Compare>
+	class flat_tree
+	{
+	public:
+
+		using container_type = mystl::vector<Key>;
+
+		using key_type = Key;
+		using value_type = Key;
+		using key_compare = Compare;
+		using value_compare = Compare;
+
+		using allocator_type = typename container_type::allocator_type;
+		using pointer = typename container_type::const_pointer;
+		using const_pointer = typename container_type::const_pointer;
+		using reference = typename container_type::const_reference;
+		using const_reference = typename container_type::const_reference;
+		using size_type = typename container_type::size_type;
+		using difference_type = typename container_type::difference_type;
+
+		// 元素的位置决定了顺序，只给只读的迭代器
+		using iterator = typename container_type::const_iterator;
+		using const_iterator = typename container_type::const_iterator;
+		using reverse_iterator = mystl::reverse_iterator<const_iterator>;
+		using const_reverse_iterator = mystl::reverse_iterator<const_iterator>;
+
+		allocator_type get_allocate() const { return allocator_type(); }
+		key_compare key_comp() const { return m_Comp; }
+		value_compare value_comp() const { return m_Comp; }
+
+	private:
+
+		container_type	m_Data;
+		key_compare		m_Comp;
+
+	public:
+
+		flat_tree() = default;
+
+		explicit flat_tree(const Compare& comp) : m_Comp(comp) {}
+
+		flat_tree(const flat_tree& rhs) = default;
+
+		flat_tree(flat_tree&& rhs) noexcept
+			: m_Data(mystl::move(rhs.m_Data)), m_Comp(rhs.m_Comp) {}
+
+		flat_tree& operator=(const flat_tree& rhs) = default;
+
+		flat_tree& operator=(flat_tree&& rhs) noexcept
+		{
+			m_Data = mystl::move(rhs.m_Data);
+			m_Comp = rhs.m_Comp;
+			return *this;
+		}
+
+	public:
+
+		const_iterator begin() const noexcept
+		{
+			return m_Data.begin();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return m_Data.end();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		bool empty() const noexcept
+		{
+			return m_Data.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return m_Data.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return m_Data.max_size();
+		}
+
+		size_type capacity() const noexcept
+		{
+			return m_Data.capacity();
+		}
+
+		void reserve(size_type n)
+		{
+			m_Data.reserve(n);
+		}
+
+		void shrink_to_fit()
+		{
+			m_Data.shrink_to_fit();
+		}
+
+		// 底层的有序数组，可以直接拿去二分或者遍历
+		const container_type& keys() const noexcept
+		{
+			return m_Data;
+		}
+
+	public:
+
+		template <class ...Args>
+		mystl::pair<iterator, bool> emplace_unique(Args&& ...args)
+		{
+			value_type tmp(mystl::forward<Args>(args)...);
+			return insert_unique(mystl::move(tmp));
+		}
+
+		template <class ...Args>
+		iterator emplace_multi(Args&& ...args)
+		{
+			value_type tmp(mystl::forward<Args>(args)...);
+			return insert_multi(mystl::move(tmp));
+		}
+
+		mystl::pair<iterator, bool> insert_unique(const value_type& value)
+		{
+			return insert_unique_at(lower_bound(value), value);
+		}
+
+		mystl::pair<iterator, bool> insert_unique(value_type&& value)
+		{
+			const_iterator pos = lower_bound(value);
+			return insert_unique_at(pos, mystl::move(value));
+		}
+
+		iterator insert_multi(const value_type& value)
+		{
+			return m_Data.insert(upper_bound(value), value);
+		}
+
+		iterator insert_multi(value_type&& value)
+		{
+			const_iterator pos = upper_bound(value);
+			return m_Data.insert(pos, mystl::move(value));
+		}
+
+		// hint 正好是插入位置时省掉整段二分，否则只在 hint 的一侧做 lower_bound
+		iterator insert_unique(const_iterator hint, const value_type& value)
+		{
+			return insert_unique_at(lower_bound_hint(hint, value), value).first;
+		}
+
+		iterator insert_unique(const_iterator hint, value_type&& value)
+		{
+			const_iterator pos = lower_bound_hint(hint, value);
+			return insert_unique_at(pos, mystl::move(value)).first;
+		}
+
+		iterator insert_multi(const_iterator hint, const value_type& value)
+		{
+			return m_Data.insert(multi_hint(hint, value), value);
+		}
+
+		iterator insert_multi(const_iterator hint, value_type&& value)
+		{
+			const_iterator pos = multi_hint(hint, value);
+			return m_Data.insert(pos, mystl::move(value));
+		}
+
+		// 批量插入：新元素先追加到末尾，用 sort 排好，再和原来的部分 inplace_merge
+		// 总共 O(n + m log m)，比逐个插入的 O(n * m) 好得多
+		template <class InputIter>
+		void insert_unique(InputIter first, InputIter last)
+		{
+			const size_type n = append(first, last);
+			merge_tail(n, true);
+		}
+
+		template <class InputIter>
+		void insert_multi(InputIter first, InputIter last)
+		{
+			const size_type n = append(first, last);
+			merge_tail(n, false);
+		}
+
+		iterator erase(const_iterator pos)
+		{
+			return m_Data.erase(pos);
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			return m_Data.erase(first, last);
+		}
+
+		size_type erase_unique(const key_type& key)
+		{
+			const_iterator pos = find(key);
+			if (pos == end()) {
+				return 0;
+			}
+			m_Data.erase(pos);
+			return 1;
+		}
+
+		size_type erase_multi(const key_type& key)
+		{
+			mystl::pair<const_iterator, const_iterator> range = equal_range_multi(key);
+			const size_type n = static_cast<size_type>(range.second - range.first);
+			m_Data.erase(range.first, range.second);
+			return n;
+		}
+
+		void clear()
+		{
+			m_Data.clear();
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return find_pos(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator find(const K& key) const
+		{
+			return find_pos(key);
+		}
+
+		size_type count_unique(const key_type& key) const
+		{
+			return find(key) == end() ? 0 : 1;
+		}
+
+		size_type count_multi(const key_type& key) const
+		{
+			mystl::pair<const_iterator, const_iterator> range = equal_range_multi(key);
+			return static_cast<size_type>(range.second - range.first);
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return mystl::lower_bound(begin(), end(), key, m_Comp);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator lower_bound(const K& key) const
+		{
+			return mystl::lower_bound(begin(), end(), key, m_Comp);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return mystl::upper_bound(begin(), end(), key, m_Comp);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator upper_bound(const K& key) const
+		{
+			return mystl::upper_bound(begin(), end(), key, m_Comp);
+		}
+
+		mystl::pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
+		{
+			const_iterator pos = find(key);
+			return mystl::make_pair(pos, pos == end() ? pos : pos + 1);
+		}
+
+		mystl::pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
+		{
+			const_iterator first = lower_bound(key);
+			return mystl::make_pair(first, mystl::upper_bound(first, end(), key, m_Comp));
+		}
+
+		void swap(flat_tree& rhs) noexcept
+		{
+			m_Data.swap(rhs.m_Data);
+			mystl::swap(m_Comp, rhs.m_Comp);
+		}
+
+	private:
+
+		template <class K>
+		const_iterator find_pos(const K& key) const
+		{
+			const_iterator pos = mystl::lower_bound(begin(), end(), key, m_Comp);
+			return (pos == end() || m_Comp(key, *pos)) ? end() : pos;
+		}
+
+		template <class V>
+		mystl::pair<iterator, bool> insert_unique_at(const_iterator pos, V&& value)
+		{
+			if (pos != end() && !m_Comp(value, *pos)) {
+				return mystl::make_pair(pos, false);
+			}
+			return mystl::make_pair(iterator(m_Data.insert(pos, mystl::forward<V>(value))), true);
+		}
+
+		// 先看 hint 是不是 lower_bound 的位置，不是的话 key 在 hint 哪边就只查哪边
+		const_iterator lower_bound_hint(const_iterator hint, const key_type& key) const
+		{
+			if (hint == end() || !m_Comp(*hint, key)) {
+				if (hint == begin() || m_Comp(*(hint - 1), key)) {
+					return hint;
+				}
+				return mystl::lower_bound(begin(), hint - 1, key, m_Comp);
+			}
+			return mystl::lower_bound(hint + 1, end(), key, m_Comp);
+		}
+
+		// multi 时 hint 两边的元素夹住 key 就直接插在 hint，否则退回到 lower_bound_hint
+		const_iterator multi_hint(const_iterator hint, const key_type& key) const
+		{
+			if ((hint == end() || !m_Comp(*hint, key)) &&
+				(hint == begin() || !m_Comp(key, *(hint - 1)))) {
+				return hint;
+			}
+			return lower_bound_hint(hint, key);
+		}
+
+		// 追加到末尾，返回原来的元素个数；中途抛异常时把追加的部分删掉
+		template <class InputIter>
+		size_type append(InputIter first, InputIter last)
+		{
+			const size_type n = m_Data.size();
+			try {
+				for (; first != last; ++first) {
+					m_Data.emplace_back(*first);
+				}
+			}
+			catch (...) {
+				m_Data.erase(m_Data.begin() + n, m_Data.end());
+				throw;
+			}
+			return n;
+		}
+
+		// [0, n) 是原来的有序部分，[n, size) 是新追加的
+		// inplace_merge 是稳定的，原来的元素排在相等的新元素前面，去重时留下的是原来的
+		void merge_tail(size_type n, bool unique)
+		{
+			typename container_type::iterator first = m_Data.begin();
+			typename container_type::iterator mid = first + n;
+			typename container_type::iterator last = m_Data.end();
+			if (mid == last) {
+				return;
+			}
+			mystl::sort(mid, last, m_Comp);
+			// 新元素都不小于原来的最大值时（比如按顺序追加）不用归并
+			if (n != 0 && m_Comp(*mid, *(mid - 1))) {
+				mystl::inplace_merge(first, mid, last, m_Comp);
+			}
+			if (unique) {
+				typename container_type::iterator out = first;
+				for (typename container_type::iterator it = first + 1; it != last; ++it) {
+					if (m_Comp(*out, *it)) {
+						*++out = mystl::move(*it);
+					}
+				}
+				m_Data.erase(out + 1, last);
+			}
+		}
+	};
+
+	template <class Key, class Compare>
+	bool operator==(const flat_tree<Key, Compare>& lhs, const flat_tree<Key, Compare>& rhs)
+	{
+		return lhs.keys() == rhs.keys();
+	}
+
+	template <class Key, class Compare>
+	bool operator!=(const flat_tree<Key, Compare>& lhs, const flat_tree<Key, Compare>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class Key, class Compare>
+	bool operator<(const flat_tree<Key, Compare>& lhs, const flat_tree<Key, Compare>& rhs)
+	{
+		return lhs.keys() < rhs.keys();
+	}
+
+
+	template <class Key, class Compare = mystl::less<Key>>
+	class flat_set
+	{
+	private:
+
+		using base_type = flat_tree<Key, Compare>;
+		base_type tree;
+
+	public:
+
+		using container_type = typename base_type::container_type;
+		using allocator_type = typename base_type::allocator_type;
+		using key_type = typename base_type::key_type;
+		using value_type = typename base_type::value_type;
+		using key_compare = typename base_type::key_compare;
+		using value_compare = typename base_type::value_compare;
+
+		using pointer = typename base_type::pointer;
+		using const_pointer = typename base_type::const_pointer;
+		using reference = typename base_type::reference;
+		using const_reference = typename base_type::const_reference;
+		using size_type = typename base_type::size_type;
+		using difference_type = typename base_type::difference_type;
+
+		using iterator = typename base_type::iterator;
+		using const_iterator = typename base_type::const_iterator;
+		using reverse_iterator = typename base_type::reverse_iterator;
+		using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+		allocator_type get_allocator() const { return tree.get_allocate(); }
+		key_compare key_comp() const { return tree.key_comp(); }
+		value_compare value_comp() const { return tree.value_comp(); }
+
+	public:
+
+		flat_set() = default;
+
+		explicit flat_set(const Compare& comp) : tree(comp) {}
+
+		template <class InputIter>
+		flat_set(InputIter first, InputIter last, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_unique(first, last);
+		}
+
+		flat_set(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_unique(ilist.begin(), ilist.end());
+		}
+
+		flat_set(const flat_set& other) : tree(other.tree) {}
+
+		flat_set(flat_set&& other) noexcept : tree(mystl::move(other.tree)) {}
+
+		flat_set& operator=(const flat_set& other)
+		{
+			tree = other.tree;
+			return *this;
+		}
+
+		flat_set& operator=(flat_set&& other) noexcept
+		{
+			tree = mystl::move(other.tree);
+			return *this;
+		}
+
+		flat_set& operator=(std::initializer_list<value_type> ilist)
+		{
+			tree.clear();
+			tree.insert_unique(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		~flat_set() = default;
+
+		const_iterator begin() const noexcept
+		{
+			return tree.begin();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return tree.end();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return tree.rbegin();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return tree.rend();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return tree.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return tree.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return tree.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return tree.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return tree.max_size();
+		}
+
+		size_type capacity() const noexcept
+		{
+			return tree.capacity();
+		}
+
+		void reserve(size_type n)
+		{
+			tree.reserve(n);
+		}
+
+		void shrink_to_fit()
+		{
+			tree.shrink_to_fit();
+		}
+
+		const container_type& keys() const noexcept
+		{
+			return tree.keys();
+		}
+
+		template <class ...Args>
+		pair<iterator, bool> emplace(Args&& ...args)
+		{
+			return tree.emplace_unique(mystl::forward<Args>(args)...);
+		}
+
+		pair<iterator, bool> insert(const value_type& value)
+		{
+			return tree.insert_unique(value);
+		}
+
+		pair<iterator, bool> insert(value_type&& value)
+		{
+			return tree.insert_unique(mystl::move(value));
+		}
+
+		iterator insert(const_iterator hint, const value_type& value)
+		{
+			return tree.insert_unique(hint, value);
+		}
+
+		iterator insert(const_iterator hint, value_type&& value)
+		{
+			return tree.insert_unique(hint, mystl::move(value));
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			tree.insert_unique(first, last);
+		}
+
+		void insert(std::initializer_list<value_type> ilist)
+		{
+			tree.insert_unique(ilist.begin(), ilist.end());
+		}
+
+		iterator erase(const_iterator pos)
+		{
+			return tree.erase(pos);
+		}
+
+		size_type erase(const key_type& key)
+		{
+			return tree.erase_unique(key);
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			return tree.erase(first, last);
+		}
+
+		void clear()
+		{
+			tree.clear();
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return tree.find(key);
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return tree.count_unique(key);
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return tree.find(key) != tree.end();
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return tree.lower_bound(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return tree.upper_bound(key);
+		}
+
+		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return tree.equal_range_unique(key);
+		}
+
+		void swap(flat_set& rhs) noexcept
+		{
+			tree.swap(rhs.tree);
+		}
+
+		friend bool operator==(const flat_set& lhs, const flat_set& rhs)
+		{
+			return lhs.tree == rhs.tree;
+		}
+
+		friend bool operator!=(const flat_set& lhs, const flat_set& rhs)
+		{
+			return lhs.tree != rhs.tree;
+		}
+
+		friend bool operator<(const flat_set& lhs, const flat_set& rhs)
+		{
+			return lhs.tree < rhs.tree;
+		}
+	};
+
+	template <class Key, class Compare>
+	void swap(flat_set<Key, Compare>& lhs, flat_set<Key, Compare>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+
+	template <class Key, class Compare = mystl::less<Key>>
+	class flat_multiset
+	{
+	private:
+
+		using base_type = flat_tree<Key, Compare>;
+		base_type tree;
+
+	public:
+
+		using container_type = typename base_type::container_type;
+		using allocator_type = typename base_type::allocator_type;
+		using key_type = typename base_type::key_type;
+		using value_type = typename base_type::value_type;
+		using key_compare = typename base_type::key_compare;
+		using value_compare = typename base_type::value_compare;
+
+		using pointer = typename base_type::pointer;
+		using const_pointer = typename base_type::const_pointer;
+		using reference = typename base_type::reference;
+		using const_reference = typename base_type::const_reference;
+		using size_type = typename base_type::size_type;
+		using difference_type = typename base_type::difference_type;
+
+		using iterator = typename base_type::iterator;
+		using const_iterator = typename base_type::const_iterator;
+		using reverse_iterator = typename base_type::reverse_iterator;
+		using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+		allocator_type get_allocator() const { return tree.get_allocate(); }
+		key_compare key_comp() const { return tree.key_comp(); }
+		value_compare value_comp() const { return tree.value_comp(); }
+
+	public:
+
+		flat_multiset() = default;
+
+		explicit flat_multiset(const Compare& comp) : tree(comp) {}
+
+		template <class InputIter>
+		flat_multiset(InputIter first, InputIter last, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		flat_multiset(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: tree(comp)
+		{
+			tree.insert_multi(ilist.begin(), ilist.end());
+		}
+
+		flat_multiset(const flat_multiset& other) : tree(other.tree) {}
+
+		flat_multiset(flat_multiset&& other) noexcept : tree(mystl::move(other.tree)) {}
+
+		flat_multiset& operator=(const flat_multiset& other)
+		{
+			tree = other.tree;
+			return *this;
+		}
+
+		flat_multiset& operator=(flat_multiset&& other) noexcept
+		{
+			tree = mystl::move(other.tree);
+			return *this;
+		}
+
+		flat_multiset& operator=(std::initializer_list<value_type> ilist)
+		{
+			tree.clear();
+			tree.insert_multi(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+		~flat_multiset() = default;
+
+		const_iterator begin() const noexcept
+		{
+			return tree.begin();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return tree.end();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return tree.rbegin();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return tree.rend();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return tree.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return tree.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return tree.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return tree.size();
+		}
+
+		size_type max_size() const noexcept
+		{
+			return tree.max_size();
+		}
+
+		size_type capacity() const noexcept
+		{
+			return tree.capacity();
+		}
+
+		void reserve(size_type n)
+		{
+			tree.reserve(n);
+		}
+
+		void shrink_to_fit()
+		{
+			tree.shrink_to_fit();
+		}
+
+		const container_type& keys() const noexcept
+		{
+			return tree.keys();
+		}
+
+		template <class ...Args>
+		iterator emplace(Args&& ...args)
+		{
+			return tree.emplace_multi(mystl::forward<Args>(args)...);
+		}
+
+		iterator insert(const value_type& value)
+		{
+			return tree.insert_multi(value);
+		}
+
+		iterator insert(value_type&& value)
+		{
+			return tree.insert_multi(mystl::move(value));
+		}
+
+		iterator insert(const_iterator hint, const value_type& value)
+		{
+			return tree.insert_multi(hint, value);
+		}
+
+		iterator insert(const_iterator hint, value_type&& value)
+		{
+			return tree.insert_multi(hint, mystl::move(value));
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		void insert(std::initializer_list<value_type> ilist)
+		{
+			tree.insert_multi(ilist.begin(), ilist.end());
+		}
+
+		iterator erase(const_iterator pos)
+		{
+			return tree.erase(pos);
+		}
+
+		size_type erase(const key_type& key)
+		{
+			return tree.erase_multi(key);
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			return tree.erase(first, last);
+		}
+
+		void clear()
+		{
+			tree.clear();
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return tree.find(key);
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return tree.count_multi(key);
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return tree.find(key) != tree.end();
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return tree.lower_bound(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return tree.upper_bound(key);
+		}
+
+		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return tree.equal_range_multi(key);
+		}
+
+		void swap(flat_multiset& rhs) noexcept
+		{
+			tree.swap(rhs.tree);
+		}
+
+		friend bool operator==(const flat_multiset& lhs, const flat_multiset& rhs)
+		{
+			return lhs.tree == rhs.tree;
+		}
+
+		friend bool operator!=(const flat_multiset& lhs, const flat_multiset& rhs)
+		{
+			return lhs.tree != rhs.tree;
+		}
+
+		friend bool operator<(const flat_multiset& lhs, const flat_multiset& rhs)
+		{
+			return lhs.tree < rhs.tree;
+		}
+	};
+
+	template <class Key, class Compare>
+	void swap(flat_multiset<Key, Compare>& lhs, flat_multiset<Key, Compare>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_FLAT_SET_H
@@ -0,0 +1,421 @@
+#ifndef MYSTL_FROZEN_HASHTABLE_H
+#define MYSTL_FROZEN_HASHTABLE_H
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "hashtable.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+	// 只读的哈希表，可以离线从 hashtable 构造后写成文件，使用时直接 mmap 进来，不需要反序列化
+	// 文件布局 (所有位置都是相对文件头的偏移，和映射到的地址无关)：
+	//   header
+	//   buckets   uint64_t[bucket_count + 1]，b 号桶的元素是 entries[buckets[b], buckets[b + 1])
+	//   entries   value_type[size]，按桶号排好，同一个桶的元素是连续的
+	// 查找时读一次 buckets 再顺序扫描一小段 entries，没有指针跳转
+	// Key 和 T 必须是 trivially copyable 的，Hash 的结果在不同进程之间必须一致 (mystl::hash 满足，指针的 hash 不满足)
+	template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+	class frozen_hashtable
+	{
+	public:
+
+		using key_type		= Key;
+		using mapped_type	= T;
+		using hasher		= Hash;
+		using key_equal		= KeyEqual;
+		using size_type		= size_t;
+
+		struct value_type
+		{
+			key_type first;
+			mapped_type second;
+		};
+
+		using const_iterator = const value_type*;
+		using source_type = hashtable<pair<const Key, T>, Hash, KeyEqual>;
+
+		static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<T>::value,
+			"frozen_hashtable requires trivially copyable key and mapped types");
+
+		// 文件格式变化时 +1，旧文件打开时会被拒绝
+		// 2: 头部加上 size_t 的宽度和 hash 函数的指纹
+		static constexpr std::uint32_t format_version = 2;
+
+	private:
+
+		struct header
+		{
+			char magic[8];
+			std::uint32_t version;
+			// 写入 0x01020304，读出来不一样说明是另一种字节序的机器写的
+			std::uint32_t byte_order;
+			std::uint32_t key_size;
+			std::uint32_t mapped_size;
+			std::uint32_t entry_size;
+			std::uint32_t entry_align;
+			// hash 的结果是 size_t，32 位和 64 位进程算出来的桶号不一样
+			std::uint32_t size_width;
+			std::uint32_t reserved;
+			// 用写入时的 Hash 对前面若干个 key 算出的指纹，读的一方用自己的 Hash 重算，
+			// 不一致说明两边的 hash 函数或者种子不同，按桶查找会找不到
+			std::uint64_t hash_check;
+			std::uint64_t bucket_count;
+			std::uint64_t size;
+			std::uint64_t buckets_offset;
+			std::uint64_t entries_offset;
+			std::uint64_t file_size;
+			std::uint64_t checksum;
+		};
+
+		static constexpr std::uint32_t byte_order_mark = 0x01020304u;
+
+		const unsigned char*	m_Base;
+		size_type				m_Length;
+		const std::uint64_t*	m_Buckets;
+		const value_type*		m_Entries;
+		size_type				m_Bucket_Size;
+		size_type				m_Size;
+		hasher					m_Hash;
+		key_equal				m_Equal;
+
+	public:
+
+		explicit frozen_hashtable(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+			: m_Base(nullptr), m_Length(0), m_Buckets(nullptr), m_Entries(nullptr)
+			, m_Bucket_Size(0), m_Size(0), m_Hash(hash), m_Equal(equal) {}
+
+		// verify 为 true 时打开时会把整个文件读一遍校验 checksum
+		explicit frozen_hashtable(const char* path, bool verify = true,
+			const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+			: frozen_hashtable(hash, equal)
+		{
+			open(path, verify);
+		}
+
+		frozen_hashtable(const frozen_hashtable&) = delete;
+		frozen_hashtable& operator=(const frozen_hashtable&) = delete;
+
+		frozen_hashtable(frozen_hashtable&& rhs) noexcept
+			: m_Base(rhs.m_Base), m_Length(rhs.m_Length), m_Buckets(rhs.m_Buckets), m_Entries(rhs.m_Entries)
+			, m_Bucket_Size(rhs.m_Bucket_Size), m_Size(rhs.m_Size), m_Hash(rhs.m_Hash), m_Equal(rhs.m_Equal)
+		{
+			rhs.reset();
+		}
+
+		frozen_hashtable& operator=(frozen_hashtable&& rhs) noexcept
+		{
+			if (this != &rhs) {
+				close();
+				m_Base = rhs.m_Base;
+				m_Length = rhs.m_Length;
+				m_Buckets = rhs.m_Buckets;
+				m_Entries = rhs.m_Entries;
+				m_Bucket_Size = rhs.m_Bucket_Size;
+				m_Size = rhs.m_Size;
+				m_Hash = rhs.m_Hash;
+				m_Equal = rhs.m_Equal;
+				rhs.reset();
+			}
+			return *this;
+		}
+
+		~frozen_hashtable()
+		{
+			close();
+		}
+
+		void open(const char* path, bool verify = true)
+		{
+			close();
+			map_file(path);
+			try {
+				validate(verify);
+			}
+			catch (...) {
+				close();
+				throw;
+			}
+		}
+
+		void close() noexcept
+		{
+			if (m_Base != nullptr) {
+#if defined(_WIN32)
+				::UnmapViewOfFile(m_Base);
+#else
+				::munmap(const_cast<unsigned char*>(m_Base), m_Length);
+#endif
+			}
+			reset();
+		}
+
+		bool is_open() const noexcept { return m_Base != nullptr; }
+
+		const_iterator begin() const noexcept { return m_Entries; }
+		const_iterator end() const noexcept { return m_Entries + m_Size; }
+
+		size_type size() const noexcept { return m_Size; }
+		bool empty() const noexcept { return m_Size == 0; }
+		size_type bucket_count() const noexcept { return m_Bucket_Size; }
+
+		// 找不到返回 nullptr，返回的指针指向映射的文件，close 之后失效
+		const mapped_type* find(const key_type& key) const
+		{
+			if (m_Bucket_Size == 0) {
+				return nullptr;
+			}
+			const size_type n = static_cast<size_type>(m_Hash(key) % m_Bucket_Size);
+			const value_type* last = m_Entries + m_Buckets[n + 1];
+			for (const value_type* cur = m_Entries + m_Buckets[n]; cur != last; ++cur) {
+				if (m_Equal(cur->first, key)) {
+					return &cur->second;
+				}
+			}
+			return nullptr;
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return find(key) != nullptr;
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return find(key) != nullptr ? 1 : 0;
+		}
+
+		const mapped_type& at(const key_type& key) const
+		{
+			const mapped_type* p = find(key);
+			THROW_OUT_RANGE_IF(p == nullptr, "frozen_hashtable<Key, T> no such element exists");
+			return *p;
+		}
+
+		// 把 hashtable 的内容写成文件，桶个数按元素个数重新取素数
+		static void save(const source_type& ht, const char* path)
+		{
+			save(ht.begin(), ht.end(), path, ht.hash_fcn());
+		}
+
+		// [first, last) 的元素要有 first / second，key 不能重复
+		template <class InputIter>
+		static void save(InputIter first, InputIter last, const char* path, const Hash& hash = Hash())
+		{
+			mystl::vector<value_type> items;
+			for (; first != last; ++first) {
+				value_type v;
+				std::memset(&v, 0, sizeof(v));
+				v.first = first->first;
+				v.second = first->second;
+				items.push_back(v);
+			}
+
+			const size_type n = items.size();
+			const size_type bucket_cnt = ht_next_prime(n);
+			mystl::vector<std::uint64_t> buckets(bucket_cnt + 1, 0);
+			mystl::vector<size_type> index(n, 0);
+			for (size_type i = 0; i < n; ++i) {
+				index[i] = static_cast<size_type>(hash(items[i].first) % bucket_cnt);
+				++buckets[index[i] + 1];
+			}
+			for (size_type b = 0; b < bucket_cnt; ++b) {
+				buckets[b + 1] += buckets[b];
+			}
+
+			// 按桶号做一次计数排序，padding 先清零，写出去的文件内容是确定的
+			value_type* entries = nullptr;
+			if (n != 0) {
+				entries = mystl::allocator<value_type>::allocate(n);
+				std::memset(entries, 0, n * sizeof(value_type));
+			}
+			mystl::vector<std::uint64_t> fill(buckets.begin(), buckets.end());
+			for (size_type i = 0; i < n; ++i) {
+				std::memcpy(entries + fill[index[i]]++, &items[i], sizeof(value_type));
+			}
+
+			header h;
+			std::memset(&h, 0, sizeof(h));
+			std::memcpy(h.magic, "MYSTLFHT", 8);
+			h.version = format_version;
+			h.byte_order = byte_order_mark;
+			h.key_size = sizeof(key_type);
+			h.mapped_size = sizeof(mapped_type);
+			h.entry_size = sizeof(value_type);
+			h.entry_align = alignof(value_type);
+			h.size_width = sizeof(size_t);
+			h.hash_check = hash_fingerprint(entries, n, hash);
+			h.bucket_count = bucket_cnt;
+			h.size = n;
+			h.buckets_offset = align_up(sizeof(header), alignof(std::uint64_t));
+			h.entries_offset = align_up(h.buckets_offset + (bucket_cnt + 1) * sizeof(std::uint64_t), entry_alignment());
+			h.file_size = h.entries_offset + n * sizeof(value_type);
+			h.checksum = checksum(reinterpret_cast<const unsigned char*>(buckets.data()), (bucket_cnt + 1) * sizeof(std::uint64_t),
+				reinterpret_cast<const unsigned char*>(entries), n * sizeof(value_type));
+
+			std::FILE* fp = std::fopen(path, "wb");
+			std::uint64_t pos = 0;
+			bool ok = fp != nullptr;
+			ok = ok && write_at(fp, pos, 0, &h, sizeof(h));
+			ok = ok && write_at(fp, pos, h.buckets_offset, buckets.data(), (bucket_cnt + 1) * sizeof(std::uint64_t));
+			ok = ok && write_at(fp, pos, h.entries_offset, entries, n * sizeof(value_type));
+			if (fp != nullptr) {
+				ok = std::fclose(fp) == 0 && ok;
+			}
+			if (entries != nullptr) {
+				mystl::allocator<value_type>::deallocate(entries, n);
+			}
+			THROW_RUNTIME_ERROR_IF(!ok, "frozen_hashtable: failed to write file");
+		}
+
+	private:
+
+		void reset() noexcept
+		{
+			m_Base = nullptr;
+			m_Length = 0;
+			m_Buckets = nullptr;
+			m_Entries = nullptr;
+			m_Bucket_Size = 0;
+			m_Size = 0;
+		}
+
+		static constexpr std::uint64_t entry_alignment() noexcept
+		{
+			return alignof(value_type) > 8 ? alignof(value_type) : 8;
+		}
+
+		static constexpr std::uint64_t align_up(std::uint64_t n, std::uint64_t a) noexcept
+		{
+			return (n + a - 1) / a * a;
+		}
+
+		// 只取前 hash_check_count 个元素，打开大文件时也是常数时间
+		static constexpr size_type hash_check_count = 64;
+
+		static std::uint64_t hash_fingerprint(const value_type* entries, size_type n, const Hash& hash)
+		{
+			std::uint64_t h = hash_mix(n);
+			for (size_type i = 0; i < n && i < hash_check_count; ++i) {
+				h = hash_mix(h ^ static_cast<std::uint64_t>(hash(entries[i].first)), hash_secret(1));
+			}
+			return h;
+		}
+
+		static std::uint64_t checksum(const unsigned char* buckets, size_t bucket_bytes,
+			const unsigned char* entries, size_t entry_bytes) noexcept
+		{
+			return hash_bytes(entries, entry_bytes, hash_bytes(buckets, bucket_bytes, format_version));
+		}
+
+		// pos 是当前写到的位置，先用 0 补齐到 offset 再写数据
+		static bool write_at(std::FILE* fp, std::uint64_t& pos, std::uint64_t offset, const void* data, std::uint64_t len)
+		{
+			for (; pos < offset; ++pos) {
+				if (std::fputc(0, fp) == EOF) {
+					return false;
+				}
+			}
+			pos += len;
+			return len == 0 || std::fwrite(data, 1, static_cast<size_t>(len), fp) == len;
+		}
+
+		void map_file(const char* path)
+		{
+#if defined(_WIN32)
+			HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL, nullptr);
+			THROW_RUNTIME_ERROR_IF(file == INVALID_HANDLE_VALUE, "frozen_hashtable: cannot open file");
+			LARGE_INTEGER len;
+			if (!::GetFileSizeEx(file, &len) || len.QuadPart < static_cast<LONGLONG>(sizeof(header))) {
+				::CloseHandle(file);
+				THROW_RUNTIME_ERROR_IF(true, "frozen_hashtable: file too small");
+			}
+			HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			::CloseHandle(file);
+			THROW_RUNTIME_ERROR_IF(mapping == nullptr, "frozen_hashtable: cannot map file");
+			// 映射视图会自己持有 mapping 对象，句柄可以马上关掉
+			void* base = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			::CloseHandle(mapping);
+			THROW_RUNTIME_ERROR_IF(base == nullptr, "frozen_hashtable: cannot map file");
+			m_Length = static_cast<size_type>(len.QuadPart);
+#else
+			const int fd = ::open(path, O_RDONLY);
+			THROW_RUNTIME_ERROR_IF(fd < 0, "frozen_hashtable: cannot open file");
+			struct stat st;
+			if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(header))) {
+				::close(fd);
+				THROW_RUNTIME_ERROR_IF(true, "frozen_hashtable: file too small");
+			}
+			void* base = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+			::close(fd);
+			THROW_RUNTIME_ERROR_IF(base == MAP_FAILED, "frozen_hashtable: cannot map file");
+			m_Length = static_cast<size_type>(st.st_size);
+#endif
+			m_Base = static_cast<const unsigned char*>(base);
+		}
+
+		// 头部的每个字段都要检查，文件可能是截断的、别的版本的或者别的类型的
+		void validate(bool verify)
+		{
+			header h;
+			std::memcpy(&h, m_Base, sizeof(h));
+			THROW_RUNTIME_ERROR_IF(std::memcmp(h.magic, "MYSTLFHT", 8) != 0, "frozen_hashtable: bad magic");
+			THROW_RUNTIME_ERROR_IF(h.version != format_version, "frozen_hashtable: unsupported version");
+			THROW_RUNTIME_ERROR_IF(h.byte_order != byte_order_mark, "frozen_hashtable: byte order mismatch");
+			THROW_RUNTIME_ERROR_IF(h.key_size != sizeof(key_type) || h.mapped_size != sizeof(mapped_type) ||
+				h.entry_size != sizeof(value_type) || h.entry_align != alignof(value_type),
+				"frozen_hashtable: element type mismatch");
+			THROW_RUNTIME_ERROR_IF(h.size_width != sizeof(size_t), "frozen_hashtable: size_t width mismatch");
+			THROW_RUNTIME_ERROR_IF(h.file_size != m_Length || h.bucket_count == 0 ||
+				h.buckets_offset % alignof(std::uint64_t) != 0 || h.entries_offset % alignof(value_type) != 0 ||
+				h.bucket_count + 1 > (m_Length - h.buckets_offset) / sizeof(std::uint64_t) ||
+				h.buckets_offset + (h.bucket_count + 1) * sizeof(std::uint64_t) > h.entries_offset ||
+				h.size > (m_Length - h.entries_offset) / sizeof(value_type) ||
+				h.entries_offset + h.size * sizeof(value_type) != m_Length,
+				"frozen_hashtable: corrupted layout");
+
+			const std::uint64_t* buckets = reinterpret_cast<const std::uint64_t*>(m_Base + h.buckets_offset);
+			const unsigned char* entries = m_Base + h.entries_offset;
+			if (verify) {
+				THROW_RUNTIME_ERROR_IF(checksum(reinterpret_cast<const unsigned char*>(buckets),
+					static_cast<size_t>((h.bucket_count + 1) * sizeof(std::uint64_t)), entries,
+					static_cast<size_t>(h.size * sizeof(value_type))) != h.checksum, "frozen_hashtable: checksum mismatch");
+			}
+			// 不校验 checksum 时也要保证偏移单调且不越界，否则 find 会读到 entries 外面去
+			THROW_RUNTIME_ERROR_IF(buckets[0] != 0 || buckets[h.bucket_count] != h.size,
+				"frozen_hashtable: corrupted layout");
+			for (std::uint64_t b = 0; b < h.bucket_count; ++b) {
+				THROW_RUNTIME_ERROR_IF(buckets[b + 1] < buckets[b], "frozen_hashtable: corrupted layout");
+			}
+			THROW_RUNTIME_ERROR_IF(hash_fingerprint(reinterpret_cast<const value_type*>(entries),
+				static_cast<size_type>(h.size), m_Hash) != h.hash_check, "frozen_hashtable: hash function mismatch");
+
+			m_Buckets = buckets;
+			m_Entries = reinterpret_cast<const value_type*>(entries);
+			m_Bucket_Size = static_cast<size_type>(h.bucket_count);
+			m_Size = static_cast<size_type>(h.size);
+		}
+	};
+
+}
+
+#endif // !MYSTL_FROZEN_HASHTABLE_H
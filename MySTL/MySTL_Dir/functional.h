@@ -3,6 +3,9 @@
 
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 
 
 namespace mystl {
@@ -77,56 +80,89 @@ namespace mystl {
 	template <class T>
 	struct no_equal_to : public binary_function<T, T, bool>
 	{
-		bool operator()(const T& x, const T& y) { return x != y; }
+		bool operator()(const T& x, const T& y) const { return x != y; }
 	};
 
 
 	template <class T>
 	struct equal_to : public binary_function<T, T, bool>
 	{
-		bool operator()(const T& x, const T& y) { return x == y; }
+		bool operator()(const T& x, const T& y) const { return x == y; }
 	};
 
 
 	template <class T>
 	struct greater : public binary_function<T, T, bool>
 	{
-		bool operator()(const T& x, const T& y) { return x > y; }
+		bool operator()(const T& x, const T& y) const { return x > y; }
 	};
 
 
 	template <class T>
 	struct less : public binary_function<T, T, bool>
 	{
-		bool operator()(const T& x, const T& y) { return x < y; }
+		bool operator()(const T& x, const T& y) const { return x < y; }
 	};
 
 
 	template <class T>
 	struct greater_equal : public binary_function<T, T, bool>
 	{
-		bool operator()(const T& x, const T& y) { return x >= y; }
+		bool operator()(const T& x, const T& y) const { return x >= y; }
 	};
 
 	
 	template <class T>
 	struct less_equal : public binary_function<T, T, bool>
 	{
-		bool operator()(const T& x, const T& y) { return x <= y; }
+		bool operator()(const T& x, const T& y) const { return x <= y; }
 	};
 
 
+	// 透明比较器，operator() 是模板，可以比较任意两个能用 == / < 比较的类型
+	// 带上 is_transparent 之后容器会开放异构查找
+	template <>
+	struct equal_to<void>
+	{
+		typedef void is_transparent;
+
+		template <class T, class U>
+		bool operator()(const T& x, const U& y) const { return x == y; }
+	};
+
+
+	template <>
+	struct less<void>
+	{
+		typedef void is_transparent;
+
+		template <class T, class U>
+		bool operator()(const T& x, const U& y) const { return x < y; }
+	};
+
+
+	template <class...>
+	struct make_void { typedef void type; };
+
+	// 判断 T 是否声明了 is_transparent，是则容器可以用非 key_type 的类型查找
+	template <class T, class = void>
+	struct is_transparent : std::false_type {};
+
+	template <class T>
+	struct is_transparent<T, typename make_void<typename T::is_transparent>::type> : std::true_type {};
+
+
 	template <class T>
 	struct logical_and : public binary_function<T, T, bool>
 	{
-		bool operator()(const T& x, const T& y) { return x && y; }
+		bool operator()(const T& x, const T& y) const { return x && y; }
 	};
 
 
 	template <class T>
 	struct logical_or : public binary_function<T, T, bool>
 	{
-		bool operator()(const T& x, const T& y) { return x || y; }
+		bool operator()(const T& x, const T& y) const { return x || y; }
 	};
 
 
@@ -179,25 +215,152 @@ namespace mystl {
 
 
 
+	// 哈希的底层工具，算法参考 wyhash：
+	// 核心是 64 位乘 64 位得到 128 位结果，再把高低两半异或，一次乘法就能让每一位影响所有输出位
+	// hash_mix 用来打散整数，hash_bytes 每轮处理 16 / 48 个字节，比逐字节的 FNV 快很多
+
+	// 四个随机常数写成 constexpr 函数而不是命名空间作用域的数组
+	// C++14 里那样的数组每个编译单元各有一份，被 inline 函数引用就违反了 ODR
+	constexpr std::uint64_t hash_secret(int i) noexcept
+	{
+		return i == 0 ? 0x2d358dccaa6c78a5ull
+			: i == 1 ? 0x8bb84b93962eacc9ull
+			: i == 2 ? 0x4b33a62ed433d4a3ull
+			: 0x4d5a2da51de1aa47ull;
+	}
+
+	// a * b 的 128 位结果，低 64 位放回 a，高 64 位放回 b
+	// 写成 constexpr 是为了编译期的哈希表 (perfect_hash_map.h) 也能用同一套 hash
+	// 所以这里不用 _umul128 这类不能在编译期求值的 intrinsic
+	constexpr void hash_mum(std::uint64_t& a, std::uint64_t& b) noexcept
+	{
+#if defined(__SIZEOF_INT128__)
+		unsigned __int128 r = a;
+		r *= b;
+		a = static_cast<std::uint64_t>(r);
+		b = static_cast<std::uint64_t>(r >> 64);
+#else
+		// 没有 128 位乘法时拆成四个 32 位乘法
+		const std::uint64_t ha = a >> 32, hb = b >> 32, la = (std::uint32_t)a, lb = (std::uint32_t)b;
+		const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+		const std::uint64_t t = rl + (rm0 << 32);
+		std::uint64_t c = t < rl;
+		const std::uint64_t lo = t + (rm1 << 32);
+		c += lo < t;
+		a = lo;
+		b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+	}
+
+	constexpr std::uint64_t hash_mix(std::uint64_t a, std::uint64_t b) noexcept
+	{
+		hash_mum(a, b);
+		return a ^ b;
+	}
+
+	// 整数的打散函数，相邻的整数映射后高低位都分布均匀
+	constexpr std::uint64_t hash_mix(std::uint64_t x) noexcept
+	{
+		return hash_mix(x ^ hash_secret(0), hash_secret(1));
+	}
+
+	// 用 memcpy 读，避免未对齐访问，编译器会优化成一条 load
+	inline std::uint64_t hash_read8(const unsigned char* p) noexcept
+	{
+		std::uint64_t v;
+		std::memcpy(&v, p, 8);
+		return v;
+	}
+
+	inline std::uint64_t hash_read4(const unsigned char* p) noexcept
+	{
+		std::uint32_t v;
+		std::memcpy(&v, p, 4);
+		return v;
+	}
+
+	// 1 到 3 个字节时读首、中、尾三个字节
+	inline std::uint64_t hash_read3(const unsigned char* p, size_t k) noexcept
+	{
+		return (((std::uint64_t)p[0]) << 16) | (((std::uint64_t)p[k >> 1]) << 8) | p[k - 1];
+	}
+
+	inline std::uint64_t hash_bytes(const void* key, size_t len, std::uint64_t seed = 0) noexcept
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(key);
+		seed ^= hash_mix(seed ^ hash_secret(0), hash_secret(1));
+		std::uint64_t a, b;
+		if (len <= 16) {
+			if (len >= 4) {
+				// 4 到 16 个字节用首尾相互重叠的 4 字节读，不需要循环
+				a = (hash_read4(p) << 32) | hash_read4(p + ((len >> 3) << 2));
+				b = (hash_read4(p + len - 4) << 32) | hash_read4(p + len - 4 - ((len >> 3) << 2));
+			}
+			else if (len > 0) {
+				a = hash_read3(p, len);
+				b = 0;
+			}
+			else {
+				a = b = 0;
+			}
+		}
+		else {
+			size_t i = len;
+			if (i >= 48) {
+				// 三条互不依赖的乘法链并行，每轮吃 48 个字节
+				std::uint64_t see1 = seed, see2 = seed;
+				do {
+					seed = hash_mix(hash_read8(p) ^ hash_secret(1), hash_read8(p + 8) ^ seed);
+					see1 = hash_mix(hash_read8(p + 16) ^ hash_secret(2), hash_read8(p + 24) ^ see1);
+					see2 = hash_mix(hash_read8(p + 32) ^ hash_secret(3), hash_read8(p + 40) ^ see2);
+					p += 48;
+					i -= 48;
+				} while (i >= 48);
+				seed ^= see1 ^ see2;
+			}
+			while (i > 16) {
+				seed = hash_mix(hash_read8(p) ^ hash_secret(1), hash_read8(p + 8) ^ seed);
+				i -= 16;
+				p += 16;
+			}
+			// 最后 16 个字节和前面可能重叠，也就不需要按字节处理尾巴
+			a = hash_read8(p + i - 16);
+			b = hash_read8(p + i - 8);
+		}
+		a ^= hash_secret(1);
+		b ^= seed;
+		hash_mum(a, b);
+		return hash_mix(a ^ hash_secret(0) ^ len, b ^ hash_secret(1));
+	}
+
+	// 32 位平台上 size_t 放不下 64 位结果，把高位折叠进来
+	inline size_t hash_fold(std::uint64_t h) noexcept
+	{
+		return static_cast<size_t>(h ^ (h >> 32));
+	}
+
+
 	template <class Key>
 	struct hash {};
 
 
+	// 指针按对齐总是低几位为 0，直接用地址做 hash 会集中在少数桶里
 	template <class T>
 	struct hash<T*> 
 	{
 		size_t operator()(T* p) const noexcept
 		{
-			return reinterpret_cast<size_t>(p);
+			return hash_fold(hash_mix(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p))));
 		}
 	};
 
 
-#define MYSTL_TRIVIAL_HASH_FCN(Type)         \
-template <> struct hash<Type>                \
-{                                            \
-  size_t operator()(Type val) const noexcept \
-  { return static_cast<size_t>(val); }       \
+	// 整数不再直接返回自身，恒等映射在桶数为 2 的幂的表里会严重聚集
+#define MYSTL_TRIVIAL_HASH_FCN(Type)                                      \
+template <> struct hash<Type>                                             \
+{                                                                         \
+  size_t operator()(Type val) const noexcept                              \
+  { return hash_fold(hash_mix(static_cast<std::uint64_t>(val))); }        \
 };
 
 
@@ -238,45 +401,68 @@ template <> struct hash<Type>                \
 
 	inline size_t bitwise_hash(const unsigned char* first, size_t count)
 	{
-#if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) && __SIZEOF_POINTER__ == 8)
-		const size_t fnv_offset = 14695981039346656037ull;
-		const size_t fnv_prime = 1099511628211ull;
-
-#else
-		const size_t fnv_offset = 2166136261u;
-		const size_t fnv_prime = 16777619u;
-
-#endif
-
-		size_t result = fnv_offset;
-		for (size_t i = 0; i < count; i++) {
-
-			result ^= (size_t)first[i];
-			result *= fnv_prime;
-		}
-
-		return result;
+		return hash_fold(hash_bytes(first, count));
 	}
 		
 
 	template <>
 	struct hash<float>
 	{
-		size_t operator()(const float& val) { return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(float)); }
+		size_t operator()(const float& val) const noexcept { return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(float)); }
 	};
 
 
 	template <>
 	struct hash<double>
 	{
-		size_t operator()(const double& val) { return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(double)); }
+		size_t operator()(const double& val) const noexcept { return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(double)); }
 	};
 
 
 	template <>
 	struct hash<long double>
 	{
-		size_t operator()(const long double& val) { return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(long double)); }
+		size_t operator()(const long double& val) const noexcept { return val == 0.0f ? 0 : bitwise_hash((const unsigned char*)&val, sizeof(long double)); }
+	};
+
+
+	// 把 value 的 hash 合并进 seed，用来给 pair、多个字段组成的 key 算 hash
+	// 先加上黄金分割数再整体打散，(a, b) 和 (b, a) 的结果不同
+	template <class T>
+	void hash_combine(size_t& seed, const T& value)
+	{
+		seed = hash_fold(hash_mix(static_cast<std::uint64_t>(seed) + 0x9e3779b97f4a7c15ull +
+			static_cast<std::uint64_t>(hash<T>()(value))));
+	}
+
+	inline void hash_values_imp(size_t&) {}
+
+	template <class T, class ...Rest>
+	void hash_values_imp(size_t& seed, const T& value, const Rest& ...rest)
+	{
+		hash_combine(seed, value);
+		hash_values_imp(seed, rest...);
+	}
+
+	// 依次合并多个值的 hash，可以直接用来给 tuple 或者结构体写 hash
+	template <class ...Args>
+	size_t hash_values(const Args& ...args)
+	{
+		size_t seed = 0;
+		hash_values_imp(seed, args...);
+		return seed;
+	}
+
+	template <class T1, class T2>
+	class pair;
+
+	template <class T1, class T2>
+	struct hash<mystl::pair<T1, T2>>
+	{
+		size_t operator()(const mystl::pair<T1, T2>& p) const
+		{
+			return hash_values(p.first, p.second);
+		}
 	};
 }
 
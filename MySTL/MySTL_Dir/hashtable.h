@@ -1,7 +1,12 @@
 #ifndef MYSTL_HASHTABLE_H
 #define MYSTL_HASHTABLE_H
 
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <initializer_list>
+#include <memory>
+#include <thread>
 
 #include "algo.h"
 #include "functional.h"
@@ -9,6 +14,7 @@
 #include "vector.h"
 #include "util.h"
 #include "exceptdef.h"
+#include "node_handle.h"
 
 namespace mystl {
 
@@ -30,7 +36,7 @@ namespace mystl {
 		}
 	};
 
-	//  iterator һƣ pair
+	// 和 iterator 中一样的设计，特例化 pair
 	template <class T, bool>
 	struct ht_value_traits_imp
 	{
@@ -56,7 +62,7 @@ namespace mystl {
 	template <class T>
 	struct ht_value_traits_imp<T, true>
 	{
-		// remove_cv ȥ type е const  volatile ؼ
+		// remove_cv 去除 type 中的 const 和 volatile 关键字
 		typedef typename std::remove_cv<typename T::first_type>::type	key_type;
 		typedef typename T::second_type	mapped_type;
 		typedef T	value_type;
@@ -99,7 +105,7 @@ namespace mystl {
 
 	};
 
-	// 
+	// 声明
 	template <class T, class HashFun, class KeyEqual>
 	class hashtable;
 
@@ -115,7 +121,7 @@ namespace mystl {
 	template <class T>
 	struct ht_const_local_iterator;
 
-	//  hash ĵ
+	// 这个是 hash 表上数组的迭代器
 	template <class T, class Hash, class KeyEqual>
 	struct ht_iterator_base: public mystl::iterator<mystl::forward_iterator_tag, T>
 	{
@@ -169,7 +175,11 @@ namespace mystl {
 
 		ht_iterator() = default;
 
-		ht_iterator(node_ptr n, contain_ptr t) : node(n), ht(t) {}
+		ht_iterator(node_ptr n, contain_ptr t)
+		{
+			node = n;
+			ht = t;
+		}
 
 		ht_iterator(const iterator& rhs)
 		{
@@ -218,8 +228,8 @@ namespace mystl {
 			node = node->next;
 			if (node == nullptr) {
 				auto idx = ht->hash(value_traits::get_key(old->value));
-				while (node == nullptr && ++idx < ht->mBucketSize) {
-					node = ht->mBucket[idx];
+				while (node == nullptr && ++idx < ht->m_Bucket_Size) {
+					node = ht->m_Bucket[idx];
 				}
 			}
 			return *this;
@@ -236,7 +246,7 @@ namespace mystl {
 
 
 	template <class T, class Hash, class KeyEqual>
-	struct ht_cosnt_iterator : public ht_iterator_base<T, Hash, KeyEqual>
+	struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual>
 	{
 		typedef ht_iterator_base<T, Hash, KeyEqual> base;
 		typedef typename base::hashtable			hashtable;
@@ -253,17 +263,21 @@ namespace mystl {
 		using base::node;
 		using base::ht;
 
-		ht_cosnt_iterator() = default;
+		ht_const_iterator() = default;
 
-		ht_cosnt_iterator(node_ptr n, contain_ptr t) : node(n), ht(t) {}
+		ht_const_iterator(node_ptr n, contain_ptr t)
+		{
+			node = n;
+			ht = t;
+		}
 
-		ht_cosnt_iterator(const iterator& rhs)
+		ht_const_iterator(const iterator& rhs)
 		{
 			node = rhs.node;
 			ht = rhs.ht;
 		}
 
-		ht_cosnt_iterator(const const_iterator& rhs)
+		ht_const_iterator(const const_iterator& rhs)
 		{
 			node = rhs.node;
 			ht = rhs.ht;
@@ -297,30 +311,30 @@ namespace mystl {
 			return &(operator*());
 		}
 
-		iterator& operator++()
+		const_iterator& operator++()
 		{
 			MYSTL_DEBUG(node != nullptr);
 			const node_ptr old = node;
 			node = node->next;
 			if (node == nullptr) {
 				auto idx = ht->hash(value_traits::get_key(old->value));
-				while (node == nullptr && ++idx < ht->mBucketSize) {
-					node = ht->mBucket[idx];
+				while (node == nullptr && ++idx < ht->m_Bucket_Size) {
+					node = ht->m_Bucket[idx];
 				}
 			}
 			return *this;
 		}
 
-		iterator operator++(int)
+		const_iterator operator++(int)
 		{
-			iterator tmp = *this;
+			const_iterator tmp = *this;
 			++* this;
 			return tmp;
 		}
 
 	};
 
-	// ĵ
+	// 这个是链表的迭代器
 	template <class T>
 	struct ht_local_iterator : public mystl::iterator<mystl::forward_iterator_tag, T>
 	{
@@ -398,7 +412,7 @@ namespace mystl {
 
 		ht_const_local_iterator(node_ptr n) : node(n) {}
 
-		ht_const_local_iterator(const ht_local_iterator& rhs) : node(rhs.node) {}
+		ht_const_local_iterator(const local_iterator& rhs) : node(rhs.node) {}
 
 		ht_const_local_iterator(const ht_const_local_iterator& rhs) : node(rhs.node) {}
 
@@ -437,7 +451,7 @@ namespace mystl {
 		}
 	};
 
-	// ȷĸγ
+	// 用来确定是哪个编译器来编译这段程序
 #if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) && __SIZEOF_POINTER__ == 8)
 #define SYSTEM_64 1
 #else
@@ -493,6 +507,27 @@ namespace mystl {
 		return pos == last ? *(last - 1) : *pos;
 	}
 
+	// hashtable::stats() 的结果，用来判断慢是因为 hash 分布不好还是负载因子太高
+	struct hashtable_stats
+	{
+		static constexpr size_t histogram_size = 16;
+
+		size_t size;
+		size_t bucket_count;
+		size_t empty_buckets;
+		size_t max_chain;
+		// chain_histogram[i] 为链长等于 i 的桶的个数，最后一格统计所有链长 >= histogram_size - 1 的桶
+		size_t chain_histogram[histogram_size];
+		float load_factor;
+		float max_load_factor;
+		float empty_bucket_ratio;
+		// 查找一个存在的元素平均要比较的次数，hash 分布均匀时约为 1 + load_factor / 2
+		double average_probe;
+		size_t node_bytes;
+		size_t bucket_bytes;
+		size_t rehash_count;
+	};
+
 	template <class T, class Hash, class KeyEqual>
 	class hashtable
 	{
@@ -510,6 +545,8 @@ namespace mystl {
 
 		using node_type		= hashtable_node<T>;
 		using node_ptr		= hashtable_node<T>*;
+		// node_type 已经是节点本身的类型，所以节点句柄叫 node_handle_type
+		using node_handle_type = mystl::node_handle<node_type, value_type>;
 		using bucket_type	= mystl::vector<node_ptr>;
 
 		using allocator_type = mystl::allocator<T>;
@@ -532,30 +569,60 @@ namespace mystl {
 
 	private:
 
+		// 批量查找时每组 key 的个数，太大了预取的 cache line 会互相挤掉
+		static constexpr size_type batch_group = 16;
+
+		// 区间至少有这么多个元素才整块分配节点
+		static constexpr size_type bulk_min_size = 32;
+
+		// 并行构建和并行 rehash 时每个线程至少分到这么多个元素，太少了开线程的开销比省下的还多
+		static constexpr size_type parallel_min_size = 16384;
+
 		bucket_type m_Bucket;
 		size_type	m_Bucket_Size;
 		size_type	m_Size;
 		float		m_Mlf;
+		// 桶数组被替换的次数，只用于 stats()
+		size_type	m_Rehash_Count;
 		hasher		m_Hash;
 		key_equal	m_Equal;
 
+		// 批量插入和拷贝时节点是一次分配的一整块，块里的节点不能单独释放
+		// 释放后挂在所在块自己的空闲链表上 (用 next 串起来) 给 create_node 复用，
+		// 块里的节点全部释放之后整块还回去
+		// 有空闲节点的块用 next_free / prev_free 串成双向链表，create_node 从链表头取
+		struct node_block
+		{
+			node_ptr	first;
+			size_type	count;
+			// 还在用的节点个数，包括在表里的和正在构造的
+			size_type	live;
+			node_ptr	free;
+			node_block* next_free;
+			node_block* prev_free;
+		};
+		using block_allocator = mystl::allocator<node_block>;
+
+		// 按 first 的地址排序，free_node 二分查找节点在哪个块里
+		mystl::vector<node_block*> m_Blocks;
+		node_block* m_Free_Blocks;
+		// 所有块里空闲节点的总数
+		size_type	m_Free_Count;
+
 		
 	private:
 
-		bool is_equal(const key_type& lhs, const key_type& rhs)
-		{
-			return m_Equal(lhs, rhs);
-		}
-
-		bool is_equal(const key_type& lhs, const key_type& rhs) const
+		// 写成模板是为了异构查找时可以直接拿 K 和 key_type 比较，不用先构造出 key_type
+		template <class K1, class K2>
+		bool is_equal(const K1& lhs, const K2& rhs) const
 		{
 			return m_Equal(lhs, rhs);
 		}
 
 		const_iterator M_cit(node_ptr node) const noexcept
 		{
-			// Ҫ const_cast Ϊ const Ļ
-			// ô this һ const hashtalbe*
+			// 这里要用 const_cast 是因为如果是 const 变量调用它的话
+			// 那么 this 会是一个 const hashtalbe*
 			return const_iterator(node, const_cast<hashtable*>(this));
 		}
 
@@ -585,7 +652,7 @@ namespace mystl {
 		explicit hashtable(size_type bucket_cnt,
 			const Hash& hash = Hash(),
 			const KeyEqual& equal = KeyEqual())
-			: m_Size(0), m_Mlf(1.0f), m_Hash(hash), m_Equal(equal)
+			: m_Size(0), m_Mlf(1.0f), m_Rehash_Count(0), m_Hash(hash), m_Equal(equal), m_Free_Blocks(nullptr), m_Free_Count(0)
 		{
 			init(bucket_cnt);
 		}
@@ -595,12 +662,14 @@ namespace mystl {
 		hashtable(Iter first, Iter last, size_type bucket_cnt,
 			const Hash& hash = Hash(),
 			const KeyEqual& equal = KeyEqual())
-			: m_Size(mystl::distance(first, last)), m_Mlf(1.0f), m_Hash(hash), m_Equal(equal)
+			: m_Size(0), m_Mlf(1.0f), m_Rehash_Count(0), m_Hash(hash), m_Equal(equal), m_Free_Blocks(nullptr), m_Free_Count(0)
 		{
+			// 只按区间长度准备桶，元素由外层按 unique 或 multi 插入
 			init(mystl::max(bucket_cnt, static_cast<size_type>(mystl::distance(first, last))));
 		}
 
 		hashtable(const hashtable& rhs)
+			: m_Mlf(rhs.m_Mlf), m_Hash(rhs.m_Hash), m_Equal(rhs.m_Equal), m_Free_Blocks(nullptr), m_Free_Count(0)
 		{
 			copy_init(rhs);
 		}
@@ -609,13 +678,20 @@ namespace mystl {
 			: m_Bucket_Size(rhs.m_Bucket_Size)
 			, m_Size(rhs.m_Size)
 			, m_Mlf(rhs.m_Mlf)
+			, m_Rehash_Count(rhs.m_Rehash_Count)
 			, m_Hash(rhs.m_Hash)
 			, m_Equal(rhs.m_Equal)
+			, m_Blocks(mystl::move(rhs.m_Blocks))
+			, m_Free_Blocks(rhs.m_Free_Blocks)
+			, m_Free_Count(rhs.m_Free_Count)
 		{
 			m_Bucket = mystl::move(rhs.m_Bucket);
+			rhs.m_Free_Blocks = nullptr;
+			rhs.m_Free_Count = 0;
 			rhs.m_Bucket_Size = 0;
 			rhs.m_Size = 0;
 			rhs.m_Mlf = 0.0f;
+			rhs.m_Rehash_Count = 0;
 		}
 
 		~hashtable()
@@ -627,7 +703,7 @@ namespace mystl {
 		{
 			if (this != &rhs) {
 				hashtable tmp(rhs);
-				swap(rhs);
+				swap(tmp);
 			}
 			return *this;
 		}
@@ -635,7 +711,7 @@ namespace mystl {
 		hashtable& operator=(hashtable&& rhs) noexcept
 		{
 			hashtable tmp(mystl::move(rhs));
-			swap(rhs);
+			swap(tmp);
 			return *this;
 		}
 
@@ -656,10 +732,10 @@ namespace mystl {
 
 		const_iterator	end() const noexcept
 		{
-			return iterator(nullptr, this);
+			return M_cit(nullptr);
 		}
 
-		// const ֻܵ const 
+		// const 函数只能调用 const 函数
 		const_iterator	cbegin() const noexcept
 		{
 			return begin();
@@ -690,7 +766,7 @@ namespace mystl {
 		{
 			node_ptr np = create_node(mystl::forward<Args>(args)...);
 			try {
-				// Ԫظ +1 Ͱ * ϣӣùϣӼСײ
+				// 如果元素个数 +1 大于桶个数 * 哈希因子，重新设置哈希因子减小碰撞
 				if ((float)(m_Size + 1) > (float)m_Bucket_Size * max_load_factor()) {
 					rehash(m_Size + 1);
 				}
@@ -707,7 +783,7 @@ namespace mystl {
 		{
 			node_ptr np = create_node(mystl::forward<Args>(args)...);
 			try {
-				// Ԫظ +1 Ͱ * ϣӣùϣӼСײ
+				// 如果元素个数 +1 大于桶个数 * 哈希因子，重新设置哈希因子减小碰撞
 				if ((float)(m_Size + 1) > (float)m_Bucket_Size * max_load_factor()) {
 					rehash(m_Size + 1);
 				}
@@ -716,7 +792,11 @@ namespace mystl {
 				destroy_node(np);
 				throw;
 			}
-			return insert_node_unique(np);
+			pair<iterator, bool> result = insert_node_unique(np);
+			if (!result.second) {
+				destroy_node(np);
+			}
+			return result;
 		}
 
 		iterator insert_multi_noresize(const value_type& value)
@@ -725,7 +805,7 @@ namespace mystl {
 			node_ptr first = m_Bucket[n];
 			node_ptr np = create_node(value);
 			for (node_ptr cur = first; cur != nullptr; cur = cur->next) {
-				// ȵľͲһ,Ȼͷ
+				// 如果存在相等的就插入让它们在一起,不然丢到链表头
 				if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value))) {
 					np->next = cur->next;
 					cur->next = np;
@@ -734,19 +814,19 @@ namespace mystl {
 				}
 			}
 			np->next = m_Bucket[n];
-			m_Bucket = np;
+			m_Bucket[n] = np;
 			++m_Size;
 			return iterator(np, this);
 		}
 		
 		pair<iterator, bool> insert_unique_noresize(const value_type& value)
 		{
-			// ϣҳ±
+			// 计算哈希找出它的下标
 			const size_type n = hash(value_traits::get_key(value));
 			node_ptr first = m_Bucket[n];
-			// ͰĬǴС
+			// 桶的默认排序是大的在下小的在上
 			for (node_ptr cur = first; cur != nullptr; cur = cur->next) {
-				// к value ȵľ false صǰλ
+				// 如果有和 value 相等的就输出 false 并返回当前位置
 				if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value))) {
 					return mystl::make_pair(iterator(cur, this), false);
 				}
@@ -755,7 +835,7 @@ namespace mystl {
 			np->next = first;
 			m_Bucket[n] = np;
 			++m_Size;
-			// true  false ϣǷѾиԪ
+			// true 和 false 哈希表中是否已经有该元素
 			return mystl::make_pair<iterator, bool>(iterator(np, this), true);
 		}
 
@@ -795,6 +875,100 @@ namespace mystl {
 			copy_insert_unique(first, last, mystl::iterator_category(first));
 		}
 
+		// 节点句柄：extract 把节点从桶里摘下来交给句柄，insert 再把它挂到另一个表上
+		// 整个过程只改 next 指针，不会分配或释放节点，元素也不会被拷贝
+		// 例外是批量插入和拷贝构造时整块分配的节点，它们要先把元素移动到单独分配的节点上再交出去，
+		// 这时 extract 会分配一次内存，元素要支持移动，之前拿到的指向这个元素的指针和引用也会失效
+		node_handle_type extract(const_iterator pos)
+		{
+			return node_handle_type(extract_node(pos.node));
+		}
+
+		node_handle_type extract(const key_type& key)
+		{
+			return node_handle_type(extract_node(find_node(key)));
+		}
+
+		// key 已经存在时不插入，节点仍然留在 nh 里
+		pair<iterator, bool> insert_unique(node_handle_type&& nh)
+		{
+			if (nh.empty()) {
+				return mystl::make_pair(end(), false);
+			}
+			rehash_if_need(1);
+			pair<iterator, bool> result = insert_node_unique(nh.get());
+			if (result.second) {
+				nh.release();
+			}
+			return result;
+		}
+
+		iterator insert_multi(node_handle_type&& nh)
+		{
+			if (nh.empty()) {
+				return end();
+			}
+			rehash_if_need(1);
+			return insert_node_multi(nh.release());
+		}
+
+		// 把 other 的节点全部转移过来，key 已经存在的节点留在 other 里
+		// 单独分配的节点直接重新挂链；other 里整块分配的节点和 extract 一样要分配新节点并移动元素
+		void merge_unique(hashtable& other)
+		{
+			if (this == &other || other.m_Size == 0) {
+				return;
+			}
+			rehash_if_need(other.m_Size);
+			for (size_type i = 0; i < other.m_Bucket_Size; ++i) {
+				node_ptr prev = nullptr;
+				node_ptr cur = other.m_Bucket[i];
+				while (cur != nullptr) {
+					node_ptr next = cur->next;
+					if (find_node(value_traits::get_key(cur->value)) != nullptr) {
+						prev = cur;
+					}
+					else {
+						node_ptr moved = other.own_node(cur);
+						if (prev == nullptr) {
+							other.m_Bucket[i] = next;
+						}
+						else {
+							prev->next = next;
+						}
+						--other.m_Size;
+						if (moved != cur) {
+							other.destroy_node(cur);
+						}
+						moved->next = nullptr;
+						insert_node_unique(moved);
+					}
+					cur = next;
+				}
+			}
+		}
+
+		void merge_multi(hashtable& other)
+		{
+			if (this == &other || other.m_Size == 0) {
+				return;
+			}
+			rehash_if_need(other.m_Size);
+			for (size_type i = 0; i < other.m_Bucket_Size; ++i) {
+				while (other.m_Bucket[i] != nullptr) {
+					node_ptr cur = other.m_Bucket[i];
+					node_ptr moved = other.own_node(cur);
+					other.m_Bucket[i] = cur->next;
+					--other.m_Size;
+					if (moved != cur) {
+						other.destroy_node(cur);
+					}
+					moved->next = nullptr;
+					insert_node_multi(moved);
+				}
+			}
+		}
+
 		void erase(const_iterator pos)
 		{
 			node_ptr p = pos.node;
@@ -854,43 +1028,28 @@ namespace mystl {
 
 		size_type erase_multi(const key_type& key)
 		{
-			// ɾеĺ key ͬ node ,ɾ˶ٸ
-			auto p = equal_range_multi(key);
-			if (p.first.node != nullptr) {
-				erase(p.first, p.second);
-				return mystl::distance(p.first, p.second);
-			}
-			return 0;
+			return erase_multi_key(key);
+		}
+
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type erase_multi(const K& key)
+		{
+			return erase_multi_key(key);
 		}
 
 		size_type erase_unique(const key_type& key)
 		{
-			const size_type n = hash(key);
-			node_ptr first = m_Bucket[n];
-			if (first != nullptr) {
-				if (is_equal(value_traits::get_key(first->value), key)) {
-					m_Bucket[n] = first->next;
-					destroy_node(first);
-					--m_Size;
-					return 1;
-				}
-				else {
-					node_ptr next = first->next;
-					while (next != nullptr) {
-						if (is_equal(value_traits::get_key(next->value), key)) {
-							m_Bucket[n] = first->next;
-							destroy_node(first);
-							--m_Size;
-							return 1;
-						}
-						else {
-							first = next;
-							next = first->next;
-						}
-					}
-				}
-			}
-			return 0;
+			return erase_unique_key(key);
+		}
+
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type erase_unique(const K& key)
+		{
+			return erase_unique_key(key);
 		}
 
 		void clear()
@@ -907,6 +1066,7 @@ namespace mystl {
 				}
 				m_Size = 0;
 			}
+			release_blocks();
 		}
 
 		void swap(hashtable& rhs) noexcept
@@ -916,118 +1076,177 @@ namespace mystl {
 				mystl::swap(m_Size, rhs.m_Size);
 				mystl::swap(m_Bucket_Size, rhs.m_Bucket_Size);
 				mystl::swap(m_Mlf, rhs.m_Mlf);
+				mystl::swap(m_Rehash_Count, rhs.m_Rehash_Count);
 				mystl::swap(m_Hash, rhs.m_Hash);
 				mystl::swap(m_Equal, rhs.m_Equal);
+				m_Blocks.swap(rhs.m_Blocks);
+				mystl::swap(m_Free_Blocks, rhs.m_Free_Blocks);
+				mystl::swap(m_Free_Count, rhs.m_Free_Count);
 			}
 		}
 
 		size_type count(const key_type& key) const
 		{
-			const size_type idx = hash(key);
-			size_type result = 0;
-			for (node_ptr cur = m_Bucket[idx]; cur != nullptr; cur = cur->next) {
-				if (is_equal(key, value_traits::get_key(cur->value))) {
-					++result;
-				}
-			}
-			return result;
+			return count_key(key);
+		}
+
+		// 异构查找：Hash 和 KeyEqual 都声明了 is_transparent 时
+		// 可以直接用能和 key 比较的类型 K 来查找，不需要先构造一个 key_type
+		// H 和 E 要写成默认模板参数，这样 enable_if 才依赖于函数模板自己的参数
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type count(const K& key) const
+		{
+			return count_key(key);
 		}
 
 		iterator find(const key_type& key)
 		{
-			const size_type n = hash(key);
-			node_ptr first = m_Bucket[n];
-			for(; first != nullptr && !is_equal(key, value_traits::get_key(first->value)); first = first->next) {}
-			return iterator(first, this);
+			return iterator(find_node(key), this);
 		}
 
-		// const ޷õ const 
+		// const 函数无法调用到非 const 函数
 		const_iterator find(const key_type& key) const
 		{
-			const size_type n = hash(key);
-			node_ptr first = m_Bucket[n];
-			for (; first != nullptr && !is_equal(key, value_traits::get_key(first->value)); first = first->next) {}
-			return M_cit(first);
+			return M_cit(find_node(key));
+		}
+
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		iterator find(const K& key)
+		{
+			return iterator(find_node(key), this);
+		}
+
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		const_iterator find(const K& key) const
+		{
+			return M_cit(find_node(key));
 		}
 
 		pair<iterator, iterator> equal_range_multi(const key_type& key)
 		{
-			const size_type n = hash(key);
-			for (node_ptr first = m_Bucket[n]; first != nullptr; first = first->next) {
-				if (is_equal(key, value_traits::get_key(first->value))) {
-					for (node_ptr second = first->next; second != nullptr; second = second->next) {
-						if (!is_equal(key, value_traits::get_key(second->value))) {
-							return make_pair(iterator(first, this), iterator(second, this));
-						}
-					}
-					for (size_type m = n + 1; m < m_Bucket_Size; m++) {
-						if (m_Bucket[m] != nullptr) {
-							return make_pair(iterator(first, this), iterator(m_Bucket[m], this));
-						}
-					}
-					return make_pair(iterator(first, this), end());
-				}
-			}
-			return make_pair(end(), end());
+			pair<node_ptr, node_ptr> p = range_multi(key);
+			return mystl::make_pair(iterator(p.first, this), iterator(p.second, this));
 		}
 
 		pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const
 		{
-			const size_type n = hash(key);
-			for (node_ptr first = m_Bucket[n]; first != nullptr; first = first->next) {
-				if (is_equal(key, value_traits::get_key(first->value))) {
-					for (node_ptr second = first->next; second != nullptr; second = second->next) {
-						if (!is_equal(key, value_traits::get_key(second->value))) {
-							return make_pair(M_cit(first), M_cit(second));
-						}
-					}
-					for (size_type m = n + 1; m < m_Bucket_Size; m++) {
-						if (m_Bucket[m] != nullptr) {
-							return make_pair(M_cit(first), M_cit(m_Bucket[m]));
-						}
-					}
-					return make_pair(M_cit(first), cend());
-				}
-			}
-			return make_pair(cend(), cend());
+			pair<node_ptr, node_ptr> p = range_multi(key);
+			return mystl::make_pair(M_cit(p.first), M_cit(p.second));
+		}
+
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<iterator, iterator> equal_range_multi(const K& key)
+		{
+			pair<node_ptr, node_ptr> p = range_multi(key);
+			return mystl::make_pair(iterator(p.first, this), iterator(p.second, this));
+		}
+
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<const_iterator, const_iterator> equal_range_multi(const K& key) const
+		{
+			pair<node_ptr, node_ptr> p = range_multi(key);
+			return mystl::make_pair(M_cit(p.first), M_cit(p.second));
 		}
 
 		pair<iterator, iterator> equal_range_unique(const key_type& key)
 		{
-			const size_type n = hash(key);
-			for (node_ptr first = m_Bucket[n]; first != nullptr; first = first->next) {
-				if (is_equal(key, value_traits::get_key(first->value))) {
-					if (first->next != nullptr) {
-						return make_pair(iterator(first, this), iterator(first->next, this));
-					}
-					for (size_type m = n + 1; m < m_Bucket_Size; ++m) {
-						if (m_Bucket[m] != nullptr) {
-							return make_pair(iterator(first, this), iterator(m_Bucket[m], this));
-						}
-					}
-					return make_pair(iterator(first, this), end());
-				}
-			}
-			return make_pair(end(), end());
+			pair<node_ptr, node_ptr> p = range_unique(key);
+			return mystl::make_pair(iterator(p.first, this), iterator(p.second, this));
 		}
 
 		pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const
 		{
-			const size_type n = hash(key);
-			for (node_ptr first = m_Bucket[n]; first != nullptr; first = first->next) {
-				if (is_equal(key, value_traits::get_key(first->value))) {
-					if (first->next != nullptr) {
-						return make_pair(M_cit(first), M_cit(first->next));
-					}
-					for (size_type m = n + 1; m < m_Bucket_Size; ++m) {
-						if (m_Bucket[m] != nullptr) {
-							return make_pair(M_cit(first), M_cit(m_Bucket[m]));
+			pair<node_ptr, node_ptr> p = range_unique(key);
+			return mystl::make_pair(M_cit(p.first), M_cit(p.second));
+		}
+
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<iterator, iterator> equal_range_unique(const K& key)
+		{
+			pair<node_ptr, node_ptr> p = range_unique(key);
+			return mystl::make_pair(iterator(p.first, this), iterator(p.second, this));
+		}
+
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<const_iterator, const_iterator> equal_range_unique(const K& key) const
+		{
+			pair<node_ptr, node_ptr> p = range_unique(key);
+			return mystl::make_pair(M_cit(p.first), M_cit(p.second));
+		}
+
+		// 批量查找，把第 i 个 key 的结果写到 out 的第 i 个位置
+		// 每次取一组 key，先把整组的 hash 算完并预取桶，再读桶头预取第一个节点，最后才比较
+		// 这样一组里的 cache miss 可以重叠在一起，而不是一个 find 接一个地等
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out)
+		{
+			node_ptr head[batch_group];
+			while (first != last) {
+				ForwardIter group = first;
+				size_type n = 0;
+				first = batch_prefetch(first, last, head, n);
+				for (size_type i = 0; i < n; ++i, ++group) {
+					node_ptr cur = head[i];
+					for (; cur != nullptr && !is_equal(*group, value_traits::get_key(cur->value)); cur = cur->next) {}
+					*out = iterator(cur, this);
+					++out;
+				}
+			}
+			return out;
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			node_ptr head[batch_group];
+			while (first != last) {
+				ForwardIter group = first;
+				size_type n = 0;
+				first = batch_prefetch(first, last, head, n);
+				for (size_type i = 0; i < n; ++i, ++group) {
+					node_ptr cur = head[i];
+					for (; cur != nullptr && !is_equal(*group, value_traits::get_key(cur->value)); cur = cur->next) {}
+					*out = M_cit(cur);
+					++out;
+				}
+			}
+			return out;
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter count_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			node_ptr head[batch_group];
+			while (first != last) {
+				ForwardIter group = first;
+				size_type n = 0;
+				first = batch_prefetch(first, last, head, n);
+				for (size_type i = 0; i < n; ++i, ++group) {
+					size_type result = 0;
+					for (node_ptr cur = head[i]; cur != nullptr; cur = cur->next) {
+						if (is_equal(*group, value_traits::get_key(cur->value))) {
+							++result;
 						}
 					}
-					return make_pair(M_cit(first), cend());
+					*out = result;
+					++out;
 				}
 			}
-			return make_pair(cend(), cend());
+			return out;
 		}
 
 		local_iterator begin(size_type n) noexcept
@@ -1054,13 +1273,13 @@ namespace mystl {
 			return nullptr;
 		}
 
-		const_local_iterator end(size_type n) noexcept
+		const_local_iterator end(size_type n) const noexcept
 		{
 			MYSTL_DEBUG(n < m_Size);
 			return nullptr;
 		}
 
-		const_local_iterator cend(size_type n) noexcept
+		const_local_iterator cend(size_type n) const noexcept
 		{
 			MYSTL_DEBUG(n < m_Size);
 			return nullptr;
@@ -1076,7 +1295,7 @@ namespace mystl {
 			return ht_prime_list[PRIME_NUM - 1];
 		}
 
-		// ±Ϊ idx µԪ
+		// 返回下标为 idx 下的元素数量
 		size_type bucket_size(size_type idx) const noexcept
 		{
 			size_type result = 0;
@@ -1091,34 +1310,86 @@ namespace mystl {
 			return hash(key);
 		}
 
-		// ײ  m_Bucket_Size С m_Size һײ
+		// 碰撞几率 如果 m_Bucket_Size 小于 m_Size 则一定会碰撞
 		float load_factor() const noexcept
 		{
 			return m_Bucket_Size != 0 ? (float)m_Size / m_Bucket_Size : 0.0f;
 		}
 
-		// ײ
+		// 最大碰撞几率
 		float max_load_factor() const noexcept
 		{
 			return m_Mlf;
 		}
 
+		// 遍历所有的桶统计链长，O(bucket_count + size)
+		hashtable_stats stats() const noexcept
+		{
+			hashtable_stats result = {};
+			size_type probes = 0;
+			for (size_type i = 0; i < m_Bucket_Size; ++i) {
+				size_type len = 0;
+				for (node_ptr cur = m_Bucket[i]; cur != nullptr; cur = cur->next) {
+					++len;
+				}
+				// 链上第 k 个元素要比较 k 次才能找到
+				probes += len * (len + 1) / 2;
+				if (len == 0) {
+					++result.empty_buckets;
+				}
+				if (len > result.max_chain) {
+					result.max_chain = len;
+				}
+				++result.chain_histogram[len < hashtable_stats::histogram_size ? len : hashtable_stats::histogram_size - 1];
+			}
+			result.size = m_Size;
+			result.bucket_count = m_Bucket_Size;
+			result.load_factor = load_factor();
+			result.max_load_factor = max_load_factor();
+			result.empty_bucket_ratio = m_Bucket_Size != 0 ? (float)result.empty_buckets / m_Bucket_Size : 0.0f;
+			result.average_probe = m_Size != 0 ? (double)probes / m_Size : 0.0;
+			// 块里空闲的节点还占着内存，也要算进去
+			result.node_bytes = (m_Size + m_Free_Count) * sizeof(node_type) + m_Blocks.size() * sizeof(node_block);
+			result.bucket_bytes = m_Bucket_Size * sizeof(node_ptr);
+			result.rehash_count = m_Rehash_Count;
+			return result;
+		}
+
 		void rehash(size_type cnt)
 		{
-			// rehash ͰҲԼСͰ
+			// rehash 可以增大桶个数也可以减小桶个数
 			size_type n = ht_next_prime(cnt);
-			// ͰھͰĸ,µͰ
-			if (n > m_Bucket_Size) {
+			if (need_replace(n)) {
 				replace_bucket(n);
 			}
-			else {
-				if (((float)m_Size / (float)n < max_load_factor() - 0.25f) &&
-					((float)n < (float)m_Bucket_Size * 0.75f)) {
-					replace_bucket(n);
-				}
+		}
+
+		// 和 rehash 一样决定新的桶数，重新挂节点的工作分给 threads 个线程，threads 为 0 时按 CPU 核数
+		void parallel_rehash(size_type cnt, size_type threads = 0)
+		{
+			size_type n = ht_next_prime(cnt);
+			if (need_replace(n)) {
+				parallel_replace_bucket(n, worker_count(threads, m_Size));
 			}
 		}
 
+		// 多线程把 [first, last) 插入表中，结果和 insert_unique(first, last) 一样，
+		// 区间里重复的 key 保留先出现的那个
+		// 第一步每个线程在自己那一段输入上构造节点，按目标桶分给负责那段桶的线程；
+		// 第二步每个线程只往自己负责的桶里挂节点，桶互不重叠所以不用加锁
+		// 要求 hasher 和 key_equal 可以多线程同时调用且不抛异常
+		template <class RandomIter>
+		void parallel_build_unique(RandomIter first, RandomIter last, size_type threads = 0)
+		{
+			parallel_build(first, last, threads, true);
+		}
+
+		template <class RandomIter>
+		void parallel_build_multi(RandomIter first, RandomIter last, size_type threads = 0)
+		{
+			parallel_build(first, last, threads, false);
+		}
+
 		void reserve(size_type count)
 		{
 			rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f));
@@ -1154,37 +1425,43 @@ namespace mystl {
 		void	copy_init(const hashtable& ht)
 		{
 			m_Bucket_Size = 0;
+			m_Rehash_Count = 0;
 			m_Bucket.reserve(ht.m_Bucket_Size);
 			m_Bucket.assign(ht.m_Bucket_Size, nullptr);
+			m_Bucket_Size = ht.m_Bucket_Size;
+			m_Size = 0;
+			// 所有节点一次分配，按原来的顺序依次拷贝到块里
+			node_ptr block = ht.m_Size != 0 ? new_block(ht.m_Size) : nullptr;
 			try {
 				for (size_type i = 0; i < ht.m_Bucket_Size; i++) {
-					node_ptr cur = ht.m_Bucket[i];
-					if (cur != nullptr) {
-						node_ptr np = create_node(cur->value);
-						m_Bucket[i] = np;
-						for (node_ptr next = cur->next; next != nullptr; cur = next, next = cur->next) {
-							np->next = create_node(next->value);
-							np = np->next;
-						}
+					node_ptr* tail = &m_Bucket[i];
+					for (node_ptr cur = ht.m_Bucket[i]; cur != nullptr; cur = cur->next) {
+						node_ptr np = block + m_Size;
+						data_allocator::construct(mystl::address_of(np->value), cur->value);
 						np->next = nullptr;
+						*tail = np;
+						tail = &np->next;
+						++m_Size;
 					}
 				}
 			}
 			catch (...) {
 				clear();
+				throw;
 			}
 		}
 
+		// 有空闲的块内节点时优先复用
 		template <class ...Args>
 		node_ptr	create_node(Args&& ...args)
 		{
-			node_ptr tmp = node_allocator::allocate(1);
+			node_ptr tmp = m_Free_Blocks != nullptr ? take_free() : node_allocator::allocate(1);
 			try {
 				data_allocator::construct(mystl::address_of(tmp->value), mystl::forward<Args>(args)...);
 				tmp->next = nullptr;
 			}
 			catch (...) {
-				node_allocator::deallocate(tmp);
+				free_node(tmp);
 				throw;
 			}
 			return tmp;
@@ -1192,9 +1469,167 @@ namespace mystl {
 
 		void	destroy_node(node_ptr np)
 		{
-			data_allocator::destroy(np->value);
-			node_allocator::deallocate(np);
-			np = nullptr;
+			data_allocator::destroy(mystl::address_of(np->value));
+			free_node(np);
+		}
+
+		// 只释放节点的内存，元素已经析构过了
+		// 块内的节点放回所在块的空闲链表，块里最后一个节点释放时整块还回去
+		void	free_node(node_ptr np) noexcept
+		{
+			const size_type i = find_block(np);
+			if (i == m_Blocks.size()) {
+				node_allocator::deallocate(np);
+				return;
+			}
+			node_block* b = m_Blocks[i];
+			if (--b->live == 0) {
+				if (b->free != nullptr) {
+					unlink_free_block(b);
+					m_Free_Count -= b->count - 1;
+				}
+				m_Blocks.erase(m_Blocks.begin() + i);
+				node_allocator::deallocate(b->first);
+				block_allocator::deallocate(b);
+				return;
+			}
+			if (b->free == nullptr) {
+				b->next_free = m_Free_Blocks;
+				b->prev_free = nullptr;
+				if (m_Free_Blocks != nullptr) {
+					m_Free_Blocks->prev_free = b;
+				}
+				m_Free_Blocks = b;
+			}
+			np->next = b->free;
+			b->free = np;
+			++m_Free_Count;
+		}
+
+		// 从第一个有空闲节点的块里取一个，调用前 m_Free_Blocks 不能为空
+		node_ptr	take_free() noexcept
+		{
+			node_block* b = m_Free_Blocks;
+			node_ptr np = b->free;
+			b->free = np->next;
+			++b->live;
+			--m_Free_Count;
+			if (b->free == nullptr) {
+				unlink_free_block(b);
+			}
+			return np;
+		}
+
+		void	unlink_free_block(node_block* b) noexcept
+		{
+			if (b->prev_free != nullptr) {
+				b->prev_free->next_free = b->next_free;
+			}
+			else {
+				m_Free_Blocks = b->next_free;
+			}
+			if (b->next_free != nullptr) {
+				b->next_free->prev_free = b->prev_free;
+			}
+		}
+
+		// np 所在块在 m_Blocks 里的下标，不在任何块里时返回 m_Blocks.size()
+		// 比较地址用 std::less，不相关的指针之间直接用 < 是未指定的
+		size_type	find_block(node_ptr np) const noexcept
+		{
+			std::less<node_ptr> less;
+			size_type lo = 0;
+			size_type hi = m_Blocks.size();
+			// 找最后一个 first <= np 的块
+			while (lo < hi) {
+				const size_type mid = lo + (hi - lo) / 2;
+				if (less(np, m_Blocks[mid]->first)) {
+					hi = mid;
+				}
+				else {
+					lo = mid + 1;
+				}
+			}
+			if (lo != 0 && less(np, m_Blocks[lo - 1]->first + m_Blocks[lo - 1]->count)) {
+				return lo - 1;
+			}
+			return m_Blocks.size();
+		}
+
+		bool	in_block(node_ptr np) const noexcept
+		{
+			return find_block(np) != m_Blocks.size();
+		}
+
+		// 分配 n 个节点的一整块，里面的节点全部算作在用，用不上的由调用者 free_node
+		node_ptr	new_block(size_type n)
+		{
+			node_ptr first = node_allocator::allocate(n);
+			node_block* b = nullptr;
+			try {
+				b = block_allocator::allocate(1);
+				*b = node_block{ first, n, n, nullptr, nullptr, nullptr };
+				std::less<node_ptr> less;
+				size_type pos = m_Blocks.size();
+				while (pos != 0 && less(first, m_Blocks[pos - 1]->first)) {
+					--pos;
+				}
+				m_Blocks.insert(m_Blocks.begin() + pos, b);
+			}
+			catch (...) {
+				if (b != nullptr) {
+					block_allocator::deallocate(b);
+				}
+				node_allocator::deallocate(first);
+				throw;
+			}
+			return first;
+		}
+
+		// 只在所有节点都已经析构之后调用，这时块里的节点都在空闲链表上
+		void	release_blocks() noexcept
+		{
+			for (size_type i = 0; i < m_Blocks.size(); ++i) {
+				node_allocator::deallocate(m_Blocks[i]->first);
+				block_allocator::deallocate(m_Blocks[i]);
+			}
+			m_Blocks.clear();
+			m_Free_Blocks = nullptr;
+			m_Free_Count = 0;
+		}
+
+		// 要把 np 交给别的容器时调用：块内的节点把元素移动到一个单独分配的新节点上返回，
+		// 原节点不动，由调用者摘下来之后再 destroy_node；其它节点直接返回自己
+		node_ptr	own_node(node_ptr np)
+		{
+			if (!in_block(np)) {
+				return np;
+			}
+			node_ptr tmp = node_allocator::allocate(1);
+			try {
+				data_allocator::construct(mystl::address_of(tmp->value), mystl::move(np->value));
+				tmp->next = nullptr;
+			}
+			catch (...) {
+				node_allocator::deallocate(tmp);
+				throw;
+			}
+			return tmp;
+		}
+
+		node_ptr	extract_node(node_ptr np)
+		{
+			if (np == nullptr) {
+				return nullptr;
+			}
+			// 桶号要在 own_node 之前算，块内节点的元素会被移走，之后再 hash 用的就是移动后的空值
+			const size_type n = hash(value_traits::get_key(np->value));
+			node_ptr moved = own_node(np);
+			unlink_node(np, n);
+			if (moved != np) {
+				destroy_node(np);
+			}
+			return moved;
 		}
 
 		size_type	next_size(size_type n) const
@@ -1202,21 +1637,197 @@ namespace mystl {
 			return ht_next_prime(n);
 		}
 
-		size_type	hash(const key_type& key, size_type n) const
+		// 新桶数比原来多就一定换，比原来少时只有负载因子足够低、并且能省下足够多的桶才换
+		bool	need_replace(size_type n) const
+		{
+			if (n > m_Bucket_Size) {
+				return true;
+			}
+			return ((float)m_Size / (float)n < max_load_factor() - 0.25f) &&
+				((float)n < (float)m_Bucket_Size * 0.75f);
+		}
+
+		template <class K>
+		size_type	hash(const K& key, size_type n) const
 		{
 			return m_Hash(key) % n;
 		}
 
-		size_type	hash(const key_type& key) const
+		template <class K>
+		size_type	hash(const K& key) const
 		{
 			return m_Hash(key) % m_Bucket_Size;
 		}
 
+		// 下面几个是查找和删除的实现，K 为 key_type 或者异构查找时的任意可比较类型
+
+		template <class K>
+		node_ptr find_node(const K& key) const
+		{
+			node_ptr first = m_Bucket[hash(key)];
+			for (; first != nullptr && !is_equal(key, value_traits::get_key(first->value)); first = first->next) {}
+			return first;
+		}
+
+		template <class K>
+		size_type count_key(const K& key) const
+		{
+			size_type result = 0;
+			for (node_ptr cur = m_Bucket[hash(key)]; cur != nullptr; cur = cur->next) {
+				if (is_equal(key, value_traits::get_key(cur->value))) {
+					++result;
+				}
+			}
+			return result;
+		}
+
+		// 返回第一个等于 key 的节点之后的第一个节点，nullptr 表示 end()
+		node_ptr next_node(node_ptr np, size_type n) const
+		{
+			if (np->next != nullptr) {
+				return np->next;
+			}
+			for (size_type m = n + 1; m < m_Bucket_Size; ++m) {
+				if (m_Bucket[m] != nullptr) {
+					return m_Bucket[m];
+				}
+			}
+			return nullptr;
+		}
+
+		// 相等的元素在链表里是挨在一起的，找不到时返回 (nullptr, nullptr) 即 (end(), end())
+		template <class K>
+		pair<node_ptr, node_ptr> range_multi(const K& key) const
+		{
+			const size_type n = hash(key);
+			for (node_ptr first = m_Bucket[n]; first != nullptr; first = first->next) {
+				if (is_equal(key, value_traits::get_key(first->value))) {
+					node_ptr last = first;
+					while (last->next != nullptr && is_equal(key, value_traits::get_key(last->next->value))) {
+						last = last->next;
+					}
+					return mystl::make_pair(first, next_node(last, n));
+				}
+			}
+			return pair<node_ptr, node_ptr>(nullptr, nullptr);
+		}
+
+		template <class K>
+		pair<node_ptr, node_ptr> range_unique(const K& key) const
+		{
+			const size_type n = hash(key);
+			for (node_ptr first = m_Bucket[n]; first != nullptr; first = first->next) {
+				if (is_equal(key, value_traits::get_key(first->value))) {
+					return mystl::make_pair(first, next_node(first, n));
+				}
+			}
+			return pair<node_ptr, node_ptr>(nullptr, nullptr);
+		}
+
+		template <class K>
+		size_type erase_multi_key(const K& key)
+		{
+			// 删除所有的和 key 相同的 node ,并返回删除了多少个
+			const size_type n = hash(key);
+			size_type result = 0;
+			node_ptr prev = nullptr;
+			node_ptr cur = m_Bucket[n];
+			while (cur != nullptr) {
+				if (is_equal(key, value_traits::get_key(cur->value))) {
+					node_ptr next = cur->next;
+					if (prev == nullptr) {
+						m_Bucket[n] = next;
+					}
+					else {
+						prev->next = next;
+					}
+					destroy_node(cur);
+					--m_Size;
+					++result;
+					cur = next;
+				}
+				else if (result != 0) {
+					break;
+				}
+				else {
+					prev = cur;
+					cur = cur->next;
+				}
+			}
+			return result;
+		}
+
+		template <class K>
+		size_type erase_unique_key(const K& key)
+		{
+			const size_type n = hash(key);
+			node_ptr prev = nullptr;
+			for (node_ptr cur = m_Bucket[n]; cur != nullptr; prev = cur, cur = cur->next) {
+				if (is_equal(key, value_traits::get_key(cur->value))) {
+					if (prev == nullptr) {
+						m_Bucket[n] = cur->next;
+					}
+					else {
+						prev->next = cur->next;
+					}
+					destroy_node(cur);
+					--m_Size;
+					return 1;
+				}
+			}
+			return 0;
+		}
+
+		// 把 np 从所在的桶里摘下来，np 为 nullptr 时什么都不做
+		node_ptr unlink_node(node_ptr np)
+		{
+			if (np == nullptr) {
+				return nullptr;
+			}
+			return unlink_node(np, hash(value_traits::get_key(np->value)));
+		}
+
+		// 同上，n 是 np 所在的桶号
+		node_ptr unlink_node(node_ptr np, size_type n)
+		{
+			if (m_Bucket[n] == np) {
+				m_Bucket[n] = np->next;
+			}
+			else {
+				node_ptr prev = m_Bucket[n];
+				for (; prev->next != np; prev = prev->next) {}
+				prev->next = np->next;
+			}
+			np->next = nullptr;
+			--m_Size;
+			return np;
+		}
+
+		// 批量查找的前两步，处理 [first, last) 中最多 batch_group 个 key
+		// 返回这一组之后的位置，n 为这一组的个数，head[i] 为第 i 个 key 所在桶的第一个节点
+		template <class ForwardIter>
+		ForwardIter batch_prefetch(ForwardIter first, ForwardIter last, node_ptr* head, size_type& n) const
+		{
+			size_type idx[batch_group];
+			n = 0;
+			for (; n < batch_group && first != last; ++n, ++first) {
+				idx[n] = hash(*first);
+				MYSTL_PREFETCH(&m_Bucket[idx[n]]);
+			}
+			for (size_type i = 0; i < n; ++i) {
+				head[i] = m_Bucket[idx[i]];
+				if (head[i] != nullptr) {
+					MYSTL_PREFETCH(head[i]);
+				}
+			}
+			return first;
+		}
+
 		void	rehash_if_need(size_type n)
 		{
-			//  n ʾҪݸ
+			// 这里的 n 表示要插入数据个数
 			if (static_cast<float>(m_Size + n) > static_cast<float>(m_Bucket_Size) * max_load_factor()) {
-				// Ҫ m_Size + n Ͱ
+				// 最少要 m_Size + n 个桶
 				rehash(m_Size + n);
 			}
 		}
@@ -1233,11 +1844,7 @@ namespace mystl {
 		template <class ForwardIter>
 		void	copy_insert_multi(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag)
 		{
-			size_type n = mystl::distance(first, last);
-			rehash_if_need(n);
-			for (; n > 0; n--, first++) {
-				insert_multi_noresize(*first);
-			}
+			bulk_insert(first, last, false);
 		}
 
 		template <class InputIter>
@@ -1251,11 +1858,52 @@ namespace mystl {
 
 		template <class ForwardIter>
 		void	copy_insert_unique(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag)
+		{
+			bulk_insert(first, last, true);
+		}
+
+		// 能预先知道个数的区间走这里：桶只调整一次，先用掉块里的空闲节点，
+		// 剩下的节点一次分配成一整块，然后一遍扫过区间，逐个在块里构造元素并挂到桶上
+		// unique 时重复的 key 析构掉，节点留在块的空闲链表里给以后的插入用
+		template <class ForwardIter>
+		void	bulk_insert(ForwardIter first, ForwardIter last, bool unique)
 		{
 			size_type n = mystl::distance(first, last);
 			rehash_if_need(n);
-			for (; n > 0; n--, first++) {
-				insert_unique_noresize(*first);
+			for (; first != last && (n < bulk_min_size || m_Free_Count != 0); ++first, --n) {
+				if (unique) {
+					insert_unique_noresize(*first);
+				}
+				else {
+					insert_multi_noresize(*first);
+				}
+			}
+			if (n == 0) {
+				return;
+			}
+			node_ptr block = new_block(n);
+			size_type i = 0;
+			try {
+				for (; i < n; ++i, ++first) {
+					node_ptr np = block + i;
+					data_allocator::construct(mystl::address_of(np->value), *first);
+					np->next = nullptr;
+					if (unique) {
+						if (!insert_node_unique(np).second) {
+							destroy_node(np);
+						}
+					}
+					else {
+						insert_node_multi(np);
+					}
+				}
+			}
+			catch (...) {
+				// 没有用到的节点放进空闲链表
+				for (; i < n; ++i) {
+					free_node(block + i);
+				}
+				throw;
 			}
 		}
 
@@ -1289,11 +1937,12 @@ namespace mystl {
 				return iterator(node, this);
 			}
 			for (; np != nullptr; np = np->next) {
+				// 和 insert_multi_noresize 一样挂在相等的节点后面，保证相等的元素挨在一起
 				if (is_equal(value_traits::get_key(node->value), value_traits::get_key(np->value))) {
-					node->next = m_Bucket[n];
-					m_Bucket[n] = node;
+					node->next = np->next;
+					np->next = node;
 					++m_Size;
-					return iterator(np, this);
+					return iterator(node, this);
 				}
 			}
 			node->next = m_Bucket[n];
@@ -1302,33 +1951,242 @@ namespace mystl {
 			return iterator(node, this);
 		}
 
+		// 只把已有的节点重新挂到新桶上，不复制也不释放节点，指向元素的指针和引用在 rehash 后仍然有效
 		void replace_bucket(size_type bucket_cnt)
 		{
 			bucket_type bucket(bucket_cnt, nullptr);
-			if (m_Size != 0) {
-				for (size_type i = 0; i < m_Bucket_Size; i++) {
-					for (node_ptr first = m_Bucket[i]; first != nullptr; first = first->next) {
-						node_ptr tmp = create_node(first->value);
-						const size_type n = hash(value_traits::get_key(first->value), bucket_cnt);
-						node_ptr f = bucket[n];
-						bool is_inserted = false;
-						for (node_ptr cur = f; cur != nullptr; cur = cur->next) {
-							if (is_equal(value_traits::get_key(first->value), value_traits::get_key(cur->value))) {
-								tmp->next = cur->next;
-								cur->next = tmp;
-								is_inserted = true;
-								break;
-							}
-						}
-						if (is_inserted == false) {
-							tmp->next = f;
-							bucket[n] = tmp;
+			for (size_type i = 0; i < m_Bucket_Size; i++) {
+				node_ptr first = m_Bucket[i];
+				while (first != nullptr) {
+					node_ptr next = first->next;
+					const size_type n = hash(value_traits::get_key(first->value), bucket_cnt);
+					node_ptr cur = bucket[n];
+					for (; cur != nullptr; cur = cur->next) {
+						if (is_equal(value_traits::get_key(first->value), value_traits::get_key(cur->value))) {
+							break;
 						}
 					}
+					if (cur != nullptr) {
+						first->next = cur->next;
+						cur->next = first;
+					}
+					else {
+						first->next = bucket[n];
+						bucket[n] = first;
+					}
+					first = next;
+				}
+			}
+			bucket.swap(m_Bucket);
+			m_Bucket_Size = m_Bucket.size();
+			++m_Rehash_Count;
+		}
+
+		// 并行构建和并行 rehash 的中间结果：第 t 个线程要交给第 o 个线程的节点串在 lists[t * threads + o] 上
+		struct node_list
+		{
+			node_ptr head;
+			node_ptr tail;
+		};
+
+		static void	append_node(node_list& list, node_ptr np) noexcept
+		{
+			np->next = nullptr;
+			if (list.head == nullptr) {
+				list.head = np;
+			}
+			else {
+				list.tail->next = np;
+			}
+			list.tail = np;
+		}
+
+		// 第 o 个线程负责 [o * bucket_cnt / threads, (o + 1) * bucket_cnt / threads) 的桶
+		static size_type	owner_of(size_type n, size_type bucket_cnt, size_type threads) noexcept
+		{
+			return static_cast<size_type>(static_cast<std::uint64_t>(n) * threads / bucket_cnt);
+		}
+
+		size_type	worker_count(size_type threads, size_type n) const
+		{
+			if (threads == 0) {
+				threads = std::thread::hardware_concurrency();
+			}
+			return mystl::max(static_cast<size_type>(1), mystl::min(threads, n / parallel_min_size));
+		}
+
+		// f(1) ... f(threads - 1) 各开一个线程，f(0) 在当前线程执行，全部结束后返回
+		// 开线程失败时剩下的 f(t) 在当前线程依次执行，f 本身不能抛异常
+		template <class F>
+		static void	run_parallel(size_type threads, F f)
+		{
+			std::unique_ptr<std::thread[]> workers(new std::thread[threads - 1]);
+			size_type started = 1;
+			try {
+				for (; started < threads; ++started) {
+					workers[started - 1] = std::thread(f, started);
+				}
+			}
+			catch (...) {
+				for (size_type t = started; t < threads; ++t) {
+					f(t);
+				}
+			}
+			f(0);
+			for (size_type t = 1; t < started; ++t) {
+				workers[t - 1].join();
+			}
+		}
+
+		// 把 np 挂到以 head 开头的链上，和 insert_node_unique / insert_node_multi 的规则一样，
+		// 只是不改 m_Size；unique 时遇到相等的 key 返回 false，节点不挂上去
+		bool	link_node(node_ptr& head, node_ptr np, bool unique) const
+		{
+			for (node_ptr cur = head; cur != nullptr; cur = cur->next) {
+				if (is_equal(value_traits::get_key(np->value), value_traits::get_key(cur->value))) {
+					if (unique) {
+						return false;
+					}
+					np->next = cur->next;
+					cur->next = np;
+					return true;
 				}
 			}
+			np->next = head;
+			head = np;
+			return true;
+		}
+
+		// 第二步：第 owner 个线程按线程编号的顺序把分给它的节点挂到 bucket 上，返回挂上的个数
+		// 没挂上的 (unique 时重复的) 节点串到 dup 上，由调用者在所有线程结束后统一释放
+		size_type	link_owned(bucket_type& bucket, size_type bucket_cnt, const node_list* lists,
+			size_type threads, size_type owner, bool unique, node_ptr& dup) const
+		{
+			size_type linked = 0;
+			for (size_type t = 0; t < threads; ++t) {
+				node_ptr np = lists[t * threads + owner].head;
+				while (np != nullptr) {
+					node_ptr next = np->next;
+					if (link_node(bucket[hash(value_traits::get_key(np->value), bucket_cnt)], np, unique)) {
+						++linked;
+					}
+					else {
+						np->next = dup;
+						dup = np;
+					}
+					np = next;
+				}
+			}
+			return linked;
+		}
+
+		// replace_bucket 的多线程版本：第一步每个线程摘下一段旧桶里的节点，按新桶分给负责的线程，
+		// 第二步每个线程把分到的节点挂到自己那段新桶上
+		void	parallel_replace_bucket(size_type bucket_cnt, size_type threads)
+		{
+			if (threads <= 1) {
+				replace_bucket(bucket_cnt);
+				return;
+			}
+			bucket_type bucket(bucket_cnt, nullptr);
+			std::unique_ptr<node_list[]> lists(new node_list[threads * threads]());
+			const size_type old_cnt = m_Bucket_Size;
+			run_parallel(threads, [&](size_type t) {
+				node_list* mine = lists.get() + t * threads;
+				for (size_type i = old_cnt * t / threads; i < old_cnt * (t + 1) / threads; ++i) {
+					node_ptr np = m_Bucket[i];
+					while (np != nullptr) {
+						node_ptr next = np->next;
+						append_node(mine[owner_of(hash(value_traits::get_key(np->value), bucket_cnt), bucket_cnt, threads)], np);
+						np = next;
+					}
+				}
+			});
+			run_parallel(threads, [&](size_type o) {
+				node_ptr dup = nullptr;
+				link_owned(bucket, bucket_cnt, lists.get(), threads, o, false, dup);
+			});
 			bucket.swap(m_Bucket);
-			m_Bucket_Size = bucket.size();
+			m_Bucket_Size = m_Bucket.size();
+			++m_Rehash_Count;
+		}
+
+		template <class RandomIter>
+		void	parallel_build(RandomIter first, RandomIter last, size_type threads, bool unique)
+		{
+			const size_type n = static_cast<size_type>(last - first);
+			threads = worker_count(threads, n);
+			if (threads <= 1) {
+				bulk_insert(first, last, unique);
+				return;
+			}
+			if (static_cast<float>(m_Size + n) > static_cast<float>(m_Bucket_Size) * max_load_factor()) {
+				parallel_replace_bucket(ht_next_prime(m_Size + n), threads);
+			}
+			// 块里有空闲节点时先用它们插入前面的元素，顺序和串行插入一样
+			RandomIter mid = first;
+			for (; mid != last && m_Free_Count != 0; ++mid) {
+				if (unique) {
+					insert_unique_noresize(*mid);
+				}
+				else {
+					insert_multi_noresize(*mid);
+				}
+			}
+			if (mid != first) {
+				parallel_build(mid, last, threads, unique);
+				return;
+			}
+			node_ptr block = new_block(n);
+			std::unique_ptr<node_list[]> lists(new node_list[threads * threads]());
+			std::unique_ptr<size_type[]> built(new size_type[threads]());
+			std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[threads]);
+			const size_type bucket_cnt = m_Bucket_Size;
+
+			// 第一步：构造节点，第 i 个元素放在 block[i]，保证第二步按线程编号挂的时候还是输入的顺序
+			run_parallel(threads, [&](size_type t) {
+				node_list* mine = lists.get() + t * threads;
+				try {
+					for (size_type i = n * t / threads; i < n * (t + 1) / threads; ++i) {
+						node_ptr np = block + i;
+						data_allocator::construct(mystl::address_of(np->value), first[i]);
+						++built[t];
+						append_node(mine[owner_of(hash(value_traits::get_key(np->value), bucket_cnt), bucket_cnt, threads)], np);
+					}
+				}
+				catch (...) {
+					errors[t] = std::current_exception();
+				}
+			});
+			for (size_type t = 0; t < threads; ++t) {
+				if (errors[t]) {
+					// 桶还没动过，析构已经构造的元素，整块节点放进空闲链表
+					for (size_type u = 0; u < threads; ++u) {
+						for (size_type i = n * u / threads; i < n * u / threads + built[u]; ++i) {
+							data_allocator::destroy(mystl::address_of(block[i].value));
+						}
+					}
+					for (size_type i = 0; i < n; ++i) {
+						free_node(block + i);
+					}
+					std::rethrow_exception(errors[t]);
+				}
+			}
+
+			// 第二步：各自往自己负责的桶里挂
+			std::unique_ptr<size_type[]> linked(new size_type[threads]());
+			std::unique_ptr<node_ptr[]> dups(new node_ptr[threads]());
+			run_parallel(threads, [&](size_type o) {
+				linked[o] = link_owned(m_Bucket, bucket_cnt, lists.get(), threads, o, unique, dups[o]);
+			});
+			for (size_type o = 0; o < threads; ++o) {
+				m_Size += linked[o];
+				while (dups[o] != nullptr) {
+					node_ptr next = dups[o]->next;
+					destroy_node(dups[o]);
+					dups[o] = next;
+				}
+			}
 		}
 
 		void erase_bucket(size_type n, node_ptr first, node_ptr last)
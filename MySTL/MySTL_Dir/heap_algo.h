@@ -2,38 +2,39 @@
 #define MYSTL_HELP_ALGO_H
 
 #include "iterator.h"
+#include "util.h"
 
 
 namespace mystl {
 
-	// ʹĶѲ
-	// һֵϲ飬뵽׽ڵӽڵ㴦
+	// 使用数组做的堆插入
+	// 插入一个值，不断往上查，插入到亲节点大于他的子节点处
 	template <class RandomIter, class Distance, class T>
 	void push_heap_aux(RandomIter Iter, Distance holeIndex, Distance topIndex, T value)
 	{
 		auto parent = (holeIndex - 1) / 2;
 
 		while (holeIndex > topIndex && *(parent + Iter) < value) {
-			*(Iter + holeIndex) = *(Iter + parent);
+			*(Iter + holeIndex) = mystl::move(*(Iter + parent));
 			holeIndex = parent;
 			parent = (holeIndex - 1) / 2;
 		}
 		
-		*(Iter + holeIndex) = value;
+		*(Iter + holeIndex) = mystl::move(value);
 	}
 
-	// ӶβѣβԪز뵽ʺϵλ
+	// 从二叉树的尾部往上搜，将插入尾部的元素插入到它适合的位置
 	template <class RandomIter, class Distance>
 	void push_heap_d(RandomIter first, RandomIter last, Distance *)
 	{
-		push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0), *(last - 1));
+		mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0), mystl::move(*(last - 1)));
 	}
 
 
 	template <class RandomIter>
 	void push_heap(RandomIter first, RandomIter last)
 	{
-		mystl::push_heap_aux(first, last, mystl::distance_type(first));
+		mystl::push_heap_d(first, last, mystl::distance_type(first));
 	}
 
 
@@ -43,19 +44,19 @@ namespace mystl {
 		auto parent = (holeIndex - 1) / 2;
 
 		while (holeIndex > topIndex && cmp(*(parent + Iter), value)) {
-			*(Iter + holeIndex) = *(Iter + parent);
+			*(Iter + holeIndex) = mystl::move(*(Iter + parent));
 			holeIndex = parent;
 			parent = (holeIndex - 1) / 2;
 		}
 
-		*(Iter + holeIndex) = value;
+		*(Iter + holeIndex) = mystl::move(value);
 	}
 
 
 	template <class RandomIter, class Compared, class Distance>
 	void push_heap_d(RandomIter first, RandomIter last, Distance *, Compared cmp)
 	{
-		mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0), *(last - 1), cmp);
+		mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0), mystl::move(*(last - 1)), cmp);
 	}
 
 
@@ -66,7 +67,7 @@ namespace mystl {
 	}
 
 
-	// ҵһ··ϽڵͨͨŲһλ
+	// 找到最大的一条路径，在这条路径上节点通通往上挪一位
 	template <class RandomIter, class Distance, class T>
 	void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value)
 	{
@@ -77,32 +78,32 @@ namespace mystl {
 			if (*(first + rchild) < *(first + (rchild - 1))) {
 				rchild--;
 			}
-			*(first + holeIndex) = *(first + rchild);
+			*(first + holeIndex) = mystl::move(*(first + rchild));
 			holeIndex = rchild;
 			rchild = (rchild + 1) * 2;
 		}
 
 		if (rchild == len) {
-			*(first + holeIndex) = *(first + (rchild - 1));
+			*(first + holeIndex) = mystl::move(*(first + (rchild - 1)));
 			holeIndex = rchild - 1;
 		}
 
-		mystl::push_heap_aux(first, holeIndex, topIndex, value);
+		mystl::push_heap_aux(first, holeIndex, topIndex, mystl::move(value));
 	}
 
 
 	template <class RandomIter, class T, class Distance>
 	void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, T value, Distance*)
 	{
-		*result = *first;
-		mystl::adjust_heap(first, static_cast<Distance> (0), last - first, value);
+		*result = mystl::move(*first);
+		mystl::adjust_heap(first, static_cast<Distance>(0), last - first, mystl::move(value));
 	}
 
 
 	template <class RandomIter>
 	void pop_heap(RandomIter first, RandomIter last)
 	{
-		mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1), last - first);
+		mystl::pop_heap_aux(first, last - 1, last - 1, mystl::move(*(last - 1)), mystl::distance_type(first));
 	}
 
 
@@ -116,17 +117,17 @@ namespace mystl {
 			if (cmp(*(first + rchild), *(first + (rchild - 1)))) {
 				rchild--;
 			}
-			*(first + holeIndex) = *(first + rchild);
+			*(first + holeIndex) = mystl::move(*(first + rchild));
 			holeIndex = rchild;
 			rchild = (rchild + 1) * 2;
 		}
 
 		if (rchild == len) {
-			*(first + holeIndex) = *(first + (rchild - 1));
+			*(first + holeIndex) = mystl::move(*(first + (rchild - 1)));
 			holeIndex = rchild - 1;
 		}
 
-		mystl::push_heap_aux(first, holeIndex, topIndex, value, cmp);
+		mystl::push_heap_aux(first, holeIndex, topIndex, mystl::move(value), cmp);
 	}
 
 
@@ -134,15 +135,15 @@ namespace mystl {
 	void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result,
 		T value, Distance*, Compared cmp)
 	{
-		*result = *first;
-		mystl::adjust_heap(first, static_cast<Distance>(0), last - first, value, cmp);
+		*result = mystl::move(*first);
+		mystl::adjust_heap(first, static_cast<Distance>(0), last - first, mystl::move(value), cmp);
 	}
 
 
-	template <class RandomIter, class T, class Distance, class Compared>
+	template <class RandomIter, class Compared>
 	void pop_heap(RandomIter first, RandomIter last, Compared cmp)
 	{
-		mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1), distance_type(first), cmp);
+		mystl::pop_heap_aux(first, last - 1, last - 1, mystl::move(*(last - 1)), mystl::distance_type(first), cmp);
 	}
 
 
@@ -168,7 +169,7 @@ namespace mystl {
 	template <class RandomIter, class Distance>
 	void make_heap_aux(RandomIter first, RandomIter last, Distance*)
 	{
-		if (last - first > 1) {
+		if (last - first < 2) {
 			return;
 		}
 
@@ -176,9 +177,9 @@ namespace mystl {
 		auto holeIndex = (len - 2) / 2;
 
 		while (true) {
-			mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex));
+			mystl::adjust_heap(first, holeIndex, len, mystl::move(*(first + holeIndex)));
 			if (holeIndex == 0) {
-				return 0;
+				return;
 			}
 			holeIndex--;
 		}
@@ -194,7 +195,7 @@ namespace mystl {
 	template <class RandomIter, class Distance, class Compared>
 	void make_heap_aux(RandomIter first, RandomIter last, Distance*, Compared cmp)
 	{
-		if (last - first > 1) {
+		if (last - first < 2) {
 			return;
 		}
 
@@ -202,9 +203,9 @@ namespace mystl {
 		auto holeIndex = (len - 2) / 2;
 
 		while (true) {
-			mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex), cmp);
+			mystl::adjust_heap(first, holeIndex, len, mystl::move(*(first + holeIndex)), cmp);
 			if (holeIndex == 0) {
-				return 0;
+				return;
 			}
 			holeIndex--;
 		}
@@ -0,0 +1,482 @@
+#ifndef MYSTL_INLINE_HASHTABLE_H
+#define MYSTL_INLINE_HASHTABLE_H
+
+#include <cstdint>
+
+#include "hashtable.h"
+
+namespace mystl {
+
+	// 节点里额外存一份完整的 hash，rehash 时不用重新算
+	template <class T>
+	struct inline_hashtable_node
+	{
+		inline_hashtable_node* next;
+		size_t hash;
+		T value;
+
+		template <class ...Args>
+		explicit inline_hashtable_node(size_t h, Args&& ...args)
+			: next(nullptr), hash(h), value(mystl::forward<Args>(args)...) {}
+	};
+
+	// 一个桶正好一条 cache line，前 bucket_slots 个元素的 (hash, 指针) 直接放在桶里
+	// 64 位平台上是 4 对，32 位平台上是 8 对
+	template <class Node>
+	struct inline_bucket
+	{
+		static constexpr size_t slots = 64 / (sizeof(size_t) + sizeof(Node*));
+
+		size_t hash[slots];
+		Node* node[slots];
+	};
+
+	// 桶内直接存 (hash, 指针) 对的哈希表，只支持不重复的 key
+	// hashtable 查找要先读 m_Bucket[n] 拿到指针，再去读节点，才知道 hash 对不对得上，每个节点都是一次依赖的访存
+	// 这里先在桶这一条 cache line 里比较 hash，只有 hash 相等时才去读节点比较 key
+	// 不存在的 key 通常只读一条 cache line，存在的 key 只多读它自己的节点
+	// 桶里的槽总是从前往后连续占用，放满之后多出来的节点挂在最后一个槽的节点的 next 上
+	// 元素仍然在单独分配的节点里，插入、删除和 rehash 都不会让指向元素的指针失效
+	template <class T, class Hash, class KeyEqual>
+	class inline_hashtable
+	{
+	public:
+
+		using value_traits	= ht_value_traits<T>;
+		using key_type		= typename value_traits::key_type;
+		using mapped_type	= typename value_traits::mapped_type;
+		using value_type	= typename value_traits::value_type;
+		using hasher		= Hash;
+		using key_equal		= KeyEqual;
+		using size_type		= size_t;
+
+		using node_type		= inline_hashtable_node<T>;
+		using node_ptr		= node_type*;
+		using bucket_type	= inline_bucket<node_type>;
+
+		static constexpr size_type bucket_slots = bucket_type::slots;
+
+		static_assert(sizeof(bucket_type) == 64, "inline_bucket should fill exactly one cache line");
+
+	private:
+
+		using node_allocator = mystl::allocator<node_type>;
+		using bucket_allocator = mystl::allocator<bucket_type>;
+
+		// m_Raw 是分配到的内存，m_Bucket 是其中按 64 字节对齐的起点
+		bucket_type*	m_Raw;
+		bucket_type*	m_Bucket;
+		size_type		m_Bucket_Size;
+		size_type		m_Size;
+		float			m_Mlf;
+		hasher			m_Hash;
+		key_equal		m_Equal;
+
+	public:
+
+		explicit inline_hashtable(size_type bucket_cnt = 100,
+			const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual())
+			: m_Raw(nullptr), m_Bucket(nullptr), m_Bucket_Size(0), m_Size(0), m_Mlf(1.0f)
+			, m_Hash(hash), m_Equal(equal)
+		{
+			allocate(ht_next_prime(bucket_cnt));
+		}
+
+		inline_hashtable(const inline_hashtable& rhs)
+			: m_Raw(nullptr), m_Bucket(nullptr), m_Bucket_Size(0), m_Size(0), m_Mlf(rhs.m_Mlf)
+			, m_Hash(rhs.m_Hash), m_Equal(rhs.m_Equal)
+		{
+			allocate(rhs.m_Bucket_Size);
+			try {
+				rhs.for_each_node([&](node_ptr np) {
+					link_node(create_node(np->hash, np->value));
+					++m_Size;
+				});
+			}
+			catch (...) {
+				clear();
+				bucket_allocator::deallocate(m_Raw);
+				throw;
+			}
+		}
+
+		// rhs 留下一个没有桶的空表，仍然可以查找、删除、插入和析构
+		inline_hashtable(inline_hashtable&& rhs) noexcept
+			: m_Raw(rhs.m_Raw), m_Bucket(rhs.m_Bucket), m_Bucket_Size(rhs.m_Bucket_Size)
+			, m_Size(rhs.m_Size), m_Mlf(rhs.m_Mlf), m_Hash(rhs.m_Hash), m_Equal(rhs.m_Equal)
+		{
+			rhs.m_Raw = nullptr;
+			rhs.m_Bucket = nullptr;
+			rhs.m_Bucket_Size = 0;
+			rhs.m_Size = 0;
+		}
+
+		inline_hashtable& operator=(const inline_hashtable& rhs)
+		{
+			if (this != &rhs) {
+				inline_hashtable tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		inline_hashtable& operator=(inline_hashtable&& rhs) noexcept
+		{
+			inline_hashtable tmp(mystl::move(rhs));
+			swap(tmp);
+			return *this;
+		}
+
+		~inline_hashtable()
+		{
+			clear();
+			bucket_allocator::deallocate(m_Raw);
+		}
+
+	public:
+
+		bool empty() const noexcept
+		{
+			return m_Size == 0;
+		}
+
+		size_type size() const noexcept
+		{
+			return m_Size;
+		}
+
+		size_type bucket_count() const noexcept
+		{
+			return m_Bucket_Size;
+		}
+
+		float load_factor() const noexcept
+		{
+			return m_Bucket_Size != 0 ? (float)m_Size / (float)m_Bucket_Size : 0.0f;
+		}
+
+		float max_load_factor() const noexcept
+		{
+			return m_Mlf;
+		}
+
+		// 每个桶能放好几个元素，负载因子调到 2 左右仍然很少需要去读溢出的节点
+		void max_load_factor(float ml)
+		{
+			THROW_OUT_RANGE_IF(ml != ml || ml < 0, "invalid hash load factor");
+			m_Mlf = ml;
+		}
+
+		// 返回指向元素的指针和是否插入成功，key 已存在时指向原来的元素
+		pair<value_type*, bool> insert(const value_type& value)
+		{
+			const size_type h = m_Hash(value_traits::get_key(value));
+			node_ptr np = find_node(value_traits::get_key(value), h);
+			if (np != nullptr) {
+				return mystl::make_pair(mystl::address_of(np->value), false);
+			}
+			rehash_if_need(1);
+			np = create_node(h, value);
+			link_node(np);
+			++m_Size;
+			return mystl::make_pair(mystl::address_of(np->value), true);
+		}
+
+		template <class ...Args>
+		pair<value_type*, bool> emplace(Args&& ...args)
+		{
+			rehash_if_need(1);
+			node_ptr np = create_node(0, mystl::forward<Args>(args)...);
+			try {
+				np->hash = m_Hash(value_traits::get_key(np->value));
+				node_ptr old = find_node(value_traits::get_key(np->value), np->hash);
+				if (old != nullptr) {
+					destroy_node(np);
+					return mystl::make_pair(mystl::address_of(old->value), false);
+				}
+			}
+			catch (...) {
+				destroy_node(np);
+				throw;
+			}
+			link_node(np);
+			++m_Size;
+			return mystl::make_pair(mystl::address_of(np->value), true);
+		}
+
+		// 找不到返回 nullptr
+		value_type* find(const key_type& key)
+		{
+			node_ptr np = find_node(key, m_Hash(key));
+			return np != nullptr ? mystl::address_of(np->value) : nullptr;
+		}
+
+		const value_type* find(const key_type& key) const
+		{
+			node_ptr np = find_node(key, m_Hash(key));
+			return np != nullptr ? mystl::address_of(np->value) : nullptr;
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return find_node(key, m_Hash(key)) != nullptr ? 1 : 0;
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return count(key) != 0;
+		}
+
+		size_type erase(const key_type& key)
+		{
+			if (m_Bucket_Size == 0) {
+				return 0;
+			}
+			const size_type h = m_Hash(key);
+			bucket_type& b = m_Bucket[h % m_Bucket_Size];
+			size_type i = 0;
+			for (; i < bucket_slots && b.node[i] != nullptr; ++i) {
+				if (b.hash[i] == h && m_Equal(value_traits::get_key(b.node[i]->value), key)) {
+					break;
+				}
+			}
+			if (i < bucket_slots && b.node[i] != nullptr) {
+				// 后面的槽往前挪一个，溢出链的第一个节点补到最后一个槽
+				node_ptr np = b.node[i];
+				node_ptr overflow = b.node[bucket_slots - 1] != nullptr ? b.node[bucket_slots - 1]->next : nullptr;
+				for (; i + 1 < bucket_slots; ++i) {
+					b.hash[i] = b.hash[i + 1];
+					b.node[i] = b.node[i + 1];
+				}
+				if (i > 0 && b.node[i - 1] != nullptr) {
+					b.node[i - 1]->next = nullptr;
+				}
+				b.node[bucket_slots - 1] = overflow;
+				b.hash[bucket_slots - 1] = overflow != nullptr ? overflow->hash : 0;
+				destroy_node(np);
+				--m_Size;
+				return 1;
+			}
+			if (i < bucket_slots) {
+				return 0;
+			}
+			for (node_ptr prev = b.node[bucket_slots - 1]; prev->next != nullptr; prev = prev->next) {
+				node_ptr np = prev->next;
+				if (np->hash == h && m_Equal(value_traits::get_key(np->value), key)) {
+					prev->next = np->next;
+					destroy_node(np);
+					--m_Size;
+					return 1;
+				}
+			}
+			return 0;
+		}
+
+		void clear()
+		{
+			if (m_Size != 0) {
+				for_each_node([&](node_ptr np) {
+					destroy_node(np);
+				});
+				m_Size = 0;
+			}
+			for (size_type i = 0; i < m_Bucket_Size; ++i) {
+				reset_bucket(m_Bucket[i]);
+			}
+		}
+
+		void rehash(size_type cnt)
+		{
+			const size_type n = ht_next_prime(mystl::max(cnt, static_cast<size_type>((float)m_Size / m_Mlf + 0.5f)));
+			if (n != m_Bucket_Size) {
+				replace_bucket(n);
+			}
+		}
+
+		void reserve(size_type cnt)
+		{
+			rehash(static_cast<size_type>((float)cnt / m_Mlf + 0.5f));
+		}
+
+		// 按桶的顺序对每个元素调用 f(value)
+		template <class F>
+		void for_each(F f) const
+		{
+			for_each_node([&](node_ptr np) {
+				f(static_cast<const value_type&>(np->value));
+			});
+		}
+
+		void swap(inline_hashtable& rhs) noexcept
+		{
+			mystl::swap(m_Raw, rhs.m_Raw);
+			mystl::swap(m_Bucket, rhs.m_Bucket);
+			mystl::swap(m_Bucket_Size, rhs.m_Bucket_Size);
+			mystl::swap(m_Size, rhs.m_Size);
+			mystl::swap(m_Mlf, rhs.m_Mlf);
+			mystl::swap(m_Hash, rhs.m_Hash);
+			mystl::swap(m_Equal, rhs.m_Equal);
+		}
+
+		hasher hash_fcn() const
+		{
+			return m_Hash;
+		}
+
+		key_equal key_eq() const
+		{
+			return m_Equal;
+		}
+
+	private:
+
+		// 被移走的表没有桶，查找直接返回，插入时 rehash_if_need 会重新分配
+		node_ptr find_node(const key_type& key, size_type h) const
+		{
+			if (m_Bucket_Size == 0) {
+				return nullptr;
+			}
+			const bucket_type& b = m_Bucket[h % m_Bucket_Size];
+			// 先只比桶里的 hash，对上了才去读节点
+			for (size_type i = 0; i < bucket_slots; ++i) {
+				if (b.node[i] == nullptr) {
+					return nullptr;
+				}
+				if (b.hash[i] == h && m_Equal(value_traits::get_key(b.node[i]->value), key)) {
+					return b.node[i];
+				}
+			}
+			for (node_ptr np = b.node[bucket_slots - 1]->next; np != nullptr; np = np->next) {
+				if (np->hash == h && m_Equal(value_traits::get_key(np->value), key)) {
+					return np;
+				}
+			}
+			return nullptr;
+		}
+
+		// 桶里有空槽就放进第一个空槽，否则挂到最后一个槽的节点后面
+		void link_node(node_ptr np) noexcept
+		{
+			link_node(m_Bucket[np->hash % m_Bucket_Size], np);
+		}
+
+		static void link_node(bucket_type& b, node_ptr np) noexcept
+		{
+			for (size_type i = 0; i < bucket_slots; ++i) {
+				if (b.node[i] == nullptr) {
+					b.hash[i] = np->hash;
+					b.node[i] = np;
+					np->next = nullptr;
+					return;
+				}
+			}
+			np->next = b.node[bucket_slots - 1]->next;
+			b.node[bucket_slots - 1]->next = np;
+		}
+
+		// f 可以释放传给它的节点，下一个节点在调用之前就取好了
+		template <class F>
+		void for_each_node(F f) const
+		{
+			for (size_type n = 0; n < m_Bucket_Size; ++n) {
+				const bucket_type& b = m_Bucket[n];
+				node_ptr overflow = b.node[bucket_slots - 1] != nullptr ? b.node[bucket_slots - 1]->next : nullptr;
+				for (size_type i = 0; i < bucket_slots && b.node[i] != nullptr; ++i) {
+					f(b.node[i]);
+				}
+				while (overflow != nullptr) {
+					node_ptr next = overflow->next;
+					f(overflow);
+					overflow = next;
+				}
+			}
+		}
+
+		static void reset_bucket(bucket_type& b) noexcept
+		{
+			for (size_type i = 0; i < bucket_slots; ++i) {
+				b.hash[i] = 0;
+				b.node[i] = nullptr;
+			}
+		}
+
+		void allocate(size_type bucket_cnt)
+		{
+			THROW_LENGTH_ERROR_IF(bucket_cnt >= static_cast<size_type>(-1) / sizeof(bucket_type),
+				"inline_hashtable<T> size too big");
+			// 多分配一个桶用来对齐到 64 字节
+			m_Raw = bucket_allocator::allocate(bucket_cnt + 1);
+			const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(m_Raw);
+			m_Bucket = reinterpret_cast<bucket_type*>((addr + 63) & ~static_cast<std::uintptr_t>(63));
+			m_Bucket_Size = bucket_cnt;
+			for (size_type i = 0; i < bucket_cnt; ++i) {
+				reset_bucket(m_Bucket[i]);
+			}
+		}
+
+		void rehash_if_need(size_type n)
+		{
+			if (static_cast<float>(m_Size + n) > static_cast<float>(m_Bucket_Size) * m_Mlf) {
+				rehash(static_cast<size_type>(static_cast<float>(m_Size + n) / m_Mlf + 0.5f));
+			}
+		}
+
+		// 节点里存了 hash，直接按它挂到新桶上，不用调用 hasher
+		void replace_bucket(size_type bucket_cnt)
+		{
+			bucket_type* old_raw = m_Raw;
+			bucket_type* old_bucket = m_Bucket;
+			const size_type old_size = m_Bucket_Size;
+			allocate(bucket_cnt);
+			for (size_type n = 0; n < old_size; ++n) {
+				const bucket_type& b = old_bucket[n];
+				node_ptr overflow = b.node[bucket_slots - 1] != nullptr ? b.node[bucket_slots - 1]->next : nullptr;
+				for (size_type i = 0; i < bucket_slots && b.node[i] != nullptr; ++i) {
+					link_node(b.node[i]);
+				}
+				while (overflow != nullptr) {
+					node_ptr next = overflow->next;
+					link_node(overflow);
+					overflow = next;
+				}
+			}
+			bucket_allocator::deallocate(old_raw);
+		}
+
+		template <class ...Args>
+		node_ptr create_node(size_type h, Args&& ...args)
+		{
+			node_ptr np = node_allocator::allocate(1);
+			try {
+				node_allocator::construct(np, h, mystl::forward<Args>(args)...);
+			}
+			catch (...) {
+				node_allocator::deallocate(np);
+				throw;
+			}
+			return np;
+		}
+
+		void destroy_node(node_ptr np)
+		{
+			node_allocator::destroy(np);
+			node_allocator::deallocate(np);
+		}
+	};
+
+	template <class T, class Hash, class KeyEqual>
+	void swap(inline_hashtable<T, Hash, KeyEqual>& lhs, inline_hashtable<T, Hash, KeyEqual>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+	using inline_hash_map = inline_hashtable<mystl::pair<const Key, T>, Hash, KeyEqual>;
+
+	template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+	using inline_hash_set = inline_hashtable<Key, Hash, KeyEqual>;
+
+}
+
+#endif // !MYSTL_INLINE_HASHTABLE_H
@@ -0,0 +1,472 @@
+#ifndef MYSTL_INT_HASH_SET_H
+#define MYSTL_INT_HASH_SET_H
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "functional.h"
+#include "allocator.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+	// 整数 key 专用的开放寻址集合
+	// key 直接存在槽数组里，没有节点也没有桶指针，uint32_t 每个元素只占 4 / 负载因子 个字节
+	// 槽按 group_size 个分成一组，线性探测以组为单位：一次比较一整组，组里有空槽就说明 key 不在表里
+	// 开了 AVX2 时 4 字节和 8 字节的 key 一组只要一两条比较指令，否则退回逐个比较
+	// 全 1 的值当空槽，全 1 减一当删除标记，这两个值本身作为 key 插入时只记一个标志位，所以任何值都能存
+	template <class T, class Hash = mystl::hash<T>>
+	class int_hash_set
+	{
+		static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+			"int_hash_set only supports integer keys");
+
+	public:
+
+		using key_type		= T;
+		using value_type	= T;
+		using hasher		= Hash;
+		using size_type		= size_t;
+
+		static constexpr size_type group_size = 8;
+		static constexpr T empty_key = static_cast<T>(~static_cast<typename std::make_unsigned<T>::type>(0));
+		static constexpr T deleted_key = static_cast<T>(empty_key - 1);
+
+	private:
+
+		using data_allocator = mystl::allocator<T>;
+
+		// 一组的字节数，槽数组按它对齐，SIMD 读一组不会跨 cache line
+		static constexpr size_type group_bytes = group_size * sizeof(T);
+
+		T*			m_Raw;
+		T*			m_Slots;
+		size_type	m_Group_Count;
+		// 槽里的元素个数，不含两个特殊值
+		size_type	m_Size;
+		// 元素加删除标记占用的槽数，决定什么时候 rehash
+		size_type	m_Used;
+		bool		m_Has_Empty_Key;
+		bool		m_Has_Deleted_Key;
+		hasher		m_Hash;
+
+	public:
+
+		int_hash_set() noexcept
+			: m_Raw(nullptr), m_Slots(nullptr), m_Group_Count(0), m_Size(0), m_Used(0)
+			, m_Has_Empty_Key(false), m_Has_Deleted_Key(false), m_Hash()
+		{
+		}
+
+		explicit int_hash_set(size_type n, const Hash& hash = Hash())
+			: m_Raw(nullptr), m_Slots(nullptr), m_Group_Count(0), m_Size(0), m_Used(0)
+			, m_Has_Empty_Key(false), m_Has_Deleted_Key(false), m_Hash(hash)
+		{
+			reserve(n);
+		}
+
+		template <class InputIter>
+		int_hash_set(InputIter first, InputIter last, const Hash& hash = Hash())
+			: int_hash_set(0, hash)
+		{
+			for (; first != last; ++first) {
+				insert(*first);
+			}
+		}
+
+		int_hash_set(std::initializer_list<T> ilist, const Hash& hash = Hash())
+			: int_hash_set(ilist.begin(), ilist.end(), hash)
+		{
+		}
+
+		int_hash_set(const int_hash_set& rhs)
+			: m_Raw(nullptr), m_Slots(nullptr), m_Group_Count(0), m_Size(rhs.m_Size), m_Used(rhs.m_Used)
+			, m_Has_Empty_Key(rhs.m_Has_Empty_Key), m_Has_Deleted_Key(rhs.m_Has_Deleted_Key), m_Hash(rhs.m_Hash)
+		{
+			if (rhs.m_Slots != nullptr) {
+				allocate(rhs.m_Group_Count);
+				std::memcpy(m_Slots, rhs.m_Slots, capacity() * sizeof(T));
+			}
+		}
+
+		int_hash_set(int_hash_set&& rhs) noexcept
+			: m_Raw(rhs.m_Raw), m_Slots(rhs.m_Slots), m_Group_Count(rhs.m_Group_Count)
+			, m_Size(rhs.m_Size), m_Used(rhs.m_Used)
+			, m_Has_Empty_Key(rhs.m_Has_Empty_Key), m_Has_Deleted_Key(rhs.m_Has_Deleted_Key)
+			, m_Hash(rhs.m_Hash)
+		{
+			rhs.m_Raw = nullptr;
+			rhs.m_Slots = nullptr;
+			rhs.m_Group_Count = 0;
+			rhs.m_Size = 0;
+			rhs.m_Used = 0;
+			rhs.m_Has_Empty_Key = false;
+			rhs.m_Has_Deleted_Key = false;
+		}
+
+		int_hash_set& operator=(const int_hash_set& rhs)
+		{
+			if (this != &rhs) {
+				int_hash_set tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		int_hash_set& operator=(int_hash_set&& rhs) noexcept
+		{
+			int_hash_set tmp(mystl::move(rhs));
+			swap(tmp);
+			return *this;
+		}
+
+		~int_hash_set()
+		{
+			data_allocator::deallocate(m_Raw);
+		}
+
+	public:
+
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		size_type size() const noexcept
+		{
+			return m_Size + (m_Has_Empty_Key ? 1 : 0) + (m_Has_Deleted_Key ? 1 : 0);
+		}
+
+		// 槽的个数
+		size_type capacity() const noexcept
+		{
+			return m_Group_Count * group_size;
+		}
+
+		size_type memory_bytes() const noexcept
+		{
+			return capacity() * sizeof(T);
+		}
+
+		float load_factor() const noexcept
+		{
+			return capacity() != 0 ? (float)m_Size / capacity() : 0.0f;
+		}
+
+		bool contains(T key) const noexcept
+		{
+			if (key == empty_key) {
+				return m_Has_Empty_Key;
+			}
+			if (key == deleted_key) {
+				return m_Has_Deleted_Key;
+			}
+			if (m_Slots == nullptr) {
+				return false;
+			}
+			// 负载因子不超过 7/8，总有空槽，循环一定会结束
+			for (size_type g = group_of(key); ; g = (g + 1) & (m_Group_Count - 1)) {
+				const T* p = m_Slots + g * group_size;
+				if (match(p, key) != 0) {
+					return true;
+				}
+				if (match(p, empty_key) != 0) {
+					return false;
+				}
+			}
+		}
+
+		size_type count(T key) const noexcept
+		{
+			return contains(key) ? 1 : 0;
+		}
+
+		// 返回是否插入成功，key 已存在时返回 false
+		bool insert(T key)
+		{
+			if (key == empty_key) {
+				return set_flag(m_Has_Empty_Key);
+			}
+			if (key == deleted_key) {
+				return set_flag(m_Has_Deleted_Key);
+			}
+			if (m_Used + 1 > max_used()) {
+				grow();
+			}
+			T* tomb = nullptr;
+			for (size_type g = group_of(key); ; g = (g + 1) & (m_Group_Count - 1)) {
+				T* p = m_Slots + g * group_size;
+				if (match(p, key) != 0) {
+					return false;
+				}
+				// 优先复用探测路径上第一个删除标记，但要走到有空槽的组才能确定 key 不存在
+				if (tomb == nullptr) {
+					const unsigned d = match(p, deleted_key);
+					if (d != 0) {
+						tomb = p + first_bit(d);
+					}
+				}
+				const unsigned e = match(p, empty_key);
+				if (e != 0) {
+					if (tomb != nullptr) {
+						*tomb = key;
+					}
+					else {
+						p[first_bit(e)] = key;
+						++m_Used;
+					}
+					++m_Size;
+					return true;
+				}
+			}
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			for (; first != last; ++first) {
+				insert(*first);
+			}
+		}
+
+		size_type erase(T key) noexcept
+		{
+			if (key == empty_key) {
+				return clear_flag(m_Has_Empty_Key);
+			}
+			if (key == deleted_key) {
+				return clear_flag(m_Has_Deleted_Key);
+			}
+			if (m_Slots == nullptr) {
+				return 0;
+			}
+			for (size_type g = group_of(key); ; g = (g + 1) & (m_Group_Count - 1)) {
+				T* p = m_Slots + g * group_size;
+				const unsigned m = match(p, key);
+				const unsigned e = match(p, empty_key);
+				if (m != 0) {
+					// 组里本来就有空槽时查找会停在这一组，直接置空不会切断别的 key 的探测路径
+					if (e != 0) {
+						p[first_bit(m)] = empty_key;
+						--m_Used;
+					}
+					else {
+						p[first_bit(m)] = deleted_key;
+					}
+					--m_Size;
+					return 1;
+				}
+				if (e != 0) {
+					return 0;
+				}
+			}
+		}
+
+		void clear() noexcept
+		{
+			// empty_key 全 1，按字节填 0xff 就是把所有槽置空
+			if (m_Slots != nullptr) {
+				std::memset(m_Slots, 0xff, memory_bytes());
+			}
+			m_Size = 0;
+			m_Used = 0;
+			m_Has_Empty_Key = false;
+			m_Has_Deleted_Key = false;
+		}
+
+		// 保证放 n 个元素之前不会 rehash
+		void reserve(size_type n)
+		{
+			size_type groups = 1;
+			while (groups * group_size * 7 / 8 < n) {
+				groups <<= 1;
+			}
+			if (groups > m_Group_Count) {
+				rehash_groups(groups);
+			}
+		}
+
+		void swap(int_hash_set& rhs) noexcept
+		{
+			mystl::swap(m_Raw, rhs.m_Raw);
+			mystl::swap(m_Slots, rhs.m_Slots);
+			mystl::swap(m_Group_Count, rhs.m_Group_Count);
+			mystl::swap(m_Size, rhs.m_Size);
+			mystl::swap(m_Used, rhs.m_Used);
+			mystl::swap(m_Has_Empty_Key, rhs.m_Has_Empty_Key);
+			mystl::swap(m_Has_Deleted_Key, rhs.m_Has_Deleted_Key);
+			mystl::swap(m_Hash, rhs.m_Hash);
+		}
+
+		// 没有迭代器，按槽的顺序对每个元素调用 f(key)
+		template <class F>
+		void for_each(F f) const
+		{
+			if (m_Has_Empty_Key) {
+				f(empty_key);
+			}
+			if (m_Has_Deleted_Key) {
+				f(deleted_key);
+			}
+			for (size_type i = 0; i < capacity(); ++i) {
+				if (m_Slots[i] != empty_key && m_Slots[i] != deleted_key) {
+					f(m_Slots[i]);
+				}
+			}
+		}
+
+		hasher hash_function() const
+		{
+			return m_Hash;
+		}
+
+	private:
+
+		size_type group_of(T key) const noexcept
+		{
+			return static_cast<size_type>(m_Hash(key)) & (m_Group_Count - 1);
+		}
+
+		size_type max_used() const noexcept
+		{
+			return capacity() * 7 / 8;
+		}
+
+		bool set_flag(bool& flag) noexcept
+		{
+			const bool inserted = !flag;
+			flag = true;
+			return inserted;
+		}
+
+		size_type clear_flag(bool& flag) noexcept
+		{
+			const size_type n = flag ? 1 : 0;
+			flag = false;
+			return n;
+		}
+
+		static unsigned first_bit(unsigned m) noexcept
+		{
+			unsigned i = 0;
+			while ((m & 1) == 0) {
+				m >>= 1;
+				++i;
+			}
+			return i;
+		}
+
+		// 返回一组里等于 key 的槽的位掩码，第 i 位对应第 i 个槽
+		static unsigned match(const T* p, T key) noexcept
+		{
+			return match(p, key, std::integral_constant<size_type, sizeof(T)>());
+		}
+
+		template <size_type N>
+		static unsigned match(const T* p, T key, std::integral_constant<size_type, N>) noexcept
+		{
+			unsigned m = 0;
+			for (size_type i = 0; i < group_size; ++i) {
+				m |= static_cast<unsigned>(p[i] == key) << i;
+			}
+			return m;
+		}
+
+#if defined(__AVX2__)
+		static unsigned match(const T* p, T key, std::integral_constant<size_type, 4>) noexcept
+		{
+			const __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+			const __m256i eq = _mm256_cmpeq_epi32(v, _mm256_set1_epi32(static_cast<int>(key)));
+			return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+		}
+
+		static unsigned match(const T* p, T key, std::integral_constant<size_type, 8>) noexcept
+		{
+			const __m256i k = _mm256_set1_epi64x(static_cast<long long>(key));
+			const __m256i lo = _mm256_cmpeq_epi64(_mm256_load_si256(reinterpret_cast<const __m256i*>(p)), k);
+			const __m256i hi = _mm256_cmpeq_epi64(_mm256_load_si256(reinterpret_cast<const __m256i*>(p + 4)), k);
+			return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(lo))) |
+				(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(hi))) << 4);
+		}
+#endif
+
+		void allocate(size_type groups)
+		{
+			// 多分配一组用来对齐
+			m_Raw = data_allocator::allocate((groups + 1) * group_size);
+			const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(m_Raw);
+			const std::uintptr_t aligned = (addr + group_bytes - 1) & ~static_cast<std::uintptr_t>(group_bytes - 1);
+			m_Slots = reinterpret_cast<T*>(aligned);
+			m_Group_Count = groups;
+		}
+
+		// 元素太多就翻倍，删除标记太多就按原大小重建一次把它们清掉
+		void grow()
+		{
+			if (m_Group_Count == 0 || m_Size + 1 > capacity() * 7 / 16) {
+				THROW_LENGTH_ERROR_IF(m_Group_Count > (size_type(-1) / sizeof(T) / group_size) / 4,
+					"int_hash_set<T> size too big");
+				rehash_groups(m_Group_Count == 0 ? 1 : m_Group_Count * 2);
+			}
+			else {
+				rehash_groups(m_Group_Count);
+			}
+		}
+
+		void rehash_groups(size_type groups)
+		{
+			int_hash_set tmp;
+			tmp.m_Hash = m_Hash;
+			tmp.allocate(groups);
+			std::memset(tmp.m_Slots, 0xff, tmp.memory_bytes());
+			for (size_type i = 0; i < capacity(); ++i) {
+				const T key = m_Slots[i];
+				if (key != empty_key && key != deleted_key) {
+					tmp.insert_noresize(key);
+				}
+			}
+			tmp.m_Has_Empty_Key = m_Has_Empty_Key;
+			tmp.m_Has_Deleted_Key = m_Has_Deleted_Key;
+			swap(tmp);
+		}
+
+		// rehash 时用，新表里没有重复也没有删除标记，找到第一个空槽就放
+		void insert_noresize(T key) noexcept
+		{
+			for (size_type g = group_of(key); ; g = (g + 1) & (m_Group_Count - 1)) {
+				T* p = m_Slots + g * group_size;
+				const unsigned e = match(p, empty_key);
+				if (e != 0) {
+					p[first_bit(e)] = key;
+					++m_Size;
+					++m_Used;
+					return;
+				}
+			}
+		}
+	};
+
+	template <class T, class Hash>
+	constexpr typename int_hash_set<T, Hash>::size_type int_hash_set<T, Hash>::group_size;
+
+	template <class T, class Hash>
+	constexpr T int_hash_set<T, Hash>::empty_key;
+
+	template <class T, class Hash>
+	constexpr T int_hash_set<T, Hash>::deleted_key;
+
+	template <class T, class Hash>
+	void swap(int_hash_set<T, Hash>& lhs, int_hash_set<T, Hash>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_INT_HASH_SET_H
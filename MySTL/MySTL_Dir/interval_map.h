@@ -0,0 +1,387 @@
+#ifndef MYSTL_INTERVAL_MAP_H
+#define MYSTL_INTERVAL_MAP_H
+
+
+#include "rb_tree.h"
+
+
+namespace mystl {
+
+	// 闭区间 [low, high]，要求 !(high < low)，Key 只需要支持 <
+	template <class Key>
+	struct interval
+	{
+		Key low;
+		Key high;
+	};
+
+	template <class Key>
+	bool operator==(const interval<Key>& lhs, const interval<Key>& rhs)
+	{
+		return !(lhs.low < rhs.low) && !(rhs.low < lhs.low) && !(lhs.high < rhs.high) && !(rhs.high < lhs.high);
+	}
+
+	template <class Key>
+	bool operator!=(const interval<Key>& lhs, const interval<Key>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	// 先按左端点再按右端点排序
+	template <class Key>
+	struct interval_less
+	{
+		bool operator()(const interval<Key>& lhs, const interval<Key>& rhs) const
+		{
+			return lhs.low < rhs.low || (!(rhs.low < lhs.low) && lhs.high < rhs.high);
+		}
+	};
+
+	// 区间树的节点增强：每个节点多存一个以它为根的子树里最大的右端点
+	// 节点内存是原始分配的，max_high 不经过构造直接赋值，所以要求 Key 可平凡拷贝 (见 interval_map)
+	template <class Key, class T>
+	struct rb_tree_augment<mystl::pair<const interval<Key>, T>>
+	{
+		static constexpr bool enabled = true;
+
+		Key max_high;
+
+		template <class NodePtr>
+		static void update(NodePtr x) noexcept
+		{
+			const Key* m = &x->get_node_ptr()->value.first.high;
+			if (x->left != nullptr && *m < x->left->max_high) {
+				m = &x->left->max_high;
+			}
+			if (x->right != nullptr && *m < x->right->max_high) {
+				m = &x->right->max_high;
+			}
+			x->max_high = *m;
+		}
+
+		template <class NodePtr>
+		static void copy(NodePtr dst, NodePtr src) noexcept
+		{
+			dst->max_high = src->max_high;
+		}
+	};
+
+	// 区间 -> 值的 multimap，按 (low, high) 排序，允许相同的区间
+	// 底层是 rb_tree，每个节点维护子树的最大右端点，旋转、插入、删除时随之更新
+	// 重叠查询从根往下走，右端点最大值都小于 a 的子树整棵跳过，遇到左端点大于 b 的节点就不再往右，
+	// 没有命中时 O(log n)；命中 k 个时最坏 O(log n + k log(n / k))，命中的区间在排序上连成一段时是 O(log n + k)
+	// 只靠子树最大右端点做不到一般情况的 O(log n + k)：命中的节点之间夹着右端点很小的节点时，
+	// 每个命中都要单独从公共祖先往下找
+	template <class Key, class T>
+	class interval_map
+	{
+		static_assert(std::is_trivially_copyable<Key>::value,
+			"interval_map<Key, T> needs a trivially copyable Key");
+
+	public:
+
+		using interval_type = interval<Key>;
+
+	private:
+
+		using base_type = rb_tree<pair<const interval_type, T>, interval_less<Key>>;
+		using base_ptr = typename base_type::base_ptr;
+		base_type tree;
+
+	public:
+
+		using allocator_type = typename base_type::allocator_type;
+		using key_type = typename base_type::key_type;
+		using mapped_type = typename base_type::mapped_type;
+		using value_type = typename base_type::value_type;
+		using key_compare = typename base_type::key_compare;
+
+		using pointer = typename base_type::pointer;
+		using const_pointer = typename base_type::const_pointer;
+		using reference = typename base_type::reference;
+		using const_reference = typename base_type::const_reference;
+		using size_type = typename base_type::size_type;
+		using difference_type = typename base_type::difference_type;
+
+		using iterator = typename base_type::iterator;
+		using const_iterator = typename base_type::const_iterator;
+		using reverse_iterator = typename base_type::reverse_iterator;
+		using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+		allocator_type get_allocator() const { return tree.get_allocate(); }
+		key_compare key_comp() const { return tree.key_comp(); }
+
+	public:
+
+		interval_map() = default;
+
+		template <class InputIter>
+		interval_map(InputIter first, InputIter last)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		interval_map(std::initializer_list<value_type> ilist)
+		{
+			tree.insert_multi(ilist.begin(), ilist.end());
+		}
+
+		interval_map(const interval_map& other) : tree(other.tree) {}
+
+		interval_map(interval_map&& other) noexcept : tree(mystl::move(other.tree)) {}
+
+		interval_map& operator=(const interval_map& other)
+		{
+			tree = other.tree;
+			return *this;
+		}
+
+		interval_map& operator=(interval_map&& other) noexcept
+		{
+			tree = mystl::move(other.tree);
+			return *this;
+		}
+
+		~interval_map() = default;
+
+		// 批量构建：[first, last) 已经按 (low, high) 排好序，O(n) 建成平衡的树，原来的元素全部丢掉
+		template <class ForwardIter>
+		void assign_sorted(ForwardIter first, ForwardIter last)
+		{
+			tree.assign_sorted_multi(first, last);
+		}
+
+		iterator begin() noexcept
+		{
+			return tree.begin();
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return tree.begin();
+		}
+
+		iterator end() noexcept
+		{
+			return tree.end();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return tree.end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return tree.rbegin();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return tree.rbegin();
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return tree.rend();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return tree.rend();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return tree.cbegin();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return tree.cend();
+		}
+
+		bool empty() const noexcept
+		{
+			return tree.empty();
+		}
+
+		size_type size() const noexcept
+		{
+			return tree.size();
+		}
+
+		template <class ...Args>
+		iterator emplace(Args&& ...args)
+		{
+			return tree.emplace_multi(mystl::forward<Args>(args)...);
+		}
+
+		iterator insert(const value_type& value)
+		{
+			return tree.insert_multi(value);
+		}
+
+		iterator insert(value_type&& value)
+		{
+			return tree.insert_multi(mystl::move(value));
+		}
+
+		iterator insert(const Key& low, const Key& high, const mapped_type& obj)
+		{
+			return tree.emplace_multi(interval_type{ low, high }, obj);
+		}
+
+		template <class InputIter>
+		void insert(InputIter first, InputIter last)
+		{
+			tree.insert_multi(first, last);
+		}
+
+		iterator erase(iterator position)
+		{
+			return tree.erase(position);
+		}
+
+		// 删掉所有和 key 相同的区间
+		size_type erase(const key_type& key)
+		{
+			return tree.erase_multi(key);
+		}
+
+		void erase(iterator first, iterator last)
+		{
+			tree.erase(first, last);
+		}
+
+		void clear()
+		{
+			tree.clear();
+		}
+
+		void swap(interval_map& other) noexcept
+		{
+			tree.swap(other.tree);
+		}
+
+		// 精确查找区间 key
+		iterator find(const key_type& key)
+		{
+			return tree.find(key);
+		}
+
+		const_iterator find(const key_type& key) const
+		{
+			return tree.find(key);
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return tree.count_multi(key);
+		}
+
+		// 下面是重叠查询，区间都是闭区间
+
+		// 任意一个和 [a, b] 相交的区间，没有则返回 end()，O(log n)
+		iterator find_overlapping(const Key& a, const Key& b)
+		{
+			return iterator(find_overlapping_node(a, b));
+		}
+
+		const_iterator find_overlapping(const Key& a, const Key& b) const
+		{
+			return const_iterator(find_overlapping_node(a, b));
+		}
+
+		// 按 (low, high) 的顺序对每个和 [a, b] 相交的元素调用 fn(value_type&)，返回调用次数
+		template <class Fn>
+		size_type for_each_overlapping(const Key& a, const Key& b, Fn fn)
+		{
+			auto visit = [&fn](base_ptr x) { fn(x->get_node_ptr()->value); };
+			return visit_overlapping(root_node(), a, b, visit);
+		}
+
+		template <class Fn>
+		size_type for_each_overlapping(const Key& a, const Key& b, Fn fn) const
+		{
+			auto visit = [&fn](base_ptr x) { fn(static_cast<const value_type&>(x->get_node_ptr()->value)); };
+			return visit_overlapping(root_node(), a, b, visit);
+		}
+
+		// 包含点 x 的区间，也就是和 [x, x] 相交的区间
+		template <class Fn>
+		size_type for_each_containing(const Key& x, Fn fn)
+		{
+			return for_each_overlapping(x, x, fn);
+		}
+
+		template <class Fn>
+		size_type for_each_containing(const Key& x, Fn fn) const
+		{
+			return for_each_overlapping(x, x, fn);
+		}
+
+	private:
+
+		// header 的 parent 就是根
+		base_ptr root_node() const
+		{
+			return tree.empty() ? nullptr : tree.end().node->get_parent();
+		}
+
+		static const interval_type& get_interval(base_ptr x)
+		{
+			return x->get_node_ptr()->value.first;
+		}
+
+		// 左子树里有和 [a, b] 相交的就往左，否则左子树里不可能有，往右
+		base_ptr find_overlapping_node(const Key& a, const Key& b) const
+		{
+			base_ptr x = root_node();
+			while (x != nullptr) {
+				const interval_type& iv = get_interval(x);
+				if (!(b < iv.low) && !(iv.high < a)) {
+					return x;
+				}
+				if (x->left != nullptr && !(x->left->max_high < a)) {
+					x = x->left;
+				}
+				else {
+					x = x->right;
+				}
+			}
+			return tree.end().node;
+		}
+
+		// 按中序走，访问到的节点要么命中，要么是某个命中节点的祖先，
+		// 要么在第一个左端点大于 b 的节点到根的路径上，所以一共是 k + 1 条到根的路径的并
+		template <class Visit>
+		static size_type visit_overlapping(base_ptr x, const Key& a, const Key& b, Visit& visit)
+		{
+			size_type n = 0;
+			while (x != nullptr && !(x->max_high < a)) {
+				n += visit_overlapping(x->left, a, b, visit);
+				const interval_type& iv = get_interval(x);
+				// x 和右子树的左端点都不小于 iv.low
+				if (b < iv.low) {
+					break;
+				}
+				if (!(iv.high < a)) {
+					visit(x);
+					++n;
+				}
+				x = x->right;
+			}
+			return n;
+		}
+	};
+
+	template <class Key, class T>
+	void swap(interval_map<Key, T>& lhs, interval_map<Key, T>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_INTERVAL_MAP_H
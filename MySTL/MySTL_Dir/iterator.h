@@ -7,14 +7,14 @@
 
 namespace mystl
 {
-	// ֵ
+	// 五种迭代器类型
 	class input_iterator_tag{};
 	class output_iterator_tag{};
 	class forward_iterator_tag: public input_iterator_tag{};
 	class bidirectional_iterator_tag: public forward_iterator_tag{};
 	class radom_access_iterator_tag: public bidirectional_iterator_tag{};
 
-	// ֲ̳ͬĵ
+	// 用这个类继承上面的类来区分不同的迭代器
 	template <class Category,class T,class Distance = ptrdiff_t,class Pointer = T*,class Reference = T&>
 	class iterator {
 	public:
@@ -25,7 +25,7 @@ namespace mystl
 		using iterator_category = Category;
 	};
 	
-	// жǲһ
+	// 判断这个类是不是一个迭代器
 	template <class Iterator>
 	class has_iterator_cat {
 	private:
@@ -36,11 +36,11 @@ namespace mystl
 		static constexpr bool value = (sizeof(test<Iterator>(0)) == sizeof(char));
 	};
 
-	// һ
+	// 这个类是做一个过滤
 	template <class Iterator, bool>
 	class iterator_traits_impl{};
 
-	// Ļ
+	// 迭代器的基础
 	template <class Iterator>
 	class iterator_traits_impl <Iterator, true> {
 	public:
@@ -51,22 +51,22 @@ namespace mystl
 		using iterator_category = typename Iterator::iterator_category;
 	};
 
-	// һʲôҲ
+	// 如果不是一个迭代器就什么也不做
 	template <class Iterator, bool>
 	class iterator_traits_helper{};
 
-	// һͼ̳
+	// 如果是一个输出或输入迭代器就继承它
 	template <class Iterator>
 	class iterator_traits_helper<Iterator, true>: public iterator_traits_impl<Iterator,
 		std::is_convertible<typename Iterator::iterator_category, input_iterator_tag>::value ||
 		std::is_convertible<typename Iterator::iterator_category, output_iterator_tag>::value>
 	{};
 
-	// ̳һ࣬ǲǵģж
+	// 继承一个类，它是不是迭代器由模板判断
 	template <class Iterator>
 	class iterator_traits: public iterator_traits_helper<Iterator, has_iterator_cat<Iterator>::value> {};
 
-	// ָ
+	// 对指针的特例化
 	template <class T>
 	class iterator_traits<T*> {
 	public:
@@ -77,7 +77,7 @@ namespace mystl
 		using iterator_category = radom_access_iterator_tag;
 	};
 
-	// õ
+	// 对引用的特例化
 	template <class T>
 	class iterator_traits<T&> {
 	public:
@@ -88,7 +88,7 @@ namespace mystl
 		using iterator_category = radom_access_iterator_tag;
 	};
 
-	// constָ
+	// 对const指针的特例化
 	template <class T>
 	class iterator_traits<const T*> {
 	public:
@@ -99,7 +99,7 @@ namespace mystl
 		using iterator_category = radom_access_iterator_tag;
 	};
 
-	// жĻ
+	// 判断类的基类
 	template <class T, class U, bool = has_iterator_cat<iterator_traits<T>>::value>
 	class has_iterator_cat_of : public m_bool_constant<std::is_convertible
 		<typename iterator_traits<T>::iterator_category, U>::value> {};
@@ -123,24 +123,24 @@ namespace mystl
 	template <class Iter>
 	class is_radom_access_iterator : public has_iterator_cat_of<Iter, mystl::radom_access_iterator_tag> {};
 
-	// ĿǷһͣͨȥ
+	// 目的是返回一个迭代器的类型，通过这个类型去调用其它函数
 	template <class Iter>
 	typename iterator_traits<Iter>::iterator_category iterator_category(const Iter&) {
-		using Category = iterator_traits<Iter>::iterator_category;
+		using Category = typename iterator_traits<Iter>::iterator_category;
 		return Category();
 	}
 
 	template <class Iter>
 	typename iterator_traits<Iter>::different_type* distance_type(const Iter&) {
-		return static_cast<iterator_traits<Iter>::different_type*>(0);
+		return static_cast<typename iterator_traits<Iter>::different_type*>(0);
 	}
 
 	template <class Iter>
 	typename iterator_traits<Iter>::value_type* value_type(const Iter&) {
-		return static_cast<iterator_traits<Iter>::value_type*>(0);
+		return static_cast<typename iterator_traits<Iter>::value_type*>(0);
 	}
 
-	// ĳ
+	// 链表的长度
 	template <class Iter>
 	typename iterator_traits<Iter>::different_type distance_dispatch(Iter first, Iter end, input_iterator_tag) {
 		typename iterator_traits<Iter>::different_type size = 0;
@@ -151,13 +151,13 @@ namespace mystl
 		return size;
 	}
 
-	// ĳ
+	// 数组的长度
 	template <class Iter>
 	typename iterator_traits<Iter>::different_type distance_dispatch(Iter first, Iter end, radom_access_iterator_tag) {
 		return end - first;
 	}
 
-	// ͨ;ĸ
+	// 通过迭代器类型决定调用哪个函数
 	template <class Iter>
 	typename iterator_traits<Iter>::different_type distance(Iter first, Iter end) {
 		return distance_dispatch(first, end, iterator_category(first));
@@ -193,7 +193,7 @@ namespace mystl
 
 
 	/*------------------------------------------------------------------------------------------*/
-	// 
+	// 反向迭代器
 
 	
 
@@ -204,14 +204,14 @@ namespace mystl
 
 	public:
 
-		// ԺtypedefҪusingױ
-		using iterator_type		= typename Iter;
-		typedef typename reverse_iterator<typename Iter>					self;
-		typedef typename iterator_traits<typename Iter>::pointer			pointer;
-		typedef typename iterator_traits<typename Iter>::reference			reference;
-		typedef typename iterator_traits<typename Iter>::value_type			value_type;
-		typedef typename iterator_traits<typename Iter>::different_type		different_type;
-		typedef typename iterator_traits<typename Iter>::iterator_category	iterator_category;
+		// 以后尽量用typedef，不要用using，容易报错
+		using iterator_type		= Iter;
+		typedef reverse_iterator<Iter>										self;
+		typedef typename iterator_traits<Iter>::pointer						pointer;
+		typedef typename iterator_traits<Iter>::reference					reference;
+		typedef typename iterator_traits<Iter>::value_type					value_type;
+		typedef typename iterator_traits<Iter>::different_type				different_type;
+		typedef typename iterator_traits<Iter>::iterator_category			iterator_category;
 
 		/*using self				= typename reverse_iterator<Iter>;
 		template <class Iter>
@@ -263,38 +263,38 @@ namespace mystl
 
 	template <class Iter>
 	typename reverse_iterator<Iter>::different_type
-		operator-(Iter lhs, Iter rhs) {
+		operator-(const reverse_iterator<Iter>& lhs, const reverse_iterator<Iter>& rhs) {
 		return rhs.base() - lhs.base();
 	}
 
 	template <class Iter>
-	typename bool operator==(Iter lhs, Iter rhs) {
+	bool operator==(const reverse_iterator<Iter>& lhs, const reverse_iterator<Iter>& rhs) {
 		return rhs.base() == lhs.base();
 	}
 
 	template <class Iter>
-	typename bool operator!=(Iter lhs, Iter rhs) {
-		return !operator==(lhs, rhs);
+	bool operator!=(const reverse_iterator<Iter>& lhs, const reverse_iterator<Iter>& rhs) {
+		return !(lhs == rhs);
 	}
 
 	template <class Iter>
-	typename bool operator<(Iter lhs, Iter rhs) {
-		return lhs.base() < rhs.base();
+	bool operator<(const reverse_iterator<Iter>& lhs, const reverse_iterator<Iter>& rhs) {
+		return rhs.base() < lhs.base();
 	}
 
 	template <class Iter>
-	typename bool operator<=(Iter lhs, Iter rhs) {
-		return operator==(lhs, rhs) || operator<(lhs, rhs);
+	bool operator<=(const reverse_iterator<Iter>& lhs, const reverse_iterator<Iter>& rhs) {
+		return !(rhs < lhs);
 	}
 
 	template <class Iter>
-	typename bool operator>(Iter lhs, Iter rhs) {
-		return !operator<=(lhs, rhs);
+	bool operator>(const reverse_iterator<Iter>& lhs, const reverse_iterator<Iter>& rhs) {
+		return rhs < lhs;
 	}
 
 	template <class Iter>
-	typename bool operator>=(Iter lhs, Iter rhs) {
-		return !operator<(lhs, rhs);
+	bool operator>=(const reverse_iterator<Iter>& lhs, const reverse_iterator<Iter>& rhs) {
+		return !(lhs < rhs);
 	}
 }
 
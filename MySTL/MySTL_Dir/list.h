@@ -10,8 +10,8 @@
 
 namespace mystl {
 
-	// publicʱӦpublicӦü鴫Ĵ
-	// publicprivateʱprivateӦüϵͳĴ
+	// 外面调用public函数时应该public函数应该检查传入参数的错误
+	// public函数调用private函数时private函数应该检查系统的错误
 
 	template <class T> struct list_node_base;
 	template <class T> struct list_node;
@@ -0,0 +1,341 @@
+#ifndef MYSTL_LRU_CACHE_H
+#define MYSTL_LRU_CACHE_H
+
+#include <atomic>
+
+#include "hashtable.h"
+
+namespace mystl {
+
+	// 淘汰策略
+	// lru_policy: 每次命中把节点移到链表头，淘汰链表尾，严格按最近使用的顺序
+	// clock_policy: 命中只置一个引用位，不动链表；淘汰时指针绕环走，跳过并清掉有引用位的节点
+	//               get 不改结构，多个线程可以在读锁 (rw_lock 的 lock_shared) 下同时 get
+	struct lru_policy {};
+	struct clock_policy {};
+
+	// 双向链表的指针单独放在基类里，表头哨兵只需要这两个指针，不用构造 value
+	struct lru_cache_link
+	{
+		lru_cache_link* prev;
+		lru_cache_link* next;
+	};
+
+	// 一个节点同时挂在桶的单链表和淘汰顺序的双向链表上，每个元素只分配一次
+	template <class T>
+	struct lru_cache_node : public lru_cache_link
+	{
+		lru_cache_node* hash_next;
+		std::atomic<bool> referenced;
+		T value;
+
+		template <class ...Args>
+		explicit lru_cache_node(Args&& ...args)
+			: hash_next(nullptr), referenced(false), value(mystl::forward<Args>(args)...) {}
+	};
+
+	// 固定容量的缓存，满了之后 put 新 key 会按 Policy 淘汰一个旧元素
+	// 容量在构造时就定了，桶数组一次分配好，之后不会 rehash
+	template <class Key, class T, class Hash = mystl::hash<Key>,
+		class KeyEqual = mystl::equal_to<Key>, class Policy = lru_policy>
+	class lru_cache
+	{
+	public:
+
+		using key_type		= Key;
+		using mapped_type	= T;
+		using value_type	= mystl::pair<const Key, T>;
+		using hasher		= Hash;
+		using key_equal		= KeyEqual;
+		using size_type		= size_t;
+
+	private:
+
+		using node_type = lru_cache_node<value_type>;
+		using node_ptr = node_type*;
+		using link_ptr = lru_cache_link*;
+		using node_allocator = mystl::allocator<node_type>;
+		using bucket_type = mystl::vector<node_ptr>;
+
+		bucket_type		m_Bucket;
+		size_type		m_Bucket_Size;
+		size_type		m_Size;
+		size_type		m_Capacity;
+		// 环形链表的哨兵，next 是最近用的一端，prev 是最久没用的一端
+		lru_cache_link	m_Head;
+		// clock_policy 下淘汰指针的位置，指向 m_Head 表示从最久的一端开始
+		link_ptr		m_Hand;
+		hasher			m_Hash;
+		key_equal		m_Equal;
+
+		// get 在 clock_policy 下可能被多个线程同时调用，计数器用原子变量
+		std::atomic<size_type> m_Hits;
+		std::atomic<size_type> m_Misses;
+		size_type		m_Evictions;
+
+	public:
+
+		explicit lru_cache(size_type capacity,
+			const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual())
+			: m_Bucket_Size(ht_next_prime(capacity)), m_Size(0), m_Capacity(capacity)
+			, m_Hand(&m_Head), m_Hash(hash), m_Equal(equal)
+			, m_Hits(0), m_Misses(0), m_Evictions(0)
+		{
+			THROW_LENGTH_ERROR_IF(capacity == 0, "lru_cache capacity must be positive");
+			m_Bucket.assign(m_Bucket_Size, nullptr);
+			m_Head.prev = m_Head.next = &m_Head;
+		}
+
+		// 节点之间靠指针互相引用，拷贝需要重建两条链，这里不提供
+		lru_cache(const lru_cache&) = delete;
+		lru_cache& operator=(const lru_cache&) = delete;
+
+		~lru_cache()
+		{
+			clear();
+		}
+
+	public:
+
+		bool empty() const noexcept
+		{
+			return m_Size == 0;
+		}
+
+		size_type size() const noexcept
+		{
+			return m_Size;
+		}
+
+		size_type capacity() const noexcept
+		{
+			return m_Capacity;
+		}
+
+		// 查找并记一次命中，lru_policy 下同时把节点移到最近用的一端
+		// 找不到返回 nullptr，返回的指针在这个 key 被淘汰或删除之前有效
+		T* get(const key_type& key)
+		{
+			node_ptr np = find_node(key);
+			if (np == nullptr) {
+				m_Misses.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			m_Hits.fetch_add(1, std::memory_order_relaxed);
+			touch(np, Policy());
+			return mystl::address_of(np->value.second);
+		}
+
+		// 只查找，不算命中也不影响淘汰顺序
+		const T* peek(const key_type& key) const
+		{
+			node_ptr np = find_node(key);
+			return np != nullptr ? mystl::address_of(np->value.second) : nullptr;
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return find_node(key) != nullptr;
+		}
+
+		// key 已存在时更新值并算一次使用，返回 false；否则插入，满了淘汰一个，返回 true
+		template <class V>
+		bool put(const key_type& key, V&& value)
+		{
+			node_ptr np = find_node(key);
+			if (np != nullptr) {
+				np->value.second = mystl::forward<V>(value);
+				touch(np, Policy());
+				return false;
+			}
+			// 先构造新节点再淘汰，构造抛异常时缓存里的元素一个都不少
+			np = create_node(key, mystl::forward<V>(value));
+			if (m_Size == m_Capacity) {
+				try {
+					evict(Policy());
+				}
+				catch (...) {
+					destroy_node(np);
+					throw;
+				}
+			}
+			const size_type n = bucket_of(key);
+			np->hash_next = m_Bucket[n];
+			m_Bucket[n] = np;
+			link_front(np);
+			++m_Size;
+			return true;
+		}
+
+		size_type erase(const key_type& key)
+		{
+			const size_type n = bucket_of(key);
+			for (node_ptr* pp = &m_Bucket[n]; *pp != nullptr; pp = &(*pp)->hash_next) {
+				if (m_Equal((*pp)->value.first, key)) {
+					node_ptr np = *pp;
+					*pp = np->hash_next;
+					unlink(np);
+					destroy_node(np);
+					--m_Size;
+					return 1;
+				}
+			}
+			return 0;
+		}
+
+		void clear()
+		{
+			link_ptr cur = m_Head.next;
+			while (cur != &m_Head) {
+				link_ptr next = cur->next;
+				destroy_node(static_cast<node_ptr>(cur));
+				cur = next;
+			}
+			m_Head.prev = m_Head.next = &m_Head;
+			m_Hand = &m_Head;
+			m_Bucket.assign(m_Bucket_Size, nullptr);
+			m_Size = 0;
+		}
+
+		size_type hits() const noexcept
+		{
+			return m_Hits.load(std::memory_order_relaxed);
+		}
+
+		size_type misses() const noexcept
+		{
+			return m_Misses.load(std::memory_order_relaxed);
+		}
+
+		size_type evictions() const noexcept
+		{
+			return m_Evictions;
+		}
+
+		float hit_ratio() const noexcept
+		{
+			const size_type total = hits() + misses();
+			return total != 0 ? (float)hits() / total : 0.0f;
+		}
+
+		void reset_stats() noexcept
+		{
+			m_Hits.store(0, std::memory_order_relaxed);
+			m_Misses.store(0, std::memory_order_relaxed);
+			m_Evictions = 0;
+		}
+
+	private:
+
+		size_type bucket_of(const key_type& key) const
+		{
+			return m_Hash(key) % m_Bucket_Size;
+		}
+
+		node_ptr find_node(const key_type& key) const
+		{
+			for (node_ptr np = m_Bucket[bucket_of(key)]; np != nullptr; np = np->hash_next) {
+				if (m_Equal(np->value.first, key)) {
+					return np;
+				}
+			}
+			return nullptr;
+		}
+
+		template <class V>
+		node_ptr create_node(const key_type& key, V&& value)
+		{
+			node_ptr np = node_allocator::allocate(1);
+			try {
+				node_allocator::construct(np, key, mystl::forward<V>(value));
+			}
+			catch (...) {
+				node_allocator::deallocate(np);
+				throw;
+			}
+			return np;
+		}
+
+		void destroy_node(node_ptr np)
+		{
+			node_allocator::destroy(np);
+			node_allocator::deallocate(np);
+		}
+
+		void link_front(link_ptr np) noexcept
+		{
+			np->prev = &m_Head;
+			np->next = m_Head.next;
+			m_Head.next->prev = np;
+			m_Head.next = np;
+		}
+
+		void unlink(link_ptr np) noexcept
+		{
+			// 淘汰指针正指着要摘掉的节点时先让它退回到更新的一侧
+			if (m_Hand == np) {
+				m_Hand = np->prev;
+			}
+			np->prev->next = np->next;
+			np->next->prev = np->prev;
+		}
+
+		void touch(node_ptr np, lru_policy) noexcept
+		{
+			if (m_Head.next != np) {
+				unlink(np);
+				link_front(np);
+			}
+		}
+
+		void touch(node_ptr np, clock_policy) noexcept
+		{
+			if (!np->referenced.load(std::memory_order_relaxed)) {
+				np->referenced.store(true, std::memory_order_relaxed);
+			}
+		}
+
+		void evict(lru_policy)
+		{
+			evict_node(static_cast<node_ptr>(m_Head.prev));
+		}
+
+		// 指针从最久的一端往最近的一端走，有引用位的清掉再给一次机会
+		// 最多绕一圈就会遇到引用位已清零的节点
+		void evict(clock_policy)
+		{
+			for (;;) {
+				if (m_Hand == &m_Head) {
+					m_Hand = m_Head.prev;
+				}
+				node_ptr np = static_cast<node_ptr>(m_Hand);
+				if (!np->referenced.load(std::memory_order_relaxed)) {
+					evict_node(np);
+					return;
+				}
+				np->referenced.store(false, std::memory_order_relaxed);
+				m_Hand = m_Hand->prev;
+			}
+		}
+
+		void evict_node(node_ptr victim)
+		{
+			node_ptr* pp = &m_Bucket[bucket_of(victim->value.first)];
+			while (*pp != victim) {
+				pp = &(*pp)->hash_next;
+			}
+			*pp = victim->hash_next;
+			unlink(victim);
+			destroy_node(victim);
+			--m_Size;
+			++m_Evictions;
+		}
+	};
+
+	template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+	using clock_cache = lru_cache<Key, T, Hash, KeyEqual, clock_policy>;
+
+}
+
+#endif // !MYSTL_LRU_CACHE_H
@@ -1,9 +1,10 @@
 #ifndef MYSTL_MEMORY_H
 #define MYSTL_MEMORY_H
 
-// ļǹڻ
+// 这个文件是关于缓冲区的
 
 #include <cstddef>
+#include <climits>
 #include <limits>
 #include <cstdlib>
 
@@ -15,7 +16,7 @@
 
 namespace mystl {
 
-	//Ǵһȡָλõĵַ
+	//这个函数是从一个迭代器中取出指向位置的地址
 	template <class T>
 	constexpr T* address_of(T& value) noexcept {
 		return &value;
@@ -34,7 +35,7 @@ namespace mystl {
 			}
 			len /= 2;
 		}
-		return pair<T*, ptrdiff_t>(nullptr, 0)
+		return pair<T*, ptrdiff_t>(nullptr, 0);
 	}
 
 	template <class T>
@@ -44,7 +45,7 @@ namespace mystl {
 
 	template <class T>
 	pair<T*, ptrdiff_t> get_temporary_buffer(ptrdiff_t len) {
-		return get_buffer_helper(len, static_cast<T*>(0))
+		return get_buffer_helper(len, static_cast<T*>(0));
 	}
 
 	template <class T>
@@ -87,23 +88,23 @@ namespace mystl {
 			mystl::uninitialized_fill_n(ptr, len, value);
 		}
 		
-	private:
-		temporary_buffer(const temporary_buffer&) = default;
-
-		temporary_buffer& operator=(const temporary_buffer&) = default;
+	public:
+		temporary_buffer(const temporary_buffer&) = delete;
 
+		temporary_buffer& operator=(const temporary_buffer&) = delete;
 
 	};
 
 
 	template<class ForwardIter, class T>
 	inline temporary_buffer<ForwardIter, T>::temporary_buffer(ForwardIter first, ForwardIter last)
+		: len(0), original_len(0), ptr(nullptr)
 	{
 		try {
-			len = mystl::distance(first, last);
+			original_len = mystl::distance(first, last);
 			allocate_buffer();
 			if (len > 0) {
-				initialize_buffer(*first, std::is_trivially_default_constructible<T>::value);
+				initialize_buffer(*first, typename std::is_trivially_default_constructible<T>::type());
 			}
 		}
 		catch (...) {
@@ -116,16 +117,17 @@ namespace mystl {
 	template<class ForwardIter, class T>
 	inline void temporary_buffer<ForwardIter, T>::allocate_buffer()
 	{
-		original_len = len;
-		if (len > INT_MAX / sizeof(T)) {
-			original_len = INT_MAX / sizeof(T);
+		// 申请不到 original_len 个时逐次减半，len 是实际拿到的个数
+		len = original_len;
+		if (len > static_cast<ptrdiff_t>(INT_MAX / sizeof(T))) {
+			len = INT_MAX / sizeof(T);
 		}
-		while (original_len != 0) {
+		while (len > 0) {
 			ptr = static_cast<T*>(malloc(len * sizeof(T)));
 			if (ptr != nullptr) {
 				break;
 			}
-			original_len /= 2;
+			len /= 2;
 		}
 	}
 
@@ -0,0 +1,121 @@
+#ifndef MYSTL_NODE_HANDLE_H
+#define MYSTL_NODE_HANDLE_H
+
+#include "memory.h"
+#include "util.h"
+
+namespace mystl {
+
+	template <class T, class Hash, class KeyEqual>
+	class hashtable;
+
+	template <class T, class Compare, bool OrderStat>
+	class rb_tree;
+
+	// 节点句柄，持有从 hashtable 或 rb_tree 里 extract 出来的节点
+	// 节点在两个容器之间转移时只改指针，不会重新分配内存，也不会拷贝或移动元素
+	// 例外是 hashtable 批量插入和拷贝时整块分配的节点：块里的节点不能单独释放，
+	// extract 和 merge 遇到它们时会单独分配一个节点并把元素移动过去，
+	// 所以对这些节点来说每次转移都有一次分配和一次移动，元素的地址也会变
+	// 句柄析构时如果还持有节点，就和容器里一样析构元素并释放节点
+	template <class Node, class Value>
+	class node_handle
+	{
+		template <class T, class Hash, class KeyEqual>
+		friend class mystl::hashtable;
+
+		template <class T, class Compare, bool OrderStat>
+		friend class mystl::rb_tree;
+
+	public:
+
+		using value_type = Value;
+
+	private:
+
+		using data_allocator = mystl::allocator<Value>;
+		using node_allocator = mystl::allocator<Node>;
+
+		Node* m_Node;
+
+		explicit node_handle(Node* np) noexcept : m_Node(np) {}
+
+		Node* get() const noexcept
+		{
+			return m_Node;
+		}
+
+		// 容器接手节点后调用，句柄不再负责释放
+		Node* release() noexcept
+		{
+			Node* np = m_Node;
+			m_Node = nullptr;
+			return np;
+		}
+
+		void destroy() noexcept
+		{
+			if (m_Node != nullptr) {
+				data_allocator::destroy(mystl::address_of(m_Node->value));
+				node_allocator::deallocate(m_Node);
+				m_Node = nullptr;
+			}
+		}
+
+	public:
+
+		node_handle() noexcept : m_Node(nullptr) {}
+
+		node_handle(const node_handle&) = delete;
+		node_handle& operator=(const node_handle&) = delete;
+
+		node_handle(node_handle&& rhs) noexcept : m_Node(rhs.m_Node)
+		{
+			rhs.m_Node = nullptr;
+		}
+
+		node_handle& operator=(node_handle&& rhs) noexcept
+		{
+			if (this != &rhs) {
+				destroy();
+				m_Node = rhs.m_Node;
+				rhs.m_Node = nullptr;
+			}
+			return *this;
+		}
+
+		~node_handle()
+		{
+			destroy();
+		}
+
+		bool empty() const noexcept
+		{
+			return m_Node == nullptr;
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return m_Node != nullptr;
+		}
+
+		value_type& value() const noexcept
+		{
+			return m_Node->value;
+		}
+
+		void swap(node_handle& rhs) noexcept
+		{
+			mystl::swap(m_Node, rhs.m_Node);
+		}
+	};
+
+	template <class Node, class Value>
+	void swap(node_handle<Node, Value>& lhs, node_handle<Node, Value>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_NODE_HANDLE_H
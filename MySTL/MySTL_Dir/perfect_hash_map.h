@@ -0,0 +1,281 @@
+#ifndef MYSTL_PERFECT_HASH_MAP_H
+#define MYSTL_PERFECT_HASH_MAP_H
+
+#include <cstdint>
+#include <type_traits>
+
+#include "functional.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+	// 编译期字符串引用，只记录指针和长度
+	// 字符串字面量可以隐式转换过来，运行时拿到的 (ptr, len) 也可以直接构造，不要求以 '\0' 结尾
+	struct string_ref
+	{
+		const char* data;
+		size_t size;
+
+		constexpr string_ref() noexcept : data(""), size(0) {}
+
+		constexpr string_ref(const char* s, size_t n) noexcept : data(s), size(n) {}
+
+		template <size_t N>
+		constexpr string_ref(const char(&s)[N]) noexcept : data(s), size(N - 1) {}
+	};
+
+	constexpr bool operator==(const string_ref& lhs, const string_ref& rhs) noexcept
+	{
+		if (lhs.size != rhs.size) {
+			return false;
+		}
+		for (size_t i = 0; i < lhs.size; ++i) {
+			if (lhs.data[i] != rhs.data[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	constexpr bool operator!=(const string_ref& lhs, const string_ref& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+	// perfect_hash_map 对 key 的要求：带种子的 constexpr hash 和 constexpr 的相等比较
+	// 整数和枚举直接用 hash_mix，其它类型需要自己特化
+	template <class Key, bool = std::is_integral<Key>::value || std::is_enum<Key>::value>
+	struct perfect_hash_traits {};
+
+	template <class Key>
+	struct perfect_hash_traits<Key, true>
+	{
+		static constexpr std::uint64_t hash(const Key& key, std::uint64_t seed) noexcept
+		{
+			return hash_mix(static_cast<std::uint64_t>(key) ^ seed ^ hash_secret(0), hash_secret(1));
+		}
+
+		static constexpr bool equal(const Key& lhs, const Key& rhs) noexcept
+		{
+			return lhs == rhs;
+		}
+	};
+
+	// 和 hash_bytes 一样每 8 个字节做一次 hash_mix，只是按小端拼字，不用 memcpy，所以能在编译期求值
+	template <>
+	struct perfect_hash_traits<string_ref, false>
+	{
+		static constexpr std::uint64_t read(const char* p, size_t n) noexcept
+		{
+			std::uint64_t v = 0;
+			for (size_t i = 0; i < n; ++i) {
+				v |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (i * 8);
+			}
+			return v;
+		}
+
+		static constexpr std::uint64_t hash(const string_ref& key, std::uint64_t seed) noexcept
+		{
+			std::uint64_t h = hash_mix(seed ^ hash_secret(0), hash_secret(1) ^ key.size);
+			size_t i = 0;
+			for (; i + 8 <= key.size; i += 8) {
+				h = hash_mix(read(key.data + i, 8) ^ hash_secret(1), h ^ hash_secret(2));
+			}
+			return hash_mix(read(key.data + i, key.size - i) ^ hash_secret(3), h);
+		}
+
+		static constexpr bool equal(const string_ref& lhs, const string_ref& rhs) noexcept
+		{
+			return lhs == rhs;
+		}
+	};
+
+	template <class Key, class T>
+	struct perfect_hash_entry
+	{
+		Key key;
+		T value;
+	};
+
+	// 编译期构造的完美哈希表，算法参考 PTHash：
+	// key 先按 hash 分到 N / 2 + 1 个桶里，再从大到小给每个桶找一个 pilot，
+	// 使桶里所有 key 的 mix(hash ^ pilot) % slot_count 互不相同且没有被占用
+	// 查找时只需要 hash 一次、读一次 pilot、比较一次 key，没有冲突链也没有探测
+	// 整个对象是字面类型，声明成 constexpr 变量之后表直接放在只读数据段，启动时不做任何事
+	template <class Key, class T, size_t N, class Traits = perfect_hash_traits<Key>>
+	class perfect_hash_map
+	{
+	public:
+
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = perfect_hash_entry<Key, T>;
+		using size_type = size_t;
+		using const_iterator = const value_type*;
+
+		static_assert(N > 0, "perfect_hash_map needs at least one key");
+
+		static constexpr size_type bucket_count = N / 2 + 1;
+		// 留 20% 空位，最后几个桶找 pilot 时不至于要试太多次
+		static constexpr size_type slot_count = N + N / 4 + 1;
+
+		static constexpr std::uint32_t max_pilot = 0xffff;
+		static constexpr size_type max_seed = 64;
+
+	private:
+
+		value_type m_Entries[N] = {};
+		std::uint16_t m_Pilots[bucket_count] = {};
+		// 槽里存 entry 的下标，N 表示空槽
+		std::uint32_t m_Slots[slot_count] = {};
+		std::uint64_t m_Seed = 0;
+
+	public:
+
+		explicit constexpr perfect_hash_map(const value_type(&items)[N])
+		{
+			for (size_type i = 0; i < N; ++i) {
+				m_Entries[i] = items[i];
+			}
+			size_type s = 0;
+			for (; s < max_seed; ++s) {
+				m_Seed = hash_mix(s);
+				if (build()) {
+					break;
+				}
+			}
+			THROW_RUNTIME_ERROR_IF(s == max_seed, "perfect_hash_map: failed to find pilots");
+		}
+
+		constexpr const_iterator begin() const noexcept { return m_Entries; }
+		constexpr const_iterator end() const noexcept { return m_Entries + N; }
+
+		constexpr size_type size() const noexcept { return N; }
+		constexpr bool empty() const noexcept { return false; }
+
+		// 找不到返回 nullptr
+		constexpr const T* find(const key_type& key) const noexcept
+		{
+			const std::uint64_t h = Traits::hash(key, m_Seed);
+			const std::uint32_t idx = m_Slots[position(h, m_Pilots[bucket(h)])];
+			return idx != N && Traits::equal(m_Entries[idx].key, key) ? &m_Entries[idx].value : nullptr;
+		}
+
+		constexpr bool contains(const key_type& key) const noexcept
+		{
+			return find(key) != nullptr;
+		}
+
+		constexpr size_type count(const key_type& key) const noexcept
+		{
+			return find(key) != nullptr ? 1 : 0;
+		}
+
+		constexpr const T& at(const key_type& key) const
+		{
+			const T* p = find(key);
+			THROW_OUT_RANGE_IF(p == nullptr, "perfect_hash_map<Key, T> no such element exists");
+			return *p;
+		}
+
+	private:
+
+		// 分桶用高 32 位，槽位由整个 hash 和 pilot 重新混合得到，两者不相关
+		static constexpr size_type bucket(std::uint64_t h) noexcept
+		{
+			return static_cast<size_type>((h >> 32) % bucket_count);
+		}
+
+		static constexpr size_type position(std::uint64_t h, std::uint64_t pilot) noexcept
+		{
+			return static_cast<size_type>(hash_mix(h ^ pilot, hash_secret(2)) % slot_count);
+		}
+
+		// 用当前的 m_Seed 尝试构造，某个桶找不到 pilot 返回 false 换一个 seed 重来
+		constexpr bool build()
+		{
+			std::uint64_t hashes[N] = {};
+			size_type sizes[bucket_count] = {};
+			for (size_type i = 0; i < N; ++i) {
+				hashes[i] = Traits::hash(m_Entries[i].key, m_Seed);
+				++sizes[bucket(hashes[i])];
+			}
+
+			// 计数排序把 key 按桶归拢，members[offsets[b], offsets[b + 1]) 是 b 号桶的 key
+			size_type offsets[bucket_count + 1] = {};
+			for (size_type b = 0; b < bucket_count; ++b) {
+				offsets[b + 1] = offsets[b] + sizes[b];
+			}
+			size_type members[N] = {};
+			size_type fill[bucket_count] = {};
+			for (size_type i = 0; i < N; ++i) {
+				const size_type b = bucket(hashes[i]);
+				members[offsets[b] + fill[b]++] = i;
+			}
+
+			// 重复的 key 一定在同一个桶里，在这里报错，否则会把所有 seed 都试一遍
+			for (size_type b = 0; b < bucket_count; ++b) {
+				for (size_type i = offsets[b]; i < offsets[b + 1]; ++i) {
+					for (size_type j = i + 1; j < offsets[b + 1]; ++j) {
+						THROW_RUNTIME_ERROR_IF(Traits::equal(m_Entries[members[i]].key, m_Entries[members[j]].key),
+							"perfect_hash_map: duplicate key");
+					}
+				}
+			}
+
+			// 桶按大小从大到小处理，大桶在表还空的时候更容易放下
+			size_type order[bucket_count] = {};
+			size_type n = 0;
+			for (size_type sz = N; sz > 0; --sz) {
+				for (size_type b = 0; b < bucket_count; ++b) {
+					if (sizes[b] == sz) {
+						order[n++] = b;
+					}
+				}
+			}
+
+			for (size_type i = 0; i < slot_count; ++i) {
+				m_Slots[i] = static_cast<std::uint32_t>(N);
+			}
+			for (size_type k = 0; k < n; ++k) {
+				const size_type b = order[k];
+				std::uint32_t pilot = 0;
+				for (; pilot <= max_pilot; ++pilot) {
+					size_type i = offsets[b];
+					for (; i < offsets[b + 1]; ++i) {
+						const size_type pos = position(hashes[members[i]], pilot);
+						if (m_Slots[pos] != N) {
+							break;
+						}
+						m_Slots[pos] = static_cast<std::uint32_t>(members[i]);
+					}
+					if (i == offsets[b + 1]) {
+						break;
+					}
+					// 放不下，撤销这个 pilot 已经占用的槽
+					while (i-- > offsets[b]) {
+						m_Slots[position(hashes[members[i]], pilot)] = static_cast<std::uint32_t>(N);
+					}
+				}
+				if (pilot > max_pilot) {
+					return false;
+				}
+				m_Pilots[b] = static_cast<std::uint16_t>(pilot);
+			}
+			return true;
+		}
+	};
+
+	// 用法：
+	// constexpr auto fields = mystl::make_perfect_hash_map<mystl::string_ref, int>({
+	//     { "host", 1 }, { "port", 2 }, { "path", 3 } });
+	// static_assert(*fields.find("port") == 2, "");
+	template <class Key, class T, class Traits = perfect_hash_traits<Key>, size_t N>
+	constexpr perfect_hash_map<Key, T, N, Traits> make_perfect_hash_map(const perfect_hash_entry<Key, T>(&items)[N])
+	{
+		return perfect_hash_map<Key, T, N, Traits>(items);
+	}
+
+}
+
+#endif // !MYSTL_PERFECT_HASH_MAP_H
@@ -0,0 +1,472 @@
+#ifndef MYSTL_PERSISTENT_MAP_H
+#define MYSTL_PERSISTENT_MAP_H
+
+#include <atomic>
+#include <initializer_list>
+
+#include "algobase.h"
+#include "functional.h"
+#include "allocator.h"
+#include "exceptdef.h"
+#include "util.h"
+
+namespace mystl {
+
+	// 节点建好之后就不再修改，可以同时挂在多个版本的树上，用引用计数决定什么时候释放
+	template <class T>
+	struct persistent_map_node
+	{
+		std::atomic<size_t> refs;
+		persistent_map_node* left;
+		persistent_map_node* right;
+		int height;
+		T value;
+
+		template <class ...Args>
+		persistent_map_node(persistent_map_node* l, persistent_map_node* r, int h, Args&& ...args)
+			: refs(1), left(l), right(r), height(h), value(mystl::forward<Args>(args)...) {}
+	};
+
+	// 持久化 (不可变) 的有序 map，底层是路径复制的 AVL 树
+	// 每次修改只复制从根到修改点的一条路径 (O(log n) 个新节点)，其余子树和旧版本共享
+	// 拷贝一个 persistent_map 只是根节点引用计数加一，旧版本的内容永远不变，
+	// 所以可以把拷贝交给别的线程随便读，不需要加锁；引用计数是原子的，最后一个持有者负责释放
+	// 同一个 persistent_map 对象在被修改的同时不能被拷贝，发布新版本时需要自己用锁或原子指针保护这一个对象
+	// 没有迭代器：树里没有父指针 (节点被多个版本共享)，读操作返回元素指针或者用 for_each 遍历
+	template <class Key, class T, class Compare = mystl::less<Key>>
+	class persistent_map
+	{
+	public:
+
+		using key_type		= Key;
+		using mapped_type	= T;
+		using value_type	= mystl::pair<const Key, T>;
+		using key_compare	= Compare;
+		using size_type		= size_t;
+
+	private:
+
+		using node_type = persistent_map_node<value_type>;
+		using node_ptr = node_type*;
+		using node_allocator = mystl::allocator<node_type>;
+
+		node_ptr m_Root;
+		size_type m_Size;
+		key_compare m_Comp;
+
+	public:
+
+		explicit persistent_map(const Compare& comp = Compare())
+			: m_Root(nullptr), m_Size(0), m_Comp(comp)
+		{
+		}
+
+		template <class InputIter>
+		persistent_map(InputIter first, InputIter last, const Compare& comp = Compare())
+			: m_Root(nullptr), m_Size(0), m_Comp(comp)
+		{
+			for (; first != last; ++first) {
+				insert(*first);
+			}
+		}
+
+		persistent_map(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+			: persistent_map(ilist.begin(), ilist.end(), comp)
+		{
+		}
+
+		// O(1)，和 other 共享所有节点
+		persistent_map(const persistent_map& other) noexcept
+			: m_Root(retain(other.m_Root)), m_Size(other.m_Size), m_Comp(other.m_Comp)
+		{
+		}
+
+		persistent_map(persistent_map&& other) noexcept
+			: m_Root(other.m_Root), m_Size(other.m_Size), m_Comp(other.m_Comp)
+		{
+			other.m_Root = nullptr;
+			other.m_Size = 0;
+		}
+
+		persistent_map& operator=(const persistent_map& other) noexcept
+		{
+			if (this != &other) {
+				node_ptr old = m_Root;
+				m_Root = retain(other.m_Root);
+				m_Size = other.m_Size;
+				m_Comp = other.m_Comp;
+				release(old);
+			}
+			return *this;
+		}
+
+		persistent_map& operator=(persistent_map&& other) noexcept
+		{
+			if (this != &other) {
+				release(m_Root);
+				m_Root = other.m_Root;
+				m_Size = other.m_Size;
+				m_Comp = other.m_Comp;
+				other.m_Root = nullptr;
+				other.m_Size = 0;
+			}
+			return *this;
+		}
+
+		~persistent_map()
+		{
+			release(m_Root);
+		}
+
+		size_type size() const noexcept
+		{
+			return m_Size;
+		}
+
+		bool empty() const noexcept
+		{
+			return m_Size == 0;
+		}
+
+		key_compare key_comp() const
+		{
+			return m_Comp;
+		}
+
+		// 以下的修改都只影响 *this，之前拷贝出去的版本不变
+		// 中途抛出异常时已经复制出来的节点会被释放，*this 保持原样
+
+		// key 已经存在时不插入，返回 false
+		bool insert(const value_type& value)
+		{
+			return insert(value.first, value.second);
+		}
+
+		template <class M>
+		bool insert(const key_type& key, M&& obj)
+		{
+			bool inserted = false;
+			node_ptr root = insert_node(m_Root, key, false, inserted, obj);
+			if (root != nullptr) {
+				replace_root(root);
+			}
+			m_Size += inserted;
+			return inserted;
+		}
+
+		// key 已经存在时替换它的值，返回是否是新插入的
+		template <class M>
+		bool insert_or_assign(const key_type& key, M&& obj)
+		{
+			bool inserted = false;
+			node_ptr root = insert_node(m_Root, key, true, inserted, obj);
+			replace_root(root);
+			m_Size += inserted;
+			return inserted;
+		}
+
+		size_type erase(const key_type& key)
+		{
+			bool erased = false;
+			node_ptr root = erase_node(m_Root, key, erased);
+			if (!erased) {
+				return 0;
+			}
+			replace_root(root);
+			--m_Size;
+			return 1;
+		}
+
+		void clear() noexcept
+		{
+			release(m_Root);
+			m_Root = nullptr;
+			m_Size = 0;
+		}
+
+		void swap(persistent_map& other) noexcept
+		{
+			mystl::swap(m_Root, other.m_Root);
+			mystl::swap(m_Size, other.m_Size);
+			mystl::swap(m_Comp, other.m_Comp);
+		}
+
+		// 读操作返回的指针在这个版本 (或者共享这些节点的任何一个拷贝) 还活着的时候一直有效
+		const value_type* find(const key_type& key) const
+		{
+			const value_type* p = lower_bound(key);
+			return p != nullptr && !m_Comp(key, p->first) ? p : nullptr;
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return find(key) != nullptr;
+		}
+
+		size_type count(const key_type& key) const
+		{
+			return contains(key) ? 1 : 0;
+		}
+
+		const mapped_type& at(const key_type& key) const
+		{
+			const value_type* p = find(key);
+			THROW_OUT_RANGE_IF(p == nullptr, "persistent_map<Key, T> no such element exists");
+			return p->second;
+		}
+
+		// 和 rb_tree 一样，第一个不小于 key 的元素，没有返回 nullptr
+		const value_type* lower_bound(const key_type& key) const
+		{
+			node_ptr y = nullptr;
+			for (node_ptr x = m_Root; x != nullptr; ) {
+				if (!m_Comp(x->value.first, key)) {
+					y = x;
+					x = x->left;
+				}
+				else {
+					x = x->right;
+				}
+			}
+			return y != nullptr ? &y->value : nullptr;
+		}
+
+		// 第一个大于 key 的元素，没有返回 nullptr
+		const value_type* upper_bound(const key_type& key) const
+		{
+			node_ptr y = nullptr;
+			for (node_ptr x = m_Root; x != nullptr; ) {
+				if (m_Comp(key, x->value.first)) {
+					y = x;
+					x = x->left;
+				}
+				else {
+					x = x->right;
+				}
+			}
+			return y != nullptr ? &y->value : nullptr;
+		}
+
+		// 按 key 从小到大对每个元素调用 fn(const value_type&)
+		template <class Fn>
+		void for_each(Fn fn) const
+		{
+			visit(m_Root, fn);
+		}
+
+		// 遍历 [first, last)，不在范围内的子树直接跳过
+		template <class Fn>
+		void for_each_range(const key_type& first, const key_type& last, Fn fn) const
+		{
+			visit_range(m_Root, first, last, fn);
+		}
+
+	private:
+
+		static node_ptr retain(node_ptr p) noexcept
+		{
+			if (p != nullptr) {
+				p->refs.fetch_add(1, std::memory_order_relaxed);
+			}
+			return p;
+		}
+
+		// 引用计数减到 0 才真正释放，再递归释放它持有的子树；沿右子树走用循环，递归深度不超过树高
+		static void release(node_ptr p) noexcept
+		{
+			while (p != nullptr && p->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				release(p->left);
+				node_ptr right = p->right;
+				node_allocator::destroy(p);
+				node_allocator::deallocate(p);
+				p = right;
+			}
+		}
+
+		void replace_root(node_ptr root) noexcept
+		{
+			node_ptr old = m_Root;
+			m_Root = root;
+			release(old);
+		}
+
+		static int height(node_ptr p) noexcept
+		{
+			return p != nullptr ? p->height : 0;
+		}
+
+		// 新建节点，接管 l 和 r 的引用；构造失败时把它们释放掉
+		template <class ...Args>
+		static node_ptr make_node(node_ptr l, node_ptr r, Args&& ...args)
+		{
+			const int h = 1 + mystl::max(height(l), height(r));
+			node_ptr np = nullptr;
+			try {
+				np = node_allocator::allocate(1);
+				node_allocator::construct(np, l, r, h, mystl::forward<Args>(args)...);
+			}
+			catch (...) {
+				if (np != nullptr) {
+					node_allocator::deallocate(np);
+				}
+				release(l);
+				release(r);
+				throw;
+			}
+			return np;
+		}
+
+		// 作用域结束时放掉一个引用，旋转时拆开的子树根不管成功还是抛异常都要放掉
+		struct node_holder
+		{
+			node_ptr p;
+			~node_holder() { release(p); }
+		};
+
+		// 用 value 和 l、r 组一个平衡的节点，l 和 r 的高度最多差 2，接管 l 和 r 的引用
+		// 旋转时被拆开的子树根是共享的 (或者刚复制出来的)，不能原地改，复制它的值重新组
+		// 每个 make_node 的参数里最多一个会抛异常的调用，保证抛异常时引用不泄漏
+		static node_ptr make_balanced(const value_type& value, node_ptr l, node_ptr r)
+		{
+			const int hl = height(l);
+			const int hr = height(r);
+			if (hl > hr + 1) {
+				node_holder hold{ l };
+				node_ptr ll = l->left;
+				node_ptr lr = l->right;
+				if (height(ll) >= height(lr)) {
+					node_ptr b = make_node(retain(lr), r, value);
+					return make_node(retain(ll), b, l->value);
+				}
+				node_ptr b = make_node(retain(lr->right), r, value);
+				node_ptr a;
+				try {
+					a = make_node(retain(ll), retain(lr->left), l->value);
+				}
+				catch (...) {
+					release(b);
+					throw;
+				}
+				return make_node(a, b, lr->value);
+			}
+			if (hr > hl + 1) {
+				node_holder hold{ r };
+				node_ptr rl = r->left;
+				node_ptr rr = r->right;
+				if (height(rr) >= height(rl)) {
+					node_ptr a = make_node(l, retain(rl), value);
+					return make_node(a, retain(rr), r->value);
+				}
+				node_ptr a = make_node(l, retain(rl->left), value);
+				node_ptr b;
+				try {
+					b = make_node(retain(rl->right), retain(rr), r->value);
+				}
+				catch (...) {
+					release(a);
+					throw;
+				}
+				return make_node(a, b, rl->value);
+			}
+			return make_node(l, r, value);
+		}
+
+		// 返回新的子树 (持有一个引用)；key 已经存在且不替换时什么都不复制，返回 nullptr
+		template <class M>
+		node_ptr insert_node(node_ptr t, const key_type& key, bool assign, bool& inserted, M& obj)
+		{
+			if (t == nullptr) {
+				inserted = true;
+				return make_node(nullptr, nullptr, key, mystl::forward<M>(obj));
+			}
+			if (m_Comp(key, t->value.first)) {
+				node_ptr l = insert_node(t->left, key, assign, inserted, obj);
+				return l == nullptr ? nullptr : make_balanced(t->value, l, retain(t->right));
+			}
+			if (m_Comp(t->value.first, key)) {
+				node_ptr r = insert_node(t->right, key, assign, inserted, obj);
+				return r == nullptr ? nullptr : make_balanced(t->value, retain(t->left), r);
+			}
+			if (!assign) {
+				return nullptr;
+			}
+			return make_node(retain(t->left), retain(t->right), t->value.first, mystl::forward<M>(obj));
+		}
+
+		// 返回删掉 key 之后的新子树 (持有一个引用)，没找到时 erased 为 false，返回值无意义
+		node_ptr erase_node(node_ptr t, const key_type& key, bool& erased)
+		{
+			if (t == nullptr) {
+				return nullptr;
+			}
+			if (m_Comp(key, t->value.first)) {
+				node_ptr l = erase_node(t->left, key, erased);
+				return erased ? make_balanced(t->value, l, retain(t->right)) : nullptr;
+			}
+			if (m_Comp(t->value.first, key)) {
+				node_ptr r = erase_node(t->right, key, erased);
+				return erased ? make_balanced(t->value, retain(t->left), r) : nullptr;
+			}
+			erased = true;
+			if (t->left == nullptr) {
+				return retain(t->right);
+			}
+			if (t->right == nullptr) {
+				return retain(t->left);
+			}
+			// 用右子树的最小值顶替 t
+			node_ptr m = t->right;
+			while (m->left != nullptr) {
+				m = m->left;
+			}
+			node_ptr r = erase_min(t->right);
+			return make_balanced(m->value, retain(t->left), r);
+		}
+
+		static node_ptr erase_min(node_ptr t)
+		{
+			if (t->left == nullptr) {
+				return retain(t->right);
+			}
+			node_ptr l = erase_min(t->left);
+			return make_balanced(t->value, l, retain(t->right));
+		}
+
+		template <class Fn>
+		static void visit(node_ptr t, Fn& fn)
+		{
+			while (t != nullptr) {
+				visit(t->left, fn);
+				fn(static_cast<const value_type&>(t->value));
+				t = t->right;
+			}
+		}
+
+		template <class Fn>
+		void visit_range(node_ptr t, const key_type& first, const key_type& last, Fn& fn) const
+		{
+			while (t != nullptr) {
+				if (m_Comp(t->value.first, first)) {
+					t = t->right;
+				}
+				else if (!m_Comp(t->value.first, last)) {
+					t = t->left;
+				}
+				else {
+					visit_range(t->left, first, last, fn);
+					fn(static_cast<const value_type&>(t->value));
+					t = t->right;
+				}
+			}
+		}
+	};
+
+	template <class Key, class T, class Compare>
+	void swap(persistent_map<Key, T, Compare>& lhs, persistent_map<Key, T, Compare>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !MYSTL_PERSISTENT_MAP_H
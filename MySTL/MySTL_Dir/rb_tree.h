@@ -3,12 +3,14 @@
 
 #include <initializer_list>
 #include <cassert>
+#include <cstdint>
 
 #include "functional.h"
 #include "iterator.h"
 #include "memory.h"
 #include "type_traits.h"
 #include "exceptdef.h"
+#include "node_handle.h"
 
 namespace mystl {
 
@@ -17,11 +19,11 @@ namespace mystl {
 	static constexpr rb_tree_color_type rb_tree_red = false;
 	static constexpr rb_tree_color_type rb_tree_black = true;
 
-	template <class T> struct rb_tree_node_base;
-	template <class T> struct rb_tree_node;
+	template <class T, bool OrderStat = false> struct rb_tree_node_base;
+	template <class T, bool OrderStat = false> struct rb_tree_node;
 
-	template <class T> struct rb_tree_iterator;
-	template <class T> struct rb_tree_const_iterator;
+	template <class T, bool OrderStat = false> struct rb_tree_iterator;
+	template <class T, bool OrderStat = false> struct rb_tree_const_iterator;
 
 	template <class T, bool>
 	struct rb_tree_value_traits_imp
@@ -30,7 +32,7 @@ namespace mystl {
 		using value_type = T;
 		using mapped_type = T;
 
-		//  static ָģη͵
+		// 这里的 static 是指这个函数是属于类的，不是修饰返回类型的
 		template <class Tp>
 		static const key_type& get_key(const Tp& value)
 		{
@@ -52,11 +54,11 @@ namespace mystl {
 		using mapped_type = typename T::second_type;
 		using value_type = T;
 
-		//  static ָģη͵
+		// 这里的 static 是指这个函数是属于类的，不是修饰返回类型的
 		template <class Tp>
 		static const key_type& get_key(const Tp& value)
 		{
-			return value;
+			return value.first;
 		}
 
 		template <class Tp>
@@ -103,15 +105,75 @@ namespace mystl {
 		using node_ptr = rb_tree_node<T>*;
 	};
 
+	// 节点上额外维护的、由节点自己的值和两个孩子算出来的信息，比如区间树里子树的最大右端点
+	// 默认什么都没有，是空基类；按值类型 T 特化，给出数据成员、enabled 和两个静态函数：
+	// enabled 为 true，update(x) 由 x 的值和两个孩子重新算 x，copy(dst, src) 拷贝
+	// rb_tree 在旋转、插入、删除、拼接之后按需要调用，update 不能抛异常
 	template <class T>
-	struct rb_tree_node_base
+	struct rb_tree_augment
+	{
+		static constexpr bool enabled = false;
+
+		template <class NodePtr>
+		static void update(NodePtr) noexcept {}
+
+		template <class NodePtr>
+		static void copy(NodePtr, NodePtr) noexcept {}
+	};
+
+	// OrderStat 为 true 时每个节点多存一个以它为根的子树的节点个数，用来做 select / rank
+	// 为 false 时是空基类，不占空间
+	// 两个空基类串成一条继承链，有的编译器只对第一个空基类做空基类优化
+	template <bool OrderStat, class Base>
+	struct rb_tree_size_field : public Base
+	{
+	};
+
+	template <class Base>
+	struct rb_tree_size_field<true, Base> : public Base
+	{
+		size_t size;
+	};
+
+	template <class T, bool OrderStat>
+	struct rb_tree_node_base : public rb_tree_size_field<OrderStat, rb_tree_augment<T>>
 	{
 		using color_type = rb_tree_color_type;
-		using base_ptr = rb_tree_node_base<T>*;
-		using node_ptr = rb_tree_node<T>*;
+		using augment_type = rb_tree_augment<T>;
+		using base_ptr = rb_tree_node_base<T, OrderStat>*;
+		using node_ptr = rb_tree_node<T, OrderStat>*;
+
+		// parent 指针和颜色压在同一个字里：节点至少按指针对齐，指针最低位总是 0，正好放颜色
+		// 省掉单独的 color 之后节点少 8 字节 (一个 bool 因为对齐要占满一个指针的位置)
+		// 读写 parent 和颜色都要走下面几个函数
+		std::uintptr_t parent_color;
+		base_ptr left, right;
+
+		base_ptr get_parent() const noexcept
+		{
+			return reinterpret_cast<base_ptr>(parent_color & ~static_cast<std::uintptr_t>(1));
+		}
+
+		void set_parent(base_ptr p) noexcept
+		{
+			parent_color = reinterpret_cast<std::uintptr_t>(p) | (parent_color & 1);
+		}
+
+		color_type get_color() const noexcept
+		{
+			return static_cast<color_type>(parent_color & 1);
+		}
 
-		base_ptr parent, left, right;
-		color_type color;
+		void set_color(color_type c) noexcept
+		{
+			parent_color = (parent_color & ~static_cast<std::uintptr_t>(1)) | static_cast<std::uintptr_t>(c);
+		}
+
+		// 节点刚分配、parent_color 还没有初始化时用这个一起设置
+		void set_parent_color(base_ptr p, color_type c) noexcept
+		{
+			parent_color = reinterpret_cast<std::uintptr_t>(p) | static_cast<std::uintptr_t>(c);
+		}
 
 		base_ptr get_base_ptr()
 		{
@@ -129,11 +191,11 @@ namespace mystl {
 		}
 	};
 
-	template <class T>
-	struct rb_tree_node : public rb_tree_node_base<T>
+	template <class T, bool OrderStat>
+	struct rb_tree_node : public rb_tree_node_base<T, OrderStat>
 	{
-		using base_ptr = rb_tree_node_base<T>*;
-		using node_ptr = rb_tree_node<T>*;
+		using base_ptr = rb_tree_node_base<T, OrderStat>*;
+		using node_ptr = rb_tree_node<T, OrderStat>*;
 
 		T value;
 
@@ -149,7 +211,7 @@ namespace mystl {
 
 	};
 
-	template <class T>
+	template <class T, bool OrderStat = false>
 	struct rb_tree_traits
 	{
 		using value_traits = rb_tree_value_traits<T>;
@@ -162,34 +224,38 @@ namespace mystl {
 		using const_pointer = const value_type*;
 		using const_reference = const value_type&;
 
-		using base_type = rb_tree_node_base<T>;
-		using node_type = rb_tree_node<T>;
+		using base_type = rb_tree_node_base<T, OrderStat>;
+		using node_type = rb_tree_node<T, OrderStat>;
 
-		using base_ptr = rb_tree_node_base<T>*;
-		using node_ptr = rb_tree_node<T>*;
+		using base_ptr = rb_tree_node_base<T, OrderStat>*;
+		using node_ptr = rb_tree_node<T, OrderStat>*;
 	};
 
-	template <class T>
+	template <class T, bool OrderStat>
 	struct rb_tree_iterator_base : public mystl::iterator<mystl::bidirectional_iterator_tag, T>
 	{
-		using base_ptr = typename rb_tree_traits<T>::base_ptr;
+		using base_ptr = typename rb_tree_traits<T, OrderStat>::base_ptr;
 
 		base_ptr node;
 
 		rb_tree_iterator_base() : node(nullptr) {}
 
+		bool operator==(const rb_tree_iterator_base& rhs) const { return node == rhs.node; }
+		bool operator!=(const rb_tree_iterator_base& rhs) const { return node != rhs.node; }
+
 		void inc()
 		{
 			if (node->right != nullptr) {
 				node = rb_tree_min(node->right);
 			}
 			else {
-				base_ptr parent = node->parent;
+				base_ptr parent = node->get_parent();
 				while (parent->right == node) {
 					node = parent;
-					parent = node->parent;
+					parent = node->get_parent();
 				}
-				if (parent->right != node) {
+				// 根节点就是最大节点时 node 会走到 header，此时 header->right 就是 parent，应该停在 header
+				if (node->right != parent) {
 					node = parent;
 				}
 			}
@@ -197,17 +263,17 @@ namespace mystl {
 
 		void dec()
 		{
-			if (node->parent->parent == node && rb_tree_is_red(node)) {
+			if (node->get_parent()->get_parent() == node && rb_tree_is_red(node)) {
 				node = node->right;
 			}
 			else if (node->left != nullptr) {
 				node = rb_tree_max(node->left);
 			}
 			else {
-				base_ptr parent = node->parent;
+				base_ptr parent = node->get_parent();
 				while (parent->left == node) {
 					node = parent;
-					parent = node->parent;
+					parent = node->get_parent();
 				}
 				if (parent->left != node) {
 					node = parent;
@@ -216,10 +282,10 @@ namespace mystl {
 		}
 	};
 
-	template <class T>
-	struct rb_tree_iterator : public rb_tree_iterator_base<T>
+	template <class T, bool OrderStat>
+	struct rb_tree_iterator : public rb_tree_iterator_base<T, OrderStat>
 	{
-		using tree_traits = rb_tree_traits<T>;
+		using tree_traits = rb_tree_traits<T, OrderStat>;
 
 		using value_type = typename tree_traits::value_type;
 		using pointer = typename tree_traits::pointer;
@@ -227,11 +293,11 @@ namespace mystl {
 		using base_ptr = typename tree_traits::base_ptr;
 		using node_ptr = typename tree_traits::node_ptr;
 
-		using iterator = rb_tree_iterator<T>;
-		using const_iterator = rb_tree_const_iterator<T>;
+		using iterator = rb_tree_iterator<T, OrderStat>;
+		using const_iterator = rb_tree_const_iterator<T, OrderStat>;
 		using self = iterator;
 
-		using rb_tree_iterator_base<T>::node;
+		using rb_tree_iterator_base<T, OrderStat>::node;
 
 		rb_tree_iterator() { node = nullptr; }
 		rb_tree_iterator(base_ptr x) { node = x; }
@@ -251,7 +317,7 @@ namespace mystl {
 
 		self& operator++()
 		{
-			inc();
+			this->inc();
 			return *this;
 		}
 
@@ -264,7 +330,7 @@ namespace mystl {
 
 		self& operator--()
 		{
-			dec();
+			this->dec();
 			return *this;
 		}
 
@@ -277,10 +343,10 @@ namespace mystl {
 
 	};
 
-	template <class T>
-	struct rb_tree_const_iterator : public rb_tree_iterator_base<T>
+	template <class T, bool OrderStat>
+	struct rb_tree_const_iterator : public rb_tree_iterator_base<T, OrderStat>
 	{
-		using tree_traits = rb_tree_traits<T>;
+		using tree_traits = rb_tree_traits<T, OrderStat>;
 
 		using value_type = typename tree_traits::value_type;
 		using pointer = typename tree_traits::const_pointer;
@@ -288,11 +354,11 @@ namespace mystl {
 		using base_ptr = typename tree_traits::base_ptr;
 		using node_ptr = typename tree_traits::node_ptr;
 
-		using iterator = rb_tree_iterator<T>;
-		using const_iterator = rb_tree_const_iterator<T>;
-		using self = iterator;
+		using iterator = rb_tree_iterator<T, OrderStat>;
+		using const_iterator = rb_tree_const_iterator<T, OrderStat>;
+		using self = const_iterator;
 
-		using rb_tree_iterator_base<T>::node;
+		using rb_tree_iterator_base<T, OrderStat>::node;
 
 		rb_tree_const_iterator() { node = nullptr; }
 		rb_tree_const_iterator(base_ptr x) { node = x; }
@@ -312,26 +378,26 @@ namespace mystl {
 
 		self& operator++()
 		{
-			inc();
+			this->inc();
 			return *this;
 		}
 
 		self operator++(int)
 		{
-			iterator tmp(*this);
+			self tmp(*this);
 			++(*this);
 			return tmp;
 		}
 
 		self& operator--()
 		{
-			dec();
+			this->dec();
 			return *this;
 		}
 
 		self operator--(int)
 		{
-			iterator tmp(*this);
+			self tmp(*this);
 			--(*this);
 			return tmp;
 		}
@@ -359,37 +425,37 @@ namespace mystl {
 	template <class NodePtr>
 	bool rb_tree_is_lchild(NodePtr node) noexcept
 	{
-		return node == node->parent->left;
+		return node == node->get_parent()->left;
 	}
 
 	template <class NodePtr>
 	bool rb_tree_is_rchild(NodePtr node) noexcept
 	{
-		return node == node->parent->right;
+		return node == node->get_parent()->right;
 	}
 
 	template <class NodePtr>
 	bool rb_tree_is_red(NodePtr node) noexcept
 	{
-		return rb_tree_red == node->color;
+		return rb_tree_red == node->get_color();
 	}
 
 	template <class NodePtr>
 	bool rb_tree_is_black(NodePtr node) noexcept
 	{
-		return rb_tree_black == node->color;
+		return rb_tree_black == node->get_color();
 	}
 
 	template <class NodePtr>
 	void rb_tree_set_red(NodePtr node) noexcept
 	{
-		node->color = rb_tree_red;
+		node->set_color(rb_tree_red);
 	}
 
 	template <class NodePtr>
 	void rb_tree_set_black(NodePtr node) noexcept
 	{
-		node->color = rb_tree_black;
+		node->set_color(rb_tree_black);
 	}
 
 	template <class NodePtr>
@@ -398,14 +464,114 @@ namespace mystl {
 		if (node->right != nullptr) {
 			return rb_tree_min(node->right);
 		}
-		NodePtr parent = node->parent;
+		NodePtr parent = node->get_parent();
 		while (parent->right == node) {
 			node = parent;
-			parent = node->parent;
+			parent = node->get_parent();
 		}
 		return parent;
 	}
 
+	// 子树大小的维护，节点没有 size 时全都是空操作
+	template <class NodePtr>
+	struct rb_tree_has_size : public std::false_type {};
+
+	template <class T>
+	struct rb_tree_has_size<rb_tree_node_base<T, true>*> : public std::true_type {};
+
+	template <class NodePtr>
+	size_t rb_tree_size_of(NodePtr x) noexcept
+	{
+		return x == nullptr ? 0 : x->size;
+	}
+
+	template <class NodePtr>
+	void rb_tree_update_size(NodePtr, std::false_type) noexcept {}
+
+	template <class NodePtr>
+	void rb_tree_update_size(NodePtr x, std::true_type) noexcept
+	{
+		x->size = 1 + rb_tree_size_of(x->left) + rb_tree_size_of(x->right);
+	}
+
+	// 两个孩子的 size 都正确时重新算 x 的 size
+	template <class NodePtr>
+	void rb_tree_update_size(NodePtr x) noexcept
+	{
+		rb_tree_update_size(x, rb_tree_has_size<NodePtr>());
+	}
+
+	template <class NodePtr>
+	void rb_tree_copy_size(NodePtr, NodePtr, std::false_type) noexcept {}
+
+	template <class NodePtr>
+	void rb_tree_copy_size(NodePtr dst, NodePtr src, std::true_type) noexcept
+	{
+		dst->size = src->size;
+	}
+
+	template <class NodePtr>
+	void rb_tree_copy_size(NodePtr dst, NodePtr src) noexcept
+	{
+		rb_tree_copy_size(dst, src, rb_tree_has_size<NodePtr>());
+	}
+
+	template <class NodePtr>
+	void rb_tree_add_size(NodePtr, NodePtr, long, std::false_type) noexcept {}
+
+	template <class NodePtr>
+	void rb_tree_add_size(NodePtr x, NodePtr root, long delta, std::true_type) noexcept
+	{
+		while (x != root) {
+			x = x->get_parent();
+			x->size += delta;
+		}
+	}
+
+	// x 的祖先（不含 x，到 root 为止）的 size 都加上 delta
+	template <class NodePtr>
+	void rb_tree_add_size(NodePtr x, NodePtr root, long delta) noexcept
+	{
+		rb_tree_add_size(x, root, delta, rb_tree_has_size<NodePtr>());
+	}
+
+	// rb_tree_augment 的维护，没有特化的值类型全都是空操作
+	template <class NodePtr>
+	using rb_tree_augment_of = typename std::remove_pointer<NodePtr>::type::augment_type;
+
+	template <class NodePtr>
+	void rb_tree_update_augment(NodePtr x) noexcept
+	{
+		rb_tree_augment_of<NodePtr>::update(x);
+	}
+
+	template <class NodePtr>
+	void rb_tree_copy_augment(NodePtr dst, NodePtr src) noexcept
+	{
+		rb_tree_augment_of<NodePtr>::copy(dst, src);
+	}
+
+	template <class NodePtr>
+	void rb_tree_propagate_augment(NodePtr, NodePtr, std::false_type) noexcept {}
+
+	template <class NodePtr>
+	void rb_tree_propagate_augment(NodePtr x, NodePtr root, std::true_type) noexcept
+	{
+		for (; x != nullptr; x = x->get_parent()) {
+			rb_tree_update_augment(x);
+			if (x == root) {
+				break;
+			}
+		}
+	}
+
+	// 从 x 往上到 root 为止（都包含）逐个重新算，x 为 nullptr 时什么都不做
+	template <class NodePtr>
+	void rb_tree_propagate_augment(NodePtr x, NodePtr root) noexcept
+	{
+		rb_tree_propagate_augment(x, root, std::integral_constant<bool, rb_tree_augment_of<NodePtr>::enabled>());
+	}
+
 	/*---------------------------------------*\
 	|       p                         p       |
 	|      / \                       / \      |
@@ -422,22 +588,26 @@ namespace mystl {
 		NodePtr y = x->right;
 		x->right = y->left;
 		if (y->left != nullptr) {
-			y->left->parent = x;
+			y->left->set_parent(x);
 		}
-		y->parent = x->parent;
+		y->set_parent(x->get_parent());
 
 		if (x == root) {
 			root = y;
 		}
 		else if (rb_tree_is_lchild(x)) {
-			x->parent->left = y;
+			x->get_parent()->left = y;
 		}
 		else {
-			x->parent->right = y;
+			x->get_parent()->right = y;
 		}
 
 		y->left = x;
-		x->parent = y;
+		x->set_parent(y);
+		rb_tree_update_size(x);
+		rb_tree_update_size(y);
+		rb_tree_update_augment(x);
+		rb_tree_update_augment(y);
 	}
 
 
@@ -457,22 +627,26 @@ namespace mystl {
 		NodePtr y = x->left;
 		x->left = y->right;
 		if (y->right != nullptr) {
-			y->right->parent = x;
+			y->right->set_parent(x);
 		}
-		y->parent = x->parent;
+		y->set_parent(x->get_parent());
 
 		if (x == root) {
-			root = x;
+			root = y;
 		}
 		else if (rb_tree_is_lchild(x)) {
-			x->parent->left = y;
+			x->get_parent()->left = y;
 		}
 		else {
-			x->parent->right = y;
+			x->get_parent()->right = y;
 		}
 
 		y->right = x;
-		x->parent = y;
+		x->set_parent(y);
+		rb_tree_update_size(x);
+		rb_tree_update_size(y);
+		rb_tree_update_augment(x);
+		rb_tree_update_augment(y);
 	}
 
 	/*-------------------*\
@@ -483,117 +657,128 @@ namespace mystl {
 	|       a   b         |
 	\*------------------ */
 
-	// 1. ڲ죬ֱӲ
-	// 2. 죬 uncle Ϊ죬x  c ڣ y
-	// 3. 죬 uncle Ϊڣy ɺ죬 xɺڣ
-	// 4. 죬 uncle Ϊ nullptry 죬x ڣ
+	// 1. 黑插入红，直接插入
+	// 2. 红插入红，且 uncle 为红，x 和 c 变黑， y变红
+	// 3. 红插入红，且 uncle 为黑，y 变成红， x变成黑，再右旋
+	// 4. 红插入红，且 uncle 为 nullptr，y 变红，x 变黑，再右旋
 
+	// 返回 true 表示红色一路推到了根，整棵树的黑高加了一
 	template <class NodePtr>
-	void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
+	bool rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
 	{
 		rb_tree_set_red(x);
-		while (x != root && rb_tree_is_red(x->parent)) {
-			if (rb_tree_is_lchild(x->parent)) {
-				NodePtr uncle = x->parent->parent->right;
+		while (x != root && rb_tree_is_red(x->get_parent())) {
+			if (rb_tree_is_lchild(x->get_parent())) {
+				NodePtr uncle = x->get_parent()->get_parent()->right;
 				if (uncle != nullptr && rb_tree_is_red(uncle)) {
-					rb_tree_set_black(x->parent);
+					rb_tree_set_black(x->get_parent());
 					rb_tree_set_black(uncle);
-					x = x->parent->parent;
+					x = x->get_parent()->get_parent();
 					rb_tree_set_red(x);
 				}
 				else {
 					if (rb_tree_is_lchild(x) == false) {
-						x = x->parent;
+						x = x->get_parent();
 						rb_tree_rotate_left(x, root);
 					}
-					rb_tree_set_black(x->parent);
-					rb_tree_set_red(x->parent->parent);
-					rb_tree_rotate_right(x->parent->parent, root);
+					rb_tree_set_black(x->get_parent());
+					rb_tree_set_red(x->get_parent()->get_parent());
+					rb_tree_rotate_right(x->get_parent()->get_parent(), root);
 					break;
 				}
 			}
 			else {
-				NodePtr uncle = x->parent->parent->left;
+				NodePtr uncle = x->get_parent()->get_parent()->left;
 				if (uncle != nullptr && rb_tree_is_red(uncle)) {
 					rb_tree_set_black(uncle);
-					rb_tree_set_black(x->parent);
-					x = x->parent->parent;
+					rb_tree_set_black(x->get_parent());
+					x = x->get_parent()->get_parent();
 					rb_tree_set_red(x);
 				}
 				else {
 					if (rb_tree_is_rchild(x) == false) {
-						x = x->parent;
+						x = x->get_parent();
 						rb_tree_rotate_right(x, root);
 					}
-					rb_tree_set_black(x->parent);
-					rb_tree_set_red(x->parent->parent);
-					rb_tree_rotate_left(x->parent->parent, root);
+					rb_tree_set_black(x->get_parent());
+					rb_tree_set_red(x->get_parent()->get_parent());
+					rb_tree_rotate_left(x->get_parent()->get_parent(), root);
 					break;
 				}
 			}
 		}
+		// 情况 1 会把红色一路往上推，推到根的时候根要重新染黑
+		rb_tree_set_black(root);
+		return x == root;
 	}
 
 	template <class NodePtr>
 	NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, NodePtr& rightmost) noexcept
 	{
-		//  y ֻ z ڵ z
-		// ΪǺԵһڵΪյʱһڵΪɫ
+		// 这里的 y 只可能是 z 右子树的最左节点或者 z
+		// 因为是红黑树，所以当一个节点为空的时候另一个节点必为红色
 		NodePtr y = (z->left == nullptr || z->right == nullptr) ? z : rb_tree_next(z);
-		//  y ڵ x  y ҽڵ㣬 z ڵ
+		// 真正从原位置摘掉的是 y，它上面的每个节点都少了一个后代
+		rb_tree_add_size(y, root, -1);
+		// 如果 y 是右子树最左节点则 x 是 y 的右节点，否则是 z 的左节点
 		NodePtr x = (y->left != nullptr) ? y->left : y->right;
-		// xp ָҪ x ĸڵ
+		// xp 是用来指向要 x 的父节点
 		NodePtr xp = nullptr;
-		//  y  z
+		// 如果 y 不是 z
 		if (y != z) {
-			// z ӽڵӱ y  zӽڵ
-			z->left->parent = y;
+			// z 和左子节点的连接变成 y 和 z的左子节点的连接
+			z->left->set_parent(y);
 			y->left = z->left;
-			//  y ڵԼ
+			// 如果 y 的右子树的最左节点是它自己
 			if (y != z->right) {
-				xp = y->parent;
-				// x ǿյ
+				xp = y->get_parent();
+				// x 可能是空的情况
 				if (x != nullptr) {
-					x->parent = y->parent;
+					x->set_parent(y->get_parent());
 				}
-				y->parent->left = x;
+				y->get_parent()->left = x;
 				y->right = z->right;
-				z->right->parent = y;
+				z->right->set_parent(y);
 			}
 			else {
-				//  y == z->right ˵ y ǿյ
-				// ֻҪ y ڵָ z ڵͿ
+				// 如果 y == z->right 则说明 y 的左边是空的
+				// 我们只需要让 y 的左节点指向 z 的左节点就可以了
 				xp = y;
 			}
-			// z ͸ڵӱ z ĸڵ y 
+			// z 和父节点的连接变成 z 的父节点和 y 的连接
 			if (root == z) {
 				root = y;
 			}
 			else if (rb_tree_is_lchild(z)) {
-				z->parent->left = y;
+				z->get_parent()->left = y;
 			}
 			else {
-				z->parent->right = y;
+				z->get_parent()->right = y;
 			}
-			y->parent = z->parent;
-			mystl::swap(y->color, z->color);
-			// y ָ z
+			y->set_parent(z->get_parent());
+			const rb_tree_color_type yc = y->get_color();
+			y->set_color(z->get_color());
+			z->set_color(yc);
+			rb_tree_copy_size(y, z);
+			// y 指向 z
 			y = z;
+			// 从摘掉的位置往上重新算，y 在 z 原来的位置上，也在这条路径上
+			rb_tree_propagate_augment(xp, root);
 		}
 		else {
-			xp = y->parent;
+			xp = y->get_parent();
 			if (x != nullptr) {
-				x->parent = y->parent;
+				x->set_parent(y->get_parent());
 			}
 
 			if (root == z) {
 				root = x;
 			}
 			else if (rb_tree_is_lchild(z)) {
-				z->parent->left = x;
+				z->get_parent()->left = x;
 			}
 			else {
-				z->parent->right = x;
+				z->get_parent()->right = x;
 			}
 
 			if (leftmost == z) {
@@ -602,50 +787,54 @@ namespace mystl {
 			if (rightmost == z) {
 				rightmost = (x == nullptr) ? xp : rb_tree_max(x);
 			}
+			// 删的是根时上面没有要重新算的节点，xp 是 header 或 nullptr
+			if (root != x) {
+				rb_tree_propagate_augment(xp, root);
+			}
 		}
 
-		// ɾ
+		// 删除分六种情况
 		// https://blog.csdn.net/qq_40843865/article/details/102498310
-		// ѭ 2 Ϊ
-		// ѭڽ 2 е
+		// 其中循环外解决情况 2 以为的所有情况
+		// 循环内解决情况 2 中的四种情况
 
 		if (rb_tree_is_black(y)) {
-			// x ǻ᲻ϵѭ x ѭ root ڵ
-			// Ҫ x ڵ
+			// x 是会不断的循环，可能 x 会循环到 root 节点
+			// 我们需要调整 x 节点
 
-			// һʼѭΪ x == nullptr ,ΪɾǺɫûкӵĽڵ
+			// 一开始进入循环是因为 x == nullptr ,因为删除的是黑色没有孩子的节点
 			while (x != root && (x == nullptr || rb_tree_is_black(x)))
 			{
 				if (x == xp->left) {
 					NodePtr brother = xp->right;
 					if (rb_tree_is_red(brother)) {
-						// 
+						// 情况四
 						rb_tree_set_red(xp);
 						rb_tree_set_black(brother);
 						rb_tree_rotate_left(xp, root);
 						brother = xp->right;
 					}
-					// һ brother µĽڵ
+					// 情况三和情况一、情况二的区别是 brother 下的节点
 					if ((brother->left == nullptr || rb_tree_is_black(brother->left)) &&
 						(brother->right == nullptr || rb_tree_is_black(brother->right))) {
-						// 
+						// 情况三
 						rb_tree_set_red(brother);
 						x = xp;
-						xp = xp->parent;
+						xp = xp->get_parent();
 					}
 					else {
-						// תһ
+						// 情况二转情况一
 						if (brother->right == nullptr || rb_tree_is_black(brother->right)) {
-							// 
-							if (brother->left == nullptr) {
+							// 情况二
+							if (brother->left != nullptr) {
 								rb_tree_set_black(brother->left);
 							}
 							rb_tree_set_red(brother);
 							rb_tree_rotate_right(brother, root);
 							brother = xp->right;
 						}
-						// һ
-						brother->color = xp->color;
+						// 情况一
+						brother->set_color(xp->get_color());
 						rb_tree_set_black(xp);
 						if (brother->right != nullptr) {
 							rb_tree_set_black(brother->right);
@@ -667,7 +856,7 @@ namespace mystl {
 						(brother->right == nullptr || rb_tree_is_black(brother->right))) {
 						rb_tree_set_red(brother);
 						x = xp;
-						xp = xp->parent;
+						xp = xp->get_parent();
 					}
 					else {
 						if (brother->left == nullptr || rb_tree_is_black(brother->left)) {
@@ -678,7 +867,7 @@ namespace mystl {
 							rb_tree_rotate_left(brother, root);
 							brother = xp->left;
 						}
-						brother->color = xp->color;
+						brother->set_color(xp->get_color());
 						rb_tree_set_black(xp);
 						if (brother->left != nullptr) {
 							rb_tree_set_black(brother->left);
@@ -696,18 +885,20 @@ namespace mystl {
 	}
 
 
-	template <class T, class Compare>
+	template <class T, class Compare, bool OrderStat = false>
 	class rb_tree
 	{
 	public:
 
-		using tree_traits = rb_tree_traits<T>;
+		using tree_traits = rb_tree_traits<T, OrderStat>;
 		using value_traits = rb_tree_value_traits<T>;
 
 		using base_type = typename tree_traits::base_type;
 		using base_ptr = typename tree_traits::base_ptr;
 		using node_type = typename tree_traits::node_type;
 		using node_ptr = typename tree_traits::node_ptr;
+		// node_type 已经是节点本身的类型，所以节点句柄叫 node_handle_type
+		using node_handle_type = mystl::node_handle<node_type, T>;
 		using key_type = typename tree_traits::key_type;
 		using mapped_type = typename tree_traits::mapped_type;
 		using value_type = typename tree_traits::value_type;
@@ -725,8 +916,8 @@ namespace mystl {
 		using size_type = typename allocator_type::size_type;
 		using difference_type = typename allocator_type::difference_type;
 
-		using iterator = rb_tree_iterator<T>;
-		using const_iterator = rb_tree_const_iterator<T>;
+		using iterator = rb_tree_iterator<T, OrderStat>;
+		using const_iterator = rb_tree_const_iterator<T, OrderStat>;
 		using reverse_iterator = mystl::reverse_iterator<iterator>;
 		using const_reverse_iterator = mystl::reverse_iterator<const_iterator>;
 
@@ -735,14 +926,18 @@ namespace mystl {
 
 	private:
 
+		// 颜色放在 parent 指针的最低位
+		static_assert(alignof(base_type) >= 2, "rb_tree_node_base must leave the low pointer bit free");
+
 		base_ptr mHeader;
 		size_type mNodeCount;
-		// mKeyComp Կ <
+		// mKeyComp 可以看作 <
 		key_compare mKeyComp;
 
 	private:
 
-		base_ptr& root() const { return mHeader->parent; }
+		base_ptr root() const { return mHeader->get_parent(); }
+		void set_root(base_ptr x) { mHeader->set_parent(x); }
 		base_ptr& leftmost() const { return mHeader->left; }
 		base_ptr& rightmost() const { return mHeader->right; }
 
@@ -757,7 +952,7 @@ namespace mystl {
 		{
 			rb_tree_init();
 			if (rhs.mNodeCount != 0) {
-				root() = copy_from(rhs.root(), mHeader);
+				set_root(copy_from(rhs.root(), mHeader));
 				leftmost() = rb_tree_min(root());
 				rightmost() = rb_tree_max(root());
 			}
@@ -778,7 +973,7 @@ namespace mystl {
 			if (&rhs != this) {
 				clear();
 				if (rhs.mNodeCount != 0) {
-					root() = copy_from(rhs.root(), mHeader);
+					set_root(copy_from(rhs.root(), mHeader));
 					leftmost() = rb_tree_min(root());
 					rightmost() = rb_tree_max(root());
 				}
@@ -792,6 +987,7 @@ namespace mystl {
 		rb_tree& operator=(rb_tree&& rhs)
 		{
 			clear();
+			base_allocator::deallocate(mHeader);
 			mHeader = mystl::move(rhs.mHeader);
 			mNodeCount = rhs.mNodeCount;
 			mKeyComp = rhs.mKeyComp;
@@ -802,6 +998,7 @@ namespace mystl {
 		~rb_tree()
 		{
 			clear();
+			base_allocator::deallocate(mHeader);
 		}
 
 	public:
@@ -887,16 +1084,16 @@ namespace mystl {
 		iterator emplace_multi(Args&& ...args)
 		{
 			THROW_LENGTH_ERROR_IF(mNodeCount > max_size() - 1, "");
-			node_ptr np = create_node(mystl::move(args));
+			node_ptr np = create_node(mystl::forward<Args>(args)...);
 			mystl::pair<iterator, bool> p = get_insert_multi_pos(value_traits::get_key(np->value));
-			return insert_node_at(p.first, np, p.second);
+			return insert_node_at(p.first.node, np, p.second);
 		}
 
 		template <class ...Args>
 		iterator emplace_multi_use_hint(iterator pos, Args&& ...args)
 		{
 			THROW_LENGTH_ERROR_IF(mNodeCount > max_size() - 1, " ");
-			node_ptr np = create_node(mystl::move(args));
+			node_ptr np = create_node(mystl::forward<Args>(args)...);
 			if (mNodeCount == 0) {
 				return insert_node_at(mHeader, np, true);
 			}
@@ -961,20 +1158,20 @@ namespace mystl {
 		mystl::pair<iterator, bool> emplace_unique(Args&& ...args)
 		{
 			THROW_LENGTH_ERROR_IF(mNodeCount > max_size() - 1, "");
-			node_ptr np = create_node(mystl::move(args));
-			mystl::pair<mystl::pair<iterator, bool>, bool> p = get_insert_unique_pos(value_traits::get_key(np->value));
+			node_ptr np = create_node(mystl::forward<Args>(args)...);
+			mystl::pair<mystl::pair<base_ptr, bool>, bool> p = get_insert_unique_pos(value_traits::get_key(np->value));
 			if (p.second) {
-				return make_pair(insert_node_at(p.first.first, np, p.first.second), true);
+				return mystl::make_pair(insert_node_at(p.first.first, np, p.first.second), true);
 			}
 			destroy_node(np);
-			return make_pair(iterator(p.first.first), false);
+			return mystl::make_pair(iterator(p.first.first), false);
 		}
 
 		template <class ...Args>
 		iterator emplace_unique_use_hint(iterator pos, Args&& ...args)
 		{
 			THROW_LENGTH_ERROR_IF(mNodeCount > max_size() - 1, " ");
-			node_ptr np = create_node(mystl::move(args));
+			node_ptr np = create_node(mystl::forward<Args>(args)...);
 			if (mNodeCount == 0) {
 				return insert_node_at(mHeader, np, true);
 			}
@@ -983,29 +1180,16 @@ namespace mystl {
 				if (mKeyComp(key, value_traits::get_key(*pos))) {
 					return insert_node_at(pos.node, np, true);
 				}
-				else {
-					mystl::pair<mystl::pair<iterator, bool>, bool> iter = get_insert_unique_pos(key);
-					if (iter.second == false) {
-						destroy_node(np);
-						return iter.first.first;
-					}
-					return insert_node_at(iter.first.node, np, iter.second);
-				}
 			}
 			else if (pos == end()) {
-				if (mKeyComp(key, value_traits::get_key(rightmost()->get_node_ptr()->value)) == false) {
+				if (mKeyComp(value_traits::get_key(rightmost()->get_node_ptr()->value), key)) {
 					return insert_node_at(rightmost(), np, false);
 				}
-				else {
-					mystl::pair<mystl::pair<iterator, bool>, bool> iter = get_insert_unique_pos(key);
-					if (iter.second == false) {
-						destroy_node(np);
-						return iter.first.first;
-					}
-					return insert_node_at(iter.first.node, np, iter.second);
-				}
 			}
-			return inset_unique_use_hint(pos, key, np);
+			else {
+				return inset_unique_use_hint(pos, key, np);
+			}
+			return insert_unique_node(key, np);
 		}
 
 		mystl::pair<iterator, bool> insert_unique(const value_type& value)
@@ -1013,9 +1197,9 @@ namespace mystl {
 			THROW_LENGTH_ERROR_IF(mNodeCount > max_size() - 1, " ");
 			mystl::pair<pair<iterator, bool>, bool> p = get_insert_unique_pos(value_traits::get_key(value));
 			if (p.second) {
-				return make_pair(insert_value_at(p.first.first.node, value, p.first.second), true);
+				return mystl::make_pair(insert_value_at(p.first.first.node, value, p.first.second), true);
 			}
-			return make_pair(p.first.first, false);
+			return mystl::make_pair(p.first.first, false);
 		}
 
 		mystl::pair<iterator, bool> insert_unique(value_type&& value)
@@ -1023,12 +1207,12 @@ namespace mystl {
 			return emplace_unique(mystl::move(value));
 		}
 
-		mystl::pair<iterator, bool> insert_unique(iterator hint, const value_type& value)
+		iterator insert_unique(iterator hint, const value_type& value)
 		{
 			return emplace_unique_use_hint(hint, value);
 		}
 
-		mystl::pair<iterator, bool> insert_unique(iterator hint, value_type&& value)
+		iterator insert_unique(iterator hint, value_type&& value)
 		{
 			return emplace_unique_use_hint(hint, mystl::move(value));
 		}
@@ -1043,219 +1227,699 @@ namespace mystl {
 			}
 		}
 
+		// 用一个已经按 key_comp 排好序的区间替换整棵树，O(n) 建树，不做逐个查找和旋转
+		// assign_sorted_unique 遇到相邻的相等 key 只保留第一个
+		template <class ForwardIter>
+		void assign_sorted_unique(ForwardIter first, ForwardIter last)
+		{
+			assign_sorted(first, last, true);
+		}
+
+		template <class ForwardIter>
+		void assign_sorted_multi(ForwardIter first, ForwardIter last)
+		{
+			assign_sorted(first, last, false);
+		}
+
 		iterator erase(iterator hint)
 		{
-			node_ptr np = hint.node->get_node_ptr();
 			iterator next = hint;
 			++next;
-			rb_tree_erase_rebalance(np, root(), leftmost(), rightmost());
-			--mNodeCount;
+			destroy_node(unlink_node(hint.node));
 			return next;
 		}
 
-		size_type erase_multi(const key_type& key)
+		// 节点句柄：extract 把节点从树上摘下来交给句柄，insert 再把它接到另一棵树上
+		// 整个过程只改父子指针和颜色，不会分配或释放节点，元素也不会被拷贝
+		node_handle_type extract(iterator pos)
 		{
-			mystl::pair<iterator, iterator> range = equal_range_multi(key);
-			size_type n = mystl::distance(range.first, range.second);
-			erase(range.first, range.second);
-			return n;
+			return node_handle_type(unlink_node(pos.node));
 		}
 
-		size_type erase_unique(const key_type& key)
+		node_handle_type extract(const key_type& key)
 		{
-			iterator it = find(key);
-			if (it != end()) {
-				erase(key);
-				return 1;
-			}
-			return 0;
+			base_ptr p = find_node(key);
+			return p == mHeader ? node_handle_type() : node_handle_type(unlink_node(p));
 		}
 
-		void erase(iterator first, iterator last)
+		// key 已经存在时不插入，节点仍然留在 nh 里
+		mystl::pair<iterator, bool> insert_unique(node_handle_type&& nh)
 		{
-			if (first == begin() && last == end()) {
-				clear();
+			if (nh.empty()) {
+				return mystl::make_pair(end(), false);
 			}
-			else {
-				while (first != last) {
-					erase(first++);
-				}
+			THROW_LENGTH_ERROR_IF(mNodeCount > max_size() - 1, "");
+			mystl::pair<mystl::pair<base_ptr, bool>, bool> p = get_insert_unique_pos(value_traits::get_key(nh.value()));
+			if (!p.second) {
+				return mystl::make_pair(iterator(p.first.first), false);
 			}
+			return mystl::make_pair(insert_node_at(p.first.first, nh.release(), p.first.second), true);
 		}
 
-		void clear()
+		iterator insert_multi(node_handle_type&& nh)
 		{
-			if (mNodeCount != 0) {
-				erase_since(root());
-				leftmost() = rightmost() = mHeader;
-				root() == nullptr;
-				mNodeCount = 0;
+			if (nh.empty()) {
+				return end();
 			}
+			THROW_LENGTH_ERROR_IF(mNodeCount > max_size() - 1, "");
+			mystl::pair<iterator, bool> p = get_insert_multi_pos(value_traits::get_key(nh.value()));
+			return insert_node_at(p.first.node, nh.release(), p.second);
 		}
 
-		iterator find(const key_type& key)
+		// 把 other 的节点全部转移过来，key 已经存在的节点留在 other 里
+		void merge_unique(rb_tree& other)
 		{
-			base_ptr y = mHeader;
-			base_ptr x = root();
-			while (x != nullptr) {
-				if (mKeyComp(value_traits::get_key(x->get_node_value()), key) == false) {
-					y = x;
-					x = x->left;
-				}
-				else {
-					x = x->right;
+			if (this == &other) {
+				return;
+			}
+			for (iterator it = other.begin(); it.node != other.mHeader; ) {
+				iterator cur = it++;
+				mystl::pair<mystl::pair<base_ptr, bool>, bool> p = get_insert_unique_pos(value_traits::get_key(*cur));
+				if (p.second) {
+					insert_node_at(p.first.first, other.unlink_node(cur.node), p.first.second);
 				}
 			}
-			iterator iter = iterator(y);
-			return (iter == end() || mKeyComp(key, value_traits::get_key(*iter))) ? end() : iter;
 		}
 
-		const_iterator find(const key_type& key) const
+		void merge_multi(rb_tree& other)
 		{
-			base_ptr y = mHeader;
-			base_ptr x = root();
-			while (x != nullptr) {
-				if (mKeyComp(value_traits::get_key(x->get_node_value()), key) == false) {
-					y = x;
-					x = x->left;
-				}
-				else {
-					x = x->right;
-				}
+			if (this == &other) {
+				return;
+			}
+			for (iterator it = other.begin(); it.node != other.mHeader; ) {
+				iterator cur = it++;
+				mystl::pair<iterator, bool> p = get_insert_multi_pos(value_traits::get_key(*cur));
+				insert_node_at(p.first.node, other.unlink_node(cur.node), p.second);
 			}
-			const_iterator iter = iterator(y);
-			return (iter == end() || mKeyComp(key, value_traits::get_key(*iter))) ? end() : iter;
 		}
 
-		size_type count_multi(const key_type& key) const
+		// 按 key 把树切成两半：this 留下小于 key 的部分，不小于 key 的部分作为返回值
+		// 切分和拼接都按黑高对齐，树结构的调整是 O(log n)
+		// 两边的 size 要知道切点前面有几个元素 (设为 k)：OrderStat 为 true 时用子树大小算，整个 split 是 O(log n)；
+		// 为 false 时只能从两头同时往切点数，整个 split 是 O(log n + min(k, n - k))
+		// 需要 O(log n) 的 split 请用 rb_tree<T, Compare, true>
+		rb_tree split(const key_type& key)
 		{
-			mystl::pair<iterator, iterator> p = equal_range_multi(key);
-			return static_cast<size_type>(mystl::distance(p.first, p.second));
+			rb_tree right;
+			right.mKeyComp = mKeyComp;
+			base_ptr p = lower_bound_node(key);
+			if (p == mHeader) {
+				return right;
+			}
+			const size_type n = mNodeCount;
+			const size_type left_n = count_before(p);
+			root()->set_parent(nullptr);
+			base_ptr l, r;
+			size_type lbh, rbh;
+			split_tree(p, l, lbh, r, rbh);
+			right.attach(join_tree(nullptr, 0, p, r, rbh, rbh), n - left_n);
+			attach(l, left_n);
+			return right;
+		}
+
+		// 把 right 整棵接到 this 的后面，right 变空
+		// 要求 right 的元素都不小于 this 的元素，unique 的树还要求严格大于
+		void join(rb_tree& right)
+		{
+			if (this == &right || right.mNodeCount == 0) {
+				return;
+			}
+			if (mNodeCount == 0) {
+				swap(right);
+				return;
+			}
+			MYSTL_DEBUG(!mKeyComp(value_traits::get_key(right.leftmost()->get_node_ptr()->value),
+				value_traits::get_key(rightmost()->get_node_ptr()->value)));
+			const size_type n = mNodeCount + right.mNodeCount;
+			// right 的最小节点摘下来当中间节点，两棵树只需要拼一次
+			base_ptr k = right.unlink_node(right.leftmost())->get_base_ptr();
+			base_ptr r = right.root();
+			size_type rbh = 0, bh;
+			if (r != nullptr) {
+				r->set_parent(nullptr);
+				rbh = black_height(r);
+			}
+			right.attach(nullptr, 0);
+			base_ptr l = root();
+			l->set_parent(nullptr);
+			attach(join_tree(l, black_height(l), k, r, rbh, bh), n);
 		}
 
-		size_type count_unique(const key_type& key) const
+		// 并集：other 的元素全部并进来，other 变空
+		// 分治做：按一棵树的根把另一棵切开，左右分别递归再接起来，较小的树当切分的一方
+		// unique 时 key 相同的两个元素留 this 的那个，other 的被释放
+		void union_unique(rb_tree& other)
 		{
-			return find(key) == end() ? 1 : 0;
+			union_with(other, true);
 		}
 
-		iterator lower_bound(const key_type& key)
+		void union_multi(rb_tree& other)
 		{
-			base_ptr y = mHeader;
-			base_ptr x = root();
-			while (x != nullptr) {
-				if (mKeyComp(value_traits::get_key(x->get_node_value()), key) == false) {
-					y = x;
-					x = x->left;
-				}
-				else {
-					x = x->right;
-				}
-			}
-			iterator iter = iterator(y);
-			return iter;
+			union_with(other, false);
 		}
 
-		const_iterator lower_bound(const key_type& key) const
+		// 交集：只留下 key 在 other 里也出现的元素，其余节点和 other 的节点都被释放，other 变空
+		void intersect_unique(rb_tree& other)
 		{
-			base_ptr y = mHeader;
-			base_ptr x = root();
-			while (x != nullptr) {
-				if (mKeyComp(value_traits::get_key(x->get_node_value()), key) == false) {
-					y = x;
-					x = x->left;
-				}
-				else {
-					x = x->right;
-				}
+			if (this == &other) {
+				return;
+			}
+			if (mNodeCount == 0 || other.mNodeCount == 0) {
+				clear();
+				other.clear();
+				return;
 			}
-			const_iterator iter = iterator(y);
-			return iter;
+			const bool this_small = mNodeCount <= other.mNodeCount;
+			base_ptr a = this_small ? root() : other.root();
+			base_ptr b = this_small ? other.root() : root();
+			a->set_parent(nullptr);
+			b->set_parent(nullptr);
+			size_type kept = 0, bh;
+			other.attach(nullptr, 0);
+			base_ptr t = intersect_tree(a, black_height(a), b, black_height(b), !this_small, bh, kept);
+			attach(t, kept);
 		}
 
-		iterator upper_bound(const key_type& key)
+		size_type erase_multi(const key_type& key)
 		{
-			base_ptr y = mHeader;
-			base_ptr x = root();
-			while (x != nullptr) {
-				if (mKeyComp(key, value_traits::get_key(x->get_node_value()))) {
-					y = x;
-					x = x->left;
-				}
-				else {
-					x = x->right;
-				}
-			}
-			iterator iter = iterator(y);
-			return iter;
+			return erase_multi_key(key);
 		}
 
-		const_iterator upper_bound(const key_type& key) const
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		size_type erase_multi(const K& key)
 		{
-			base_ptr y = mHeader;
-			base_ptr x = root();
-			while (x != nullptr) {
-				if (mKeyComp(key, value_traits::get_key(x->get_node_value()))) {
-					y = x;
-					x = x->left;
-				}
-				else {
-					x = x->right;
-				}
-			}
-			const_iterator iter = iterator(y);
-			return iter;
+			return erase_multi_key(key);
 		}
 
-		mystl::pair<iterator, iterator>
-			equal_range_multi(const key_type& key)
+		size_type erase_unique(const key_type& key)
 		{
-			return make_pair(lower_bound(key), upper_bound(key));
+			return erase_unique_key(key);
 		}
 
-		mystl::pair<const_iterator, const_iterator>
-			equal_range_multi(const key_type& key) const
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		size_type erase_unique(const K& key)
 		{
-			return make_pair(lower_bound(key), upper_bound(key));
+			return erase_unique_key(key);
 		}
 
-		mystl::pair<iterator, iterator>
-			equal_range_unique(const key_type& key)
+		// 把 [first, last) 整段切下来，两边再用 last 接回去，不用逐个节点删除再调整
+		// 调整部分是 O(log n)，剩下的只有释放切下来的节点
+		void erase(iterator first, iterator last)
 		{
-			iterator iter = find(key);
-			iterator next = iter;
-			++next;
-			return iter == end() ? make_pair(iter, iter) : make_pair(iter, next);
+			if (first == last) {
+				return;
+			}
+			if (first == begin() && last == end()) {
+				clear();
+				return;
+			}
+			root()->set_parent(nullptr);
+			base_ptr l, r;
+			size_type lbh, rbh, bh;
+			split_tree(first.node, l, lbh, r, rbh);
+			size_type erased = 1;
+			destroy_node(first.node->get_node_ptr());
+			if (last.node == mHeader) {
+				erased += erase_since(r);
+				attach(l, mNodeCount - erased);
+				return;
+			}
+			base_ptr ml, mr;
+			size_type mlbh, mrbh;
+			split_tree(last.node, ml, mlbh, mr, mrbh);
+			erased += erase_since(ml);
+			attach(join_tree(l, lbh, last.node, mr, mrbh, bh), mNodeCount - erased);
 		}
 
-		mystl::pair<const_iterator, const_iterator>
-			equal_range_unique(const key_type& key) const
+		void clear()
 		{
-			const_iterator iter = find(key);
-			const_iterator next = iter;
-			++next;
-			return iter == end() ? make_pair(iter, iter) : make_pair(iter, next);
+			if (mNodeCount != 0) {
+				erase_since(root());
+				leftmost() = rightmost() = mHeader;
+				set_root(nullptr);
+				mNodeCount = 0;
+			}
 		}
 
-		void swap(rb_tree& rhs)
+		iterator find(const key_type& key)
 		{
-			mystl::swap(rhs.mNodeCount, mNodeCount);
-			mystl::swap(rhs.mKeyComp, mKeyComp);
-			mystl::swap(rhs.mHeader, mHeader);
+			return iterator(find_node(key));
 		}
 
-	private:
+		const_iterator find(const key_type& key) const
+		{
+			return const_iterator(find_node(key));
+		}
 
-		template <class ...Args>
-		node_ptr create_node(Args&& ...args)
+		// 异构查找：Compare 声明了 is_transparent 时可以直接用能和 key 比较的类型 K 查找
+		// C 要写成默认模板参数，这样 enable_if 才依赖于函数模板自己的参数
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		iterator find(const K& key)
 		{
-			node_ptr tmp = node_allocator::allocate(1);
-			try {
-				data_allocator::construct(mystl::address_of(tmp->value), mystl::move(args)...);
-				tmp->left = tmp->right = tmp->parent = nullptr;
-			}
-			catch (...) {
-				node_allocator::deallocate(tmp, 1);
-				throw;
+			return iterator(find_node(key));
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator find(const K& key) const
+		{
+			return const_iterator(find_node(key));
+		}
+
+		size_type count_multi(const key_type& key) const
+		{
+			return count_multi_key(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		size_type count_multi(const K& key) const
+		{
+			return count_multi_key(key);
+		}
+
+		size_type count_unique(const key_type& key) const
+		{
+			return find_node(key) == mHeader ? 0 : 1;
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		size_type count_unique(const K& key) const
+		{
+			return find_node(key) == mHeader ? 0 : 1;
+		}
+
+		iterator lower_bound(const key_type& key)
+		{
+			return iterator(lower_bound_node(key));
+		}
+
+		const_iterator lower_bound(const key_type& key) const
+		{
+			return const_iterator(lower_bound_node(key));
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		iterator lower_bound(const K& key)
+		{
+			return iterator(lower_bound_node(key));
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator lower_bound(const K& key) const
+		{
+			return const_iterator(lower_bound_node(key));
+		}
+
+		iterator upper_bound(const key_type& key)
+		{
+			return iterator(upper_bound_node(key));
+		}
+
+		const_iterator upper_bound(const key_type& key) const
+		{
+			return const_iterator(upper_bound_node(key));
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		iterator upper_bound(const K& key)
+		{
+			return iterator(upper_bound_node(key));
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		const_iterator upper_bound(const K& key) const
+		{
+			return const_iterator(upper_bound_node(key));
+		}
+
+		mystl::pair<iterator, iterator>
+			equal_range_multi(const key_type& key)
+		{
+			return mystl::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		mystl::pair<const_iterator, const_iterator>
+			equal_range_multi(const key_type& key) const
+		{
+			return mystl::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		mystl::pair<iterator, iterator>
+			equal_range_multi(const K& key)
+		{
+			return mystl::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		mystl::pair<const_iterator, const_iterator>
+			equal_range_multi(const K& key) const
+		{
+			return mystl::make_pair(lower_bound(key), upper_bound(key));
+		}
+
+		mystl::pair<iterator, iterator>
+			equal_range_unique(const key_type& key)
+		{
+			return equal_range_unique_key<iterator>(key);
+		}
+
+		mystl::pair<const_iterator, const_iterator>
+			equal_range_unique(const key_type& key) const
+		{
+			return equal_range_unique_key<const_iterator>(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		mystl::pair<iterator, iterator>
+			equal_range_unique(const K& key)
+		{
+			return equal_range_unique_key<iterator>(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		mystl::pair<const_iterator, const_iterator>
+			equal_range_unique(const K& key) const
+		{
+			return equal_range_unique_key<const_iterator>(key);
+		}
+
+		// 按顺序对 key 在 [lo, hi) 里的每个元素调用 fn(value_type&)
+		// 区间扫描用这个比 lower_bound 加迭代器 ++ 快：不回溯父指针，而且会预取接下来要走的子树
+		template <class Fn>
+		void for_each_range(const key_type& lo, const key_type& hi, Fn fn)
+		{
+			auto visit = [&fn](base_ptr x) { fn(x->get_node_ptr()->value); };
+			for_each_range_node(lo, hi, visit);
+		}
+
+		template <class Fn>
+		void for_each_range(const key_type& lo, const key_type& hi, Fn fn) const
+		{
+			auto visit = [&fn](base_ptr x) { fn(static_cast<const value_type&>(x->get_node_ptr()->value)); };
+			for_each_range_node(lo, hi, visit);
+		}
+
+		template <class K, class Fn, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		void for_each_range(const K& lo, const K& hi, Fn fn)
+		{
+			auto visit = [&fn](base_ptr x) { fn(x->get_node_ptr()->value); };
+			for_each_range_node(lo, hi, visit);
+		}
+
+		template <class K, class Fn, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		void for_each_range(const K& lo, const K& hi, Fn fn) const
+		{
+			auto visit = [&fn](base_ptr x) { fn(static_cast<const value_type&>(x->get_node_ptr()->value)); };
+			for_each_range_node(lo, hi, visit);
+		}
+
+		void swap(rb_tree& rhs)
+		{
+			mystl::swap(rhs.mNodeCount, mNodeCount);
+			mystl::swap(rhs.mKeyComp, mKeyComp);
+			mystl::swap(rhs.mHeader, mHeader);
+		}
+
+		// 下面几个是 order statistic 操作，只有 OrderStat 为 true 的树可以用，都是 O(log n)
+
+		// 第 k 个元素（从 0 开始），k >= size() 时返回 end()
+		iterator select(size_type k)
+		{
+			static_assert(OrderStat, "select needs rb_tree<T, Compare, true>");
+			return iterator(select_node(k));
+		}
+
+		const_iterator select(size_type k) const
+		{
+			static_assert(OrderStat, "select needs rb_tree<T, Compare, true>");
+			return const_iterator(select_node(k));
+		}
+
+		// 小于 key 的元素个数，也就是 lower_bound(key) 的下标
+		size_type rank(const key_type& key) const
+		{
+			static_assert(OrderStat, "rank needs rb_tree<T, Compare, true>");
+			return rank_key(key);
+		}
+
+		template <class K, class C = Compare,
+			typename std::enable_if<mystl::is_transparent<C>::value, int>::type = 0>
+		size_type rank(const K& key) const
+		{
+			static_assert(OrderStat, "rank needs rb_tree<T, Compare, true>");
+			return rank_key(key);
+		}
+
+		// it 指向的元素的下标，end() 的下标是 size()
+		size_type index_of(const_iterator it) const
+		{
+			static_assert(OrderStat, "index_of needs rb_tree<T, Compare, true>");
+			base_ptr x = it.node;
+			if (x == mHeader) {
+				return mNodeCount;
+			}
+			size_type n = rb_tree_size_of(x->left);
+			while (x != root()) {
+				if (rb_tree_is_rchild(x)) {
+					n += rb_tree_size_of(x->get_parent()->left) + 1;
+				}
+				x = x->get_parent();
+			}
+			return n;
+		}
+
+		// 相当于 mystl::distance(first, last)，但不用一个个往后走
+		difference_type distance(const_iterator first, const_iterator last) const
+		{
+			return static_cast<difference_type>(index_of(last)) - static_cast<difference_type>(index_of(first));
+		}
+
+	private:
+
+		// 查找时一边比较当前节点一边把两个孩子取进缓存，下一层无论往哪边走，要读的节点都已经在路上了
+		static void prefetch_children(base_ptr x) noexcept
+		{
+			MYSTL_PREFETCH(x->left);
+			MYSTL_PREFETCH(x->right);
+		}
+
+		// for_each_range 的实现，对 [lo, hi) 里的每个节点按顺序调用 fn(x)
+		// 用显式栈做中序遍历，不用迭代器的 inc 一步步回溯父指针；不在范围内的子树整棵跳过
+		// 节点入栈时就预取它的右子树，等出栈访问完它再往右走时，右孩子已经在缓存里了
+		template <class K, class Fn>
+		void for_each_range_node(const K& lo, const K& hi, Fn& fn) const
+		{
+			// 红黑树的高度不超过 2log(n + 1)
+			base_ptr stack[2 * sizeof(size_type) * 8];
+			size_type top = 0;
+			base_ptr x = root();
+			while (x != nullptr) {
+				if (mKeyComp(value_traits::get_key(x->get_node_ptr()->value), lo)) {
+					x = x->right;
+				}
+				else {
+					MYSTL_PREFETCH(x->right);
+					stack[top++] = x;
+					x = x->left;
+				}
+			}
+			while (top != 0) {
+				x = stack[--top];
+				if (!mKeyComp(value_traits::get_key(x->get_node_ptr()->value), hi)) {
+					return;
+				}
+				fn(x);
+				// 右子树里的 key 都不小于 x，也就不小于 lo，一路往左压栈即可
+				for (x = x->right; x != nullptr; x = x->left) {
+					MYSTL_PREFETCH(x->right);
+					stack[top++] = x;
+				}
+			}
+		}
+
+		// 下面几个是查找和删除的实现，K 为 key_type 或者异构查找时的任意可比较类型
+
+		// 第一个不小于 key 的节点，没有则返回 mHeader
+		template <class K>
+		base_ptr lower_bound_node(const K& key) const
+		{
+			base_ptr y = mHeader;
+			base_ptr x = root();
+			while (x != nullptr) {
+				prefetch_children(x);
+				if (mKeyComp(value_traits::get_key(x->get_node_ptr()->value), key) == false) {
+					y = x;
+					x = x->left;
+				}
+				else {
+					x = x->right;
+				}
+			}
+			return y;
+		}
+
+		// 第一个大于 key 的节点，没有则返回 mHeader
+		template <class K>
+		base_ptr upper_bound_node(const K& key) const
+		{
+			base_ptr y = mHeader;
+			base_ptr x = root();
+			while (x != nullptr) {
+				prefetch_children(x);
+				if (mKeyComp(key, value_traits::get_key(x->get_node_ptr()->value))) {
+					y = x;
+					x = x->left;
+				}
+				else {
+					x = x->right;
+				}
+			}
+			return y;
+		}
+
+		template <class K>
+		base_ptr find_node(const K& key) const
+		{
+			base_ptr y = lower_bound_node(key);
+			return (y == mHeader || mKeyComp(key, value_traits::get_key(y->get_node_ptr()->value))) ? mHeader : y;
+		}
+
+		template <class K>
+		size_type count_multi_key(const K& key) const
+		{
+			const_iterator first(lower_bound_node(key));
+			const_iterator last(upper_bound_node(key));
+			return count_between(first, last, std::integral_constant<bool, OrderStat>());
+		}
+
+		template <class Iter, class K>
+		mystl::pair<Iter, Iter> equal_range_unique_key(const K& key) const
+		{
+			base_ptr p = find_node(key);
+			Iter iter(p);
+			if (p == mHeader) {
+				return mystl::make_pair(iter, iter);
+			}
+			Iter next = iter;
+			++next;
+			return mystl::make_pair(iter, next);
+		}
+
+		template <class K>
+		size_type erase_multi_key(const K& key)
+		{
+			iterator first(lower_bound_node(key));
+			iterator last(upper_bound_node(key));
+			size_type n = mystl::distance(first, last);
+			erase(first, last);
+			return n;
+		}
+
+		template <class K>
+		size_type erase_unique_key(const K& key)
+		{
+			base_ptr p = find_node(key);
+			if (p != mHeader) {
+				erase(iterator(p));
+				return 1;
+			}
+			return 0;
+		}
+
+		size_type count_between(const_iterator first, const_iterator last, std::false_type) const
+		{
+			return static_cast<size_type>(mystl::distance(first, last));
+		}
+
+		size_type count_between(const_iterator first, const_iterator last, std::true_type) const
+		{
+			return index_of(last) - index_of(first);
+		}
+
+		void init_size(base_ptr, std::false_type) noexcept {}
+
+		void init_size(base_ptr x, std::true_type) noexcept
+		{
+			x->size = 1;
+		}
+
+		// 第 k 个节点（从 0 开始），没有则返回 mHeader
+		base_ptr select_node(size_type k) const
+		{
+			base_ptr x = root();
+			while (x != nullptr) {
+				const size_type left_size = rb_tree_size_of(x->left);
+				if (k < left_size) {
+					x = x->left;
+				}
+				else if (k == left_size) {
+					return x;
+				}
+				else {
+					k -= left_size + 1;
+					x = x->right;
+				}
+			}
+			return mHeader;
+		}
+
+		template <class K>
+		size_type rank_key(const K& key) const
+		{
+			size_type n = 0;
+			base_ptr x = root();
+			while (x != nullptr) {
+				if (mKeyComp(value_traits::get_key(x->get_node_ptr()->value), key)) {
+					n += rb_tree_size_of(x->left) + 1;
+					x = x->right;
+				}
+				else {
+					x = x->left;
+				}
+			}
+			return n;
+		}
+
+		// 把节点从树上摘下来并重新平衡，返回的节点可以直接 insert_node_at 到任意一棵树上
+		node_ptr unlink_node(base_ptr x)
+		{
+			base_ptr r = root();
+			base_ptr y = rb_tree_erase_rebalance(x, r, leftmost(), rightmost());
+			set_root(r);
+			y->set_parent(nullptr);
+			y->left = y->right = nullptr;
+			--mNodeCount;
+			return y->get_node_ptr();
+		}
+
+		template <class ...Args>
+		node_ptr create_node(Args&& ...args)
+		{
+			node_ptr tmp = node_allocator::allocate(1);
+			try {
+				data_allocator::construct(mystl::address_of(tmp->value), mystl::forward<Args>(args)...);
+				tmp->left = tmp->right = nullptr;
+				tmp->set_parent_color(nullptr, rb_tree_red);
+			}
+			catch (...) {
+				node_allocator::deallocate(tmp, 1);
+				throw;
 			}
 			return tmp;
 		}
@@ -1263,7 +1927,9 @@ namespace mystl {
 		node_ptr clone_node(base_ptr x)
 		{
 			node_ptr tmp = create_node(x->get_node_ptr()->value);
-			tmp->color = x->color;
+			tmp->set_color(x->get_color());
+			rb_tree_copy_size(tmp->get_base_ptr(), x);
+			rb_tree_copy_augment(tmp->get_base_ptr(), x);
 			tmp->left = nullptr;
 			tmp->right = nullptr;
 			return tmp;
@@ -1278,8 +1944,7 @@ namespace mystl {
 		void rb_tree_init()
 		{
 			mHeader = base_allocator::allocate(1);
-			mHeader->color = rb_tree_red;
-			root() = nullptr;
+			mHeader->set_parent_color(nullptr, rb_tree_red);
 			leftmost() = rightmost() = mHeader;
 			mNodeCount = 0;
 		}
@@ -1301,7 +1966,7 @@ namespace mystl {
 				add_to_left = mKeyComp(key, value_traits::get_key(x->get_node_ptr()->value));
 				x = add_to_left ? x->left : x->right;
 			}
-			return  make_pair(iterator(y), add_to_left);
+			return  mystl::make_pair(iterator(y), add_to_left);
 		}
 
 		mystl::pair<mystl::pair<base_ptr, bool>, bool>
@@ -1317,8 +1982,8 @@ namespace mystl {
 			}
 			iterator it = iterator(y);
 			if (add_to_left) {
-				if (y == begin() || y == mHeader) {
-					return make_pair(make_pair(it, true), true);
+				if (y == mHeader || y == leftmost()) {
+					return mystl::make_pair(mystl::make_pair(y, true), true);
 				}
 				else {
 					--it;
@@ -1326,42 +1991,24 @@ namespace mystl {
 			}
 
 			if (mKeyComp(value_traits::get_key(*it), key)) {
-				return make_pair(make_pair(y, add_to_left), true);
+				return mystl::make_pair(mystl::make_pair(y, add_to_left), true);
 			}
-			return make_pair(make_pair(y, add_to_left), false);
+			// 插入失败时 first.first 是已经存在的那个节点
+			return mystl::make_pair(mystl::make_pair(it.node, add_to_left), false);
 		}
 
 		iterator insert_value_at(base_ptr x, const value_type& value, bool add_to_left)
 		{
-			node_ptr np = create_node(value);
-			np->parent = x;
-			base_ptr base_np = np->get_base_ptr();
-			if (x == mHeader) {
-				mHeader->left = mHeader->right = x;
-			}
-			else if (add_to_left) {
-				x->left = base_np;
-				if (leftmost() == x) {
-					leftmost() = base_np;
-				}
-			}
-			else {
-				x->right = base_np;
-				if (rightmost() == x) {
-					rightmost() == base_np;
-				}
-			}
-			++mNodeCount;
-			rb_tree_insert_rebalance(np, root);
-			return iterator(np);
+			return insert_node_at(x, create_node(value), add_to_left);
 		}
 
 		iterator insert_node_at(base_ptr x, node_ptr np, bool add_to_left)
 		{
-			np->parent = x;
+			np->set_parent(x);
 			base_ptr base_np = np->get_base_ptr();
 			if (x == mHeader) {
-				mHeader->left = mHeader->right = x;
+				set_root(base_np);
+				leftmost() = rightmost() = base_np;
 			}
 			else if (add_to_left) {
 				x->left = base_np;
@@ -1372,15 +2019,20 @@ namespace mystl {
 			else {
 				x->right = base_np;
 				if (rightmost() == x) {
-					rightmost() == base_np;
+					rightmost() = base_np;
 				}
 			}
 			++mNodeCount;
-			rb_tree_insert_rebalance(np, root);
+			init_size(base_np, std::integral_constant<bool, OrderStat>());
+			rb_tree_add_size(base_np, root(), 1);
+			rb_tree_propagate_augment(base_np, root());
+			base_ptr r = root();
+			rb_tree_insert_rebalance(base_np, r);
+			set_root(r);
 			return iterator(np);
 		}
 
-		iterator inset_multi_use_hint(iterator hint, key_type key, node_ptr node)
+		iterator inset_multi_use_hint(iterator hint, const key_type& key, node_ptr node)
 		{
 			base_ptr np = hint.node;
 			iterator before = hint;
@@ -1389,56 +2041,135 @@ namespace mystl {
 			if (!(mKeyComp(key, value_traits::get_key(*before))) &&
 				!(mKeyComp(value_traits::get_key(*hint), key)))
 			{
-				// before < key < hint
+				// before <= key <= hint，新节点接在 before 的右边或者 hint 的左边
 				if (bnp->right == nullptr) {
-					return insert_node_at(bnp, np, false);
+					return insert_node_at(bnp, node, false);
 				}
-				else if (bnp->left == nullptr) {
-					return insert_node_at(bup, np, true);
+				else if (np->left == nullptr) {
+					return insert_node_at(np, node, true);
 				}
 			}
 			mystl::pair<iterator, bool> pos = get_insert_multi_pos(key);
-			return insert_node_at(pos.first.node, np, pos.second);
+			return insert_node_at(pos.first.node, node, pos.second);
 		}
 
-		iterator inset_unique_use_hint(iterator hint, key_type key, node_ptr node)
+		iterator inset_unique_use_hint(iterator hint, const key_type& key, node_ptr node)
 		{
 			base_ptr np = hint.node;
 			iterator before = hint;
 			--before;
 			base_ptr bnp = before.node;
-			if (!(mKeyComp(key, value_traits::get_key(*before))) &&
-				!(mKeyComp(value_traits::get_key(*hint), key)))
+			if (mKeyComp(value_traits::get_key(*before), key) &&
+				mKeyComp(key, value_traits::get_key(*hint)))
 			{
 				// before < key < hint
 				if (bnp->right == nullptr) {
-					return insert_node_at(bnp, np, false);
+					return insert_node_at(bnp, node, false);
 				}
-				else if (bnp->left == nullptr) {
-					return insert_node_at(bup, np, true);
+				else if (np->left == nullptr) {
+					return insert_node_at(np, node, true);
 				}
 			}
-			mystl::pair<mystl::pair<iterator, bool>, bool> pos = get_insert_unique_pos(key);
+			return insert_unique_node(key, node);
+		}
+
+		// hint 用不上时按 key 找位置，key 已经存在就释放 node，返回已有的元素
+		iterator insert_unique_node(const key_type& key, node_ptr node)
+		{
+			mystl::pair<mystl::pair<base_ptr, bool>, bool> pos = get_insert_unique_pos(key);
 			if (pos.second == false) {
-				destroy_node(np);
-				return pos.first.first;
+				destroy_node(node);
+				return iterator(pos.first.first);
+			}
+			return insert_node_at(pos.first.first, node, pos.first.second);
+		}
+
+		// 先数出要建的节点个数，再按中序递归建一棵左右子树大小最多差一的树
+		// 这样的树前 red_depth 层一定是满的，这些层全染黑，最下面不满的那一层染红，每条路径上的黑节点数都相同
+		template <class ForwardIter>
+		void assign_sorted(ForwardIter first, ForwardIter last, bool unique)
+		{
+			size_type n = 0;
+			for (ForwardIter it = first, prev = first; it != last; prev = it, ++it) {
+				if (it != first) {
+					MYSTL_DEBUG(!mKeyComp(value_traits::get_key(*it), value_traits::get_key(*prev)));
+					if (unique && !mKeyComp(value_traits::get_key(*prev), value_traits::get_key(*it))) {
+						continue;
+					}
+				}
+				++n;
+			}
+			clear();
+			if (n == 0) {
+				return;
+			}
+			// 满足 2^red_depth - 1 <= n 的最大 red_depth
+			size_type red_depth = 0;
+			while ((static_cast<size_type>(2) << red_depth) - 1 <= n) {
+				++red_depth;
 			}
-			return insert_node_at(pos.first.node, np, pos.second);
+			set_root(build_sorted(first, last, n, 0, red_depth, unique));
+			root()->set_parent(mHeader);
+			leftmost() = rb_tree_min(root());
+			rightmost() = rb_tree_max(root());
+			mNodeCount = n;
+		}
+
+		// 用 [first, last) 开头的 n 个元素建子树，first 跟着往后走
+		template <class ForwardIter>
+		base_ptr build_sorted(ForwardIter& first, ForwardIter last, size_type n,
+			size_type depth, size_type red_depth, bool unique)
+		{
+			if (n == 0) {
+				return nullptr;
+			}
+			const size_type left_n = (n - 1) / 2;
+			base_ptr left = build_sorted(first, last, left_n, depth + 1, red_depth, unique);
+			node_ptr np = nullptr;
+			try {
+				np = create_node(*first);
+			}
+			catch (...) {
+				erase_since(left);
+				throw;
+			}
+			np->set_color(depth == red_depth ? rb_tree_red : rb_tree_black);
+			np->left = left;
+			if (left != nullptr) {
+				left->set_parent(np->get_base_ptr());
+			}
+			++first;
+			while (unique && first != last && !mKeyComp(value_traits::get_key(np->value), value_traits::get_key(*first))) {
+				++first;
+			}
+			try {
+				np->right = build_sorted(first, last, n - left_n - 1, depth + 1, red_depth, unique);
+			}
+			catch (...) {
+				erase_since(np->get_base_ptr());
+				throw;
+			}
+			if (np->right != nullptr) {
+				np->right->set_parent(np->get_base_ptr());
+			}
+			rb_tree_update_size(np->get_base_ptr());
+			rb_tree_update_augment(np->get_base_ptr());
+			return np->get_base_ptr();
 		}
 
 		base_ptr copy_from(base_ptr x, base_ptr p)
 		{
-			node_ptr np = clone_node(x);
-			np->parent = p;
+			node_ptr top = clone_node(x);
+			top->set_parent(p);
 			try {
 				if (x->right != nullptr) {
-					copy_from(x->right, np);
+					top->right = copy_from(x->right, top);
 				}
-				p = np;
+				p = top;
 				x = x->left;
-				while (p != nullptr) {
+				while (x != nullptr) {
 					node_ptr y = clone_node(x);
-					y->parent = p;
+					y->set_parent(p);
 					p->left = y;
 					if (x->right != nullptr) {
 						y->right = copy_from(x->right, y);
@@ -1448,62 +2179,365 @@ namespace mystl {
 				}
 			}
 			catch (...) {
-				destroy_node(np);
+				erase_since(top);
 				throw;
 			}
-			return np;
+			return top;
 		}
 
-		void erase_since(base_ptr x)
+		// 释放以 x 为根的整棵子树，返回释放的节点数
+		size_type erase_since(base_ptr x)
 		{
+			size_type n = 0;
 			while (x != nullptr) {
-				erase_since(x->right);
+				n += erase_since(x->right);
 				base_ptr y = x->left;
 				destroy_node(x->get_node_ptr());
+				++n;
 				x = y;
 			}
+			return n;
+		}
+
+		// 下面是 split / join 的实现，操作的都是单独拿出来的子树：根的 parent 为 nullptr
+		// bh 是黑高，从子树的根往下数黑色节点的个数（空节点不算）
+
+		// 以 x 为根的整棵子树挂回 mHeader，元素个数为 n
+		void attach(base_ptr x, size_type n) noexcept
+		{
+			set_root(x);
+			if (x != nullptr) {
+				x->set_parent(mHeader);
+				leftmost() = rb_tree_min(x);
+				rightmost() = rb_tree_max(x);
+			}
+			else {
+				leftmost() = rightmost() = mHeader;
+			}
+			mNodeCount = n;
+		}
+
+		static size_type black_height(base_ptr x) noexcept
+		{
+			size_type h = 0;
+			for (; x != nullptr; x = x->left) {
+				if (rb_tree_is_black(x)) {
+					++h;
+				}
+			}
+			return h;
+		}
+
+		// 把子树 x 从父节点上拿下来，根是红色时染黑，bh 跟着加一
+		static base_ptr detach_tree(base_ptr x, size_type& bh) noexcept
+		{
+			if (x != nullptr) {
+				x->set_parent(nullptr);
+				if (rb_tree_is_red(x)) {
+					rb_tree_set_black(x);
+					++bh;
+				}
+			}
+			return x;
+		}
+
+		// 用节点 k 把 l 和 r 接成一棵树，要求 l < k < r，l 和 r 的根都是黑色
+		// 黑高相同时 k 直接当根；否则沿较高那棵的右（左）边往下找黑高相同的黑色节点 c，
+		// k 替换 c 的位置，c 和矮的树当 k 的两个孩子，再按插入红节点调整，只需 O(|lbh - rbh| + 1)
+		base_ptr join_tree(base_ptr l, size_type lbh, base_ptr k, base_ptr r, size_type rbh, size_type& bh) noexcept
+		{
+			k->set_parent(nullptr);
+			if (lbh == rbh) {
+				k->left = l;
+				k->right = r;
+				if (l != nullptr) {
+					l->set_parent(k);
+				}
+				if (r != nullptr) {
+					r->set_parent(k);
+				}
+				rb_tree_set_black(k);
+				rb_tree_update_size(k);
+				rb_tree_update_augment(k);
+				bh = lbh + 1;
+				return k;
+			}
+			const bool left_taller = lbh > rbh;
+			base_ptr root = left_taller ? l : r;
+			const size_type target = left_taller ? rbh : lbh;
+			size_type h = left_taller ? lbh : rbh;
+			base_ptr c = root, cp = nullptr;
+			while (c != nullptr && !(rb_tree_is_black(c) && h == target)) {
+				if (rb_tree_is_black(c)) {
+					--h;
+				}
+				cp = c;
+				c = left_taller ? c->right : c->left;
+			}
+			if (left_taller) {
+				k->left = c;
+				k->right = r;
+				cp->right = k;
+			}
+			else {
+				k->left = l;
+				k->right = c;
+				cp->left = k;
+			}
+			k->set_parent(cp);
+			if (k->left != nullptr) {
+				k->left->set_parent(k);
+			}
+			if (k->right != nullptr) {
+				k->right->set_parent(k);
+			}
+			if (OrderStat) {
+				for (base_ptr x = k; x != nullptr; x = x->get_parent()) {
+					rb_tree_update_size(x);
+				}
+			}
+			rb_tree_propagate_augment(k, root);
+			// 接上去的 k 是红色，调整时红色推到根的话根重新染黑，黑高加一
+			bh = (left_taller ? lbh : rbh) + (rb_tree_insert_rebalance(k, root) ? 1 : 0);
+			return root;
+		}
+
+		// 没有中间节点的拼接，从 r 里摘下最小节点来当中间节点
+		base_ptr join_tree(base_ptr l, size_type lbh, base_ptr r, size_type rbh, size_type& bh) noexcept
+		{
+			if (l == nullptr) {
+				bh = rbh;
+				return r;
+			}
+			if (r == nullptr) {
+				bh = lbh;
+				return l;
+			}
+			base_ptr k = rb_tree_min(r);
+			base_ptr lm = nullptr, rm = nullptr;
+			rb_tree_erase_rebalance(k, r, lm, rm);
+			k->left = k->right = nullptr;
+			return join_tree(l, lbh, k, r, black_height(r), bh);
+		}
+
+		// p 所在的树按 p 切成三份：p 之前的 l、p 本身、p 之后的 r
+		// 从 p 往上走，每个祖先连同它另一边的子树都拼到 l 或 r 上
+		// 相邻两次拼接的黑高差加起来不超过树高，总共 O(log n)
+		void split_tree(base_ptr p, base_ptr& l, size_type& lbh, base_ptr& r, size_type& rbh) noexcept
+		{
+			size_type xbh = black_height(p);
+			lbh = rbh = xbh - (rb_tree_is_black(p) ? 1 : 0);
+			l = detach_tree(p->left, lbh);
+			r = detach_tree(p->right, rbh);
+			base_ptr x = p;
+			base_ptr q = p->get_parent();
+			while (q != nullptr) {
+				const bool from_left = q->left == x;
+				base_ptr next = q->get_parent();
+				const size_type qbh = xbh + (rb_tree_is_black(q) ? 1 : 0);
+				size_type obh = xbh;
+				base_ptr other = detach_tree(from_left ? q->right : q->left, obh);
+				if (from_left) {
+					r = join_tree(r, rbh, q, other, obh, rbh);
+				}
+				else {
+					l = join_tree(other, obh, q, l, lbh, lbh);
+				}
+				x = q;
+				xbh = qbh;
+				q = next;
+			}
+			p->set_parent(nullptr);
+			p->left = p->right = nullptr;
+		}
+
+		// 按 key 切开子树 b：l 是小于 key 的部分，r 是大于 key 的部分
+		// 等于 key 的节点 unique 时单独放进 eq，multi 时留在 r 里
+		void split_tree_by_key(base_ptr b, const key_type& key, bool unique,
+			base_ptr& l, size_type& lbh, base_ptr& eq, base_ptr& r, size_type& rbh) noexcept
+		{
+			eq = nullptr;
+			base_ptr p = nullptr;
+			for (base_ptr x = b; x != nullptr; ) {
+				if (!mKeyComp(value_traits::get_key(x->get_node_ptr()->value), key)) {
+					p = x;
+					x = x->left;
+				}
+				else {
+					x = x->right;
+				}
+			}
+			if (p == nullptr) {
+				l = b;
+				lbh = black_height(b);
+				r = nullptr;
+				rbh = 0;
+				return;
+			}
+			split_tree(p, l, lbh, r, rbh);
+			if (unique && !mKeyComp(key, value_traits::get_key(p->get_node_ptr()->value))) {
+				eq = p;
+			}
+			else {
+				r = join_tree(nullptr, 0, p, r, rbh, rbh);
+			}
+		}
+
+		// 以 a 的根为界切开 b，左右两边各自递归，最后用 a 的根接起来
+		// prefer_b 为 true 时 key 相同留 b 的节点，dropped 记释放了几个重复节点
+		base_ptr union_tree(base_ptr a, size_type abh, base_ptr b, size_type bbh,
+			bool unique, bool prefer_b, size_type& bh, size_type& dropped)
+		{
+			if (a == nullptr) {
+				bh = bbh;
+				return b;
+			}
+			if (b == nullptr) {
+				bh = abh;
+				return a;
+			}
+			size_type albh = abh - (rb_tree_is_black(a) ? 1 : 0), arbh = albh;
+			base_ptr al = detach_tree(a->left, albh);
+			base_ptr ar = detach_tree(a->right, arbh);
+			base_ptr bl, eq, br;
+			size_type blbh, brbh, lbh, rbh;
+			split_tree_by_key(b, value_traits::get_key(a->get_node_ptr()->value), unique, bl, blbh, eq, br, brbh);
+			base_ptr k = a;
+			if (eq != nullptr) {
+				if (prefer_b) {
+					mystl::swap(k, eq);
+				}
+				destroy_node(eq->get_node_ptr());
+				++dropped;
+			}
+			base_ptr l = union_tree(al, albh, bl, blbh, unique, prefer_b, lbh, dropped);
+			base_ptr r = union_tree(ar, arbh, br, brbh, unique, prefer_b, rbh, dropped);
+			return join_tree(l, lbh, k, r, rbh, bh);
+		}
+
+		// 和 union_tree 一样按 a 的根切开 b，只有两边都有的 key 才留下，kept 记留下了几个
+		base_ptr intersect_tree(base_ptr a, size_type abh, base_ptr b, size_type bbh,
+			bool prefer_b, size_type& bh, size_type& kept)
+		{
+			if (a == nullptr || b == nullptr) {
+				erase_since(a);
+				erase_since(b);
+				bh = 0;
+				return nullptr;
+			}
+			size_type albh = abh - (rb_tree_is_black(a) ? 1 : 0), arbh = albh;
+			base_ptr al = detach_tree(a->left, albh);
+			base_ptr ar = detach_tree(a->right, arbh);
+			a->left = a->right = nullptr;
+			base_ptr bl, eq, br;
+			size_type blbh, brbh, lbh, rbh;
+			split_tree_by_key(b, value_traits::get_key(a->get_node_ptr()->value), true, bl, blbh, eq, br, brbh);
+			base_ptr l = intersect_tree(al, albh, bl, blbh, prefer_b, lbh, kept);
+			base_ptr r = intersect_tree(ar, arbh, br, brbh, prefer_b, rbh, kept);
+			if (eq == nullptr) {
+				destroy_node(a->get_node_ptr());
+				return join_tree(l, lbh, r, rbh, bh);
+			}
+			base_ptr k = a;
+			if (prefer_b) {
+				mystl::swap(k, eq);
+			}
+			destroy_node(eq->get_node_ptr());
+			++kept;
+			return join_tree(l, lbh, k, r, rbh, bh);
+		}
+
+		void union_with(rb_tree& other, bool unique)
+		{
+			if (this == &other || other.mNodeCount == 0) {
+				return;
+			}
+			if (mNodeCount == 0) {
+				swap(other);
+				return;
+			}
+			const size_type n = mNodeCount + other.mNodeCount;
+			const bool this_small = mNodeCount <= other.mNodeCount;
+			base_ptr a = this_small ? root() : other.root();
+			base_ptr b = this_small ? other.root() : root();
+			a->set_parent(nullptr);
+			b->set_parent(nullptr);
+			size_type dropped = 0, bh;
+			other.attach(nullptr, 0);
+			base_ptr t = union_tree(a, black_height(a), b, black_height(b), unique, !this_small, bh, dropped);
+			attach(t, n - dropped);
+		}
+
+		// p 前面的元素个数，OrderStat 时直接算排名
+		size_type count_before(base_ptr p) const noexcept
+		{
+			return count_before(p, std::integral_constant<bool, OrderStat>());
+		}
+
+		size_type count_before(base_ptr p, std::true_type) const noexcept
+		{
+			return index_of(const_iterator(p));
+		}
+
+		// 一个从头往 p 走，一个从 p 往尾走，谁先走到就知道 p 前面有几个
+		size_type count_before(base_ptr p, std::false_type) const noexcept
+		{
+			const_iterator f = begin(), b(p), e = end();
+			const_iterator target(p);
+			size_type n = 0;
+			for (;;) {
+				if (f == target) {
+					return n;
+				}
+				if (b == e) {
+					return mNodeCount - n;
+				}
+				++f;
+				++b;
+				++n;
+			}
 		}
 	};
 
 
-	template <class T, class Compare>
-	bool operator==(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+	template <class T, class Compare, bool OrderStat>
+	bool operator==(const rb_tree<T, Compare, OrderStat>& lhs, const rb_tree<T, Compare, OrderStat>& rhs)
 	{
 		return lhs.size() == rhs.size() && (mystl::equal(lhs.begin(), lhs.end(), rhs.begin()));
 	}
 
-	template <class T, class Compare>
-	bool operator!=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+	template <class T, class Compare, bool OrderStat>
+	bool operator!=(const rb_tree<T, Compare, OrderStat>& lhs, const rb_tree<T, Compare, OrderStat>& rhs)
 	{
 		return !(lhs == rhs);
 	}
 
-	template <class T, class Compare>
-	bool operator<(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+	template <class T, class Compare, bool OrderStat>
+	bool operator<(const rb_tree<T, Compare, OrderStat>& lhs, const rb_tree<T, Compare, OrderStat>& rhs)
 	{
 		return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 	}
 
-	template <class T, class Compare>
-	bool operator>(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+	template <class T, class Compare, bool OrderStat>
+	bool operator>(const rb_tree<T, Compare, OrderStat>& lhs, const rb_tree<T, Compare, OrderStat>& rhs)
 	{
 		return rhs < lhs;
 	}
 
-	template <class T, class Compare>
-	bool operator<=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+	template <class T, class Compare, bool OrderStat>
+	bool operator<=(const rb_tree<T, Compare, OrderStat>& lhs, const rb_tree<T, Compare, OrderStat>& rhs)
 	{
 		return !(lhs > rhs);
 	}
 
-	template <class T, class Compare>
-	bool operator>=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+	template <class T, class Compare, bool OrderStat>
+	bool operator>=(const rb_tree<T, Compare, OrderStat>& lhs, const rb_tree<T, Compare, OrderStat>& rhs)
 	{
 		return !(lhs < rhs);
 	}
 
-	template <class T, class Compare>
-	void swap(rb_tree<T, Compare>& lhs, rb_tree<T, Compare>& rhs) noexcept
+	template <class T, class Compare, bool OrderStat>
+	void swap(rb_tree<T, Compare, OrderStat>& lhs, rb_tree<T, Compare, OrderStat>& rhs) noexcept
 	{
 		lhs.swap(rhs);
 	}
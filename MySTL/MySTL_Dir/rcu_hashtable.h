@@ -0,0 +1,407 @@
+#ifndef MYSTL_RCU_HASHTABLE_H
+#define MYSTL_RCU_HASHTABLE_H
+
+#include <atomic>
+#include <mutex>
+
+#include "hashtable.h"
+#include "epoch.h"
+
+namespace mystl {
+
+	// 和 hashtable_node 一样的布局，只是 next 换成了原子指针
+	// 节点一旦发布出去 value 就不再修改，修改值是换一个新节点上去
+	template <class T>
+	struct rcu_hashtable_node
+	{
+		std::atomic<rcu_hashtable_node*> next;
+		T value;
+
+		template <class ...Args>
+		explicit rcu_hashtable_node(Args&& ...args)
+			: next(nullptr), value(mystl::forward<Args>(args)...) {}
+	};
+
+	// 读多写少的哈希表
+	// 读者不加锁，只是在 epoch 临界区里沿着原子指针往下读，不会被写者阻塞
+	// 写者按桶分段加锁 (桶下标 % lock_count)，同一段的写者互斥
+	// 摘下来的节点和旧的桶数组都交给 epoch_manager，等没有读者能看到时再释放
+	template <class T, class Hash, class KeyEqual>
+	class rcu_hashtable
+	{
+	public:
+
+		using value_traits	= ht_value_traits<T>;
+		using key_type		= typename value_traits::key_type;
+		using mapped_type	= typename value_traits::mapped_type;
+		using value_type	= typename value_traits::value_type;
+		using hasher		= Hash;
+		using key_equal		= KeyEqual;
+		using size_type		= size_t;
+
+		using node_type		= rcu_hashtable_node<T>;
+		using node_ptr		= rcu_hashtable_node<T>*;
+
+		static constexpr size_type lock_count = 64;
+
+	private:
+
+		struct bucket_array
+		{
+			size_type size;
+			std::atomic<node_ptr>* bucket;
+		};
+
+		using node_allocator = mystl::allocator<node_type>;
+		using slot_allocator = mystl::allocator<std::atomic<node_ptr>>;
+		using table_allocator = mystl::allocator<bucket_array>;
+
+		std::atomic<bucket_array*> m_Table;
+		std::atomic<size_type> m_Size;
+		float m_Mlf;
+		hasher m_Hash;
+		key_equal m_Equal;
+
+		std::mutex m_Locks[lock_count];
+		mutable epoch_manager m_Epoch;
+
+	public:
+
+		explicit rcu_hashtable(size_type bucket_cnt,
+			const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual())
+			: m_Table(create_table(ht_next_prime(bucket_cnt))), m_Size(0), m_Mlf(1.0f)
+			, m_Hash(hash), m_Equal(equal)
+		{
+		}
+
+		rcu_hashtable(const rcu_hashtable&) = delete;
+		rcu_hashtable& operator=(const rcu_hashtable&) = delete;
+
+		// 析构时不能再有并发的读写
+		~rcu_hashtable()
+		{
+			destroy_table(m_Table.load(std::memory_order_relaxed), true);
+		}
+
+		size_type size() const noexcept
+		{
+			return m_Size.load(std::memory_order_relaxed);
+		}
+
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		size_type bucket_count() const noexcept
+		{
+			return m_Table.load(std::memory_order_acquire)->size;
+		}
+
+		float max_load_factor() const noexcept
+		{
+			return m_Mlf;
+		}
+
+		// 读操作：找到 key 后在临界区里调用 fn(const value_type&)
+		// fn 里拿到的引用离开 find 之后就可能被释放，需要的话在 fn 里拷贝出来
+		template <class Fn>
+		bool find(const key_type& key, Fn fn) const
+		{
+			epoch_guard guard(m_Epoch);
+			const bucket_array* t = m_Table.load(std::memory_order_acquire);
+			node_ptr cur = t->bucket[hash(key, t->size)].load(std::memory_order_acquire);
+			for (; cur != nullptr; cur = cur->next.load(std::memory_order_acquire)) {
+				if (m_Equal(key, value_traits::get_key(cur->value))) {
+					fn(static_cast<const value_type&>(cur->value));
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool contains(const key_type& key) const
+		{
+			return find(key, [](const value_type&) {});
+		}
+
+		// key 已经存在时不插入，返回 false
+		template <class ...Args>
+		bool emplace_unique(Args&& ...args)
+		{
+			node_ptr np = create_node(mystl::forward<Args>(args)...);
+			bool inserted = false;
+			{
+				epoch_guard guard(m_Epoch);
+				std::unique_lock<std::mutex> lock;
+				bucket_array* t = lock_bucket(value_traits::get_key(np->value), lock);
+				std::atomic<node_ptr>& head = t->bucket[hash(value_traits::get_key(np->value), t->size)];
+				if (find_in_chain(head, value_traits::get_key(np->value)) == nullptr) {
+					np->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+					head.store(np, std::memory_order_release);
+					m_Size.fetch_add(1, std::memory_order_relaxed);
+					inserted = true;
+				}
+			}
+			if (!inserted) {
+				destroy_node(np);
+				return false;
+			}
+			rehash_if_need();
+			return true;
+		}
+
+		bool insert_unique(const value_type& value)
+		{
+			return emplace_unique(value);
+		}
+
+		// key 已经存在时用新节点替换旧节点，旧节点走 epoch 回收
+		// 返回 true 表示是新插入的
+		template <class ...Args>
+		bool emplace_or_assign(Args&& ...args)
+		{
+			node_ptr np = create_node(mystl::forward<Args>(args)...);
+			bool inserted = true;
+			{
+				epoch_guard guard(m_Epoch);
+				std::unique_lock<std::mutex> lock;
+				bucket_array* t = lock_bucket(value_traits::get_key(np->value), lock);
+				std::atomic<node_ptr>& head = t->bucket[hash(value_traits::get_key(np->value), t->size)];
+				std::atomic<node_ptr>* link = find_link(head, value_traits::get_key(np->value));
+				if (link != nullptr) {
+					node_ptr old = link->load(std::memory_order_relaxed);
+					np->next.store(old->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+					link->store(np, std::memory_order_release);
+					m_Epoch.retire(old, &rcu_hashtable::retire_node);
+					inserted = false;
+				}
+				else {
+					np->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+					head.store(np, std::memory_order_release);
+					m_Size.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+			if (inserted) {
+				rehash_if_need();
+			}
+			return inserted;
+		}
+
+		bool insert_or_assign(const value_type& value)
+		{
+			return emplace_or_assign(value);
+		}
+
+		size_type erase_unique(const key_type& key)
+		{
+			epoch_guard guard(m_Epoch);
+			std::unique_lock<std::mutex> lock;
+			bucket_array* t = lock_bucket(key, lock);
+			std::atomic<node_ptr>* link = find_link(t->bucket[hash(key, t->size)], key);
+			if (link == nullptr) {
+				return 0;
+			}
+			node_ptr old = link->load(std::memory_order_relaxed);
+			// 被摘下的节点 next 不变，正停在它上面的读者还能继续往后走
+			link->store(old->next.load(std::memory_order_relaxed), std::memory_order_release);
+			m_Size.fetch_sub(1, std::memory_order_relaxed);
+			m_Epoch.retire(old, &rcu_hashtable::retire_node);
+			return 1;
+		}
+
+		// 扩容时锁住所有分段，读者仍然在旧桶上读
+		// 旧节点可能正被读者访问，所以新桶里放的是拷贝出来的新节点，旧桶整体走 epoch 回收
+		void rehash(size_type cnt)
+		{
+			bucket_array* retired = nullptr;
+			lock_all();
+			try {
+				bucket_array* old = m_Table.load(std::memory_order_relaxed);
+				const size_type n = ht_next_prime(cnt);
+				if (n > old->size) {
+					bucket_array* t = create_table(n);
+					try {
+						for (size_type i = 0; i < old->size; ++i) {
+							node_ptr cur = old->bucket[i].load(std::memory_order_relaxed);
+							for (; cur != nullptr; cur = cur->next.load(std::memory_order_relaxed)) {
+								node_ptr np = create_node(cur->value);
+								std::atomic<node_ptr>& head = t->bucket[hash(value_traits::get_key(np->value), n)];
+								np->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+								head.store(np, std::memory_order_relaxed);
+							}
+						}
+					}
+					catch (...) {
+						destroy_table(t, true);
+						throw;
+					}
+					m_Table.store(t, std::memory_order_release);
+					retired = old;
+				}
+			}
+			catch (...) {
+				unlock_all();
+				throw;
+			}
+			unlock_all();
+			if (retired != nullptr) {
+				m_Epoch.retire(retired, &rcu_hashtable::retire_table);
+			}
+		}
+
+		void reserve(size_type count)
+		{
+			rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f));
+		}
+
+		// 主动回收一次，写得很少的时候可以在空闲时调用
+		void reclaim()
+		{
+			m_Epoch.reclaim();
+		}
+
+		hasher hash_fcn() const
+		{
+			return m_Hash;
+		}
+
+		key_equal key_eq() const
+		{
+			return m_Equal;
+		}
+
+	private:
+
+		size_type hash(const key_type& key, size_type n) const
+		{
+			return m_Hash(key) % n;
+		}
+
+		// 锁住 key 所在桶对应的分段，锁上之后桶数组就不会再被换掉
+		// 如果加锁前后桶数组变了，说明中间发生了扩容，换成新的桶重新加锁
+		bucket_array* lock_bucket(const key_type& key, std::unique_lock<std::mutex>& lock)
+		{
+			for (;;) {
+				bucket_array* t = m_Table.load(std::memory_order_acquire);
+				std::unique_lock<std::mutex> tmp(m_Locks[hash(key, t->size) % lock_count]);
+				if (m_Table.load(std::memory_order_acquire) == t) {
+					lock.swap(tmp);
+					return t;
+				}
+			}
+		}
+
+		void lock_all()
+		{
+			for (size_type i = 0; i < lock_count; ++i) {
+				m_Locks[i].lock();
+			}
+		}
+
+		void unlock_all()
+		{
+			for (size_type i = lock_count; i > 0; --i) {
+				m_Locks[i - 1].unlock();
+			}
+		}
+
+		void rehash_if_need()
+		{
+			const size_type n = m_Table.load(std::memory_order_acquire)->size;
+			const size_type cnt = size();
+			if (static_cast<float>(cnt) > static_cast<float>(n) * max_load_factor()) {
+				rehash(cnt + 1);
+			}
+		}
+
+		node_ptr find_in_chain(std::atomic<node_ptr>& head, const key_type& key) const
+		{
+			std::atomic<node_ptr>* link = find_link(head, key);
+			return link == nullptr ? nullptr : link->load(std::memory_order_relaxed);
+		}
+
+		// 返回指向 key 所在节点的那个指针 (桶头或前一个节点的 next)，写者持锁时调用
+		std::atomic<node_ptr>* find_link(std::atomic<node_ptr>& head, const key_type& key) const
+		{
+			std::atomic<node_ptr>* link = &head;
+			for (node_ptr cur = link->load(std::memory_order_relaxed); cur != nullptr;
+				cur = link->load(std::memory_order_relaxed)) {
+				if (m_Equal(key, value_traits::get_key(cur->value))) {
+					return link;
+				}
+				link = &cur->next;
+			}
+			return nullptr;
+		}
+
+		template <class ...Args>
+		static node_ptr create_node(Args&& ...args)
+		{
+			node_ptr tmp = node_allocator::allocate(1);
+			try {
+				node_allocator::construct(tmp, mystl::forward<Args>(args)...);
+			}
+			catch (...) {
+				node_allocator::deallocate(tmp);
+				throw;
+			}
+			return tmp;
+		}
+
+		static void destroy_node(node_ptr np)
+		{
+			node_allocator::destroy(np);
+			node_allocator::deallocate(np);
+		}
+
+		static bucket_array* create_table(size_type n)
+		{
+			bucket_array* t = table_allocator::allocate(1);
+			try {
+				t->size = n;
+				t->bucket = slot_allocator::allocate(n);
+			}
+			catch (...) {
+				table_allocator::deallocate(t);
+				throw;
+			}
+			for (size_type i = 0; i < n; ++i) {
+				::new ((void*)(t->bucket + i)) std::atomic<node_ptr>(nullptr);
+			}
+			return t;
+		}
+
+		// with_nodes 为 true 时连同链上的节点一起释放
+		static void destroy_table(bucket_array* t, bool with_nodes)
+		{
+			if (with_nodes) {
+				for (size_type i = 0; i < t->size; ++i) {
+					node_ptr cur = t->bucket[i].load(std::memory_order_relaxed);
+					while (cur != nullptr) {
+						node_ptr next = cur->next.load(std::memory_order_relaxed);
+						destroy_node(cur);
+						cur = next;
+					}
+				}
+			}
+			slot_allocator::deallocate(t->bucket, t->size);
+			table_allocator::deallocate(t);
+		}
+
+		static void retire_node(void* p)
+		{
+			destroy_node(static_cast<node_ptr>(p));
+		}
+
+		// 扩容后旧桶上的节点都已经拷贝到新桶，旧节点只会被旧桶引用，可以一起释放
+		static void retire_table(void* p)
+		{
+			destroy_table(static_cast<bucket_array*>(p), true);
+		}
+	};
+
+}
+
+#endif // !MYSTL_RCU_HASHTABLE_H
@@ -0,0 +1,108 @@
+#ifndef MYSTL_RW_LOCK_H
+#define MYSTL_RW_LOCK_H
+
+#include <atomic>
+#include <thread>
+
+namespace mystl {
+
+	// 读写自旋锁，读多写少的场景下读者之间互不阻塞
+	// m_State 为 -1 表示有写者持有，大于等于 0 表示当前读者的个数
+	// m_Waiting 记录正在等待的写者，有写者在等时新的读者让路，避免写者饿死
+	class rw_lock
+	{
+	private:
+
+		std::atomic<int> m_State;
+		std::atomic<int> m_Waiting;
+
+	public:
+
+		rw_lock() noexcept : m_State(0), m_Waiting(0) {}
+
+		rw_lock(const rw_lock&) = delete;
+		rw_lock& operator=(const rw_lock&) = delete;
+
+		void lock() noexcept
+		{
+			m_Waiting.fetch_add(1, std::memory_order_relaxed);
+			for (;;) {
+				int expected = 0;
+				if (m_State.compare_exchange_weak(expected, -1, std::memory_order_acquire,
+					std::memory_order_relaxed)) {
+					break;
+				}
+				std::this_thread::yield();
+			}
+			m_Waiting.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		bool try_lock() noexcept
+		{
+			int expected = 0;
+			return m_State.compare_exchange_strong(expected, -1, std::memory_order_acquire,
+				std::memory_order_relaxed);
+		}
+
+		void unlock() noexcept
+		{
+			m_State.store(0, std::memory_order_release);
+		}
+
+		void lock_shared() noexcept
+		{
+			for (;;) {
+				int state = m_State.load(std::memory_order_relaxed);
+				if (state >= 0 && m_Waiting.load(std::memory_order_relaxed) == 0 &&
+					m_State.compare_exchange_weak(state, state + 1, std::memory_order_acquire,
+						std::memory_order_relaxed)) {
+					break;
+				}
+				std::this_thread::yield();
+			}
+		}
+
+		void unlock_shared() noexcept
+		{
+			m_State.fetch_sub(1, std::memory_order_release);
+		}
+	};
+
+	// 和 std::lock_guard 一样的 RAII 写法，分别对应写锁和读锁
+	template <class Lock>
+	class unique_lock_guard
+	{
+	private:
+
+		Lock& m_Lock;
+
+	public:
+
+		explicit unique_lock_guard(Lock& lock) : m_Lock(lock) { m_Lock.lock(); }
+
+		~unique_lock_guard() { m_Lock.unlock(); }
+
+		unique_lock_guard(const unique_lock_guard&) = delete;
+		unique_lock_guard& operator=(const unique_lock_guard&) = delete;
+	};
+
+	template <class Lock>
+	class shared_lock_guard
+	{
+	private:
+
+		Lock& m_Lock;
+
+	public:
+
+		explicit shared_lock_guard(Lock& lock) : m_Lock(lock) { m_Lock.lock_shared(); }
+
+		~shared_lock_guard() { m_Lock.unlock_shared(); }
+
+		shared_lock_guard(const shared_lock_guard&) = delete;
+		shared_lock_guard& operator=(const shared_lock_guard&) = delete;
+	};
+
+}
+
+#endif // !MYSTL_RW_LOCK_H
@@ -1,7 +1,7 @@
 #ifndef MYSTL_SET_ALGO_H
 #define MYSTL_SET_ALGO_H
 
-// ͷļкҪ
+// 这个头文件所有函数要求有序
 
 #include "algobase.h"
 #include "iterator.h"
@@ -25,11 +25,9 @@ namespace mystl {
 				mystl::construct(&*begin, *first);
 			}
 		}
-		catch {
-			while (result != begin) {
-				mystl::destroy(&*result);
-				--begin;
-			}
+		catch (...) {
+			mystl::destroy(result, begin);
+			throw;
 		}
 		return begin;
 	}
@@ -38,7 +36,7 @@ namespace mystl {
 	ForwardIter uninitialized_copy(InputIter first, InputIter last, ForwardIter result)
 	{
 		return mystl::uncheck_uninit_copy(first, last, result,
-			std::is_trivially_copy_assignable<typename iterator_traits<ForwardIter>::value_type>{});
+			std::is_trivially_copy_assignable<typename mystl::iterator_traits<ForwardIter>::value_type>{});
 	}
 
 	template <class InputIter, class Size, class ForwardIter>
@@ -53,14 +51,12 @@ namespace mystl {
 		auto begin = result;
 		try {
 			for (; n > 0; n--, first++, begin++) {
-				mystl::construct(&*result, *first);
+				mystl::construct(&*begin, *first);
 			}
 		}
-		catch {
-			while (begin != result) {
-				mystl::destroy(&*begin);
-				--begin;
-			}
+		catch (...) {
+			mystl::destroy(result, begin);
+			throw;
 		}
 		return begin;
 	}
@@ -75,7 +71,8 @@ namespace mystl {
 	template <class InputIter, class T>
 	InputIter uncheck_uninit_fill(InputIter first, InputIter last, const T& value, std::true_type)
 	{
-		return mystl::fill(first, last, value);
+		mystl::fill(first, last, value);
+		return last;
 	}
 
 	template <class InputIter, class T>
@@ -87,11 +84,9 @@ namespace mystl {
 				mystl::construct(&*first, value);
 			}
 		}
-		catch {
-			while (result != first) {
-				mystl::destroy(&*first);
-				first--;
-			}
+		catch (...) {
+			mystl::destroy(result, first);
+			throw;
 		}
 		return first;
 	}
@@ -100,7 +95,7 @@ namespace mystl {
 	InputIter uninitialized_fill(InputIter first, InputIter last, const T& value)
 	{
 		return mystl::uncheck_uninit_fill(first, last, value,
-			std::is_trivially_copy_assignable<typename mystl::iterator_traits<T>::value_type>{});
+			std::is_trivially_copy_assignable<typename mystl::iterator_traits<InputIter>::value_type>{});
 	}
 
 
@@ -120,11 +115,9 @@ namespace mystl {
 				mystl::construct(&*first, value);
 			}
 		}
-		catch {
-			while (first != begin) {
-				mystl::destroy(&*first);
-				--first;
-			}
+		catch (...) {
+			mystl::destroy(begin, first);
+			throw;
 		}
 		return first;
 	}
@@ -139,64 +132,66 @@ namespace mystl {
 
 
 	template <class InputIter, class ForwardIter>
-	InputIter uncheck_uninit_move(InputIter first, InputIter last, ForwardIter result, std::true_type)
+	ForwardIter uncheck_uninit_move(InputIter first, InputIter last, ForwardIter result, std::true_type)
 	{
 		return mystl::move(first, last, result);
 	}
 
 
 	template <class InputIter, class ForwardIter>
-	InputIter uncheck_uninit_move(InputIter first, InputIter last, ForwardIter result, std::false_type)
+	ForwardIter uncheck_uninit_move(InputIter first, InputIter last, ForwardIter result, std::false_type)
 	{
-		auto begin = first;
+		auto begin = result;
 		try {
-			for (; first != last; first++) {
-				mystl::construct(&*result, mystl::move(*first));
+			for (; first != last; first++, begin++) {
+				mystl::construct(&*begin, mystl::move(*first));
 			}
 		}
-		catch {
-			mystl::destroy(begin, first);
+		catch (...) {
+			mystl::destroy(result, begin);
+			throw;
 		}
-		return first;
+		return begin;
 	}
 
 
 	template <class InputIter, class ForwardIter>
-	InputIter uninitialized_move(InputIter first, InputIter last, ForwardIter result)
+	ForwardIter uninitialized_move(InputIter first, InputIter last, ForwardIter result)
 	{
 		return mystl::uncheck_uninit_move(first, last, result,
-			std::is_trivially_move_assignable<typename mystl::iterator_traits<InputIter>::value_type> {});
+			std::is_trivially_move_assignable<typename mystl::iterator_traits<ForwardIter>::value_type> {});
 	}
 
 
 	template <class InputIter, class ForwardIter, class Size>
-	InputIter uncheck_uninit_move_n(InputIter first, Size n, ForwardIter result, std::true_type)
+	ForwardIter uncheck_uninit_move_n(InputIter first, Size n, ForwardIter result, std::true_type)
 	{
 		return mystl::move(first, first + n, result);
 	}
 
 
 	template <class InputIter, class ForwardIter, class Size>
-	InputIter uncheck_uninit_move_n(InputIter first, Size n, ForwardIter result, std::false_type)
+	ForwardIter uncheck_uninit_move_n(InputIter first, Size n, ForwardIter result, std::false_type)
 	{
-		auto begin = first;
+		auto begin = result;
 		try {
-			for (; n > 0; n--, first++) {
-				mystl::construct(&*result, mystl::move(*first));
+			for (; n > 0; n--, first++, begin++) {
+				mystl::construct(&*begin, mystl::move(*first));
 			}
 		}
-		catch {
-			mystl::destroy(begin, first);
+		catch (...) {
+			mystl::destroy(result, begin);
+			throw;
 		}
-		return first;
+		return begin;
 	}
 
 
 	template <class InputIter, class ForwardIter, class Size>
-	InputIter uninitialized_move_n(InputIter first, Size n, ForwardIter result)
+	ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result)
 	{
 		return uncheck_uninit_move_n(first, n, result,
-			std::is_trivially_move_assignable<typename mystl::iterator_traits<InputIter>::value_type>{});
+			std::is_trivially_move_assignable<typename mystl::iterator_traits<ForwardIter>::value_type>{});
 	}
 
 
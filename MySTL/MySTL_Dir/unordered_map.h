@@ -35,6 +35,7 @@ namespace mystl {
 		using const_iterator = typename base_type::const_iterator;
 		using local_iterator = typename base_type::local_iterator;
 		using const_local_iterator = typename base_type::const_local_iterator;
+		using node_type = typename base_type::node_handle_type;
 
 		allocator_type get_allocator() const { return ht.get_allocate(); }
 
@@ -53,11 +54,9 @@ namespace mystl {
 			const size_type n = 100,
 			const Hash& hash = Hash(),
 			const KeyEqual& key = KeyEqual())
-			: ht(mystl::max(n, mystl::distance(first, last)), hash, key)
+			: ht(mystl::max(n, static_cast<size_type>(mystl::distance(first, last))), hash, key)
 		{
-			for (auto iter = first; iter != last; iter++) {
-				ht.insert_unique_noresize(*iter);
-			}
+			ht.insert_unique(first, last);
 		}
 
 
@@ -67,9 +66,7 @@ namespace mystl {
 			const KeyEqual& key = KeyEqual())
 			: ht(mystl::max(n, static_cast<size_type>(ilist.size())), hash, key)
 		{
-			for (auto iter = ilist.begin(); iter != ilist.end(); iter++) {
-				ht.insert_unique_noresize(*iter);
-			}
+			ht.insert_unique(ilist.begin(), ilist.end());
 		}
 
 
@@ -100,9 +97,7 @@ namespace mystl {
 		{
 			ht.clear();
 			ht.reserve(ilist.size());
-			for (auto iter = ilist.begin(); iter != ilist.end(); iter++) {
-				ht.insert_unique_noresize(*iter);
-			}
+			ht.insert_unique(ilist.begin(), ilist.end());
 			return *this;
 		}
 
@@ -175,7 +170,27 @@ namespace mystl {
 			ht.insert_unique(first, last);
 		}
 
-		void swap(unordered_set& rhs)
+		pair<iterator, bool> insert(node_type&& nh)
+		{
+			return ht.insert_unique(mystl::move(nh));
+		}
+
+		node_type extract(const_iterator pos)
+		{
+			return ht.extract(pos);
+		}
+
+		node_type extract(const key_type& key)
+		{
+			return ht.extract(key);
+		}
+
+		void merge(unordered_map& other)
+		{
+			ht.merge_unique(other.ht);
+		}
+
+		void swap(unordered_map& rhs)
 		{
 			ht.swap(rhs.ht);
 		}
@@ -227,6 +242,14 @@ namespace mystl {
 			return ht.erase_unique(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type erase(const K& key)
+		{
+			return ht.erase_unique(key);
+		}
+
 		void clear()
 		{
 			ht.clear();
@@ -237,26 +260,84 @@ namespace mystl {
 			return ht.count(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type count(const K& key) const
+		{
+			return ht.count(key);
+		}
+
 		iterator find(const key_type& key)
 		{
 			return ht.find(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		iterator find(const K& key)
+		{
+			return ht.find(key);
+		}
+
 		const_iterator find(const key_type& key) const
 		{
 			return ht.find(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		const_iterator find(const K& key) const
+		{
+			return ht.find(key);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out)
+		{
+			return ht.find_batch(first, last, out);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			return ht.find_batch(first, last, out);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter count_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			return ht.count_batch(first, last, out);
+		}
+
 		pair<iterator, iterator> equal_range(const key_type& key)
 		{
 			return ht.equal_range_unique(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<iterator, iterator> equal_range(const K& key)
+		{
+			return ht.equal_range_unique(key);
+		}
+
 		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
 		{
 			return ht.equal_range_unique(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<const_iterator, const_iterator> equal_range(const K& key) const
+		{
+			return ht.equal_range_unique(key);
+		}
+
 		local_iterator begin(size_type n) noexcept
 		{
 			return ht.begin(n);
@@ -304,7 +385,7 @@ namespace mystl {
 
 		size_type bucket(const key_type& key) const
 		{
-			return hash(key);
+			return ht.bucket(key);
 		}
 
 		float load_factor() const noexcept
@@ -317,6 +398,11 @@ namespace mystl {
 			return ht.max_load_factor();
 		}
 
+		hashtable_stats stats() const noexcept
+		{
+			return ht.stats();
+		}
+
 		void reserve(size_type cnt)
 		{
 			ht.reserve(cnt);
@@ -327,6 +413,17 @@ namespace mystl {
 			ht.rehash(cnt);
 		}
 
+		void parallel_rehash(size_type cnt, size_type threads = 0)
+		{
+			ht.parallel_rehash(cnt, threads);
+		}
+
+		template <class RandomIter>
+		void parallel_build(RandomIter first, RandomIter last, size_type threads = 0)
+		{
+			ht.parallel_build_unique(first, last, threads);
+		}
+
 		key_equal key_eq() const
 		{
 			return ht.key_eq();
@@ -382,6 +479,7 @@ namespace mystl {
 		using const_iterator = typename base_type::const_iterator;
 		using local_iterator = typename base_type::local_iterator;
 		using const_local_iterator = typename base_type::const_local_iterator;
+		using node_type = typename base_type::node_handle_type;
 
 		allocator_type get_allocator() const { return ht.get_allocate(); }
 
@@ -400,11 +498,9 @@ namespace mystl {
 			const size_type n = 100,
 			const Hash& hash = Hash(),
 			const KeyEqual& key = KeyEqual())
-			: ht(mystl::max(n, mystl::distance(first, last)), hash, key)
+			: ht(mystl::max(n, static_cast<size_type>(mystl::distance(first, last))), hash, key)
 		{
-			for (auto iter = first; iter != last; iter++) {
-				ht.insert_multi_noresize(*iter);
-			}
+			ht.insert_multi(first, last);
 		}
 
 
@@ -414,9 +510,7 @@ namespace mystl {
 			const KeyEqual& key = KeyEqual())
 			: ht(mystl::max(n, static_cast<size_type>(ilist.size())), hash, key)
 		{
-			for (auto iter = ilist.begin(); iter != ilist.end(); iter++) {
-				ht.insert_multi_noresize(*iter);
-			}
+			ht.insert_multi(ilist.begin(), ilist.end());
 		}
 
 
@@ -447,9 +541,7 @@ namespace mystl {
 		{
 			ht.clear();
 			ht.reserve(ilist.size());
-			for (auto iter = ilist.begin(); iter != ilist.end(); iter++) {
-				ht.insert_multi_noresize(*iter);
-			}
+			ht.insert_multi(ilist.begin(), ilist.end());
 			return *this;
 		}
 
@@ -522,7 +614,27 @@ namespace mystl {
 			ht.insert_multi(first, last);
 		}
 
-		void swap(unordered_set& rhs)
+		iterator insert(node_type&& nh)
+		{
+			return ht.insert_multi(mystl::move(nh));
+		}
+
+		node_type extract(const_iterator pos)
+		{
+			return ht.extract(pos);
+		}
+
+		node_type extract(const key_type& key)
+		{
+			return ht.extract(key);
+		}
+
+		void merge(unordered_multimap& other)
+		{
+			ht.merge_multi(other.ht);
+		}
+
+		void swap(unordered_multimap& rhs)
 		{
 			ht.swap(rhs.ht);
 		}
@@ -574,6 +686,14 @@ namespace mystl {
 			return ht.erase_multi(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type erase(const K& key)
+		{
+			return ht.erase_multi(key);
+		}
+
 		void clear()
 		{
 			ht.clear();
@@ -584,26 +704,84 @@ namespace mystl {
 			return ht.count(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type count(const K& key) const
+		{
+			return ht.count(key);
+		}
+
 		iterator find(const key_type& key)
 		{
 			return ht.find(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		iterator find(const K& key)
+		{
+			return ht.find(key);
+		}
+
 		const_iterator find(const key_type& key) const
 		{
 			return ht.find(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		const_iterator find(const K& key) const
+		{
+			return ht.find(key);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out)
+		{
+			return ht.find_batch(first, last, out);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			return ht.find_batch(first, last, out);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter count_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			return ht.count_batch(first, last, out);
+		}
+
 		pair<iterator, iterator> equal_range(const key_type& key)
 		{
 			return ht.equal_range_multi(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<iterator, iterator> equal_range(const K& key)
+		{
+			return ht.equal_range_multi(key);
+		}
+
 		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
 		{
 			return ht.equal_range_multi(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<const_iterator, const_iterator> equal_range(const K& key) const
+		{
+			return ht.equal_range_multi(key);
+		}
+
 		local_iterator begin(size_type n) noexcept
 		{
 			return ht.begin(n);
@@ -651,7 +829,7 @@ namespace mystl {
 
 		size_type bucket(const key_type& key) const
 		{
-			return hash(key);
+			return ht.bucket(key);
 		}
 
 		float load_factor() const noexcept
@@ -664,6 +842,11 @@ namespace mystl {
 			return ht.max_load_factor();
 		}
 
+		hashtable_stats stats() const noexcept
+		{
+			return ht.stats();
+		}
+
 		void reserve(size_type cnt)
 		{
 			ht.reserve(cnt);
@@ -674,6 +857,17 @@ namespace mystl {
 			ht.rehash(cnt);
 		}
 
+		void parallel_rehash(size_type cnt, size_type threads = 0)
+		{
+			ht.parallel_rehash(cnt, threads);
+		}
+
+		template <class RandomIter>
+		void parallel_build(RandomIter first, RandomIter last, size_type threads = 0)
+		{
+			ht.parallel_build_multi(first, last, threads);
+		}
+
 		key_equal key_eq() const
 		{
 			return ht.key_eq();
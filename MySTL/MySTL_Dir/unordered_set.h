@@ -33,6 +33,7 @@ namespace mystl {
 		using const_iterator		= typename base_type::const_iterator;
 		using local_iterator		= typename base_type::local_iterator;
 		using const_local_iterator	= typename base_type::const_local_iterator;
+		using node_type				= typename base_type::node_handle_type;
 
 	public:
 
@@ -52,20 +53,18 @@ namespace mystl {
 			const size_type n = 100,
 			const Hash& hash = Hash(),
 			const KeyEqual& key = KeyEqual())
-			: ht(mystl::max(n, mystl::distance(first, last)), hash, key)
+			: ht(mystl::max(n, static_cast<size_type>(mystl::distance(first, last))), hash, key)
 		{
-
+			ht.insert_unique(first, last);
 		}
 
-		unordered_set(std::initializer_list<T> ilist,
+		unordered_set(std::initializer_list<value_type> ilist,
 			const size_type n = 100,
 			const Hash& hash = Hash(),
 			const KeyEqual& key = KeyEqual())
 			: ht(mystl::max(n, static_cast<size_type>(ilist.size())), hash, key)
 		{
-			for (auto iter = ilist.begin(); iter != ilist.end(); iter++) {
-				ht.insert_unique_noresize(*iter);
-			}
+			ht.insert_unique(ilist.begin(), ilist.end());
 		}
 
 		unordered_set(const unordered_set& other) : ht(other.ht)
@@ -90,13 +89,11 @@ namespace mystl {
 			return *this;
 		}
 
-		unordered_set& operator=(std::initializer_list<T> ilist)
+		unordered_set& operator=(std::initializer_list<value_type> ilist)
 		{
 			ht.clear();
 			ht.reserve(ilist.size());
-			for (auto iter = ilist.begin(); iter != ilist.end(); iter++) {
-				ht.insert_unique_noresize(*iter);
-			}
+			ht.insert_unique(ilist.begin(), ilist.end());
 			return *this;
 		}
 
@@ -170,6 +167,26 @@ namespace mystl {
 			ht.insert_unique(first, last);
 		}
 
+		pair<iterator, bool> insert(node_type&& nh)
+		{
+			return ht.insert_unique(mystl::move(nh));
+		}
+
+		node_type extract(const_iterator pos)
+		{
+			return ht.extract(pos);
+		}
+
+		node_type extract(const key_type& key)
+		{
+			return ht.extract(key);
+		}
+
+		void merge(unordered_set& other)
+		{
+			ht.merge_unique(other.ht);
+		}
+
 		void swap(unordered_set& rhs)
 		{
 			ht.swap(rhs.ht);
@@ -190,6 +207,14 @@ namespace mystl {
 			return ht.erase_unique(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type erase(const K& key)
+		{
+			return ht.erase_unique(key);
+		}
+
 		void clear()
 		{
 			ht.clear();
@@ -200,26 +225,84 @@ namespace mystl {
 			return ht.count(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type count(const K& key) const
+		{
+			return ht.count(key);
+		}
+
 		iterator find(const key_type& key)
 		{
 			return ht.find(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		iterator find(const K& key)
+		{
+			return ht.find(key);
+		}
+
 		const_iterator find(const key_type& key) const
 		{
 			return ht.find(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		const_iterator find(const K& key) const
+		{
+			return ht.find(key);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out)
+		{
+			return ht.find_batch(first, last, out);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			return ht.find_batch(first, last, out);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter count_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			return ht.count_batch(first, last, out);
+		}
+
 		pair<iterator, iterator> equal_range(const key_type& key)
 		{
 			return ht.equal_range_unique(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<iterator, iterator> equal_range(const K& key)
+		{
+			return ht.equal_range_unique(key);
+		}
+
 		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
 		{
 			return ht.equal_range_unique(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<const_iterator, const_iterator> equal_range(const K& key) const
+		{
+			return ht.equal_range_unique(key);
+		}
+
 		local_iterator begin(size_type n) noexcept
 		{
 			return ht.begin(n);
@@ -267,7 +350,7 @@ namespace mystl {
 
 		size_type bucket(const key_type& key) const
 		{
-			return hash(key);
+			return ht.bucket(key);
 		}
 
 		float load_factor() const noexcept
@@ -280,6 +363,11 @@ namespace mystl {
 			return ht.max_load_factor();
 		}
 
+		hashtable_stats stats() const noexcept
+		{
+			return ht.stats();
+		}
+
 		void reserve(size_type cnt)
 		{
 			ht.reserve(cnt);
@@ -290,6 +378,17 @@ namespace mystl {
 			ht.rehash(cnt);
 		}
 
+		void parallel_rehash(size_type cnt, size_type threads = 0)
+		{
+			ht.parallel_rehash(cnt, threads);
+		}
+
+		template <class RandomIter>
+		void parallel_build(RandomIter first, RandomIter last, size_type threads = 0)
+		{
+			ht.parallel_build_unique(first, last, threads);
+		}
+
 		key_equal key_eq() const
 		{
 			return ht.key_eq();
@@ -338,6 +437,7 @@ namespace mystl {
 		using const_iterator = typename base_type::const_iterator;
 		using local_iterator = typename base_type::local_iterator;
 		using const_local_iterator = typename base_type::const_local_iterator;
+		using node_type				= typename base_type::node_handle_type;
 
 	public:
 
@@ -357,22 +457,18 @@ namespace mystl {
 			const size_type n = 100,
 			const Hash& hash = Hash(),
 			const KeyEqual& key = KeyEqual())
-			: ht(mystl::max(n, mystl::distance(first, last)), hash, key)
+			: ht(mystl::max(n, static_cast<size_type>(mystl::distance(first, last))), hash, key)
 		{
-			for (auto iter = first; iter != last; iter++) {
-				ht.insert_unique_noresize(*iter);
-			}
+			ht.insert_multi(first, last);
 		}
 
-		unordered_multiset(std::initializer_list<T> ilist,
+		unordered_multiset(std::initializer_list<value_type> ilist,
 			const size_type n = 100,
 			const Hash& hash = Hash(),
 			const KeyEqual& key = KeyEqual())
 			: ht(mystl::max(n, static_cast<size_type>(ilist.size())), hash, key)
 		{
-			for (auto iter = ilist.begin(); iter != ilist.end(); iter++) {
-				ht.insert_unique_noresize(*iter);
-			}
+			ht.insert_multi(ilist.begin(), ilist.end());
 		}
 
 		unordered_multiset(const unordered_multiset& other) : ht(other.ht)
@@ -397,13 +493,11 @@ namespace mystl {
 			return *this;
 		}
 
-		unordered_multiset& operator=(std::initializer_list<T> ilist)
+		unordered_multiset& operator=(std::initializer_list<value_type> ilist)
 		{
 			ht.clear();
 			ht.reserve(ilist.size());
-			for (auto iter = ilist.begin(); iter != ilist.end(); iter++) {
-				ht.insert_unique_noresize(*iter);
-			}
+			ht.insert_multi(ilist.begin(), ilist.end());
 			return *this;
 		}
 
@@ -477,6 +571,26 @@ namespace mystl {
 			ht.insert_multi(first, last);
 		}
 
+		iterator insert(node_type&& nh)
+		{
+			return ht.insert_multi(mystl::move(nh));
+		}
+
+		node_type extract(const_iterator pos)
+		{
+			return ht.extract(pos);
+		}
+
+		node_type extract(const key_type& key)
+		{
+			return ht.extract(key);
+		}
+
+		void merge(unordered_multiset& other)
+		{
+			ht.merge_multi(other.ht);
+		}
+
 		void swap(unordered_multiset& rhs)
 		{
 			ht.swap(rhs.ht);
@@ -497,6 +611,14 @@ namespace mystl {
 			return ht.erase_multi(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type erase(const K& key)
+		{
+			return ht.erase_multi(key);
+		}
+
 		void clear()
 		{
 			ht.clear();
@@ -507,26 +629,84 @@ namespace mystl {
 			return ht.count(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		size_type count(const K& key) const
+		{
+			return ht.count(key);
+		}
+
 		iterator find(const key_type& key)
 		{
 			return ht.find(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		iterator find(const K& key)
+		{
+			return ht.find(key);
+		}
+
 		const_iterator find(const key_type& key) const
 		{
 			return ht.find(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		const_iterator find(const K& key) const
+		{
+			return ht.find(key);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out)
+		{
+			return ht.find_batch(first, last, out);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			return ht.find_batch(first, last, out);
+		}
+
+		template <class ForwardIter, class OutputIter>
+		OutputIter count_batch(ForwardIter first, ForwardIter last, OutputIter out) const
+		{
+			return ht.count_batch(first, last, out);
+		}
+
 		pair<iterator, iterator> equal_range(const key_type& key)
 		{
 			return ht.equal_range_unique(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<iterator, iterator> equal_range(const K& key)
+		{
+			return ht.equal_range_unique(key);
+		}
+
 		pair<const_iterator, const_iterator> equal_range(const key_type& key) const
 		{
 			return ht.equal_range_unique(key);
 		}
 
+		template <class K, class H = Hash, class E = KeyEqual,
+			typename std::enable_if<mystl::is_transparent<H>::value &&
+			mystl::is_transparent<E>::value, int>::type = 0>
+		pair<const_iterator, const_iterator> equal_range(const K& key) const
+		{
+			return ht.equal_range_unique(key);
+		}
+
 		local_iterator begin(size_type n) noexcept
 		{
 			return ht.begin(n);
@@ -574,7 +754,7 @@ namespace mystl {
 
 		size_type bucket(const key_type& key) const
 		{
-			return hash(key);
+			return ht.bucket(key);
 		}
 
 		float load_factor() const noexcept
@@ -587,6 +767,11 @@ namespace mystl {
 			return ht.max_load_factor();
 		}
 
+		hashtable_stats stats() const noexcept
+		{
+			return ht.stats();
+		}
+
 		void reserve(size_type cnt)
 		{
 			ht.reserve(cnt);
@@ -597,6 +782,17 @@ namespace mystl {
 			ht.rehash(cnt);
 		}
 
+		void parallel_rehash(size_type cnt, size_type threads = 0)
+		{
+			ht.parallel_rehash(cnt, threads);
+		}
+
+		template <class RandomIter>
+		void parallel_build(RandomIter first, RandomIter last, size_type threads = 0)
+		{
+			ht.parallel_build_multi(first, last, threads);
+		}
+
 		key_equal key_eq() const
 		{
 			return ht.key_eq();
@@ -4,37 +4,47 @@
 #include <cstddef>
 #include "type_traits.h"
 
+// 软件预取，提前把 addr 所在的 cache line 读进缓存，只是提示不会改变程序语义
+#if defined(__GNUC__) || defined(__clang__)
+#define MYSTL_PREFETCH(addr) __builtin_prefetch((const void*)(addr))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define MYSTL_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#define MYSTL_PREFETCH(addr) ((void)(addr))
+#endif
+
 namespace mystl {
 
-	// noexcept(true) ʾú쳣
-	// noexcept(false) ʾú쳣
-	// noexcept ൱ noexcept(true) ״Ļֱ̻ӽ쳣
-	// Ϊɴʾ״Ϣģnoexcept״
-	// Ϊ״룬ԼСļĴС
+	// noexcept(true) 表示该函数不会抛异常
+	// noexcept(false) 表示该函数可能抛异常
+	// noexcept 相当于 noexcept(true) 如果抛错的话进程会直接结束不会抛异常
+	// 因为本来编译器会生成代码来提示抛错信息的，但声明noexcept后编译器不会声明这个函数的抛错代码
+	// 因为不会生成这个函数的抛错代码，所以减小生成文件的大小
 
 
-	// ۵
-	// ֵֵβζֵãΪֵתֵ
-	// ֵֵβζֵãΪֵתֵ
+	// 根据引用折叠
+	// 传入参数是左值或左值引用形参都是左值引用，函数为左值引用转右值引用
+	// 传入参数是右值或右值引用形参都是右值引用，函数为右值引用转右值引用
 
-	// ֵôζŷԸֵٴʹ
+	// 如果传入左值，那么就意味着放弃对该左值再次使用
 	template <class T>
 	typename std::remove_reference<T>::type&& move(T&& arg) noexcept {
 		return static_cast<typename std::remove_reference<T>::type&&> (arg);
 	}
 
-	// ôת
-	//  T  Tp Ļ Tp&& ۵ Tp&
-	//  T  Tp& Ļ Tp& && ۵ Tp&
-	//  T  Tp&& Ļ Tp&& && ۵ Tp&&
-	//  static_cast<T&&> ۵
+	// 怎么理解完美转发？
+	// 如果 T 是类型 Tp 的话 Tp&& 会折叠成 Tp&
+	// 如果 T 是类型 Tp& 的话 Tp& && 会折叠成 Tp&
+	// 如果 T 是类型 Tp&& 的话 Tp&& && 会折叠成 Tp&&
+	// 在 static_cast<T&&> 里进行折叠
 	template <class T>
 	T&& forward(typename std::remove_reference<T>::type& arg) noexcept {
 		return static_cast<T&&> (arg);
 	}
 
-	// ΪʲôҪһstatic_assertأ
-	// Ϊ۵пѡģ
+	// 为什么这个函数需要加一个static_assert来弹错误呢？
+	// 因为根据引用折叠，编译器是有可能选到这个模板的
 	template <class T>
 	T&& forward(typename std::remove_reference<T>::type&& arg) noexcept {
 		static_assert(!std::is_lvalue_reference<T>::value, "bad forward");
@@ -43,7 +53,7 @@ namespace mystl {
 
 	template <class T>
 	void swap(T& lhs, T& rhs) {
-		// moveҪǴƶƶֵСɱ
+		// 这里用move函数主要是触发移动构造和移动赋值，减小成本
 		auto tmp(mystl::move(lhs));
 		lhs = mystl::move(rhs);
 		rhs = mystl::move(tmp);
@@ -52,7 +62,7 @@ namespace mystl {
 	template <class Iter,class iterator>
 	iterator swap_range(Iter begin, Iter end, iterator first) {
 		for (; begin != end; begin++, first++) {
-			swap(*begin, *first);
+			mystl::swap(*begin, *first);
 		}
 		return first;
 	}
@@ -75,18 +85,18 @@ namespace mystl {
 		second_type second;
 		
 
-		// ģ std::enable_if<bool, T>::type
-		// boolΪtrueԷT,Ϊfalse򲻴typeɱ״
+		// 模板类 std::enable_if<bool, T>::type
+		// 如果bool为true则可以返回类型T,为false则不存在type，由编译器抛错
 		 
-		// ģstd::is_constructible<T>::valueжһǷ߱캯߱valueΪtrue
+		// 模板类std::is_constructible<T>::value是判断一个类型是否具备构造函数，如果具备则value为true
 
-		// ģstd::is_convertible<T1,T2>::valueжT1ǷתΪT2valueΪtrue
+		// 模板类std::is_convertible<T1,T2>::value是判断T1是否可以转化为T2，如果可以则value为true
 
 
-		// ĬϹ
+		// 默认构造
 		template <class Other1 = first_type,class Other2 = second_type,
-		typename std::enable_if<std::is_constructible<Other1>::value &&
-			std::is_constructible<Other2>::value, void>::type>
+		typename std::enable_if<std::is_default_constructible<Other1>::value &&
+			std::is_default_constructible<Other2>::value, int>::type = 0>
 		constexpr pair()
 			: first(), second()
 		{
@@ -128,10 +138,10 @@ namespace mystl {
 			typename std::enable_if<
 			std::is_constructible<first_type, Other1>::value &&
 			std::is_constructible<second_type, Other2>::value &&
-			std::is_constructible<Other1&&, first_type>::value &&
-			std::is_constructible<Other2&&, second_type>::value, int>::type = 0>
+			std::is_convertible<Other1&&, first_type>::value &&
+			std::is_convertible<Other2&&, second_type>::value, int>::type = 0>
 		constexpr pair(Other1&& a,Other2&& b) : 
-			first(forward<Other1>(a)), second(forward<Other2>(b))
+			first(mystl::forward<Other1>(a)), second(mystl::forward<Other2>(b))
 		{
 
 		}
@@ -140,11 +150,11 @@ namespace mystl {
 			typename std::enable_if<
 			std::is_constructible<first_type, Other1>::value &&
 			std::is_constructible<second_type, Other2>::value && (
-				!std::is_constructible<Other1&&, first_type>::value ||
-				!std::is_constructible<Other2&&, second_type>::value
+				!std::is_convertible<Other1&&, first_type>::value ||
+				!std::is_convertible<Other2&&, second_type>::value
 				), int>::type = 0>
 		explicit constexpr pair(Other1&& a, Other2&& b) :
-			first(forward<Other1>(a)), second(forward<Other2>(b))
+			first(mystl::forward<Other1>(a)), second(mystl::forward<Other2>(b))
 		{
 
 		}
@@ -152,10 +162,10 @@ namespace mystl {
 
 		template <class Other1,class Other2,
 			typename std::enable_if<
-			std::is_constructible<const Other1&, first_type>::value &&
-			std::is_constructible<const Other2&, second_type>::value &&
+			std::is_constructible<first_type, const Other1&>::value &&
+			std::is_constructible<second_type, const Other2&>::value &&
 			std::is_convertible<const Other1&, first_type>::value &&
-			std::is_convertible<const Other2&, second_type>::value, void>::type = 0>
+			std::is_convertible<const Other2&, second_type>::value, int>::type = 0>
 		constexpr pair(const pair<Other1, Other2>& other) :
 			first(other.first), second(other.second)
 		{
@@ -165,11 +175,11 @@ namespace mystl {
 
 		template <class Other1, class Other2,
 			typename std::enable_if<
-			std::is_constructible<const Other1&, first_type>::value &&
-			std::is_constructible<const Other2&, second_type>::value &&
+			std::is_constructible<first_type, const Other1&>::value &&
+			std::is_constructible<second_type, const Other2&>::value &&
 			(!std::is_convertible<const Other1&, first_type>::value ||
 				!std::is_convertible<const Other2&, second_type>::value)
-			, void>::type = 0>
+			, int>::type = 0>
 		explicit constexpr pair(const pair<Other1, Other2>& other) :
 			first(other.first), second(other.second)
 		{
@@ -179,12 +189,12 @@ namespace mystl {
 
 		template <class Other1,class Other2,
 			typename std::enable_if<
-			std::is_constructible<Other1, first_type>::value &&
-			std::is_constructible<Other2, second_type>::value &&
+			std::is_constructible<first_type, Other1>::value &&
+			std::is_constructible<second_type, Other2>::value &&
 			std::is_convertible<Other1, first_type>::value &&
-			std::is_convertible<Other2, second_type>::value, void>::type = 0>
-		constexpr pair(const pair<Other1, Other2>&& other) :
-			first(forward(other.first)), second(forward(other.second))
+			std::is_convertible<Other2, second_type>::value, int>::type = 0>
+		constexpr pair(pair<Other1, Other2>&& other) :
+			first(mystl::forward<Other1>(other.first)), second(mystl::forward<Other2>(other.second))
 		{
 
 		}
@@ -192,12 +202,12 @@ namespace mystl {
 
 		template <class Other1, class Other2,
 			typename std::enable_if<
-			std::is_constructible<Other1, first_type>::value&&
-			std::is_constructible<Other2, second_type>::value&&
+			std::is_constructible<first_type, Other1>::value&&
+			std::is_constructible<second_type, Other2>::value&&
 			(!std::is_convertible<Other1, first_type>::value ||
-				!std::is_convertible<Other2, second_type>::value), void>::type = 0>
+				!std::is_convertible<Other2, second_type>::value), int>::type = 0>
 		explicit constexpr pair(pair<Other1, Other2>&& other) :
-			first(forward(other.first)), second(forward(other.second))
+			first(mystl::forward<Other1>(other.first)), second(mystl::forward<Other2>(other.second))
 		{
 
 		}
@@ -221,15 +231,15 @@ namespace mystl {
 
 
 		template <class Other1,class Other2> 
-		typename pair<Other1, Other2>& operator=(const pair<Other1, Other2>& rhs) {
-			first = mystl::forward<Other1>(rhs.first);
-			second = mystl::forward<Other2>(rhs.second);
+		pair& operator=(const pair<Other1, Other2>& rhs) {
+			first = rhs.first;
+			second = rhs.second;
 			return *this;
 		}
 
 
 		template <class Other1,class Other2>
-		typename pair<Other1, Other2>& operator=(pair<Other1, Other2>&& rhs) {
+		pair& operator=(pair<Other1, Other2>&& rhs) {
 			first = mystl::forward<Other1>(rhs.first);
 			second = mystl::forward<Other2>(rhs.second);
 			return *this;
@@ -239,8 +249,8 @@ namespace mystl {
 
 		void swap(pair& rhs) {
 			if (&rhs != this) {
-				swap(first, rhs.first);
-				swap(second, rhs.second);
+				mystl::swap(first, rhs.first);
+				mystl::swap(second, rhs.second);
 			}
 		}
 
@@ -283,7 +293,7 @@ namespace mystl {
 
 	template <class T1, class T2>
 	pair<T1, T2> make_pair(const T1& a, const T2& b) {
-		return pair<T1, T2>(mystl::forward(a), mystl::forward(b));
+		return pair<T1, T2>(a, b);
 	}
 
 }
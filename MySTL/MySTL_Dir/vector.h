@@ -13,17 +13,17 @@ namespace mystl {
 
 #ifdef max
 #pragma message("#undefing marco max")
-#undef
+#undef max
 #endif
 
 #ifdef min
 #pragma message("#undefing marco min")
-#undef
+#undef min
 #endif
 
 
-	// ӿڲʵҪ߼
-	// ýӿʵ־߼
+	// 对外接口不实现主要逻辑
+	// 内置接口来实现具体逻辑
 
 
 	template <class T>
@@ -47,7 +47,7 @@ namespace mystl {
 		typedef value_type* iterator;
 		typedef const value_type* const_iterator;
 		typedef mystl::reverse_iterator<iterator>	reverse_iterator;
-		typedef mystl::reverse_iterator<iterator>	const_reverse_iterator;
+		typedef mystl::reverse_iterator<const_iterator>	const_reverse_iterator;
 
 
 
@@ -97,7 +97,7 @@ namespace mystl {
 			rhs._cap = nullptr;
 		}
 
-		//Ϊʼб϶дģԿ϶Ậ̫Դÿ
+		//因为初始化列表肯定是手写的，所以肯定不会含有太多资源，采用拷贝
 
 		vector(std::initializer_list<value_type> rhs)
 		{
@@ -125,8 +125,8 @@ namespace mystl {
 					_end = _begin + len;
 				}
 				else {
-					mystl::copy(rhs.begin(), rhs.begin() + len, _begin);
-					mystl::uninitialized_copy(rhs.begin() + len, rhs.end(), _end);
+					mystl::copy(rhs.begin(), rhs.begin() + size(), _begin);
+					mystl::uninitialized_copy(rhs.begin() + size(), rhs.end(), _end);
 					_end = _begin + len;
 				}
 			}
@@ -135,6 +135,9 @@ namespace mystl {
 
 		vector& operator=(vector&& rhs) noexcept
 		{
+			if (this == &rhs) {
+				return *this;
+			}
 			destroy_and_recover(_begin, _end, capacity());
 			_begin = rhs._begin;
 			_end = rhs._end;
@@ -153,7 +156,7 @@ namespace mystl {
 
 
 	public:
-		// const 汾Ϊ const ׼
+		// const 版本是为了 const 变量准备的
 		iterator begin() noexcept
 		{
 			return _begin;
@@ -243,15 +246,21 @@ namespace mystl {
 					"n can not larger than max_size() in vector<T>::reserve(n)");
 				auto tmp = data_allocator::allocate(n);
 				auto len = size();
-				mystl::uninitialized_move(_begin, _end, tmp);
-				data_allocator::deallocate(_begin, _cap - _begin);
+				try {
+					mystl::uninitialized_move(_begin, _end, tmp);
+				}
+				catch (...) {
+					data_allocator::deallocate(tmp, n);
+					throw;
+				}
+				destroy_and_recover(_begin, _end, capacity());
 				_begin = tmp;
 				_end = _begin + len;
 				_cap = _begin + n;
 			}
 		}
 
-		// cap С size
+		// cap 缩小到 size
 		void shrink_to_fit()
 		{
 			if (_end < _cap) {
@@ -261,8 +270,8 @@ namespace mystl {
 
 
 	public:
-		//ýһֳ汾Ŀǹconst
-		//constֻܵconst
+		//这里用将一个函数分成两个版本的目的是供const变量调用
+		//const变量只能调用const函数
 
 		reference operator[](size_type n)
 		{
@@ -337,13 +346,13 @@ namespace mystl {
 			copy_assign(first, last, mystl::iterator_category(first));
 		}
 
-		void assign(std::initializer_list<value_type>& list)
+		void assign(std::initializer_list<value_type> list)
 		{
 			copy_assign(list.begin(), list.end(), forward_iterator_tag());
 		}
 
-		// const_iteratorҪΪƽ
-		// ʱıһ㶼һʱֵ
+		// 这里用const_iterator主要是因为平常调用这个
+		// 函数的时候传入的变量一般都是一个临时值
 		template <class... Args>
 		iterator emplace(const_iterator pos, Args&& ...args)
 		{
@@ -355,13 +364,15 @@ namespace mystl {
 				++_end;
 			}
 			else if (_end != _cap) {
+				// 参数可能引用着容器里的元素，先把新值构造出来再挪动
+				value_type value_copy(mystl::forward<Args>(args)...);
 				auto new_pos = _end;
-				// ﹹԭΪҪȹԺܽп
-				data_allocator::construct(mystl::address_of(*new_pos), *(_end - 1));
+				// 这里构造的原因是因为要先构造以后才能进行拷贝
+				data_allocator::construct(mystl::address_of(*new_pos), mystl::move(*(_end - 1)));
 				new_pos++;
-				mystl::copy_backward(xpos, (_end - 1), _end);
+				mystl::move_backward(xpos, (_end - 1), _end);
 				_end = new_pos;
-				*xpos = value_type(mystl::forward<Args>(args)...);
+				*xpos = mystl::move(value_copy);
 			}
 			else {
 				this->reallocate_emplace(xpos, mystl::forward<Args>(args)...);
@@ -404,22 +415,22 @@ namespace mystl {
 			iterator xpos = const_cast<iterator>(pos);
 			const size_type n = pos - _begin;
 			if (_cap != _end && xpos == _end) {
-				data_allocator::construct(mystl::address_of(*_end), mystl::forward<Args>(args)...);
+				data_allocator::construct(mystl::address_of(*_end), value);
 				++_end;
 			}
 			else if (_end != _cap) {
+				// 避免 value 引用的是容器里的元素，挪动以后值就变了
+				auto value_copy = value;
 				auto new_pos = _end;
-				// ﹹԭΪҪȹԺܽп
-				data_allocator::construct(mystl::address_of(*new_pos), *(_end - 1));
+				// 这里构造的原因是因为要先构造以后才能进行拷贝
+				data_allocator::construct(mystl::address_of(*new_pos), mystl::move(*(_end - 1)));
 				new_pos++;
-				// ΪƲı value
-				auto value_copy = value;
-				mystl::copy_backward(xpos, (_end - 1), _end);
+				mystl::move_backward(xpos, (_end - 1), _end);
 				_end = new_pos;
 				*xpos = mystl::move(value_copy);
 			}
 			else {
-				this->reallocate_emplace(xpos, mystl::forward<Args>(args)...);
+				this->reallocate_insert(xpos, value);
 			}
 			return begin() + n;
 		}
@@ -446,7 +457,7 @@ namespace mystl {
 		iterator erase(const_iterator pos)
 		{
 			MYSTL_DEBUG(begin() <= pos && pos < end());
-			// ֱӸֵҪΪ pos  const
+			// 不能直接赋值主要是因为 pos 是 const
 			iterator xpos = _begin + (pos - _begin);
 			mystl::move((xpos + 1), _end, xpos);
 			--_end;
@@ -460,6 +471,9 @@ namespace mystl {
 			MYSTL_DEBUG(begin() <= first && last <= end() && !(last < first));
 			const auto n = first - begin();
 			iterator r = begin() + n;
+			if (first == last) {
+				return r;
+			}
 			data_allocator::destroy(mystl::move(r + (last - first), _end, r), _end);
 			_end = _end - (last - first);
 			return begin() + n;
@@ -501,7 +515,7 @@ namespace mystl {
 
 	private:
 
-		//  16 ڴռ
+		// 申请 16 个内存空间的数组
 		void try_init() noexcept
 		{
 			try {
@@ -514,7 +528,7 @@ namespace mystl {
 			}
 		}
 
-		//  cap ռ䣬 size ˵
+		// 申请 cap 个空间，其中 size 个是用了的
 		void init_space(size_type size, size_type cap)
 		{
 			try {
@@ -548,22 +562,22 @@ namespace mystl {
 		{
 			MYSTL_DEBUG(begin() <= first && last <= end() && !(last < first));
 			data_allocator::destroy(first, last);
-			data_allocator::deallocate(_begin);
+			data_allocator::deallocate(first, n);
 			_begin = _end = _cap = nullptr;
 		}
 
-		// ÿʱ add_size λû 1.5 
+		// 每次扩充的时候添加 add_size 个位置或者扩充成 1.5 倍
 		size_type get_new_cap(size_type add_size)
 		{
 			const size_type old = capacity();
 			THROW_LENGTH_ERROR_IF(old + add_size > max_size(), "vector<T>'s size too big");
-			//  1.5 ̫ˣͲѡ
+			// 如果扩充成 1.5 倍太大了，就不选择这个方案了
 			if (old > max_size() - old / 2) {
 				return  old + add_size > max_size() - 16 ?
 					old + add_size : old + add_size + 16;
 			}
 			return (old == 0 
-				? mystl::max(add_size, static_cast<size_type>(0)) 
+				? mystl::max(add_size, static_cast<size_type>(16)) 
 				: mystl::max(old + old / 2, old + add_size));
 		}
 
@@ -578,7 +592,7 @@ namespace mystl {
 				_end = mystl::uninitialized_fill_n(end(), n - size(), value);
 			}
 			else {
-				erase(mystl::fill_n(first, n, value), end());
+				erase(mystl::fill_n(begin(), n, value), end());
 			}
 		}
 
@@ -589,10 +603,10 @@ namespace mystl {
 			for (; first != last && cur != end(); first++, cur++) {
 				*cur = *first;
 			}
-			if (cur == end()) {
-				insert(first, last, cur);
+			if (first != last) {
+				insert(end(), first, last);
 			}
-			if (first == last) {
+			else {
 				erase(cur, end());
 			}
 		}
@@ -614,8 +628,7 @@ namespace mystl {
 				auto mid = first;
 				mystl::advance(mid, size());
 				auto new_end = mystl::copy(first, mid, begin());
-				mystl::uninitialized_copy(mid, last, new_end);
-				_end = new_end;
+				_end = mystl::uninitialized_copy(mid, last, new_end);
 
 			}
 		}
@@ -625,14 +638,25 @@ namespace mystl {
 		{
 			const auto new_size = get_new_cap(1);
 			auto new_begin = data_allocator::allocate(new_size);
+			auto new_pos = new_begin + (pos - begin());
 			auto new_end = new_begin;
+			bool constructed = false;
+			bool moved_front = false;
 			try {
-				new_end = mystl::uninitialized_move(begin(), pos, new_begin);
-				data_allocator::construct(mystl::address_of(*pos), mystl::forward<Args>(args)...);
-				new_end++;
-				new_end = mystl::uninitialized_move(pos, end(), new_end);
+				// 新元素构造在新空间里，而且要先于搬动，参数可能引用着旧空间里的元素
+				data_allocator::construct(mystl::address_of(*new_pos), mystl::forward<Args>(args)...);
+				constructed = true;
+				mystl::uninitialized_move(begin(), pos, new_begin);
+				moved_front = true;
+				new_end = mystl::uninitialized_move(pos, end(), new_pos + 1);
 			}
 			catch (...) {
+				if (moved_front) {
+					data_allocator::destroy(new_begin, new_pos);
+				}
+				if (constructed) {
+					data_allocator::destroy(new_pos);
+				}
 				data_allocator::deallocate(new_begin, new_size);
 				throw;
 			}
@@ -646,14 +670,25 @@ namespace mystl {
 		{
 			const auto new_size = get_new_cap(1);
 			auto new_begin = data_allocator::allocate(new_size);
+			auto new_pos = new_begin + (pos - begin());
 			auto new_end = new_begin;
+			bool constructed = false;
+			bool moved_front = false;
 			try {
-				new_end = mystl::uninitialized_move(begin(), pos, new_begin);
-				data_allocator::construct(mystl::address_of(*pos), value);
-				new_end++;
-				new_end = mystl::uninitialized_move(pos, end(), new_end);
+				// 新元素构造在新空间里，而且要先于搬动，参数可能引用着旧空间里的元素
+				data_allocator::construct(mystl::address_of(*new_pos), value);
+				constructed = true;
+				mystl::uninitialized_move(begin(), pos, new_begin);
+				moved_front = true;
+				new_end = mystl::uninitialized_move(pos, end(), new_pos + 1);
 			}
 			catch (...) {
+				if (moved_front) {
+					data_allocator::destroy(new_begin, new_pos);
+				}
+				if (constructed) {
+					data_allocator::destroy(new_pos);
+				}
 				data_allocator::deallocate(new_begin, new_size);
 				throw;
 			}
@@ -668,32 +703,34 @@ namespace mystl {
 			if (n == 0) {
 				return pos;
 			}
-			if ((capacity() - end()) >= n) {
-				const auto len = end() - pos;
+			const size_type xpos = pos - begin();
+			// 避免 value 引用的是容器里的元素
+			const value_type value_copy = value;
+			if (static_cast<size_type>(_cap - _end) >= n) {
+				const size_type len = end() - pos;
 				auto old_end = end();
 				if (len > n) {
-					mystl::uninitialized_copy(end() - n, end(), end());
-					_end += n;
+					_end = mystl::uninitialized_move(end() - n, end(), end());
 					mystl::move_backward(pos, old_end - n, old_end);
-					mystl::fill_n(pos, n, value);
+					mystl::fill_n(pos, n, value_copy);
 				}
 				else {
-					_end = mystl::uninitialized_fill_n(end(), n, value);
+					_end = mystl::uninitialized_fill_n(end(), n - len, value_copy);
 					_end = mystl::uninitialized_move(pos, old_end, end());
-					mystl::fill_n(pos, n, value);
+					mystl::fill_n(pos, len, value_copy);
 				}
 			}
 			else {
 				const auto new_size = get_new_cap(n);
 				auto new_begin = data_allocator::allocate(new_size);
 				auto new_end = new_begin;
-				const auto len = pos - begin();
 				try {
 					new_end = mystl::uninitialized_move(begin(), pos, new_begin);
-					new_end = mystl::uninitialized_fill_n(new_begin + len, n, value);
-					new_end = mystl::uninitialized_move(pos, end(), new_begin + len + n);
+					new_end = mystl::uninitialized_fill_n(new_end, n, value_copy);
+					new_end = mystl::uninitialized_move(pos, end(), new_end);
 				}
 				catch (...) {
+					data_allocator::destroy(new_begin, new_end);
 					data_allocator::deallocate(new_begin, new_size);
 					new_begin = new_end = nullptr;
 					throw;
@@ -704,27 +741,30 @@ namespace mystl {
 				_cap = _begin + new_size;
 				new_begin = new_end = nullptr;
 			}
+			return begin() + xpos;
 		}
 
 		template <class Iter>
 		void copy_insert(iterator pos, Iter first, Iter last)
 		{
-			const auto n = distance(first, last);
+			const size_type n = mystl::distance(first, last);
 			if (n == 0) {
-				return pos;
+				return;
 			}
-			if ((capacity() - end()) >= n) {
-				const auto len = end() - pos;
+			if (static_cast<size_type>(_cap - _end) >= n) {
+				const size_type len = end() - pos;
 				auto old_end = end();
 				if (len > n) {
-					_end = mystl::uninitialized_copy(end() - n, end(), end());
+					_end = mystl::uninitialized_move(end() - n, end(), end());
 					mystl::move_backward(pos, old_end - n, old_end);
-					mystl::uninitialized_copy(first, last, pos);
+					mystl::copy(first, last, pos);
 				}
 				else {
-					_end = mystl::uninitialized_fill_n(end(), n, value);
+					auto mid = first;
+					mystl::advance(mid, len);
+					_end = mystl::uninitialized_copy(mid, last, end());
 					_end = mystl::uninitialized_move(pos, old_end, end());
-
+					mystl::copy(first, mid, pos);
 				}
 			}
 			else {
@@ -734,9 +774,10 @@ namespace mystl {
 				try {
 					new_end = mystl::uninitialized_move(begin(), pos, new_begin);
 					new_end = mystl::uninitialized_copy(first, last, new_end);
-					new_end = mystl::uninitialized_move(pos, end(), new_begin);
+					new_end = mystl::uninitialized_move(pos, end(), new_end);
 				}
 				catch (...) {
+					data_allocator::destroy(new_begin, new_end);
 					data_allocator::deallocate(new_begin, new_size);
 					new_begin = new_end = nullptr;
 					throw;
@@ -751,7 +792,7 @@ namespace mystl {
 
 		void reinsert(size_type n)
 		{
-			const auto len = get_new_cap(n);
+			const auto len = mystl::max(n, static_cast<size_type>(1));
 			auto new_begin = data_allocator::allocate(len);
 			auto new_end = new_begin;
 			try {
@@ -762,7 +803,7 @@ namespace mystl {
 				new_begin = new_end = nullptr;
 				throw;
 			}
-			data_allocator::deallocate(begin(), capacity());
+			destroy_and_recover(begin(), end(), capacity());
 			_begin = new_begin;
 			_end = new_end;
 			_cap = _begin + len;
@@ -811,7 +852,7 @@ namespace mystl {
 	}
 
 	template <class T>
-	bool swap(vector<T>& lhs, vector<T>& rhs)
+	void swap(vector<T>& lhs, vector<T>& rhs)
 	{
 		lhs.swap(rhs);
 	}
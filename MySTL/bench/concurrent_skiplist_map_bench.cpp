@@ -0,0 +1,165 @@
+// concurrent_skiplist_map 的扩展性测试
+// 1 到全部硬件线程，每个线程按比例随机做查找、插入、删除，统计所有线程的总吞吐
+// 读多写少 (90/5/5) 和写多 (50/25/25) 两种负载，同样的负载再跑一遍读写锁保护的 rb_tree 做对比
+// 用法: concurrent_skiplist_map_bench [每轮毫秒数，默认 500] [最多线程数，默认全部硬件线程]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "concurrent_skiplist_map.h"
+#include "rb_tree.h"
+#include "rw_lock.h"
+
+namespace {
+
+	const int key_count = 1 << 16;
+
+	struct skiplist_adapter
+	{
+		mystl::concurrent_skiplist_map<int, int> map;
+
+		bool find(int key, int& out)
+		{
+			return map.find(key, [&out](const mystl::pair<const int, int>& v) { out = v.second; });
+		}
+
+		void insert(int key, int value)
+		{
+			map.emplace(key, value);
+		}
+
+		void erase(int key)
+		{
+			map.erase(key);
+		}
+	};
+
+	struct locked_adapter
+	{
+		mystl::rb_tree<mystl::pair<const int, int>, mystl::less<int>> tree;
+		mystl::rw_lock lock;
+
+		bool find(int key, int& out)
+		{
+			lock.lock_shared();
+			auto it = tree.find(key);
+			const bool found = it != tree.end();
+			if (found) {
+				out = it->second;
+			}
+			lock.unlock_shared();
+			return found;
+		}
+
+		void insert(int key, int value)
+		{
+			lock.lock();
+			tree.emplace_unique(key, value);
+			lock.unlock();
+		}
+
+		void erase(int key)
+		{
+			lock.lock();
+			tree.erase_unique(key);
+			lock.unlock();
+		}
+	};
+
+	// 百分比：剩下的是删除
+	struct workload
+	{
+		const char* name;
+		unsigned find_pct;
+		unsigned insert_pct;
+	};
+
+	template <class Map>
+	double run(Map& m, const workload& w, int threads, int millis)
+	{
+		std::atomic<bool> stop(false);
+		std::atomic<long long> ops(0);
+		std::vector<std::thread> workers;
+		for (int t = 0; t < threads; t++) {
+			workers.emplace_back([&, t]() {
+				std::mt19937 rng(100 + t);
+				long long n = 0;
+				long long hit = 0;
+				int out = 0;
+				while (!stop.load(std::memory_order_relaxed)) {
+					for (int i = 0; i < 256; i++) {
+						const unsigned r = rng();
+						const int key = static_cast<int>((r >> 8) % key_count);
+						const unsigned op = r % 100;
+						if (op < w.find_pct) {
+							hit += m.find(key, out);
+						}
+						else if (op < w.find_pct + w.insert_pct) {
+							m.insert(key, i);
+						}
+						else {
+							m.erase(key);
+						}
+					}
+					n += 256;
+				}
+				ops.fetch_add(n);
+				if (hit < 0) {
+					std::printf("%d\n", out);
+				}
+			});
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+		stop.store(true);
+		for (auto& w : workers) {
+			w.join();
+		}
+		const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return ops.load() / secs;
+	}
+
+	template <class Map>
+	void bench(const char* name, const workload& w, const std::vector<int>& thread_counts, int millis)
+	{
+		for (int threads : thread_counts) {
+			Map m;
+			// 先填一半，插入和删除大致平衡，大小保持稳定
+			for (int k = 0; k < key_count; k += 2) {
+				m.insert(k, k);
+			}
+			const double res = run(m, w, threads, millis);
+			std::printf("%-24s %-12s threads=%-3d %8.2f M ops/s (%6.2f M/s per thread)\n",
+				name, w.name, threads, res / 1e6, res / 1e6 / threads);
+		}
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	const int millis = argc > 1 ? std::atoi(argv[1]) : 500;
+	const int cores = static_cast<int>(std::thread::hardware_concurrency());
+	const int max_threads = argc > 2 ? std::atoi(argv[2]) : (cores > 0 ? cores : 1);
+	std::printf("hardware threads: %d\n", cores);
+
+	// 1, 2, 4, ... 一直到 max_threads
+	std::vector<int> thread_counts;
+	for (int t = 1; t < max_threads; t *= 2) {
+		thread_counts.push_back(t);
+	}
+	thread_counts.push_back(max_threads);
+
+	const workload loads[] = { { "read-heavy", 90, 5 }, { "write-heavy", 50, 25 } };
+	for (const workload& w : loads) {
+		bench<skiplist_adapter>("concurrent_skiplist_map", w, thread_counts, millis);
+		bench<locked_adapter>("rb_tree + rw_lock", w, thread_counts, millis);
+	}
+	return 0;
+}
@@ -0,0 +1,115 @@
+// concurrent_unordered_map 的分片扩展性测试
+// 分片数从 2 到 256，线程数从 1 到全部硬件线程，每个线程按比例随机做查找、覆盖、删除，统计总吞吐
+// 读多写少 (90/5/5) 和写多 (50/25/25) 两种负载；分片太少时写锁互相等待，分片多了吞吐应该随线程数上升
+// 用法: concurrent_unordered_map_bench [每轮毫秒数，默认 300] [最多线程数，默认全部硬件线程]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "concurrent_unordered_map.h"
+
+namespace {
+
+	const int key_count = 1 << 16;
+
+	// 百分比：剩下的是删除
+	struct workload
+	{
+		const char* name;
+		unsigned find_pct;
+		unsigned assign_pct;
+	};
+
+	template <class Map>
+	double run(Map& m, const workload& w, int threads, int millis)
+	{
+		std::atomic<bool> stop(false);
+		std::atomic<long long> ops(0);
+		std::vector<std::thread> workers;
+		for (int t = 0; t < threads; t++) {
+			workers.emplace_back([&, t]() {
+				std::mt19937 rng(100 + t);
+				long long n = 0;
+				long long hit = 0;
+				int out = 0;
+				while (!stop.load(std::memory_order_relaxed)) {
+					for (int i = 0; i < 256; i++) {
+						const unsigned r = rng();
+						const int key = static_cast<int>((r >> 8) % key_count);
+						const unsigned op = r % 100;
+						if (op < w.find_pct) {
+							hit += m.find(key, out);
+						}
+						else if (op < w.find_pct + w.assign_pct) {
+							m.insert_or_assign(key, i);
+						}
+						else {
+							m.erase(key);
+						}
+					}
+					n += 256;
+				}
+				ops.fetch_add(n);
+				if (hit < 0) {
+					std::printf("%d\n", out);
+				}
+			});
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+		stop.store(true);
+		for (auto& w : workers) {
+			w.join();
+		}
+		const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return ops.load() / secs;
+	}
+
+	template <size_t ShardBits>
+	void bench(const workload& w, const std::vector<int>& thread_counts, int millis)
+	{
+		using map_type = mystl::concurrent_unordered_map<int, int, mystl::hash<int>, mystl::equal_to<int>, ShardBits>;
+		for (int threads : thread_counts) {
+			map_type m(2 * key_count);
+			// 先填一半，覆盖和删除大致平衡，大小保持稳定
+			for (int k = 0; k < key_count; k += 2) {
+				m.insert_or_assign(k, k);
+			}
+			const double res = run(m, w, threads, millis);
+			std::printf("%-12s shards=%-4zu threads=%-3d %8.2f M ops/s (%6.2f M/s per thread)\n",
+				w.name, static_cast<size_t>(map_type::shard_count), threads, res / 1e6, res / 1e6 / threads);
+		}
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	const int millis = argc > 1 ? std::atoi(argv[1]) : 300;
+	const int cores = static_cast<int>(std::thread::hardware_concurrency());
+	const int max_threads = argc > 2 ? std::atoi(argv[2]) : (cores > 0 ? cores : 1);
+	std::printf("hardware threads: %d\n", cores);
+
+	// 1, 2, 4, ... 一直到 max_threads
+	std::vector<int> thread_counts;
+	for (int t = 1; t < max_threads; t *= 2) {
+		thread_counts.push_back(t);
+	}
+	thread_counts.push_back(max_threads);
+
+	const workload loads[] = { { "read-heavy", 90, 5 }, { "write-heavy", 50, 25 } };
+	for (const workload& w : loads) {
+		bench<1>(w, thread_counts, millis);
+		bench<2>(w, thread_counts, millis);
+		bench<4>(w, thread_counts, millis);
+		bench<6>(w, thread_counts, millis);
+		bench<8>(w, thread_counts, millis);
+	}
+	return 0;
+}
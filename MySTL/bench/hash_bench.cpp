@@ -0,0 +1,126 @@
+// functional.h 里 hash 的性能和分布测试
+// 吞吐：不同长度的字节串，hash_bytes 对比原来逐字节的 FNV-1a
+// 分布：连续整数、按 8/64/4096 步长的整数 (模拟指针和对齐的 id)、"key" + 数字的字符串
+//       分别放进 2 的幂和素数个桶里，看空桶数、最长链和卡方值 (均匀分布时接近桶数)
+// 用法: hash_bench [每种长度处理的总字节数 MiB，默认 256]
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "functional.h"
+
+namespace {
+
+	std::uint64_t fnv1a(const void* key, size_t len)
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(key);
+		std::uint64_t h = 14695981039346656037ull;
+		for (size_t i = 0; i < len; i++) {
+			h ^= p[i];
+			h *= 1099511628211ull;
+		}
+		return h;
+	}
+
+	template <class Fn>
+	double bytes_per_sec(Fn fn, const std::vector<unsigned char>& buf, size_t len, size_t total)
+	{
+		const size_t rounds = total / len + 1;
+		std::uint64_t sink = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t r = 0; r < rounds; r++) {
+			// 每轮换一个起点，避免编译器把整个循环当成常量算掉
+			sink += fn(buf.data() + (r & 63), len);
+		}
+		const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (sink == 42) {
+			std::printf("\n");
+		}
+		return static_cast<double>(rounds) * len / secs;
+	}
+
+	void bench_throughput(size_t total)
+	{
+		const size_t lens[] = { 4, 8, 16, 32, 64, 256, 1024, 4096, 1 << 20 };
+		std::vector<unsigned char> buf((1 << 20) + 64);
+		for (size_t i = 0; i < buf.size(); i++) {
+			buf[i] = static_cast<unsigned char>(i * 131 + 7);
+		}
+		std::printf("%10s %14s %14s\n", "bytes", "hash_bytes", "fnv1a");
+		for (size_t len : lens) {
+			const double a = bytes_per_sec([](const void* p, size_t n) { return mystl::hash_bytes(p, n); },
+				buf, len, total);
+			const double b = bytes_per_sec(fnv1a, buf, len, total);
+			std::printf("%10zu %11.2f GB/s %11.2f GB/s\n", len, a / 1e9, b / 1e9);
+		}
+	}
+
+	void report(const char* name, const std::vector<size_t>& hashes, size_t buckets)
+	{
+		std::vector<size_t> count(buckets, 0);
+		for (size_t h : hashes) {
+			count[h % buckets]++;
+		}
+		const double expect = static_cast<double>(hashes.size()) / buckets;
+		size_t empty = 0;
+		size_t longest = 0;
+		double chi = 0;
+		for (size_t c : count) {
+			empty += c == 0;
+			longest = c > longest ? c : longest;
+			chi += (c - expect) * (c - expect) / expect;
+		}
+		// 随机放置时空桶的期望个数
+		const double empty_expect = buckets * std::exp(-expect);
+		std::printf("%-24s buckets=%-7zu empty %7zu (random %9.1f)  longest %4zu  chi2 %10.1f\n",
+			name, buckets, empty, empty_expect, longest, chi);
+	}
+
+	template <class Key, class Gen>
+	void bench_distribution(const char* name, size_t n, Gen gen)
+	{
+		mystl::hash<Key> hasher;
+		std::vector<size_t> hashes;
+		hashes.reserve(n);
+		for (size_t i = 0; i < n; i++) {
+			hashes.push_back(hasher(gen(i)));
+		}
+		report(name, hashes, 1 << 16);
+		report(name, hashes, 65521);
+	}
+
+	struct string_hash
+	{
+		size_t operator()(const std::string& s) const
+		{
+			return mystl::bitwise_hash(reinterpret_cast<const unsigned char*>(s.data()), s.size());
+		}
+	};
+
+}
+
+namespace mystl {
+	template <>
+	struct hash<std::string> : string_hash {};
+}
+
+int main(int argc, char** argv)
+{
+	const size_t mib = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 256;
+	bench_throughput(mib << 20);
+
+	const size_t n = 1 << 18;
+	std::printf("\n%zu keys\n", n);
+	bench_distribution<std::uint64_t>("sequential", n, [](size_t i) { return static_cast<std::uint64_t>(i); });
+	bench_distribution<std::uint64_t>("stride 8", n, [](size_t i) { return static_cast<std::uint64_t>(i) * 8; });
+	bench_distribution<std::uint64_t>("stride 64", n, [](size_t i) { return static_cast<std::uint64_t>(i) * 64; });
+	bench_distribution<std::uint64_t>("stride 4096", n, [](size_t i) { return static_cast<std::uint64_t>(i) * 4096; });
+	bench_distribution<std::uint64_t>("high bits only", n, [](size_t i) { return static_cast<std::uint64_t>(i) << 40; });
+	bench_distribution<std::string>("\"key\" + i", n, [](size_t i) { return "key" + std::to_string(i); });
+	return 0;
+}
@@ -0,0 +1,89 @@
+// hashtable 并行构建和并行 rehash 的扩展性测试
+// 1 到全部硬件线程，分别计时 parallel_build_unique (一半 key 重复)、parallel_build_multi 和 parallel_rehash，
+// 1 个线程时走的就是串行的 bulk_insert，可以直接看出加速比
+// 用法: parallel_build_bench [元素个数，默认 2^21] [最多线程数，默认全部硬件线程]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "hashtable.h"
+#include "functional.h"
+
+namespace {
+
+	using table = mystl::hashtable<mystl::pair<const int, int>, mystl::hash<int>, mystl::equal_to<int>>;
+
+	template <class F>
+	double time_ms(F f)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// 跑 3 次取最快的一次，减少第一次缺页之类的干扰
+	template <class F>
+	double best_of(F f)
+	{
+		double best = 0;
+		for (int i = 0; i < 3; i++) {
+			const double t = f();
+			best = i == 0 || t < best ? t : best;
+		}
+		return best;
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : (static_cast<size_t>(1) << 21);
+	const int cores = static_cast<int>(std::thread::hardware_concurrency());
+	const int max_threads = argc > 2 ? std::atoi(argv[2]) : (cores > 0 ? cores : 1);
+	std::printf("hardware threads: %d, elements: %zu\n", cores, n);
+
+	std::mt19937 rng(1);
+	std::vector<mystl::pair<int, int>> items(n);
+	for (size_t i = 0; i < n; i++) {
+		items[i] = mystl::pair<int, int>(static_cast<int>(rng() % (n / 2)), static_cast<int>(i));
+	}
+
+	// 1, 2, 4, ... 一直到 max_threads
+	std::vector<int> thread_counts;
+	for (int t = 1; t < max_threads; t *= 2) {
+		thread_counts.push_back(t);
+	}
+	thread_counts.push_back(max_threads);
+
+	double base_unique = 0;
+	double base_multi = 0;
+	double base_rehash = 0;
+	for (int threads : thread_counts) {
+		const double unique_ms = best_of([&]() {
+			table t(16);
+			return time_ms([&]() { t.parallel_build_unique(items.data(), items.data() + n, threads); });
+		});
+		const double multi_ms = best_of([&]() {
+			table t(16);
+			return time_ms([&]() { t.parallel_build_multi(items.data(), items.data() + n, threads); });
+		});
+		const double rehash_ms = best_of([&]() {
+			table t(16);
+			t.parallel_build_multi(items.data(), items.data() + n, threads);
+			const size_t buckets = t.bucket_count() * 4;
+			return time_ms([&]() { t.parallel_rehash(buckets, threads); });
+		});
+		if (threads == 1) {
+			base_unique = unique_ms;
+			base_multi = multi_ms;
+			base_rehash = rehash_ms;
+		}
+		std::printf("threads=%-3d build_unique %8.2f ms (x%.2f)  build_multi %8.2f ms (x%.2f)  rehash %8.2f ms (x%.2f)\n",
+			threads, unique_ms, base_unique / unique_ms, multi_ms, base_multi / multi_ms, rehash_ms, base_rehash / rehash_ms);
+	}
+	return 0;
+}
@@ -0,0 +1,155 @@
+// rcu_hashtable 的读者扩展性测试
+// 后台一个写者不停地插入、覆盖、删除，1/2/4/8 个读者随机查找，统计读者总吞吐
+// 同样的负载再跑一遍分片读写锁的 concurrent_unordered_map 做对比
+// 用法: rcu_hashtable_bench [每轮毫秒数，默认 500]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "rcu_hashtable.h"
+#include "concurrent_unordered_map.h"
+#include "functional.h"
+
+namespace {
+
+	const int key_count = 1 << 16;
+
+	using rcu_table = mystl::rcu_hashtable<mystl::pair<const int, int>,
+		mystl::hash<int>, mystl::equal_to<int>>;
+	using locked_table = mystl::concurrent_unordered_map<int, int>;
+
+	struct rcu_adapter
+	{
+		rcu_table table{ 2 * key_count };
+
+		bool find(int key, int& out)
+		{
+			return table.find(key, [&out](const mystl::pair<const int, int>& v) { out = v.second; });
+		}
+
+		void assign(int key, int value)
+		{
+			table.insert_or_assign(mystl::pair<const int, int>(key, value));
+		}
+
+		void erase(int key)
+		{
+			table.erase_unique(key);
+		}
+	};
+
+	struct locked_adapter
+	{
+		locked_table table{ 2 * key_count };
+
+		bool find(int key, int& out)
+		{
+			return table.find(key, out);
+		}
+
+		void assign(int key, int value)
+		{
+			table.insert_or_assign(key, value);
+		}
+
+		void erase(int key)
+		{
+			table.erase(key);
+		}
+	};
+
+	struct result
+	{
+		double reads_per_sec;
+		double writes_per_sec;
+	};
+
+	template <class Table>
+	result run(Table& t, int readers, int millis)
+	{
+		std::atomic<bool> stop(false);
+		std::atomic<long long> reads(0);
+		std::atomic<long long> writes(0);
+
+		// 写者在前一半 key 上覆盖，在后一半 key 上插入再删除
+		std::thread writer([&]() {
+			std::mt19937 rng(7);
+			long long n = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				const int key = static_cast<int>(rng() % key_count);
+				if (key < key_count / 2) {
+					t.assign(key, static_cast<int>(n));
+				}
+				else if (n & 1) {
+					t.assign(key, 0);
+				}
+				else {
+					t.erase(key);
+				}
+				++n;
+			}
+			writes.store(n);
+		});
+
+		std::vector<std::thread> workers;
+		for (int r = 0; r < readers; r++) {
+			workers.emplace_back([&, r]() {
+				std::mt19937 rng(100 + r);
+				long long n = 0;
+				long long hit = 0;
+				int out = 0;
+				while (!stop.load(std::memory_order_relaxed)) {
+					for (int i = 0; i < 256; i++) {
+						hit += t.find(static_cast<int>(rng() % key_count), out);
+					}
+					n += 256;
+				}
+				reads.fetch_add(n);
+				if (hit < 0) {
+					std::printf("%d\n", out);
+				}
+			});
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+		stop.store(true);
+		for (auto& w : workers) {
+			w.join();
+		}
+		writer.join();
+		const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result{ reads.load() / secs, writes.load() / secs };
+	}
+
+	template <class Table>
+	void bench(const char* name, int millis)
+	{
+		const int reader_counts[] = { 1, 2, 4, 8 };
+		for (int readers : reader_counts) {
+			Table t;
+			for (int k = 0; k < key_count / 2; k++) {
+				t.assign(k, k);
+			}
+			const result res = run(t, readers, millis);
+			std::printf("%-26s readers=%d  reads %8.2f M/s (%6.2f M/s per reader)  writes %6.2f M/s\n",
+				name, readers, res.reads_per_sec / 1e6, res.reads_per_sec / 1e6 / readers,
+				res.writes_per_sec / 1e6);
+		}
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	const int millis = argc > 1 ? std::atoi(argv[1]) : 500;
+	std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+	bench<rcu_adapter>("rcu_hashtable", millis);
+	bench<locked_adapter>("concurrent_unordered_map", millis);
+	return 0;
+}
@@ -0,0 +1,85 @@
+// btree 和 allocator 的测试：拷贝必须是拷贝，只有右值才能被移走
+
+#include <string>
+
+#include "btree_set.h"
+#include "btree_map.h"
+#include "test_util.h"
+
+namespace {
+
+	std::string key_of(int i)
+	{
+		return "a fairly long key that does not fit in SSO #" + std::to_string(i);
+	}
+
+	void test_allocator_construct()
+	{
+		using alloc = mystl::allocator<std::string>;
+		std::string* p = alloc::allocate(4);
+		std::string src = key_of(1);
+		const std::string csrc = key_of(2);
+
+		alloc::construct(p, src);
+		alloc::construct(p + 1, csrc);
+		MYSTL_CHECK(src == key_of(1));
+		MYSTL_CHECK(csrc == key_of(2));
+		MYSTL_CHECK(p[0] == key_of(1));
+		MYSTL_CHECK(p[1] == key_of(2));
+
+		alloc::construct(p + 2, mystl::move(src));
+		MYSTL_CHECK(p[2] == key_of(1));
+		MYSTL_CHECK(src.empty());
+
+		alloc::construct(p + 3, 3, 'x');
+		MYSTL_CHECK(p[3] == "xxx");
+
+		alloc::destroy(p, p + 4);
+		alloc::deallocate(p, 4);
+	}
+
+	void test_copy_keeps_source()
+	{
+		const int n = 1000;
+		mystl::btree_set<std::string> s;
+		for (int i = 0; i < n; i++) {
+			s.insert(key_of(i));
+		}
+		mystl::btree_set<std::string> c(s);
+		MYSTL_CHECK_EQ(c.size(), static_cast<size_t>(n));
+		MYSTL_CHECK_EQ(s.size(), static_cast<size_t>(n));
+		auto a = s.begin();
+		auto b = c.begin();
+		for (; a != s.end(); ++a, ++b) {
+			MYSTL_CHECK(!a->empty());
+			MYSTL_CHECK(*a == *b);
+		}
+
+		mystl::btree_map<std::string, std::string> m;
+		for (int i = 0; i < n; i++) {
+			m.emplace(key_of(i), key_of(-i));
+		}
+		mystl::btree_map<std::string, std::string> m2(m);
+		mystl::btree_map<std::string, std::string> m3;
+		m3 = m;
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK(m.find(key_of(i))->second == key_of(-i));
+			MYSTL_CHECK(m2.find(key_of(i))->second == key_of(-i));
+			MYSTL_CHECK(m3.find(key_of(i))->second == key_of(-i));
+		}
+
+		// 插入左值也不能把实参移走
+		std::string k = key_of(n);
+		s.insert(k);
+		MYSTL_CHECK(k == key_of(n));
+		MYSTL_CHECK(s.find(k) != s.end());
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_allocator_construct);
+	MYSTL_RUN(test_copy_keeps_source);
+	return 0;
+}
@@ -0,0 +1,133 @@
+// concurrent_unordered_map 的测试：单线程随机操作和 std::unordered_map 比较，
+// 再让多个线程同时插入、更新、删除，检查最后的结果
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "concurrent_unordered_map.h"
+#include "test_util.h"
+
+namespace {
+
+	using map_type = mystl::concurrent_unordered_map<int, int>;
+
+	void test_against_std_map()
+	{
+		std::mt19937 rng(21);
+		map_type m(64);
+		std::unordered_map<int, int> ref;
+		for (int step = 0; step < 20000; step++) {
+			const int key = static_cast<int>(rng() % 1000);
+			const unsigned op = rng() % 4;
+			if (op == 0) {
+				const bool inserted = ref.find(key) == ref.end();
+				ref[key] = step;
+				MYSTL_CHECK_EQ(m.insert_or_assign(key, step), inserted);
+			}
+			else if (op == 1) {
+				MYSTL_CHECK_EQ(m.erase(key), ref.erase(key));
+			}
+			else if (op == 2) {
+				auto it = ref.find(key);
+				const bool found = m.update(key, [](int& v) { v += 1; });
+				MYSTL_CHECK_EQ(found, it != ref.end());
+				if (it != ref.end()) {
+					it->second += 1;
+				}
+			}
+			else {
+				int out = -1;
+				auto it = ref.find(key);
+				MYSTL_CHECK_EQ(m.find(key, out), it != ref.end());
+				MYSTL_CHECK_EQ(m.contains(key), it != ref.end());
+				if (it != ref.end()) {
+					MYSTL_CHECK_EQ(out, it->second);
+				}
+			}
+		}
+		MYSTL_CHECK_EQ(m.size(), ref.size());
+
+		// 每个元素都在且只在一个分片里
+		size_t total = 0;
+		const map_type& cm = m;
+		cm.for_each_shard([&](const map_type::base_type& ht) {
+			for (auto it = ht.begin(); it != ht.end(); ++it) {
+				auto r = ref.find(it->first);
+				MYSTL_CHECK(r != ref.end());
+				MYSTL_CHECK_EQ(it->second, r->second);
+				++total;
+			}
+		});
+		MYSTL_CHECK_EQ(total, ref.size());
+
+		m.clear();
+		MYSTL_CHECK(m.empty());
+		int out = 0;
+		MYSTL_CHECK(!m.find(1, out));
+	}
+
+	// 恒等 hash 的连续整数也要分到多个分片上
+	void test_keys_spread_over_shards()
+	{
+		map_type m;
+		for (int i = 0; i < 1000; i++) {
+			m.insert_or_assign(i, i);
+		}
+		size_t used = 0;
+		m.for_each_shard([&used](map_type::base_type& ht) { used += ht.size() != 0; });
+		MYSTL_CHECK_EQ(used, static_cast<size_t>(map_type::shard_count));
+	}
+
+	void test_concurrent_writers()
+	{
+		const int threads = 4;
+		const int per_thread = 5000;
+		const int counters = 16;
+		map_type m;
+		for (int c = 0; c < counters; c++) {
+			m.insert_or_assign(-1 - c, 0);
+		}
+		std::vector<std::thread> workers;
+		for (int t = 0; t < threads; t++) {
+			workers.emplace_back([&m, t]() {
+				// 每个线程插入自己的一段 key，删掉其中的奇数，同时给所有线程共享的计数器加一
+				for (int i = 0; i < per_thread; i++) {
+					const int key = t * per_thread + i;
+					MYSTL_CHECK(m.insert_or_assign(key, key));
+					m.update(-1 - i % counters, [](int& v) { ++v; });
+					if (i % 2 == 1) {
+						MYSTL_CHECK_EQ(m.erase(key), 1u);
+					}
+					int out = 0;
+					MYSTL_CHECK_EQ(m.find(key, out), i % 2 == 0);
+				}
+			});
+		}
+		for (auto& w : workers) {
+			w.join();
+		}
+		MYSTL_CHECK_EQ(m.size(), static_cast<size_t>(threads * per_thread / 2 + counters));
+		int sum = 0;
+		for (int c = 0; c < counters; c++) {
+			int out = 0;
+			MYSTL_CHECK(m.find(-1 - c, out));
+			sum += out;
+		}
+		MYSTL_CHECK_EQ(sum, threads * per_thread);
+		for (int key = 0; key < threads * per_thread; key++) {
+			MYSTL_CHECK_EQ(m.contains(key), key % 2 == 0);
+		}
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_against_std_map);
+	MYSTL_RUN(test_keys_spread_over_shards);
+	MYSTL_RUN(test_concurrent_writers);
+	return 0;
+}
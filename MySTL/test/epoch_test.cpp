@@ -0,0 +1,131 @@
+// epoch_manager 的测试：大量 retire 让 retire 链表反复扩容，并检查读者还在时对象不会被提前释放，
+// 包括读者比独占槽还多的情况
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "epoch.h"
+#include "test_util.h"
+
+namespace {
+
+	std::atomic<int> g_freed(0);
+
+	struct tracked
+	{
+		int value;
+	};
+
+	void free_tracked(void* p)
+	{
+		delete static_cast<tracked*>(p);
+		g_freed.fetch_add(1);
+	}
+
+	void test_retire_many()
+	{
+		g_freed.store(0);
+		{
+			mystl::epoch_manager manager;
+			for (int i = 0; i < 10000; i++) {
+				manager.retire(new tracked{ i }, &free_tracked);
+			}
+			manager.reclaim();
+			manager.reclaim();
+			manager.reclaim();
+			MYSTL_CHECK_EQ(g_freed.load(), 10000);
+		}
+		MYSTL_CHECK_EQ(g_freed.load(), 10000);
+	}
+
+	// 读者没离开之前，它进入以后 retire 的对象不能被释放
+	void test_reader_blocks_reclaim()
+	{
+		g_freed.store(0);
+		mystl::epoch_manager manager;
+		{
+			mystl::epoch_guard guard(manager);
+			manager.retire(new tracked{ 1 }, &free_tracked);
+			for (int i = 0; i < 10; i++) {
+				manager.reclaim();
+			}
+			MYSTL_CHECK_EQ(g_freed.load(), 0);
+		}
+		for (int i = 0; i < 3; i++) {
+			manager.reclaim();
+		}
+		MYSTL_CHECK_EQ(g_freed.load(), 1);
+	}
+
+	// 同时在临界区里的读者比独占槽多，多出来的走共享槽，不能卡在 enter 里
+	void test_more_readers_than_slots()
+	{
+		g_freed.store(0);
+		const int readers = static_cast<int>(mystl::epoch_manager::slot_count) + 72;
+		mystl::epoch_manager manager;
+		std::atomic<int> arrived(0);
+		std::atomic<bool> release(false);
+		std::vector<std::thread> workers;
+		for (int t = 0; t < readers; t++) {
+			workers.emplace_back([&]() {
+				mystl::epoch_guard guard(manager);
+				arrived.fetch_add(1);
+				while (!release.load()) {
+					std::this_thread::yield();
+				}
+			});
+		}
+		while (arrived.load() != readers) {
+			std::this_thread::yield();
+		}
+
+		manager.retire(new tracked{ 1 }, &free_tracked);
+		for (int i = 0; i < 10; i++) {
+			manager.reclaim();
+		}
+		MYSTL_CHECK_EQ(g_freed.load(), 0);
+
+		release.store(true);
+		for (auto& w : workers) {
+			w.join();
+		}
+		for (int i = 0; i < 3; i++) {
+			manager.reclaim();
+		}
+		MYSTL_CHECK_EQ(g_freed.load(), 1);
+	}
+
+	void test_concurrent_retire()
+	{
+		g_freed.store(0);
+		const int threads = 4;
+		const int per_thread = 20000;
+		{
+			mystl::epoch_manager manager;
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; t++) {
+				workers.emplace_back([&manager]() {
+					for (int i = 0; i < per_thread; i++) {
+						mystl::epoch_guard guard(manager);
+						manager.retire(new tracked{ i }, &free_tracked);
+					}
+				});
+			}
+			for (auto& w : workers) {
+				w.join();
+			}
+		}
+		MYSTL_CHECK_EQ(g_freed.load(), threads * per_thread);
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_retire_many);
+	MYSTL_RUN(test_reader_blocks_reclaim);
+	MYSTL_RUN(test_more_readers_than_slots);
+	MYSTL_RUN(test_concurrent_retire);
+	return 0;
+}
@@ -0,0 +1,152 @@
+// flat_set / flat_map 的测试：单个插入、区间插入（排序后归并）和删除，每一步之后和 std::set / std::map 比较
+
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+#include "flat_set.h"
+#include "flat_map.h"
+#include "test_util.h"
+
+namespace {
+
+	template <class Flat, class Std>
+	void check_set(const Flat& f, const Std& s)
+	{
+		MYSTL_CHECK_EQ(f.size(), s.size());
+		auto a = f.begin();
+		for (auto b = s.begin(); b != s.end(); ++a, ++b) {
+			MYSTL_CHECK(*a == *b);
+		}
+		MYSTL_CHECK(a == f.end());
+	}
+
+	template <class Flat, class Std>
+	void check_map(const Flat& f, const Std& m)
+	{
+		MYSTL_CHECK_EQ(f.size(), m.size());
+		auto a = f.begin();
+		for (auto b = m.begin(); b != m.end(); ++a, ++b) {
+			MYSTL_CHECK(a->first == b->first);
+			MYSTL_CHECK(a->second == b->second);
+		}
+		MYSTL_CHECK(a == f.end());
+	}
+
+	void test_range_insert()
+	{
+		int keys[] = { 5, 3, 9, 1, 3, 7, 5, 0, 8, 2 };
+		mystl::flat_set<int> s(keys, keys + 10);
+		check_set(s, std::set<int>(keys, keys + 10));
+		mystl::flat_multiset<int> ms(keys, keys + 10);
+		check_set(ms, std::multiset<int>(keys, keys + 10));
+
+		// 已有元素和新元素交错，要走归并；和已有元素相等的新元素不能插进 flat_set
+		int more[] = { 4, 6, 5, -1, 10, 9 };
+		s.insert(more, more + 6);
+		ms.insert(more, more + 6);
+		std::set<int> ss(keys, keys + 10);
+		std::multiset<int> sms(keys, keys + 10);
+		ss.insert(more, more + 6);
+		sms.insert(more, more + 6);
+		check_set(s, ss);
+		check_set(ms, sms);
+
+		mystl::pair<int, std::string> items[] = {
+			{ 3, "c" }, { 1, "a" }, { 2, "b" }, { 1, "x" }, { 5, "e" }
+		};
+		mystl::flat_map<int, std::string> m(items, items + 5);
+		std::map<int, std::string> sm;
+		for (auto& p : items) {
+			sm.emplace(p.first, p.second);
+		}
+		check_map(m, sm);
+
+		// 相等的 key 留下先插入的那个
+		mystl::pair<int, std::string> later[] = { { 4, "d" }, { 2, "y" }, { 0, "z" } };
+		m.insert(later, later + 3);
+		for (auto& p : later) {
+			sm.emplace(p.first, p.second);
+		}
+		check_map(m, sm);
+		MYSTL_CHECK(m.at(2) == "b");
+	}
+
+	// 随机的单个插入、批量插入和删除
+	void test_random_against_std()
+	{
+		std::mt19937 rng(2024);
+		mystl::flat_set<int> fs;
+		mystl::flat_multiset<int> fms;
+		mystl::flat_map<int, int> fm;
+		mystl::flat_multimap<int, int> fmm;
+		std::set<int> ss;
+		std::multiset<int> sms;
+		std::map<int, int> sm;
+		std::multimap<int, int> smm;
+
+		for (int step = 0; step < 3000; step++) {
+			const int key = static_cast<int>(rng() % 1000);
+			const int op = static_cast<int>(rng() % 4);
+			if (op == 0) {
+				MYSTL_CHECK_EQ(fs.insert(key).second, ss.insert(key).second);
+				fms.insert(key);
+				sms.insert(key);
+				MYSTL_CHECK_EQ(fm.emplace(key, step).second, sm.emplace(key, step).second);
+				fmm.emplace(key, step);
+				smm.emplace(key, step);
+			}
+			else if (op == 1) {
+				int keys[40];
+				mystl::pair<int, int> items[40];
+				const int n = static_cast<int>(rng() % 40);
+				for (int i = 0; i < n; i++) {
+					keys[i] = static_cast<int>(rng() % 1000);
+					items[i] = mystl::pair<int, int>(keys[i], step * 100 + i);
+				}
+				fs.insert(keys, keys + n);
+				fms.insert(keys, keys + n);
+				fm.insert(items, items + n);
+				fmm.insert(items, items + n);
+				ss.insert(keys, keys + n);
+				sms.insert(keys, keys + n);
+				for (int i = 0; i < n; i++) {
+					sm.emplace(items[i].first, items[i].second);
+					smm.emplace(items[i].first, items[i].second);
+				}
+			}
+			else if (op == 2) {
+				MYSTL_CHECK_EQ(fs.erase(key), ss.erase(key));
+				MYSTL_CHECK_EQ(fms.erase(key), sms.erase(key));
+				MYSTL_CHECK_EQ(fm.erase(key), sm.erase(key));
+				MYSTL_CHECK_EQ(fmm.erase(key), smm.erase(key));
+			}
+			else {
+				MYSTL_CHECK_EQ(fs.count(key), ss.count(key));
+				MYSTL_CHECK_EQ(fms.count(key), sms.count(key));
+				MYSTL_CHECK_EQ(fm.count(key), sm.count(key));
+				MYSTL_CHECK_EQ(fmm.count(key), smm.count(key));
+			}
+			if (step % 100 == 0) {
+				check_set(fs, ss);
+				check_set(fms, sms);
+				check_map(fm, sm);
+				// multimap 里相等 key 的顺序由插入顺序决定，这里两边都保持插入顺序
+				check_map(fmm, smm);
+			}
+		}
+		check_set(fs, ss);
+		check_set(fms, sms);
+		check_map(fm, sm);
+		check_map(fmm, smm);
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_range_insert);
+	MYSTL_RUN(test_random_against_std);
+	return 0;
+}
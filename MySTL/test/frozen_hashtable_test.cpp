@@ -0,0 +1,151 @@
+// frozen_hashtable 的测试：写文件再映射回来查找，以及各种损坏的文件必须在 open 时被拒绝
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "frozen_hashtable.h"
+#include "test_util.h"
+
+namespace {
+
+	const char* path = "frozen_hashtable_test.bin";
+
+	using table = mystl::frozen_hashtable<int, long long>;
+
+	// 和 mystl::hash<int> 不同的 hash，用来模拟读写两边 hash 不一致
+	struct other_hash
+	{
+		size_t operator()(int x) const { return static_cast<size_t>(x) * 31u + 7u; }
+	};
+
+	std::vector<unsigned char> read_file()
+	{
+		std::vector<unsigned char> buf;
+		std::FILE* fp = std::fopen(path, "rb");
+		MYSTL_CHECK(fp != nullptr);
+		int c;
+		while ((c = std::fgetc(fp)) != EOF) {
+			buf.push_back(static_cast<unsigned char>(c));
+		}
+		std::fclose(fp);
+		return buf;
+	}
+
+	void write_file(const std::vector<unsigned char>& buf)
+	{
+		std::FILE* fp = std::fopen(path, "wb");
+		MYSTL_CHECK(fp != nullptr);
+		MYSTL_CHECK_EQ(std::fwrite(buf.data(), 1, buf.size(), fp), buf.size());
+		std::fclose(fp);
+	}
+
+	template <class Table>
+	bool open_fails(bool verify)
+	{
+		try {
+			Table t(path, verify);
+		}
+		catch (const std::runtime_error&) {
+			return true;
+		}
+		return false;
+	}
+
+	void save_items(int n)
+	{
+		// 超过 vector 的初始容量，保存时 items 会扩容多次
+		std::vector<mystl::pair<int, long long>> items;
+		for (int i = 0; i < n; i++) {
+			items.push_back(mystl::pair<int, long long>(i * 7, static_cast<long long>(i) * i));
+		}
+		table::save(items.begin(), items.end(), path);
+	}
+
+	void test_round_trip()
+	{
+		const int n = 10000;
+		save_items(n);
+		for (int verify = 0; verify < 2; verify++) {
+			table t(path, verify != 0);
+			MYSTL_CHECK(t.is_open());
+			MYSTL_CHECK_EQ(t.size(), static_cast<size_t>(n));
+			for (int i = 0; i < n; i++) {
+				const long long* v = t.find(i * 7);
+				MYSTL_CHECK(v != nullptr);
+				MYSTL_CHECK_EQ(*v, static_cast<long long>(i) * i);
+				MYSTL_CHECK(!t.contains(i * 7 + 1));
+			}
+			size_t seen = 0;
+			for (auto it = t.begin(); it != t.end(); ++it) {
+				++seen;
+			}
+			MYSTL_CHECK_EQ(seen, static_cast<size_t>(n));
+		}
+
+		mystl::vector<mystl::pair<int, long long>> empty;
+		table::save(empty.begin(), empty.end(), path);
+		table t(path);
+		MYSTL_CHECK(t.empty());
+		MYSTL_CHECK(t.find(3) == nullptr);
+	}
+
+	// 头部的偏移在文件开头，bucket 数组紧跟在头部后面
+	size_t buckets_offset(const std::vector<unsigned char>& buf)
+	{
+		// magic + 8 个 uint32 + hash_check + bucket_count + size 之后就是 buckets_offset
+		std::uint64_t off;
+		std::memcpy(&off, buf.data() + 8 + 8 * 4 + 8 * 3, 8);
+		return static_cast<size_t>(off);
+	}
+
+	void test_rejects_bad_files()
+	{
+		save_items(1000);
+		const std::vector<unsigned char> good = read_file();
+
+		// 桶偏移不单调，不校验 checksum 时也要拒绝
+		std::vector<unsigned char> bad = good;
+		const size_t off = buckets_offset(bad);
+		std::uint64_t big = 5000;
+		std::memcpy(bad.data() + off + 8 * 3, &big, 8);
+		write_file(bad);
+		MYSTL_CHECK(open_fails<table>(false));
+		MYSTL_CHECK(open_fails<table>(true));
+
+		// 截断
+		bad = good;
+		bad.resize(bad.size() - 16);
+		write_file(bad);
+		MYSTL_CHECK(open_fails<table>(false));
+
+		// 数据被改，只有校验 checksum 时能发现
+		bad = good;
+		bad[bad.size() - 1] ^= 0x5a;
+		write_file(bad);
+		MYSTL_CHECK(open_fails<table>(true));
+
+		// size_t 宽度不同
+		bad = good;
+		std::uint32_t width = 4;
+		std::memcpy(bad.data() + 8 + 6 * 4, &width, 4);
+		write_file(bad);
+		MYSTL_CHECK(open_fails<table>(false));
+
+		// 读的一方用的 hash 不一样
+		write_file(good);
+		MYSTL_CHECK(!open_fails<table>(false));
+		MYSTL_CHECK((open_fails<mystl::frozen_hashtable<int, long long, other_hash>>(false)));
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_round_trip);
+	MYSTL_RUN(test_rejects_bad_files);
+	std::remove(path);
+	return 0;
+}
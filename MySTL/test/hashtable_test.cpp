@@ -0,0 +1,668 @@
+// hashtable 的测试：批量插入和拷贝出来的节点放在整块分配的内存里，
+// extract / merge 时要先把元素挪到单独的节点上，这里检查挪动前后表的结构都正确，
+// 以及块内节点的复用和整块释放
+// 后面是批量查找、异构查找、stats() 和 filtered_set 的测试
+
+#include <cstring>
+#include <string>
+
+#include "filtered_set.h"
+#include "unordered_map.h"
+#include "unordered_set.h"
+#include "test_util.h"
+
+namespace {
+
+	struct string_hash
+	{
+		size_t operator()(const std::string& s) const
+		{
+			return mystl::bitwise_hash(reinterpret_cast<const unsigned char*>(s.data()), s.size());
+		}
+	};
+
+	using map_type = mystl::unordered_map<std::string, int, string_hash>;
+	using multimap_type = mystl::unordered_multimap<std::string, int, string_hash>;
+	using set_type = mystl::unordered_set<std::string, string_hash>;
+	using int_table = mystl::hashtable<int, mystl::hash<int>, mystl::equal_to<int>>;
+	using pair_table = mystl::hashtable<mystl::pair<const int, int>, mystl::hash<int>, mystl::equal_to<int>>;
+
+	// 用长字符串，移动之后原对象一定变空，桶号会变
+	// map 的 key 是 const 的，移动时其实是拷贝，set 的元素才会真的被移走
+	std::string key_of(int i)
+	{
+		return "a fairly long key that does not fit in SSO #" + std::to_string(i);
+	}
+
+	mystl::vector<mystl::pair<std::string, int>> make_items(int n)
+	{
+		mystl::vector<mystl::pair<std::string, int>> items;
+		for (int i = 0; i < n; i++) {
+			items.push_back(mystl::pair<std::string, int>(key_of(i), i));
+		}
+		return items;
+	}
+
+	void check_contents(const map_type& m, int first, int last)
+	{
+		MYSTL_CHECK_EQ(m.size(), static_cast<size_t>(last - first));
+		for (int i = first; i < last; i++) {
+			auto it = m.find(key_of(i));
+			MYSTL_CHECK(it != m.end());
+			MYSTL_CHECK_EQ(it->second, i);
+		}
+	}
+
+	// 区间插入不少于 32 个元素时节点是整块分配的
+	void test_extract_after_range_insert()
+	{
+		const int n = 200;
+		auto items = make_items(n);
+		map_type m;
+		m.insert(items.begin(), items.end());
+		check_contents(m, 0, n);
+
+		for (int i = 0; i < n / 2; i++) {
+			auto nh = i % 2 == 0 ? m.extract(key_of(i)) : m.extract(m.find(key_of(i)));
+			MYSTL_CHECK(!nh.empty());
+			MYSTL_CHECK(nh.value().first == key_of(i));
+			MYSTL_CHECK_EQ(nh.value().second, i);
+			MYSTL_CHECK(m.find(key_of(i)) == m.end());
+		}
+		check_contents(m, n / 2, n);
+
+		// 摘下来的节点可以放回去，也可以放进别的表
+		map_type other;
+		for (int i = n / 2; i < n; i += 3) {
+			auto nh = m.extract(key_of(i));
+			MYSTL_CHECK(other.insert(mystl::move(nh)).second);
+		}
+		for (int i = n / 2; i < n; i++) {
+			const bool moved = (i - n / 2) % 3 == 0;
+			MYSTL_CHECK_EQ(m.count(key_of(i)), moved ? 0u : 1u);
+			MYSTL_CHECK_EQ(other.count(key_of(i)), moved ? 1u : 0u);
+		}
+
+		// 块内空出来的节点会被后面的插入复用
+		for (int i = 0; i < n / 2; i++) {
+			m.emplace(key_of(i), i);
+		}
+		for (int i = n / 2; i < n; i++) {
+			m.emplace(key_of(i), i);
+		}
+		check_contents(m, 0, n);
+	}
+
+	void test_extract_from_copy()
+	{
+		const int n = 100;
+		auto items = make_items(n);
+		map_type src(items.begin(), items.end());
+		map_type copy(src);
+		check_contents(copy, 0, n);
+
+		for (int i = 0; i < n; i += 2) {
+			auto nh = copy.extract(key_of(i));
+			MYSTL_CHECK(nh.value().first == key_of(i));
+		}
+		MYSTL_CHECK_EQ(copy.size(), static_cast<size_t>(n / 2));
+		for (int i = 1; i < n; i += 2) {
+			MYSTL_CHECK(copy.find(key_of(i)) != copy.end());
+		}
+		check_contents(src, 0, n);
+	}
+
+	// set 的元素移走之后 hash 就变了，在 own_node 之后再算桶号会找错桶
+	void test_set_extract_after_range_insert()
+	{
+		const int n = 200;
+		mystl::vector<std::string> keys;
+		for (int i = 0; i < n; i++) {
+			keys.push_back(key_of(i));
+		}
+		set_type s;
+		s.insert(keys.begin(), keys.end());
+		set_type copy(s);
+
+		for (int i = 0; i < n; i += 2) {
+			auto nh = s.extract(key_of(i));
+			MYSTL_CHECK(!nh.empty());
+			MYSTL_CHECK(nh.value() == key_of(i));
+			auto ch = copy.extract(copy.find(key_of(i + 1)));
+			MYSTL_CHECK(ch.value() == key_of(i + 1));
+		}
+		MYSTL_CHECK_EQ(s.size(), static_cast<size_t>(n / 2));
+		MYSTL_CHECK_EQ(copy.size(), static_cast<size_t>(n / 2));
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK_EQ(s.count(key_of(i)), i % 2 == 0 ? 0u : 1u);
+			MYSTL_CHECK_EQ(copy.count(key_of(i)), i % 2 == 0 ? 1u : 0u);
+		}
+
+		set_type all;
+		all.merge(s);
+		all.merge(copy);
+		MYSTL_CHECK_EQ(all.size(), static_cast<size_t>(n));
+		MYSTL_CHECK(s.empty());
+		MYSTL_CHECK(copy.empty());
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK(all.find(key_of(i)) != all.end());
+		}
+	}
+
+	void test_merge_from_block()
+	{
+		const int n = 100;
+		auto items = make_items(n);
+		map_type src(items.begin(), items.end());
+		map_type dst;
+		dst.emplace(key_of(0), -1);
+		dst.merge(src);
+		MYSTL_CHECK_EQ(dst.size(), static_cast<size_t>(n));
+		MYSTL_CHECK_EQ(src.size(), 1u);
+		MYSTL_CHECK_EQ(dst.find(key_of(0))->second, -1);
+		MYSTL_CHECK_EQ(src.find(key_of(0))->second, 0);
+		for (int i = 1; i < n; i++) {
+			MYSTL_CHECK_EQ(dst.find(key_of(i))->second, i);
+		}
+
+		multimap_type a(items.begin(), items.end());
+		multimap_type b(items.begin(), items.end());
+		a.merge(b);
+		MYSTL_CHECK_EQ(a.size(), static_cast<size_t>(2 * n));
+		MYSTL_CHECK(b.empty());
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK_EQ(a.count(key_of(i)), 2u);
+		}
+	}
+
+	// 反复批量插入再删除，空出来的块内节点要被复用，整块空了要还回去，占用的内存不能一直涨
+	void test_block_memory_bounded()
+	{
+		const int n = 1000;
+		mystl::vector<int> keys;
+		for (int i = 0; i < n; i++) {
+			keys.push_back(i);
+		}
+		const size_t node_size = sizeof(int_table::node_type);
+		int_table t(16);
+		size_t peak = 0;
+		for (int round = 0; round < 50; round++) {
+			t.insert_unique(keys.begin(), keys.end());
+			MYSTL_CHECK_EQ(t.size(), static_cast<size_t>(n));
+			// 删掉一半再整体插入一遍，空出来的节点全部被复用
+			for (int i = round % 2; i < n; i += 2) {
+				MYSTL_CHECK_EQ(t.erase_unique(i), 1u);
+			}
+			t.insert_unique(keys.begin(), keys.end());
+			MYSTL_CHECK_EQ(t.size(), static_cast<size_t>(n));
+			const size_t bytes = t.stats().node_bytes;
+			MYSTL_CHECK(bytes >= n * node_size);
+			peak = bytes > peak ? bytes : peak;
+			for (int i = 0; i < n; i++) {
+				MYSTL_CHECK_EQ(t.erase_unique(i), 1u);
+			}
+			// 块里的节点全部释放了，块已经还回去
+			MYSTL_CHECK_EQ(t.stats().node_bytes, 0u);
+		}
+		MYSTL_CHECK(peak < 2 * n * node_size);
+
+		// 重复的 key 留下的空闲节点计入 node_bytes
+		mystl::vector<int> dup(keys.begin(), keys.end());
+		dup.insert(dup.end(), keys.begin(), keys.end());
+		t.insert_unique(dup.begin(), dup.end());
+		MYSTL_CHECK_EQ(t.size(), static_cast<size_t>(n));
+		MYSTL_CHECK(t.stats().node_bytes >= 2 * n * node_size);
+		t.insert_unique(keys.begin(), keys.end());
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK(t.find(i) != t.end());
+		}
+	}
+
+	// 拷贝构造的整块节点删光之后也要还回去
+	void test_copy_block_released()
+	{
+		const int n = 500;
+		mystl::vector<int> keys;
+		for (int i = 0; i < n; i++) {
+			keys.push_back(i);
+		}
+		int_table src(16);
+		src.insert_unique(keys.begin(), keys.end());
+		int_table copy(src);
+		MYSTL_CHECK_EQ(copy.stats().node_bytes, src.stats().node_bytes);
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK_EQ(copy.erase_unique(i), 1u);
+		}
+		MYSTL_CHECK_EQ(copy.stats().node_bytes, 0u);
+
+		// 单独分配的节点和块内节点混在一起时 free_node 也要分得清
+		copy.insert_unique(keys.begin(), keys.begin() + 10);
+		copy.insert_unique(keys.begin(), keys.end());
+		copy.insert_unique(keys.begin(), keys.end());
+		MYSTL_CHECK_EQ(copy.size(), static_cast<size_t>(n));
+		for (int i = n - 1; i >= 0; i--) {
+			MYSTL_CHECK_EQ(copy.erase_unique(i), 1u);
+		}
+		MYSTL_CHECK_EQ(copy.stats().node_bytes, 0u);
+		MYSTL_CHECK_EQ(src.size(), static_cast<size_t>(n));
+	}
+
+	// 并行构建每个线程至少分到 16384 个元素，4 个线程要 65536 个
+	const int parallel_n = 4 * 16384;
+	const int parallel_threads = 4;
+
+	// key 有重复，值是在输入里的位置，unique 时保留先出现的
+	mystl::vector<mystl::pair<int, int>> make_dup_items(int n, int distinct)
+	{
+		mystl::vector<mystl::pair<int, int>> items;
+		for (int i = 0; i < n; i++) {
+			items.push_back(mystl::pair<int, int>((i * 7919) % distinct, i));
+		}
+		return items;
+	}
+
+	// 相同 key 的元素顺序也要和串行插入一样
+	void check_same_as_serial(const pair_table& got, const pair_table& expect, int distinct)
+	{
+		MYSTL_CHECK_EQ(got.size(), expect.size());
+		for (int k = 0; k < distinct; k++) {
+			auto g = got.equal_range_multi(k);
+			auto e = expect.equal_range_multi(k);
+			for (; g.first != g.second && e.first != e.second; ++g.first, ++e.first) {
+				MYSTL_CHECK_EQ(g.first->second, e.first->second);
+			}
+			MYSTL_CHECK(g.first == g.second);
+			MYSTL_CHECK(e.first == e.second);
+		}
+	}
+
+	void test_parallel_build_unique()
+	{
+		const int distinct = 40000;
+		auto items = make_dup_items(parallel_n, distinct);
+		pair_table serial(16);
+		serial.insert_unique(items.begin(), items.end());
+		pair_table par(16);
+		par.parallel_build_unique(items.begin(), items.end(), parallel_threads);
+		MYSTL_CHECK_EQ(par.size(), static_cast<size_t>(distinct));
+		check_same_as_serial(par, serial, distinct);
+
+		// 往已经有元素的表里构建，已有的 key 不被覆盖
+		pair_table target(16);
+		for (int k = 0; k < distinct; k += 3) {
+			target.insert_unique(mystl::pair<const int, int>(k, -k));
+		}
+		target.parallel_build_unique(items.begin(), items.end(), parallel_threads);
+		MYSTL_CHECK_EQ(target.size(), static_cast<size_t>(distinct));
+		for (int k = 0; k < distinct; k++) {
+			auto it = target.find(k);
+			MYSTL_CHECK(it != target.end());
+			if (k % 3 == 0) {
+				MYSTL_CHECK_EQ(it->second, -k);
+			}
+			else {
+				MYSTL_CHECK_EQ(it->second, serial.find(k)->second);
+			}
+		}
+	}
+
+	void test_parallel_build_multi()
+	{
+		const int distinct = 20000;
+		auto items = make_dup_items(parallel_n, distinct);
+		pair_table serial(16);
+		serial.insert_multi(items.begin(), items.end());
+		pair_table par(16);
+		par.parallel_build_multi(items.begin(), items.end(), parallel_threads);
+		MYSTL_CHECK_EQ(par.size(), static_cast<size_t>(parallel_n));
+		check_same_as_serial(par, serial, distinct);
+
+		// 已有的元素都保留，新元素全部加进去
+		pair_table target(16);
+		for (int k = 0; k < distinct; k += 5) {
+			target.insert_multi(mystl::pair<const int, int>(k, -1));
+		}
+		pair_table target_serial(target);
+		target.parallel_build_multi(items.begin(), items.end(), parallel_threads);
+		target_serial.insert_multi(items.begin(), items.end());
+		MYSTL_CHECK_EQ(target.size(), static_cast<size_t>(parallel_n + distinct / 5));
+		for (int k = 0; k < distinct; k++) {
+			MYSTL_CHECK_EQ(target.count(k), target_serial.count(k));
+		}
+	}
+
+	void test_parallel_rehash()
+	{
+		mystl::vector<int> keys;
+		for (int i = 0; i < parallel_n; i++) {
+			keys.push_back(i * 3);
+		}
+		int_table t(16);
+		t.insert_unique(keys.begin(), keys.end());
+		const size_t before = t.bucket_count();
+		t.parallel_rehash(before * 4, parallel_threads);
+		MYSTL_CHECK(t.bucket_count() > before);
+		MYSTL_CHECK(t.stats().rehash_count > 0);
+		MYSTL_CHECK_EQ(t.size(), static_cast<size_t>(parallel_n));
+		for (int i = 0; i < parallel_n; i++) {
+			MYSTL_CHECK(t.find(i * 3) != t.end());
+			MYSTL_CHECK(t.find(i * 3 + 1) == t.end());
+		}
+		size_t n = 0;
+		for (auto it = t.begin(); it != t.end(); ++it) {
+			++n;
+		}
+		MYSTL_CHECK_EQ(n, static_cast<size_t>(parallel_n));
+
+		// 桶数比元素少时不缩小
+		const size_t grown = t.bucket_count();
+		t.parallel_rehash(1, parallel_threads);
+		MYSTL_CHECK_EQ(t.bucket_count(), grown);
+
+		// 多线程 rehash 之后还能正常插入和删除
+		for (int i = 0; i < parallel_n; i += 2) {
+			MYSTL_CHECK_EQ(t.erase_unique(i * 3), 1u);
+		}
+		t.insert_unique(keys.begin(), keys.end());
+		MYSTL_CHECK_EQ(t.size(), static_cast<size_t>(parallel_n));
+	}
+
+
+	// 批量查找的结果要和逐个 find / count 一样，key 个数不是 batch_group 的整数倍，最后一组不满
+	void test_find_batch()
+	{
+		const int n = 300;
+		auto items = make_items(n);
+		map_type m(items.begin(), items.end());
+		mystl::vector<std::string> keys;
+		for (int i = 0; i < 2 * n + 7; i++) {
+			keys.push_back(key_of(i * 5 % (2 * n)));
+		}
+
+		mystl::vector<map_type::iterator> found(keys.size());
+		auto out = m.find_batch(keys.begin(), keys.end(), found.begin());
+		MYSTL_CHECK(out == found.end());
+		for (size_t i = 0; i < keys.size(); i++) {
+			MYSTL_CHECK(found[i] == m.find(keys[i]));
+		}
+
+		const map_type& cm = m;
+		mystl::vector<map_type::const_iterator> cfound(keys.size());
+		cm.find_batch(keys.begin(), keys.end(), cfound.begin());
+		for (size_t i = 0; i < keys.size(); i++) {
+			MYSTL_CHECK(cfound[i] == cm.find(keys[i]));
+		}
+
+		// 空区间什么也不写
+		MYSTL_CHECK(m.find_batch(keys.begin(), keys.begin(), found.begin()) == found.begin());
+
+		multimap_type mm(items.begin(), items.end());
+		mm.insert(items.begin(), items.begin() + n / 2);
+		mystl::vector<size_t> counts(keys.size());
+		mm.count_batch(keys.begin(), keys.end(), counts.begin());
+		for (size_t i = 0; i < keys.size(); i++) {
+			MYSTL_CHECK_EQ(counts[i], mm.count(keys[i]));
+		}
+		MYSTL_CHECK_EQ(counts[0], 2u);
+		MYSTL_CHECK_EQ(counts[1], 2u);
+
+		// 空表的桶全是空的，批量查找全部查不到
+		map_type empty;
+		empty.find_batch(keys.begin(), keys.end(), found.begin());
+		for (size_t i = 0; i < keys.size(); i++) {
+			MYSTL_CHECK(found[i] == empty.end());
+		}
+	}
+
+
+	// 异构查找用的 hash 和比较，用 const char* 查找时计数，确认走的是不构造 std::string 的重载
+	size_t c_str_calls = 0;
+
+	struct transparent_hash
+	{
+		using is_transparent = void;
+
+		size_t operator()(const std::string& s) const
+		{
+			return mystl::bitwise_hash(reinterpret_cast<const unsigned char*>(s.data()), s.size());
+		}
+
+		size_t operator()(const char* s) const
+		{
+			++c_str_calls;
+			return mystl::bitwise_hash(reinterpret_cast<const unsigned char*>(s), std::strlen(s));
+		}
+	};
+
+	struct transparent_equal
+	{
+		using is_transparent = void;
+
+		bool operator()(const std::string& a, const std::string& b) const { return a == b; }
+		bool operator()(const char* a, const std::string& b) const { ++c_str_calls; return b == a; }
+		bool operator()(const std::string& a, const char* b) const { ++c_str_calls; return a == b; }
+	};
+
+	void test_transparent_lookup()
+	{
+		using tmap = mystl::unordered_map<std::string, int, transparent_hash, transparent_equal>;
+		using tmultimap = mystl::unordered_multimap<std::string, int, transparent_hash, transparent_equal>;
+		const int n = 100;
+		auto items = make_items(n);
+		tmap m(items.begin(), items.end());
+		mystl::vector<std::string> keys;
+		for (int i = 0; i < n; i++) {
+			keys.push_back(key_of(i));
+		}
+
+		c_str_calls = 0;
+		for (int i = 0; i < n; i++) {
+			const char* k = keys[i].c_str();
+			auto it = m.find(k);
+			MYSTL_CHECK(it != m.end());
+			MYSTL_CHECK_EQ(it->second, i);
+			MYSTL_CHECK_EQ(m.count(k), 1u);
+			auto r = m.equal_range(k);
+			MYSTL_CHECK(r.first == it);
+			MYSTL_CHECK(++r.first == r.second);
+		}
+		MYSTL_CHECK(c_str_calls >= static_cast<size_t>(3 * n));
+		MYSTL_CHECK(m.find("no such key") == m.end());
+		MYSTL_CHECK_EQ(m.count("no such key"), 0u);
+		const tmap& cm = m;
+		MYSTL_CHECK(cm.find(keys[7].c_str()) == cm.find(keys[7]));
+
+		for (int i = 0; i < n; i += 2) {
+			MYSTL_CHECK_EQ(m.erase(keys[i].c_str()), 1u);
+		}
+		MYSTL_CHECK_EQ(m.erase("no such key"), 0u);
+		MYSTL_CHECK_EQ(m.size(), static_cast<size_t>(n / 2));
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK_EQ(m.count(keys[i].c_str()), i % 2 == 0 ? 0u : 1u);
+		}
+
+		tmultimap mm(items.begin(), items.end());
+		mm.insert(items.begin(), items.end());
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK_EQ(mm.count(keys[i].c_str()), 2u);
+			auto r = mm.equal_range(keys[i].c_str());
+			MYSTL_CHECK_EQ(static_cast<size_t>(mystl::distance(r.first, r.second)), 2u);
+		}
+		MYSTL_CHECK_EQ(mm.erase(keys[0].c_str()), 2u);
+		MYSTL_CHECK_EQ(mm.size(), static_cast<size_t>(2 * n - 2));
+	}
+
+
+	// 所有 key 落在同一个桶，stats 应该看出这是 hash 的问题而不是负载因子的问题
+	struct constant_hash
+	{
+		size_t operator()(int) const { return 7; }
+	};
+
+	void check_stats_consistent(const mystl::hashtable_stats& s)
+	{
+		size_t buckets = 0;
+		size_t elems = 0;
+		for (size_t i = 0; i < mystl::hashtable_stats::histogram_size; i++) {
+			buckets += s.chain_histogram[i];
+			elems += i * s.chain_histogram[i];
+		}
+		MYSTL_CHECK_EQ(buckets, s.bucket_count);
+		MYSTL_CHECK_EQ(s.chain_histogram[0], s.empty_buckets);
+		if (s.max_chain < mystl::hashtable_stats::histogram_size - 1) {
+			MYSTL_CHECK_EQ(elems, s.size);
+		}
+		MYSTL_CHECK_EQ(s.bucket_bytes, s.bucket_count * sizeof(void*));
+	}
+
+	void test_stats()
+	{
+		int_table empty(16);
+		auto s = empty.stats();
+		MYSTL_CHECK_EQ(s.size, 0u);
+		MYSTL_CHECK_EQ(s.max_chain, 0u);
+		MYSTL_CHECK_EQ(s.empty_buckets, s.bucket_count);
+		MYSTL_CHECK(s.empty_bucket_ratio == 1.0f);
+		MYSTL_CHECK(s.average_probe == 0.0);
+		MYSTL_CHECK_EQ(s.node_bytes, 0u);
+		check_stats_consistent(s);
+
+		const int n = 5000;
+		int_table t(16);
+		for (int i = 0; i < n; i++) {
+			t.insert_unique(i);
+		}
+		s = t.stats();
+		MYSTL_CHECK_EQ(s.size, static_cast<size_t>(n));
+		MYSTL_CHECK_EQ(s.bucket_count, t.bucket_count());
+		MYSTL_CHECK(s.load_factor == t.load_factor());
+		MYSTL_CHECK(s.max_load_factor == t.max_load_factor());
+		MYSTL_CHECK(s.load_factor <= s.max_load_factor);
+		MYSTL_CHECK(s.average_probe >= 1.0 && s.average_probe < 2.0);
+		MYSTL_CHECK(s.rehash_count > 0);
+		MYSTL_CHECK(s.node_bytes >= n * sizeof(int_table::node_type));
+		check_stats_consistent(s);
+
+		// 桶数不变时 rehash 次数不变，扩容之后加一
+		const size_t rehashes = s.rehash_count;
+		t.rehash(t.bucket_count());
+		MYSTL_CHECK_EQ(t.stats().rehash_count, rehashes);
+		t.rehash(t.bucket_count() * 4);
+		MYSTL_CHECK_EQ(t.stats().rehash_count, rehashes + 1);
+
+		// 链长为 k 的桶里查找平均比较 (k + 1) / 2 次
+		mystl::hashtable<int, constant_hash, mystl::equal_to<int>> bad(64);
+		const int m = 40;
+		for (int i = 0; i < m; i++) {
+			bad.insert_unique(i);
+		}
+		s = bad.stats();
+		MYSTL_CHECK_EQ(s.max_chain, static_cast<size_t>(m));
+		MYSTL_CHECK_EQ(s.empty_buckets, s.bucket_count - 1);
+		MYSTL_CHECK_EQ(s.chain_histogram[mystl::hashtable_stats::histogram_size - 1], 1u);
+		MYSTL_CHECK(s.average_probe == (m + 1) / 2.0);
+		check_stats_consistent(s);
+	}
+
+
+	// 查不到的 key 被过滤器挡掉时只算一次 hash，放过去查表会再算一次，用调用次数估计误判率
+	size_t filtered_hash_calls = 0;
+
+	struct counting_hash
+	{
+		size_t operator()(int key) const
+		{
+			++filtered_hash_calls;
+			return mystl::hash<int>()(key);
+		}
+	};
+
+	using filtered_type = mystl::filtered_set<int, counting_hash>;
+
+	void check_filtered(const filtered_type& s, int n, int step)
+	{
+		for (int i = 0; i < n; i++) {
+			const bool in = i % step == 0;
+			MYSTL_CHECK_EQ(s.count(i), in ? 1u : 0u);
+			MYSTL_CHECK_EQ(s.contains(i), in);
+			MYSTL_CHECK((s.find(i) != s.end()) == in);
+		}
+	}
+
+	void test_filtered_set()
+	{
+		const int n = 20000;
+		filtered_type s;
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK(s.insert(i));
+			MYSTL_CHECK(!s.insert(i));
+		}
+		MYSTL_CHECK_EQ(s.size(), static_cast<size_t>(n));
+		MYSTL_CHECK(s.filter_bytes() > 0);
+		check_filtered(s, n, 1);
+
+		// 误判率远小于 1%，这里只要求 2% 以内
+		const int misses = 100000;
+		filtered_hash_calls = 0;
+		for (int i = n; i < n + misses; i++) {
+			MYSTL_CHECK_EQ(s.count(i), 0u);
+		}
+		const size_t passed = filtered_hash_calls - misses;
+		MYSTL_CHECK(passed < static_cast<size_t>(misses / 50));
+
+		// 删掉的 key 留在过滤器里也不会被当成存在，删除过半之后重建
+		for (int i = 0; i < n; i++) {
+			if (i % 3 != 0) {
+				MYSTL_CHECK_EQ(s.erase(i), 1u);
+			}
+		}
+		MYSTL_CHECK_EQ(s.erase(n + 1), 0u);
+		MYSTL_CHECK_EQ(s.size(), static_cast<size_t>((n + 2) / 3));
+		check_filtered(s, n, 3);
+
+		// 拷贝和移动带着过滤器一起走
+		filtered_type copy(s);
+		check_filtered(copy, n, 3);
+		filtered_type moved(mystl::move(copy));
+		check_filtered(moved, n, 3);
+
+		// 扩容和缩小之后过滤器跟着重建
+		moved.reserve(4 * n);
+		check_filtered(moved, n, 3);
+		moved.rehash(1);
+		check_filtered(moved, n, 3);
+		moved.rebuild_filter();
+		check_filtered(moved, n, 3);
+
+		filtered_type other{ 1, 2, 3 };
+		other.swap(moved);
+		check_filtered(other, n, 3);
+		MYSTL_CHECK_EQ(moved.size(), 3u);
+		MYSTL_CHECK(moved.contains(2) && !moved.contains(4));
+
+		other.clear();
+		MYSTL_CHECK(other.empty());
+		MYSTL_CHECK(other.find(0) == other.end());
+		MYSTL_CHECK(other.insert(0));
+		MYSTL_CHECK(other.contains(0));
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_extract_after_range_insert);
+	MYSTL_RUN(test_extract_from_copy);
+	MYSTL_RUN(test_set_extract_after_range_insert);
+	MYSTL_RUN(test_merge_from_block);
+	MYSTL_RUN(test_block_memory_bounded);
+	MYSTL_RUN(test_copy_block_released);
+	MYSTL_RUN(test_parallel_build_unique);
+	MYSTL_RUN(test_parallel_build_multi);
+	MYSTL_RUN(test_parallel_rehash);
+	MYSTL_RUN(test_find_batch);
+	MYSTL_RUN(test_transparent_lookup);
+	MYSTL_RUN(test_stats);
+	MYSTL_RUN(test_filtered_set);
+	return 0;
+}
@@ -0,0 +1,160 @@
+// inline_hashtable 的测试：用很差的 hash 让桶里的槽放满、元素挂到溢出链上，
+// 随机插入、删除、rehash 之后和 std::unordered_map 比较；再检查被移走的表还能正常使用
+
+#include <random>
+#include <unordered_map>
+
+#include "inline_hashtable.h"
+#include "test_util.h"
+
+namespace {
+
+	// 只有 7 种 hash 值，每个桶都远远超过 bucket_slots 个元素
+	struct bad_hash
+	{
+		size_t operator()(int key) const
+		{
+			return static_cast<size_t>(key % 7 + 7);
+		}
+	};
+
+	using map_type = mystl::inline_hash_map<int, int, bad_hash>;
+
+	void check_equal(const map_type& m, const std::unordered_map<int, int>& ref)
+	{
+		MYSTL_CHECK_EQ(m.size(), ref.size());
+		size_t n = 0;
+		m.for_each([&](const map_type::value_type& v) {
+			auto it = ref.find(v.first);
+			MYSTL_CHECK(it != ref.end());
+			MYSTL_CHECK_EQ(v.second, it->second);
+			++n;
+		});
+		MYSTL_CHECK_EQ(n, ref.size());
+		for (auto& kv : ref) {
+			const map_type::value_type* p = m.find(kv.first);
+			MYSTL_CHECK(p != nullptr);
+			MYSTL_CHECK_EQ(p->second, kv.second);
+		}
+	}
+
+	// 删除的元素有时在桶的槽里，有时在溢出链上，两条路径都要走到
+	void test_overflow_chain_erase()
+	{
+		std::mt19937 rng(17);
+		map_type m(4);
+		std::unordered_map<int, int> ref;
+		for (int step = 0; step < 20000; step++) {
+			const int key = static_cast<int>(rng() % 300);
+			const unsigned op = rng() % 8;
+			if (op < 4) {
+				const bool inserted = ref.emplace(key, step).second;
+				auto res = op % 2 == 0 ? m.insert(map_type::value_type(key, step)) : m.emplace(key, step);
+				MYSTL_CHECK_EQ(res.second, inserted);
+				MYSTL_CHECK_EQ(res.first->second, ref[key]);
+			}
+			else if (op < 7) {
+				MYSTL_CHECK_EQ(m.erase(key), ref.erase(key));
+			}
+			else {
+				MYSTL_CHECK_EQ(m.count(key), ref.count(key));
+			}
+			if (step % 2000 == 0) {
+				check_equal(m, ref);
+			}
+		}
+		check_equal(m, ref);
+
+		// 每个桶从溢出链的尾部、中间、槽里依次删光
+		for (int key = 299; key >= 0; key -= 2) {
+			MYSTL_CHECK_EQ(m.erase(key), ref.erase(key));
+		}
+		check_equal(m, ref);
+		for (int key = 0; key < 300; key++) {
+			MYSTL_CHECK_EQ(m.erase(key), ref.erase(key));
+		}
+		MYSTL_CHECK(m.empty());
+		MYSTL_CHECK_EQ(m.erase(1), 0u);
+	}
+
+	// rehash 只按节点里存的 hash 重新挂，元素的地址不变
+	void test_rehash_keeps_elements()
+	{
+		using int_map = mystl::inline_hash_map<int, int>;
+		int_map m(4);
+		std::unordered_map<int, int> ref;
+		const int_map::value_type* first = nullptr;
+		for (int i = 0; i < 5000; i++) {
+			auto res = m.insert(int_map::value_type(i, i * 3));
+			ref[i] = i * 3;
+			if (i == 0) {
+				first = res.first;
+			}
+		}
+		MYSTL_CHECK(m.load_factor() <= m.max_load_factor());
+		const size_t before = m.bucket_count();
+		m.max_load_factor(4.0f);
+		m.rehash(10);
+		MYSTL_CHECK(m.bucket_count() < before);
+		// 负载因子是 4，放 20000 个元素要 5000 个桶
+		m.reserve(20000);
+		MYSTL_CHECK(m.bucket_count() >= 5000);
+		MYSTL_CHECK(m.find(0) == first);
+		MYSTL_CHECK_EQ(m.size(), ref.size());
+		for (auto& kv : ref) {
+			MYSTL_CHECK_EQ(m.find(kv.first)->second, kv.second);
+		}
+
+		map_type bad(4);
+		std::unordered_map<int, int> bad_ref;
+		for (int i = 0; i < 500; i++) {
+			bad.emplace(i, -i);
+			bad_ref[i] = -i;
+		}
+		bad.rehash(3);
+		check_equal(bad, bad_ref);
+		bad.rehash(1000);
+		check_equal(bad, bad_ref);
+	}
+
+	void test_moved_from()
+	{
+		mystl::inline_hash_set<int> a;
+		for (int i = 0; i < 100; i++) {
+			a.insert(i);
+		}
+		mystl::inline_hash_set<int> b(mystl::move(a));
+		MYSTL_CHECK_EQ(b.size(), 100u);
+		MYSTL_CHECK(a.empty());
+		MYSTL_CHECK_EQ(a.count(1), 0u);
+		MYSTL_CHECK(a.find(1) == nullptr);
+		MYSTL_CHECK_EQ(a.erase(1), 0u);
+		mystl::inline_hash_set<int> copy(a);
+		MYSTL_CHECK(copy.empty());
+		MYSTL_CHECK_EQ(copy.count(1), 0u);
+
+		// 移走之后还可以继续插入
+		MYSTL_CHECK(a.insert(7).second);
+		MYSTL_CHECK(a.emplace(8).second);
+		MYSTL_CHECK_EQ(a.count(7), 1u);
+		MYSTL_CHECK_EQ(a.size(), 2u);
+
+		mystl::inline_hash_set<int> c;
+		c = mystl::move(b);
+		MYSTL_CHECK_EQ(c.size(), 100u);
+		MYSTL_CHECK_EQ(b.count(50), 0u);
+		b.clear();
+		b.rehash(10);
+		MYSTL_CHECK(b.insert(50).second);
+		MYSTL_CHECK_EQ(b.count(50), 1u);
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_overflow_chain_erase);
+	MYSTL_RUN(test_rehash_keeps_elements);
+	MYSTL_RUN(test_moved_from);
+	return 0;
+}
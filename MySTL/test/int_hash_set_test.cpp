@@ -0,0 +1,215 @@
+// int_hash_set 的测试：各种宽度的整数随机插入、删除后和 std::unordered_set 比较，
+// 包括正好等于空槽值和删除标记值的 key，以及删除标记被后面的插入复用
+// CMake 里同一份代码还会用 -mavx2 再编译一次，4 字节和 8 字节的 key 走 AVX2 的比较
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "int_hash_set.h"
+#include "test_util.h"
+
+namespace {
+
+	// 所有 key 都从第 0 组开始探测，槽的位置完全由插入顺序决定
+	template <class T>
+	struct zero_hash
+	{
+		size_t operator()(T) const
+		{
+			return 0;
+		}
+	};
+
+	template <class Set, class T>
+	void check_equal(const Set& s, const std::unordered_set<T>& ref)
+	{
+		MYSTL_CHECK_EQ(s.size(), ref.size());
+		size_t n = 0;
+		s.for_each([&](T key) {
+			MYSTL_CHECK(ref.count(key) == 1);
+			++n;
+		});
+		MYSTL_CHECK_EQ(n, ref.size());
+		for (T key : ref) {
+			MYSTL_CHECK(s.contains(key));
+		}
+	}
+
+	template <class T>
+	void random_against_std_set(unsigned seed)
+	{
+		using set_type = mystl::int_hash_set<T>;
+		std::mt19937_64 rng(seed);
+		set_type s;
+		std::unordered_set<T> ref;
+		for (int step = 0; step < 30000; step++) {
+			const unsigned r = static_cast<unsigned>(rng() % 100);
+			T key;
+			if (r < 3) {
+				key = set_type::empty_key;
+			}
+			else if (r < 6) {
+				key = set_type::deleted_key;
+			}
+			else {
+				key = static_cast<T>(rng() % 2000);
+			}
+			const unsigned op = static_cast<unsigned>(rng() % 3);
+			if (op == 0) {
+				MYSTL_CHECK_EQ(s.insert(key), ref.insert(key).second);
+			}
+			else if (op == 1) {
+				MYSTL_CHECK_EQ(s.erase(key), ref.erase(key));
+			}
+			else {
+				MYSTL_CHECK_EQ(s.count(key), ref.count(key));
+			}
+			if (step % 5000 == 0) {
+				check_equal(s, ref);
+			}
+		}
+		check_equal(s, ref);
+		MYSTL_CHECK(s.load_factor() <= 0.875f);
+
+		set_type copy(s);
+		check_equal(copy, ref);
+		s.clear();
+		MYSTL_CHECK(s.empty());
+		MYSTL_CHECK(!s.contains(set_type::empty_key));
+		MYSTL_CHECK(!s.contains(set_type::deleted_key));
+		check_equal(copy, ref);
+	}
+
+	void test_random_all_widths()
+	{
+		random_against_std_set<std::uint32_t>(1);
+		random_against_std_set<std::int32_t>(2);
+		random_against_std_set<std::uint64_t>(3);
+		random_against_std_set<std::int64_t>(4);
+		random_against_std_set<std::uint16_t>(5);
+	}
+
+	// 空槽值和删除标记值本身作为 key 时只记标志位，不占槽，也不会被当成空槽或删除标记
+	template <class T>
+	void check_special_keys()
+	{
+		using set_type = mystl::int_hash_set<T>;
+		set_type s;
+		MYSTL_CHECK(!s.contains(set_type::empty_key));
+		MYSTL_CHECK_EQ(s.erase(set_type::deleted_key), 0u);
+		MYSTL_CHECK(s.insert(set_type::empty_key));
+		MYSTL_CHECK(!s.insert(set_type::empty_key));
+		MYSTL_CHECK(s.insert(set_type::deleted_key));
+		MYSTL_CHECK_EQ(s.size(), 2u);
+		MYSTL_CHECK_EQ(s.capacity(), 0u);
+		for (T i = 0; i < 100; i++) {
+			s.insert(i);
+		}
+		MYSTL_CHECK_EQ(s.size(), 102u);
+		MYSTL_CHECK(s.contains(set_type::empty_key));
+		MYSTL_CHECK(s.contains(set_type::deleted_key));
+		MYSTL_CHECK_EQ(s.erase(set_type::empty_key), 1u);
+		MYSTL_CHECK(!s.contains(set_type::empty_key));
+		MYSTL_CHECK(s.contains(set_type::deleted_key));
+		for (T i = 0; i < 100; i++) {
+			MYSTL_CHECK(s.contains(i));
+		}
+		MYSTL_CHECK_EQ(s.size(), 101u);
+	}
+
+	void test_special_keys()
+	{
+		check_special_keys<std::uint32_t>();
+		check_special_keys<std::int32_t>();
+		check_special_keys<std::uint64_t>();
+		check_special_keys<std::int64_t>();
+		check_special_keys<unsigned char>();
+	}
+
+	template <class T>
+	std::vector<T> slot_order(const mystl::int_hash_set<T, zero_hash<T>>& s)
+	{
+		std::vector<T> keys;
+		s.for_each([&keys](T key) { keys.push_back(key); });
+		return keys;
+	}
+
+	// 组满的时候删除只能留删除标记，之后的插入要复用它，而不是占一个新的空槽
+	template <class T>
+	void check_tombstone_reuse()
+	{
+		using set_type = mystl::int_hash_set<T, zero_hash<T>>;
+		const size_t g = set_type::group_size;
+		set_type s(2 * g);
+		const size_t groups = s.capacity() / g;
+		MYSTL_CHECK(groups >= 3);
+		for (T i = 0; i < static_cast<T>(2 * g); i++) {
+			MYSTL_CHECK(s.insert(i));
+		}
+
+		// 第 0 组是满的，删掉 3 留下删除标记，探测路径没断，第 1 组的 key 还能找到
+		MYSTL_CHECK_EQ(s.erase(3), 1u);
+		MYSTL_CHECK(!s.contains(3));
+		for (T i = static_cast<T>(g); i < static_cast<T>(2 * g); i++) {
+			MYSTL_CHECK(s.contains(i));
+		}
+
+		// 新 key 放在原来 3 的位置上
+		MYSTL_CHECK(s.insert(100));
+		std::vector<T> keys = slot_order(s);
+		MYSTL_CHECK_EQ(keys.size(), 2 * g);
+		MYSTL_CHECK_EQ(keys[3], static_cast<T>(100));
+
+		// 已经存在的 key 不能因为路径上有删除标记就被插入第二次
+		MYSTL_CHECK_EQ(s.erase(1), 1u);
+		MYSTL_CHECK(!s.insert(static_cast<T>(g + 2)));
+		MYSTL_CHECK_EQ(s.size(), 2 * g - 1);
+		MYSTL_CHECK(s.insert(1));
+		keys = slot_order(s);
+		MYSTL_CHECK_EQ(keys[1], static_cast<T>(1));
+
+		// 反复删除再插入不会让表变大
+		const size_t cap = s.capacity();
+		for (int round = 0; round < 1000; round++) {
+			const T victim = static_cast<T>(round % (2 * g));
+			const T other = static_cast<T>(1000 + round);
+			if (s.erase(victim) == 1) {
+				MYSTL_CHECK(s.insert(other));
+				MYSTL_CHECK_EQ(s.erase(other), 1u);
+				MYSTL_CHECK(s.insert(victim));
+			}
+		}
+		MYSTL_CHECK_EQ(s.capacity(), cap);
+		MYSTL_CHECK_EQ(s.size(), 2 * g);
+
+		// 第 2 组有空槽，删除直接置空
+		MYSTL_CHECK(s.insert(200));
+		MYSTL_CHECK_EQ(s.erase(200), 1u);
+		MYSTL_CHECK(s.insert(201));
+		keys = slot_order(s);
+		MYSTL_CHECK_EQ(keys.back(), static_cast<T>(201));
+		MYSTL_CHECK_EQ(keys.size(), 2 * g + 1);
+	}
+
+	void test_tombstone_reuse()
+	{
+		check_tombstone_reuse<std::uint32_t>();
+		check_tombstone_reuse<std::int64_t>();
+		check_tombstone_reuse<std::uint16_t>();
+	}
+
+}
+
+int main()
+{
+#if defined(__AVX2__)
+	std::printf("AVX2 match enabled\n");
+#endif
+	MYSTL_RUN(test_random_all_widths);
+	MYSTL_RUN(test_special_keys);
+	MYSTL_RUN(test_tombstone_reuse);
+	return 0;
+}
@@ -0,0 +1,120 @@
+// interval_map 的测试：随机插入、删除、批量构建之后，重叠查询和暴力扫描的结果逐个比较
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "interval_map.h"
+#include "test_util.h"
+
+namespace {
+
+	using map_type = mystl::interval_map<int, int>;
+	using interval_type = map_type::interval_type;
+
+	bool overlaps(const interval_type& iv, int a, int b)
+	{
+		return !(b < iv.low) && !(iv.high < a);
+	}
+
+	// 按 (low, high) 的顺序，相同区间之间的顺序不做要求，所以只比较区间
+	void check_query(map_type& m, int a, int b)
+	{
+		std::vector<interval_type> expect;
+		for (auto it = m.begin(); it != m.end(); ++it) {
+			if (overlaps(it->first, a, b)) {
+				expect.push_back(it->first);
+			}
+		}
+		std::vector<interval_type> got;
+		const size_t n = m.for_each_overlapping(a, b, [&got](map_type::value_type& v) { got.push_back(v.first); });
+		MYSTL_CHECK_EQ(n, got.size());
+		MYSTL_CHECK_EQ(got.size(), expect.size());
+		for (size_t i = 0; i < got.size(); i++) {
+			MYSTL_CHECK(got[i] == expect[i]);
+		}
+
+		const map_type& cm = m;
+		size_t cn = 0;
+		cm.for_each_overlapping(a, b, [&cn](const map_type::value_type&) { ++cn; });
+		MYSTL_CHECK_EQ(cn, expect.size());
+
+		auto it = m.find_overlapping(a, b);
+		if (expect.empty()) {
+			MYSTL_CHECK(it == m.end());
+		}
+		else {
+			MYSTL_CHECK(it != m.end());
+			MYSTL_CHECK(overlaps(it->first, a, b));
+		}
+	}
+
+	interval_type random_interval(std::mt19937& rng, int range, int max_len)
+	{
+		const int low = static_cast<int>(rng() % range);
+		return interval_type{ low, low + static_cast<int>(rng() % max_len) };
+	}
+
+	void test_random_against_scan()
+	{
+		std::mt19937 rng(11);
+		map_type m;
+		for (int step = 0; step < 3000; step++) {
+			const unsigned op = rng() % 10;
+			if (op < 6) {
+				// 长短区间混在一起，让子树的最大右端点真的起作用
+				const interval_type iv = random_interval(rng, 1000, op == 0 ? 400 : 20);
+				m.insert(iv.low, iv.high, step);
+			}
+			else if (op < 8 && !m.empty()) {
+				auto it = m.begin();
+				mystl::advance(it, static_cast<long>(rng() % m.size()));
+				m.erase(it);
+			}
+			else if (op == 8) {
+				const interval_type iv = random_interval(rng, 1000, 20);
+				m.erase(iv);
+			}
+			else {
+				const interval_type q = random_interval(rng, 1100, 60);
+				check_query(m, q.low - 50, q.high);
+				check_query(m, q.low, q.low);
+			}
+		}
+		for (int a = -10; a < 1500; a += 37) {
+			check_query(m, a, a + 25);
+		}
+	}
+
+	void test_assign_sorted()
+	{
+		std::mt19937 rng(5);
+		std::vector<mystl::pair<interval_type, int>> items;
+		for (int i = 0; i < 2000; i++) {
+			items.push_back(mystl::pair<interval_type, int>(random_interval(rng, 10000, i % 10 == 0 ? 3000 : 30), i));
+		}
+		std::sort(items.begin(), items.end(),
+			[](const mystl::pair<interval_type, int>& l, const mystl::pair<interval_type, int>& r) {
+				return mystl::interval_less<int>()(l.first, r.first);
+			});
+		map_type m;
+		m.assign_sorted(items.data(), items.data() + items.size());
+		MYSTL_CHECK_EQ(m.size(), items.size());
+		for (int a = 0; a < 10000; a += 97) {
+			check_query(m, a, a + static_cast<int>(rng() % 200));
+		}
+
+		// 不和任何区间相交
+		check_query(m, -100, -1);
+		check_query(m, 20000, 30000);
+		MYSTL_CHECK_EQ(m.for_each_containing(-5, [](map_type::value_type&) {}), 0u);
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_random_against_scan);
+	MYSTL_RUN(test_assign_sorted);
+	return 0;
+}
@@ -0,0 +1,147 @@
+// lru_cache 的测试：lru_policy 严格按最近使用的顺序淘汰，clock_policy 给有引用位的元素第二次机会，
+// 命中、未命中、淘汰的计数，以及构造新值抛异常时不会先淘汰掉旧元素
+
+#include <stdexcept>
+#include <string>
+
+#include "lru_cache.h"
+#include "test_util.h"
+
+namespace {
+
+	void test_lru_order()
+	{
+		mystl::lru_cache<int, std::string> c(3);
+		MYSTL_CHECK(c.put(1, std::string("a")));
+		MYSTL_CHECK(c.put(2, std::string("b")));
+		MYSTL_CHECK(c.put(3, std::string("c")));
+		MYSTL_CHECK_EQ(c.size(), 3u);
+
+		// 1 被用过，最久没用的是 2
+		MYSTL_CHECK(*c.get(1) == "a");
+		MYSTL_CHECK(c.put(4, std::string("d")));
+		MYSTL_CHECK(!c.contains(2));
+		MYSTL_CHECK(c.contains(1) && c.contains(3) && c.contains(4));
+
+		// 更新已有的 key 也算一次使用，不淘汰
+		MYSTL_CHECK(!c.put(3, std::string("cc")));
+		MYSTL_CHECK_EQ(c.size(), 3u);
+		// peek 不影响顺序，最久没用的仍然是 1
+		MYSTL_CHECK(*c.peek(1) == "a");
+		MYSTL_CHECK(c.put(5, std::string("e")));
+		MYSTL_CHECK(!c.contains(1));
+		MYSTL_CHECK(*c.peek(3) == "cc");
+
+		MYSTL_CHECK_EQ(c.erase(4), 1u);
+		MYSTL_CHECK_EQ(c.erase(4), 0u);
+		MYSTL_CHECK(c.put(6, std::string("f")));
+		MYSTL_CHECK_EQ(c.size(), 3u);
+		MYSTL_CHECK_EQ(c.evictions(), 2u);
+	}
+
+	void test_clock_second_chance()
+	{
+		mystl::clock_cache<int, int> c(4);
+		for (int i = 1; i <= 4; i++) {
+			c.put(i, i * 10);
+		}
+		// 1 和 3 有引用位，淘汰指针从最久的 1 开始，跳过 1，淘汰 2
+		MYSTL_CHECK_EQ(*c.get(1), 10);
+		MYSTL_CHECK_EQ(*c.get(3), 30);
+		c.put(5, 50);
+		MYSTL_CHECK(!c.contains(2));
+		MYSTL_CHECK(c.contains(1) && c.contains(3) && c.contains(4) && c.contains(5));
+
+		// 1 的引用位已经清掉了，指针接着往前走：3 的引用位被清掉，淘汰 4
+		c.put(6, 60);
+		MYSTL_CHECK(!c.contains(4));
+		MYSTL_CHECK(c.contains(1) && c.contains(3));
+
+		// 所有元素都有引用位时绕一圈全清掉，再淘汰指针停下的地方
+		for (int k : { 1, 3, 5, 6 }) {
+			MYSTL_CHECK(c.get(k) != nullptr);
+		}
+		c.put(7, 70);
+		MYSTL_CHECK_EQ(c.size(), 4u);
+		MYSTL_CHECK_EQ(c.evictions(), 3u);
+		int left = 0;
+		for (int k : { 1, 3, 5, 6 }) {
+			left += c.contains(k);
+		}
+		MYSTL_CHECK_EQ(left, 3);
+	}
+
+	void test_counters()
+	{
+		mystl::lru_cache<int, int> c(2);
+		c.put(1, 1);
+		c.put(2, 2);
+		MYSTL_CHECK(c.get(1) != nullptr);
+		MYSTL_CHECK(c.get(3) == nullptr);
+		MYSTL_CHECK(c.get(2) != nullptr);
+		MYSTL_CHECK(c.get(4) == nullptr);
+		// peek 和 contains 不计数
+		c.peek(1);
+		c.contains(9);
+		MYSTL_CHECK_EQ(c.hits(), 2u);
+		MYSTL_CHECK_EQ(c.misses(), 2u);
+		MYSTL_CHECK(c.hit_ratio() == 0.5f);
+		c.put(3, 3);
+		c.put(4, 4);
+		MYSTL_CHECK_EQ(c.evictions(), 2u);
+		c.reset_stats();
+		MYSTL_CHECK_EQ(c.hits(), 0u);
+		MYSTL_CHECK_EQ(c.misses(), 0u);
+		MYSTL_CHECK_EQ(c.evictions(), 0u);
+		MYSTL_CHECK(c.hit_ratio() == 0.0f);
+		c.clear();
+		MYSTL_CHECK(c.empty());
+		MYSTL_CHECK(c.get(3) == nullptr);
+	}
+
+	struct throw_on_copy
+	{
+		int value;
+
+		explicit throw_on_copy(int v) : value(v) {}
+
+		throw_on_copy(const throw_on_copy& rhs) : value(rhs.value)
+		{
+			if (value < 0) {
+				throw std::runtime_error("copy");
+			}
+		}
+
+		throw_on_copy& operator=(const throw_on_copy&) = default;
+	};
+
+	// 满的时候插入新 key，值构造失败不能先把旧元素淘汰掉
+	void test_put_throw_keeps_contents()
+	{
+		mystl::lru_cache<int, throw_on_copy> c(2);
+		c.put(1, throw_on_copy(1));
+		c.put(2, throw_on_copy(2));
+		bool thrown = false;
+		try {
+			const throw_on_copy bad(-1);
+			c.put(3, bad);
+		}
+		catch (const std::runtime_error&) {
+			thrown = true;
+		}
+		MYSTL_CHECK(thrown);
+		MYSTL_CHECK_EQ(c.size(), 2u);
+		MYSTL_CHECK(c.contains(1) && c.contains(2) && !c.contains(3));
+		MYSTL_CHECK_EQ(c.evictions(), 0u);
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_lru_order);
+	MYSTL_RUN(test_clock_second_chance);
+	MYSTL_RUN(test_counters);
+	MYSTL_RUN(test_put_throw_keeps_contents);
+	return 0;
+}
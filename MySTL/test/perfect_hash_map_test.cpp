@@ -0,0 +1,79 @@
+// perfect_hash_map 的测试：编译期构造和查找 (static_assert)，查不到的 key，
+// 以及运行时用 string_ref(ptr, len) 查找不以 '\0' 结尾的字符串
+
+#include <stdexcept>
+#include <string>
+
+#include "perfect_hash_map.h"
+#include "test_util.h"
+
+namespace {
+
+	constexpr auto fields = mystl::make_perfect_hash_map<mystl::string_ref, int>({
+		{ "host", 1 }, { "port", 2 }, { "path", 3 }, { "query", 4 }, { "fragment", 5 },
+		{ "user", 6 }, { "password", 7 }, { "scheme", 8 }, { "a key longer than eight bytes", 9 } });
+
+	static_assert(fields.size() == 9, "");
+	static_assert(*fields.find("host") == 1, "");
+	static_assert(*fields.find("port") == 2, "");
+	static_assert(*fields.find("fragment") == 5, "");
+	static_assert(*fields.find("a key longer than eight bytes") == 9, "");
+	static_assert(fields.at("scheme") == 8, "");
+	static_assert(fields.find("hos") == nullptr, "");
+	static_assert(fields.find("") == nullptr, "");
+	static_assert(!fields.contains("ports"), "");
+	static_assert(fields.count("path") == 1, "");
+
+	constexpr auto codes = mystl::make_perfect_hash_map<int, char>({
+		{ 200, 'o' }, { 404, 'n' }, { 500, 'e' }, { -1, 'x' }, { 0, 'z' } });
+
+	static_assert(*codes.find(404) == 'n', "");
+	static_assert(*codes.find(-1) == 'x', "");
+	static_assert(codes.find(201) == nullptr, "");
+
+	void test_runtime_lookup()
+	{
+		// 从一个更长的缓冲区里切出 key，后面不是 '\0'
+		const std::string buf = "GET /path?query#fragment port=80";
+		MYSTL_CHECK(fields.find(mystl::string_ref(buf.data() + 5, 4)) != nullptr);
+		MYSTL_CHECK_EQ(*fields.find(mystl::string_ref(buf.data() + 5, 4)), 3);
+		MYSTL_CHECK_EQ(*fields.find(mystl::string_ref(buf.data() + 10, 5)), 4);
+		MYSTL_CHECK_EQ(*fields.find(mystl::string_ref(buf.data() + 16, 8)), 5);
+		MYSTL_CHECK_EQ(fields.at(mystl::string_ref(buf.data() + 25, 4)), 2);
+
+		// 前缀、多一个字符、大小写不同都查不到
+		MYSTL_CHECK(fields.find(mystl::string_ref(buf.data() + 5, 3)) == nullptr);
+		MYSTL_CHECK(fields.find(mystl::string_ref(buf.data() + 5, 5)) == nullptr);
+		MYSTL_CHECK(!fields.contains("Host"));
+		MYSTL_CHECK_EQ(fields.count(mystl::string_ref(buf.data(), 3)), 0u);
+
+		bool thrown = false;
+		try {
+			fields.at("missing");
+		}
+		catch (const std::out_of_range&) {
+			thrown = true;
+		}
+		MYSTL_CHECK(thrown);
+
+		// 遍历的顺序就是构造时给的顺序
+		int expect = 1;
+		for (const auto& e : fields) {
+			MYSTL_CHECK_EQ(e.value, expect++);
+			MYSTL_CHECK(*fields.find(e.key) == e.value);
+		}
+
+		for (int code = -5; code < 600; code++) {
+			const char* p = codes.find(code);
+			const bool known = code == 200 || code == 404 || code == 500 || code == -1 || code == 0;
+			MYSTL_CHECK_EQ(p != nullptr, known);
+		}
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_runtime_lookup);
+	return 0;
+}
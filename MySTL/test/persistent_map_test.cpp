@@ -0,0 +1,155 @@
+// persistent_map 的测试：随机插入、删除、insert_or_assign 之后和 std::map 逐个比较，
+// 并检查修改之前拷贝出来的快照内容一直不变
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "persistent_map.h"
+#include "test_util.h"
+
+namespace {
+
+	using map_type = mystl::persistent_map<int, std::string>;
+	using ref_type = std::map<int, std::string>;
+
+	void check_equal(const map_type& m, const ref_type& ref)
+	{
+		MYSTL_CHECK_EQ(m.size(), ref.size());
+		MYSTL_CHECK_EQ(m.empty(), ref.empty());
+		auto it = ref.begin();
+		m.for_each([&](const map_type::value_type& v) {
+			MYSTL_CHECK(it != ref.end());
+			MYSTL_CHECK_EQ(v.first, it->first);
+			MYSTL_CHECK(v.second == it->second);
+			++it;
+		});
+		MYSTL_CHECK(it == ref.end());
+	}
+
+	void test_random_against_std_map()
+	{
+		std::mt19937 rng(3);
+		map_type m;
+		ref_type ref;
+		for (int step = 0; step < 20000; step++) {
+			const int key = static_cast<int>(rng() % 500);
+			const std::string value = std::to_string(step);
+			const unsigned op = rng() % 4;
+			if (op == 0) {
+				const bool inserted = ref.emplace(key, value).second;
+				MYSTL_CHECK_EQ(m.insert(key, value), inserted);
+			}
+			else if (op == 1) {
+				const bool inserted = ref.find(key) == ref.end();
+				ref[key] = value;
+				MYSTL_CHECK_EQ(m.insert_or_assign(key, value), inserted);
+			}
+			else if (op == 2) {
+				MYSTL_CHECK_EQ(m.erase(key), ref.erase(key));
+			}
+			else {
+				const map_type::value_type* p = m.find(key);
+				auto it = ref.find(key);
+				MYSTL_CHECK_EQ(p != nullptr, it != ref.end());
+				if (p != nullptr) {
+					MYSTL_CHECK(p->second == it->second);
+				}
+				MYSTL_CHECK_EQ(m.count(key), ref.count(key));
+
+				auto lb = ref.lower_bound(key);
+				const map_type::value_type* mlb = m.lower_bound(key);
+				MYSTL_CHECK_EQ(mlb != nullptr, lb != ref.end());
+				if (mlb != nullptr) {
+					MYSTL_CHECK_EQ(mlb->first, lb->first);
+				}
+				auto ub = ref.upper_bound(key);
+				const map_type::value_type* mub = m.upper_bound(key);
+				MYSTL_CHECK_EQ(mub != nullptr, ub != ref.end());
+				if (mub != nullptr) {
+					MYSTL_CHECK_EQ(mub->first, ub->first);
+				}
+			}
+			if (step % 1000 == 0) {
+				check_equal(m, ref);
+			}
+		}
+		check_equal(m, ref);
+
+		// [100, 200) 的范围遍历
+		std::vector<int> got;
+		m.for_each_range(100, 200, [&got](const map_type::value_type& v) { got.push_back(v.first); });
+		std::vector<int> expect;
+		for (auto it = ref.lower_bound(100); it != ref.end() && it->first < 200; ++it) {
+			expect.push_back(it->first);
+		}
+		MYSTL_CHECK(got == expect);
+
+		while (!ref.empty()) {
+			MYSTL_CHECK_EQ(m.erase(ref.begin()->first), 1u);
+			ref.erase(ref.begin());
+		}
+		MYSTL_CHECK(m.empty());
+		MYSTL_CHECK_EQ(m.erase(1), 0u);
+	}
+
+	// 每隔一段拷贝一个快照，后面不管怎么改，快照都要和拷贝时的内容一样
+	void test_snapshot_immutable()
+	{
+		std::mt19937 rng(8);
+		map_type m;
+		ref_type ref;
+		std::vector<map_type> snapshots;
+		std::vector<ref_type> expected;
+		for (int step = 0; step < 5000; step++) {
+			const int key = static_cast<int>(rng() % 200);
+			const unsigned op = rng() % 3;
+			if (op == 0) {
+				m.insert(key, std::to_string(step));
+				ref.emplace(key, std::to_string(step));
+			}
+			else if (op == 1) {
+				m.insert_or_assign(key, std::to_string(-step));
+				ref[key] = std::to_string(-step);
+			}
+			else {
+				m.erase(key);
+				ref.erase(key);
+			}
+			if (step % 250 == 0) {
+				snapshots.push_back(m);
+				expected.push_back(ref);
+			}
+		}
+		check_equal(m, ref);
+		for (size_t i = 0; i < snapshots.size(); i++) {
+			check_equal(snapshots[i], expected[i]);
+		}
+
+		// 快照拿到的元素指针在原对象清空之后仍然有效
+		map_type snap = m;
+		const map_type::value_type* p = snap.find(ref.begin()->first);
+		MYSTL_CHECK(p != nullptr);
+		m.clear();
+		MYSTL_CHECK(m.empty());
+		MYSTL_CHECK(p->second == ref.begin()->second);
+		check_equal(snap, ref);
+
+		// 修改快照也不影响原来的版本
+		map_type copy = snap;
+		copy.insert_or_assign(ref.begin()->first, std::string("changed"));
+		copy.erase(ref.rbegin()->first);
+		check_equal(snap, ref);
+		MYSTL_CHECK(copy.at(ref.begin()->first) == "changed");
+		MYSTL_CHECK_EQ(copy.size() + 1, snap.size());
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_random_against_std_map);
+	MYSTL_RUN(test_snapshot_immutable);
+	return 0;
+}
@@ -0,0 +1,522 @@
+// rb_tree 的测试：拷贝、assign_sorted_* 和左值插入都不能动参数，
+// 插入、删除、split / join、extract 之后和 std::multiset 逐个比较，
+// 以及并集、交集和 std::set_union / std::merge / std::set_intersection 比较并检查红黑树的性质
+// 最后是异构查找和 for_each_range 的区间扫描
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rb_tree.h"
+#include "vector.h"
+#include "test_util.h"
+
+namespace {
+
+	using tree_type = mystl::rb_tree<std::string, mystl::less<std::string>>;
+	using order_tree = mystl::rb_tree<int, mystl::less<int>, true>;
+
+	std::string key_of(int i)
+	{
+		// 补零让字典序和数值顺序一致
+		std::string s = std::to_string(i);
+		return "a fairly long key that does not fit in SSO #" + std::string(8 - s.size(), '0') + s;
+	}
+
+	template <class Tree, class Std>
+	void check_same(const Tree& t, const Std& s)
+	{
+		MYSTL_CHECK_EQ(t.size(), s.size());
+		auto a = t.begin();
+		auto b = s.begin();
+		for (; b != s.end(); ++a, ++b) {
+			MYSTL_CHECK(a != t.end());
+			MYSTL_CHECK(*a == *b);
+		}
+		MYSTL_CHECK(a == t.end());
+	}
+
+	void test_copy_keeps_source()
+	{
+		const int n = 500;
+		tree_type t;
+		for (int i = 0; i < n; i++) {
+			t.emplace_unique(key_of(i));
+		}
+		tree_type c(t);
+		tree_type d;
+		d.emplace_unique(key_of(n));
+		d = t;
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK(t.find(key_of(i)) != t.end());
+			MYSTL_CHECK(c.find(key_of(i)) != c.end());
+			MYSTL_CHECK(d.find(key_of(i)) != d.end());
+		}
+		MYSTL_CHECK_EQ(t.size(), static_cast<size_t>(n));
+		MYSTL_CHECK_EQ(c.size(), static_cast<size_t>(n));
+		MYSTL_CHECK_EQ(d.size(), static_cast<size_t>(n));
+	}
+
+	void test_assign_sorted_keeps_input()
+	{
+		mystl::vector<std::string> keys;
+		for (int i = 0; i < 300; i++) {
+			keys.push_back(key_of(i / 3));
+		}
+		const mystl::vector<std::string> saved(keys);
+
+		tree_type u;
+		u.assign_sorted_unique(keys.begin(), keys.end());
+		MYSTL_CHECK(keys == saved);
+		check_same(u, std::set<std::string>(saved.begin(), saved.end()));
+
+		tree_type m;
+		m.assign_sorted_multi(keys.begin(), keys.end());
+		MYSTL_CHECK(keys == saved);
+		check_same(m, std::multiset<std::string>(saved.begin(), saved.end()));
+	}
+
+	void test_insert_lvalue()
+	{
+		tree_type t;
+		const std::string a = key_of(1);
+		std::string b = key_of(2);
+		MYSTL_CHECK(t.insert_unique(a).second);
+		MYSTL_CHECK(t.insert_unique(b).second);
+		MYSTL_CHECK(!t.insert_unique(b).second);
+		t.insert_unique(t.end(), key_of(3));
+		t.insert_multi(b);
+		MYSTL_CHECK(a == key_of(1));
+		MYSTL_CHECK(b == key_of(2));
+		MYSTL_CHECK_EQ(t.size(), 4u);
+		MYSTL_CHECK_EQ(t.count_multi(b), 2u);
+
+		mystl::vector<std::string> more;
+		for (int i = 0; i < 10; i++) {
+			more.push_back(key_of(i));
+		}
+		t.insert_unique(more.begin(), more.end());
+		MYSTL_CHECK_EQ(t.size(), 11u);
+		MYSTL_CHECK(more[5] == key_of(5));
+	}
+
+	// 随机的插入、删除、区间删除、extract 和 split / join，每一步之后和 std::multiset 比较
+	void test_random_against_std()
+	{
+		std::mt19937 rng(42);
+		order_tree t;
+		std::multiset<int> s;
+		for (int step = 0; step < 4000; step++) {
+			const int key = static_cast<int>(rng() % 512);
+			switch (rng() % 6) {
+			case 0:
+				MYSTL_CHECK_EQ(t.insert_unique(key).second, s.count(key) == 0);
+				if (s.count(key) == 0) {
+					s.insert(key);
+				}
+				break;
+			case 1:
+				t.insert_multi(key);
+				s.insert(key);
+				break;
+			case 2:
+				MYSTL_CHECK_EQ(t.erase_multi(key), s.erase(key));
+				break;
+			case 3: {
+				const int hi = key + static_cast<int>(rng() % 32);
+				t.erase(t.lower_bound(key), t.lower_bound(hi));
+				s.erase(s.lower_bound(key), s.lower_bound(hi));
+				break;
+			}
+			case 4: {
+				auto nh = t.extract(key);
+				auto it = s.find(key);
+				MYSTL_CHECK_EQ(nh.empty(), it == s.end());
+				if (!nh.empty()) {
+					s.erase(it);
+				}
+				break;
+			}
+			default: {
+				order_tree right = t.split(key);
+				MYSTL_CHECK(right.empty() || *right.begin() >= key);
+				MYSTL_CHECK(t.empty() || *t.rbegin() < key);
+				t.join(right);
+				MYSTL_CHECK(right.empty());
+				break;
+			}
+			}
+			if (step % 64 == 0) {
+				check_same(t, s);
+				MYSTL_CHECK_EQ(t.rank(key), static_cast<size_t>(std::distance(s.begin(), s.lower_bound(key))));
+			}
+		}
+		check_same(t, s);
+		size_t i = 0;
+		for (int v : s) {
+			MYSTL_CHECK_EQ(*t.select(i++), v);
+		}
+	}
+
+	template <class BasePtr>
+	void check_size_field(BasePtr, size_t, std::false_type)
+	{
+	}
+
+	template <class BasePtr>
+	void check_size_field(BasePtr x, size_t n, std::true_type)
+	{
+		MYSTL_CHECK_EQ(x->size, n);
+	}
+
+	// 返回子树的黑高 (空节点算 1)，同时检查父指针、红节点没有红孩子、左右黑高相等，
+	// OrderStat 的树还检查每个节点存的子树大小
+	template <bool OrderStat, class BasePtr>
+	size_t check_subtree(BasePtr x, BasePtr parent, size_t& count)
+	{
+		if (x == nullptr) {
+			count = 0;
+			return 1;
+		}
+		MYSTL_CHECK(x->get_parent() == parent);
+		if (mystl::rb_tree_is_red(x)) {
+			MYSTL_CHECK(x->left == nullptr || mystl::rb_tree_is_black(x->left));
+			MYSTL_CHECK(x->right == nullptr || mystl::rb_tree_is_black(x->right));
+		}
+		size_t lc, rc;
+		const size_t lh = check_subtree<OrderStat>(x->left, x, lc);
+		const size_t rh = check_subtree<OrderStat>(x->right, x, rc);
+		MYSTL_CHECK_EQ(lh, rh);
+		count = lc + rc + 1;
+		check_size_field(x, count, std::integral_constant<bool, OrderStat>());
+		return lh + (mystl::rb_tree_is_black(x) ? 1 : 0);
+	}
+
+	template <class T, class Compare, bool OrderStat>
+	void check_rb(const mystl::rb_tree<T, Compare, OrderStat>& t)
+	{
+		// header 的 parent 是根，leftmost / rightmost 是最小和最大节点
+		auto header = t.end().node;
+		auto root = header->get_parent();
+		size_t count = 0;
+		if (root != nullptr) {
+			MYSTL_CHECK(mystl::rb_tree_is_black(root));
+			check_subtree<OrderStat>(root, header, count);
+			MYSTL_CHECK(header->left == mystl::rb_tree_min(root));
+			MYSTL_CHECK(header->right == mystl::rb_tree_max(root));
+		}
+		MYSTL_CHECK_EQ(count, t.size());
+		MYSTL_CHECK(std::is_sorted(t.begin(), t.end(), [](const T& a, const T& b) { return Compare()(
+			mystl::rb_tree_value_traits<T>::get_key(a), mystl::rb_tree_value_traits<T>::get_key(b)); }));
+	}
+
+	std::vector<int> random_keys(std::mt19937& rng, size_t n, int range)
+	{
+		std::vector<int> keys(n);
+		for (size_t i = 0; i < n; i++) {
+			keys[i] = static_cast<int>(rng() % range);
+		}
+		return keys;
+	}
+
+	// 大小差很多、差不多、有一边为空、完全不相交几种情况都要覆盖
+	struct set_op_case
+	{
+		size_t a;
+		size_t b;
+		int a_range;
+		int b_offset;
+	};
+
+	const set_op_case set_op_cases[] = {
+		{ 0, 0, 10, 0 }, { 0, 50, 100, 0 }, { 50, 0, 100, 0 }, { 1, 1000, 2000, 0 },
+		{ 1000, 3, 2000, 0 }, { 500, 500, 1000, 0 }, { 800, 700, 600, 100 }, { 300, 300, 300, 1000 },
+		{ 3000, 2000, 5000, 500 },
+	};
+
+	// map 形式的树：second 记元素来自哪一棵，检查 key 相同时留的是 this 的元素
+	template <bool OrderStat>
+	void check_unique_set_ops()
+	{
+		using map_tree = mystl::rb_tree<mystl::pair<const int, int>, mystl::less<int>, OrderStat>;
+		std::mt19937 rng(7);
+		for (const set_op_case& c : set_op_cases) {
+			std::set<int> sa, sb;
+			for (int k : random_keys(rng, c.a, c.a_range)) {
+				sa.insert(k);
+			}
+			for (int k : random_keys(rng, c.b, c.a_range)) {
+				sb.insert(k + c.b_offset);
+			}
+			auto build = [](const std::set<int>& keys, int tag) {
+				map_tree t;
+				for (int k : keys) {
+					t.insert_unique(mystl::pair<const int, int>(k, tag));
+				}
+				return t;
+			};
+
+			std::vector<int> expect;
+			std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expect));
+			map_tree a = build(sa, 1);
+			map_tree b = build(sb, 2);
+			a.union_unique(b);
+			check_rb(a);
+			check_rb(b);
+			MYSTL_CHECK(b.empty());
+			MYSTL_CHECK_EQ(a.size(), expect.size());
+			size_t i = 0;
+			for (auto it = a.begin(); it != a.end(); ++it, ++i) {
+				MYSTL_CHECK_EQ(it->first, expect[i]);
+				MYSTL_CHECK_EQ(it->second, sa.count(it->first) != 0 ? 1 : 2);
+			}
+
+			expect.clear();
+			std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expect));
+			map_tree x = build(sa, 1);
+			map_tree y = build(sb, 2);
+			x.intersect_unique(y);
+			check_rb(x);
+			check_rb(y);
+			MYSTL_CHECK(y.empty());
+			MYSTL_CHECK_EQ(x.size(), expect.size());
+			i = 0;
+			for (auto it = x.begin(); it != x.end(); ++it, ++i) {
+				MYSTL_CHECK_EQ(it->first, expect[i]);
+				MYSTL_CHECK_EQ(it->second, 1);
+			}
+
+			// 合并之后的树还能正常插入和删除
+			x.insert_unique(mystl::pair<const int, int>(-1, 0));
+			x.erase_unique(-1);
+			check_rb(x);
+		}
+	}
+
+	template <bool OrderStat>
+	void check_union_multi()
+	{
+		using multi_tree = mystl::rb_tree<int, mystl::less<int>, OrderStat>;
+		std::mt19937 rng(9);
+		for (const set_op_case& c : set_op_cases) {
+			// 取值范围小，两边都有很多重复的 key
+			std::vector<int> ka = random_keys(rng, c.a, c.a_range / 4 + 1);
+			std::vector<int> kb = random_keys(rng, c.b, c.a_range / 4 + 1);
+			multi_tree a, b;
+			for (int k : ka) {
+				a.insert_multi(k);
+			}
+			for (int k : kb) {
+				b.insert_multi(k + c.b_offset);
+			}
+			std::sort(ka.begin(), ka.end());
+			std::sort(kb.begin(), kb.end());
+			for (int& k : kb) {
+				k += c.b_offset;
+			}
+			// union_multi 保留两边所有的元素，对应 std::merge 而不是 std::set_union
+			std::vector<int> expect;
+			std::merge(ka.begin(), ka.end(), kb.begin(), kb.end(), std::back_inserter(expect));
+			a.union_multi(b);
+			check_rb(a);
+			MYSTL_CHECK(b.empty());
+			MYSTL_CHECK_EQ(a.size(), expect.size());
+			MYSTL_CHECK(std::equal(expect.begin(), expect.end(), a.begin()));
+		}
+	}
+
+	void test_set_ops()
+	{
+		check_unique_set_ops<false>();
+		check_unique_set_ops<true>();
+		check_union_multi<false>();
+		check_union_multi<true>();
+	}
+
+	// 没开 OrderStat 的树 split 要自己数两边的元素个数
+	void test_split_without_order_stat()
+	{
+		using plain_tree = mystl::rb_tree<int, mystl::less<int>>;
+		std::mt19937 rng(13);
+		for (int round = 0; round < 50; round++) {
+			plain_tree t;
+			std::multiset<int> s;
+			for (int k : random_keys(rng, rng() % 500, 300)) {
+				t.insert_multi(k);
+				s.insert(k);
+			}
+			const int key = static_cast<int>(rng() % 320) - 10;
+			plain_tree right = t.split(key);
+			check_rb(t);
+			check_rb(right);
+			MYSTL_CHECK_EQ(t.size(), static_cast<size_t>(std::distance(s.begin(), s.lower_bound(key))));
+			MYSTL_CHECK_EQ(right.size(), static_cast<size_t>(std::distance(s.lower_bound(key), s.end())));
+			t.join(right);
+			check_rb(t);
+			check_same(t, s);
+		}
+	}
+
+
+	// 用 const char* 比较时计数，确认走的是不构造 std::string 的重载
+	size_t c_str_calls = 0;
+
+	struct transparent_less
+	{
+		using is_transparent = void;
+
+		bool operator()(const std::string& a, const std::string& b) const { return a < b; }
+		bool operator()(const char* a, const std::string& b) const { ++c_str_calls; return b.compare(a) > 0; }
+		bool operator()(const std::string& a, const char* b) const { ++c_str_calls; return a.compare(b) < 0; }
+	};
+
+	void test_transparent_lookup()
+	{
+		using ttree = mystl::rb_tree<std::string, transparent_less>;
+		const int n = 200;
+		mystl::vector<std::string> keys;
+		ttree t;
+		for (int i = 0; i < n; i++) {
+			keys.push_back(key_of(i));
+			t.insert_multi(key_of(i));
+			if (i % 4 == 0) {
+				t.insert_multi(key_of(i));
+			}
+		}
+
+		c_str_calls = 0;
+		for (int i = 0; i < n; i++) {
+			const char* k = keys[i].c_str();
+			const size_t expect = i % 4 == 0 ? 2 : 1;
+			auto it = t.find(k);
+			MYSTL_CHECK(it != t.end());
+			MYSTL_CHECK(*it == keys[i]);
+			MYSTL_CHECK_EQ(t.count_multi(k), expect);
+			MYSTL_CHECK_EQ(t.count_unique(k), 1u);
+			MYSTL_CHECK(t.lower_bound(k) == t.lower_bound(keys[i]));
+			MYSTL_CHECK(t.upper_bound(k) == t.upper_bound(keys[i]));
+			auto r = t.equal_range_multi(k);
+			MYSTL_CHECK_EQ(static_cast<size_t>(mystl::distance(r.first, r.second)), expect);
+			auto u = t.equal_range_unique(k);
+			MYSTL_CHECK_EQ(static_cast<size_t>(mystl::distance(u.first, u.second)), 1u);
+		}
+		MYSTL_CHECK(c_str_calls >= static_cast<size_t>(6 * n));
+
+		// 比所有 key 都小、都大和夹在两个 key 中间的探针
+		MYSTL_CHECK(t.find("") == t.end());
+		MYSTL_CHECK(t.lower_bound("") == t.begin());
+		MYSTL_CHECK(t.lower_bound("zzz") == t.end());
+		const std::string between = keys[10] + "!";
+		MYSTL_CHECK(t.find(between.c_str()) == t.end());
+		MYSTL_CHECK(t.lower_bound(between.c_str()) == t.lower_bound(keys[11]));
+		const ttree& ct = t;
+		MYSTL_CHECK(ct.find(keys[3].c_str()) == ct.find(keys[3]));
+
+		for (int i = 0; i < n; i += 2) {
+			MYSTL_CHECK_EQ(t.erase_multi(keys[i].c_str()), i % 4 == 0 ? 2u : 1u);
+		}
+		for (int i = 1; i < n; i += 4) {
+			MYSTL_CHECK_EQ(t.erase_unique(keys[i].c_str()), 1u);
+		}
+		MYSTL_CHECK_EQ(t.erase_unique("zzz"), 0u);
+		MYSTL_CHECK_EQ(t.size(), static_cast<size_t>(n / 4));
+		for (int i = 0; i < n; i++) {
+			MYSTL_CHECK_EQ(t.count_multi(keys[i].c_str()), i % 4 == 3 ? 1u : 0u);
+		}
+	}
+
+
+	// for_each_range 访问到的元素要和 [lower_bound(lo), lower_bound(hi)) 一模一样，要求 lo 不大于 hi
+	template <class Tree, class K>
+	void check_range(const Tree& t, const K& lo, const K& hi)
+	{
+		auto it = t.lower_bound(lo);
+		const auto last = t.lower_bound(hi);
+		size_t visited = 0;
+		bool same = true;
+		t.for_each_range(lo, hi, [&](const typename Tree::value_type& v) {
+			same = same && it != last && &*it == &v;
+			if (it != last) {
+				++it;
+			}
+			++visited;
+		});
+		MYSTL_CHECK(same);
+		MYSTL_CHECK(it == last);
+		MYSTL_CHECK_EQ(visited, static_cast<size_t>(mystl::distance(t.lower_bound(lo), last)));
+	}
+
+	void test_for_each_range()
+	{
+		// 顺序插入让树尽量高，显式栈要放得下
+		const int n = 100000;
+		order_tree t;
+		for (int i = 0; i < n; i++) {
+			t.insert_multi(i * 2);
+			if (i % 7 == 0) {
+				t.insert_multi(i * 2);
+			}
+		}
+		check_range(t, 0, 2 * n);
+		check_range(t, -10, 2 * n + 10);
+		check_range(t, 1001, 1002);
+		check_range(t, 1000, 1001);
+		check_range(t, 5000, 5000);
+		check_range(t, 2 * n, 3 * n);
+		std::mt19937 rng(7);
+		for (int r = 0; r < 200; r++) {
+			int lo = static_cast<int>(rng() % (2 * n + 20)) - 10;
+			check_range(t, lo, lo + static_cast<int>(rng() % 3000));
+		}
+		// hi 比 lo 小时一个也不访问
+		size_t visited = 0;
+		t.for_each_range(6000, 10, [&visited](const int&) { ++visited; });
+		MYSTL_CHECK_EQ(visited, 0u);
+		order_tree empty;
+		check_range(empty, 0, 100);
+
+		// 非 const 版本可以改 mapped 的值
+		mystl::rb_tree<mystl::pair<const int, int>, mystl::less<int>> m;
+		for (int i = 0; i < 100; i++) {
+			m.emplace_unique(i, 0);
+		}
+		m.for_each_range(10, 20, [](mystl::pair<const int, int>& v) { v.second = v.first; });
+		for (auto it = m.begin(); it != m.end(); ++it) {
+			MYSTL_CHECK_EQ(it->second, it->first >= 10 && it->first < 20 ? it->first : 0);
+		}
+
+		// Compare 是 transparent 的时候可以直接用 const char* 作为区间的两端
+		mystl::rb_tree<std::string, transparent_less> s;
+		for (int i = 0; i < 500; i++) {
+			s.insert_unique(key_of(i));
+		}
+		const std::string lo = key_of(120);
+		const std::string hi = key_of(130) + "!";
+		c_str_calls = 0;
+		check_range(s, lo.c_str(), hi.c_str());
+		MYSTL_CHECK(c_str_calls > 0);
+		std::vector<std::string> got;
+		s.for_each_range(lo.c_str(), hi.c_str(), [&got](std::string& v) { got.push_back(v); });
+		MYSTL_CHECK_EQ(got.size(), 11u);
+		MYSTL_CHECK(got.front() == key_of(120));
+		MYSTL_CHECK(got.back() == key_of(130));
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_copy_keeps_source);
+	MYSTL_RUN(test_assign_sorted_keeps_input);
+	MYSTL_RUN(test_insert_lvalue);
+	MYSTL_RUN(test_random_against_std);
+	MYSTL_RUN(test_set_ops);
+	MYSTL_RUN(test_split_without_order_stat);
+	MYSTL_RUN(test_transparent_lookup);
+	MYSTL_RUN(test_for_each_range);
+	return 0;
+}
@@ -0,0 +1,25 @@
+#ifndef MYSTL_TEST_UTIL_H
+#define MYSTL_TEST_UTIL_H
+
+// 测试用的简单断言，不依赖 assert，Release 下也会检查
+
+#include <cstdio>
+#include <cstdlib>
+
+#define MYSTL_CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+			std::exit(1); \
+		} \
+	} while (0)
+
+#define MYSTL_CHECK_EQ(a, b) MYSTL_CHECK((a) == (b))
+
+#define MYSTL_RUN(test) \
+	do { \
+		test(); \
+		std::printf("[ok] %s\n", #test); \
+	} while (0)
+
+#endif // !MYSTL_TEST_UTIL_H
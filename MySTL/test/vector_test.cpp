@@ -0,0 +1,214 @@
+// vector 的测试：和 std::vector 做随机操作对拍，元素用 std::string 让越界和重复析构能被 sanitizer 抓到
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "vector.h"
+#include "test_util.h"
+
+namespace {
+
+	using str_vec = mystl::vector<std::string>;
+
+	bool same(const str_vec& v, const std::vector<std::string>& ref)
+	{
+		if (v.size() != ref.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < ref.size(); i++) {
+			if (v[i] != ref[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// 扩容时新元素要构造在新空间里，之前会写到旧空间的 pos 上
+	void test_grow()
+	{
+		str_vec v;
+		std::vector<std::string> ref;
+		for (int i = 0; i < 1000; i++) {
+			std::string s = "value-" + std::to_string(i);
+			if (i % 3 == 0) {
+				v.push_back(s);
+				ref.push_back(s);
+			}
+			else if (i % 3 == 1) {
+				v.emplace_back(s);
+				ref.emplace_back(s);
+			}
+			else {
+				v.push_back(std::string(s));
+				ref.push_back(std::string(s));
+			}
+		}
+		MYSTL_CHECK(same(v, ref));
+
+		str_vec w;
+		std::vector<std::string> wref;
+		for (int i = 0; i < 500; i++) {
+			std::string s = std::to_string(i);
+			size_t pos = wref.empty() ? 0 : (i * 7) % (wref.size() + 1);
+			w.insert(w.begin() + pos, s);
+			wref.insert(wref.begin() + pos, s);
+			pos = (i * 13) % (wref.size() + 1);
+			w.emplace(w.begin() + pos, s + "e");
+			wref.emplace(wref.begin() + pos, s + "e");
+		}
+		MYSTL_CHECK(same(w, wref));
+	}
+
+	// 插入的值引用着容器自己的元素
+	void test_self_insert()
+	{
+		str_vec v;
+		std::vector<std::string> ref;
+		for (int i = 0; i < 20; i++) {
+			v.push_back(std::to_string(i));
+			ref.push_back(std::to_string(i));
+		}
+		for (int i = 0; i < 100; i++) {
+			v.insert(v.begin() + 1, v[v.size() - 1]);
+			ref.insert(ref.begin() + 1, ref[ref.size() - 1]);
+			v.push_back(v[0]);
+			ref.push_back(ref[0]);
+			v.insert(v.begin(), 3, v[2]);
+			ref.insert(ref.begin(), 3, ref[2]);
+		}
+		MYSTL_CHECK(same(v, ref));
+	}
+
+	void test_random_ops()
+	{
+		std::mt19937 rng(12345);
+		str_vec v;
+		std::vector<std::string> ref;
+		for (int step = 0; step < 20000; step++) {
+			const int op = static_cast<int>(rng() % 10);
+			const size_t pos = ref.empty() ? 0 : rng() % (ref.size() + 1);
+			std::string s = std::to_string(rng() % 1000);
+			switch (op) {
+			case 0:
+				v.push_back(s);
+				ref.push_back(s);
+				break;
+			case 1:
+				v.emplace_back(s);
+				ref.emplace_back(s);
+				break;
+			case 2:
+				v.insert(v.begin() + pos, s);
+				ref.insert(ref.begin() + pos, s);
+				break;
+			case 3: {
+				const size_t n = rng() % 40;
+				v.insert(v.begin() + pos, n, s);
+				ref.insert(ref.begin() + pos, n, s);
+				break;
+			}
+			case 4: {
+				std::vector<std::string> src(rng() % 40, s);
+				for (size_t i = 0; i < src.size(); i++) {
+					src[i] += std::to_string(i);
+				}
+				v.insert(v.begin() + pos, src.data(), src.data() + src.size());
+				ref.insert(ref.begin() + pos, src.begin(), src.end());
+				break;
+			}
+			case 5:
+				if (!ref.empty()) {
+					const size_t at = rng() % ref.size();
+					v.erase(v.begin() + at);
+					ref.erase(ref.begin() + at);
+				}
+				break;
+			case 6:
+				if (!ref.empty()) {
+					const size_t last = pos + rng() % (ref.size() - pos + 1);
+					v.erase(v.begin() + pos, v.begin() + last);
+					ref.erase(ref.begin() + pos, ref.begin() + last);
+				}
+				break;
+			case 7:
+				if (!ref.empty()) {
+					v.pop_back();
+					ref.pop_back();
+				}
+				break;
+			case 8: {
+				const size_t n = rng() % 200;
+				v.resize(n, s);
+				ref.resize(n, s);
+				break;
+			}
+			default:
+				if (rng() % 2 == 0) {
+					v.shrink_to_fit();
+				}
+				else {
+					v.reserve(v.size() + rng() % 100);
+				}
+				break;
+			}
+			MYSTL_CHECK(same(v, ref));
+		}
+	}
+
+	void test_copy_assign()
+	{
+		str_vec a;
+		for (int i = 0; i < 100; i++) {
+			a.push_back(std::to_string(i));
+		}
+		str_vec b(a);
+		MYSTL_CHECK(a == b);
+		MYSTL_CHECK_EQ(a.size(), 100u);
+
+		str_vec c;
+		c.push_back("x");
+		c = a;
+		MYSTL_CHECK(c == a);
+
+		str_vec d(a.begin(), a.begin() + 10);
+		d = a;
+		MYSTL_CHECK(d == a);
+		d.assign(a.begin(), a.begin() + 5);
+		MYSTL_CHECK_EQ(d.size(), 5u);
+		MYSTL_CHECK(d[4] == "4");
+		d.assign(300, "y");
+		MYSTL_CHECK_EQ(d.size(), 300u);
+		d.assign(3, "z");
+		MYSTL_CHECK_EQ(d.size(), 3u);
+		MYSTL_CHECK(d[2] == "z");
+
+		str_vec e(mystl::move(b));
+		MYSTL_CHECK(e == a);
+		MYSTL_CHECK(b.empty());
+		b = mystl::move(e);
+		MYSTL_CHECK(b == a);
+
+		mystl::vector<int> iv{ 3, 1, 2 };
+		iv.insert(iv.begin() + 1, 5, 7);
+		MYSTL_CHECK_EQ(iv.size(), 8u);
+		MYSTL_CHECK_EQ(iv[0], 3);
+		MYSTL_CHECK_EQ(iv[5], 7);
+		MYSTL_CHECK_EQ(iv[7], 2);
+		int sum = 0;
+		for (auto it = iv.rbegin(); it != iv.rend(); ++it) {
+			sum += *it;
+		}
+		MYSTL_CHECK_EQ(sum, 41);
+	}
+
+}
+
+int main()
+{
+	MYSTL_RUN(test_grow);
+	MYSTL_RUN(test_self_insert);
+	MYSTL_RUN(test_random_ops);
+	MYSTL_RUN(test_copy_assign);
+	return 0;
+}